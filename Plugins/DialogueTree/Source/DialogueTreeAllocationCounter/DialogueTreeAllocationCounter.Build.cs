@@ -0,0 +1,18 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+using UnrealBuildTool;
+
+public class DialogueTreeAllocationCounter : ModuleRules
+{
+	public DialogueTreeAllocationCounter(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core"
+			}
+			);
+	}
+}
@@ -0,0 +1,188 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueAllocationCounter.h"
+//UE
+#include "HAL/MemoryBase.h"
+
+namespace
+{
+	/** 
+	* Where the current thread's allocations are counted. Only ever set on 
+	* the game thread, by an open FScope; null everywhere else.
+	*/
+	thread_local int64* GCountedAllocations = nullptr;
+
+	/**
+	* Allocator proxy that counts allocations for the thread's open scope,
+	* if any, and forwards everything to the allocator it was installed in
+	* front of.
+	*/
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		/** FMalloc Impl. */
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count,
+			uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count,
+			uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Count, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			Inner->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			Inner->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			Inner->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void InitializeStatsMetadata() override
+		{
+			Inner->InitializeStatsMetadata();
+		}
+
+		virtual void UpdateStats() override
+		{
+			Inner->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			Inner->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			Inner->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return Inner->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return Inner->GetDescriptiveName();
+		}
+		/** End FMalloc */
+
+	private:
+		static void CountAllocation()
+		{
+			if (int64* Counter = GCountedAllocations)
+			{
+				++*Counter;
+			}
+		}
+
+	private:
+		/** 
+		* The allocator calls are forwarded to. Set once and never cleared, 
+		* as other threads may be inside the proxy at any time.
+		*/
+		FMalloc* const Inner;
+	};
+
+	/** The installed proxy. Deliberately leaked, along with the allocator */
+	FCountingMalloc* GCountingMalloc = nullptr;
+}
+
+FDialogueAllocationCounter::FScope::FScope()
+{
+	//Worker threads share the allocator, so only the game thread counts
+	check(IsInGameThread());
+	check(!GCountedAllocations);
+	GCountedAllocations = &NumAllocations;
+}
+
+FDialogueAllocationCounter::FScope::~FScope()
+{
+	check(GCountedAllocations == &NumAllocations);
+	GCountedAllocations = nullptr;
+}
+
+int64 FDialogueAllocationCounter::FScope::GetNumAllocations() const
+{
+	return NumAllocations;
+}
+
+void FDialogueAllocationCounter::Install()
+{
+	if (GCountingMalloc || !GMalloc)
+	{
+		return;
+	}
+
+	//Loaded before the task graph, so every worker allocates through it
+	check(IsInGameThread());
+
+	GCountingMalloc = new FCountingMalloc(GMalloc);
+	FPlatformAtomics::InterlockedExchangePtr(
+		reinterpret_cast<void**>(&GMalloc),
+		GCountingMalloc
+	);
+}
+
+bool FDialogueAllocationCounter::IsInstalled()
+{
+	return GCountingMalloc != nullptr;
+}
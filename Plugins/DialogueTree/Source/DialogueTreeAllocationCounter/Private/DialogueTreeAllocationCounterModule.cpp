@@ -0,0 +1,20 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#include "DialogueTreeAllocationCounterModule.h"
+#include "DialogueAllocationCounter.h"
+
+void FDialogueTreeAllocationCounterModule::StartupModule()
+{
+	FDialogueAllocationCounter::Install();
+}
+
+bool FDialogueTreeAllocationCounterModule::SupportsDynamicReloading()
+{
+	//GMalloc keeps pointing into this module once it has loaded
+	return false;
+}
+	
+IMPLEMENT_MODULE(
+	FDialogueTreeAllocationCounterModule, 
+	DialogueTreeAllocationCounter
+)
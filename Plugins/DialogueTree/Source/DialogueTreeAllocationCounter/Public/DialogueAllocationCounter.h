@@ -0,0 +1,57 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+
+/**
+* Counts the heap allocations the game thread makes through GMalloc. The
+* counter is an allocator proxy put in front of GMalloc once, as its module
+* loads before any worker thread has started, and it is never taken out
+* again: every call is forwarded to the allocator it was installed over.
+* Allocations are only counted on the game thread, and only while an
+* FScope is open on it.
+*/
+class DIALOGUETREEALLOCATIONCOUNTER_API FDialogueAllocationCounter
+{
+public:
+	/**
+	* Counts the game thread's allocations for as long as it is alive. 
+	* Scopes cannot be nested.
+	*/
+	class DIALOGUETREEALLOCATIONCOUNTER_API FScope
+	{
+	public:
+		FScope();
+		~FScope();
+
+		FScope(const FScope&) = delete;
+		FScope& operator=(const FScope&) = delete;
+
+		/**
+		* Retrieves the allocations counted since the scope was opened.
+		* 
+		* @return int64 - the number of allocations.
+		*/
+		int64 GetNumAllocations() const;
+
+	private:
+		/** Allocations counted so far */
+		int64 NumAllocations = 0;
+	};
+
+	/**
+	* Puts the counter in front of GMalloc. Only the first call does
+	* anything, and it must be made before other threads start allocating.
+	*/
+	static void Install();
+
+	/**
+	* Checks whether the counter was installed, in which case every
+	* allocation the game thread makes through GMalloc is seen by it.
+	* 
+	* @return bool - True if allocations can be counted. False otherwise.
+	*/
+	static bool IsInstalled();
+};
@@ -0,0 +1,21 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+/**
+* Loads the allocation counter before any other module, so that it can be
+* put in front of GMalloc while the game thread is the only thread there
+* is. Never unloads it; the counter stays installed for the whole process.
+*/
+class FDialogueTreeAllocationCounterModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual bool SupportsDynamicReloading() override;
+	/** End IModuleInterface */
+};
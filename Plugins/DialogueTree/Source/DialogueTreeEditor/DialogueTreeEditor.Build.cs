@@ -40,6 +40,7 @@ public class DialogueTreeEditor : ModuleRules
 			new string[]
 			{
 				"DialogueTreeRuntime",
+				"DialogueTreeAllocationCounter",
                 "Slate",
                 "SlateCore",
                 "AssetTools",
@@ -53,6 +54,7 @@ public class DialogueTreeEditor : ModuleRules
 				"ApplicationCore",
 				"ToolMenus",
 				"GameplayTags",
+				"Json",
 				"Projects"
 			}
 			);
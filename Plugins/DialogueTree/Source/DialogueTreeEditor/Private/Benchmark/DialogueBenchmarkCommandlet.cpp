@@ -0,0 +1,348 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Benchmark/DialogueBenchmarkCommandlet.h"
+//UE
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformTime.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UObjectHash.h"
+//Plugin
+#include "Benchmark/DialogueBenchmarkActors.h"
+#include "Benchmark/DialogueBenchmarkWorld.h"
+#include "Dialogue.h"
+#include "DialogueOption.h"
+#include "DialogueProgram.h"
+#include "DialogueSettings.h"
+#include "Graph/DialogueEdGraph.h"
+#include "Graph/Nodes/GraphNodeDialogue.h"
+#include "LogDialogueTree.h"
+
+namespace
+{
+	/** Number of gathers timed per iteration, since one is too quick */
+	constexpr int32 GathersPerIteration = 100;
+
+	/**
+	* Times the given function, returning the average over the iterations.
+	*/
+	template<typename FuncType>
+	double AverageMilliseconds(int32 InIterations, FuncType&& InFunc)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 i = 0; i < InIterations; ++i)
+		{
+			InFunc();
+		}
+
+		return (FPlatformTime::Seconds() - StartTime) * 1000.0
+			/ FMath::Max(InIterations, 1);
+	}
+
+	/**
+	* Counts the runtime memory owned by the dialogue. Editor graph objects
+	* are left out, since they never ship.
+	*/
+	int64 CountRuntimeBytes(UDialogue* InDialogue)
+	{
+		TArray<UObject*> Objects;
+		GetObjectsWithOuter(InDialogue, Objects, true);
+		Objects.Add(InDialogue);
+
+		int64 Bytes = 0;
+		for (UObject* Object : Objects)
+		{
+			if (Object->IsA<UEdGraph>() || Object->GetTypedOuter<UEdGraph>())
+			{
+				continue;
+			}
+
+			FArchiveCountMem CountMem(Object);
+			Bytes += CountMem.GetMax();
+		}
+
+		return Bytes;
+	}
+}
+
+UDialogueBenchmarkCommandlet::UDialogueBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UDialogueBenchmarkCommandlet::Main(const FString& Params)
+{
+	//Parse settings
+	FString ShapesParam = TEXT("Hub,Chain,BranchLadder,VisitedQueries");
+	FString SizesParam = TEXT("8,64,512");
+	FString OutputPath = FPaths::ProjectSavedDir()
+		/ TEXT("DialogueBenchmark") / TEXT("Results.json");
+
+	FParse::Value(*Params, TEXT("Shapes="), ShapesParam);
+	FParse::Value(*Params, TEXT("Sizes="), SizesParam);
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	Iterations = FMath::Max(Iterations, 1);
+
+	TArray<FString> ShapeNames;
+	ShapesParam.ParseIntoArray(ShapeNames, TEXT(","));
+	TArray<FString> SizeStrings;
+	SizesParam.ParseIntoArray(SizeStrings, TEXT(","));
+
+	//Dialogues play headless in a world of their own
+	FDialogueBenchmarkWorld BenchmarkWorld;
+	if (!BenchmarkWorld.Create())
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Dialogue benchmark failed to create its world.")
+		);
+		return 1;
+	}
+	World = &BenchmarkWorld;
+
+	//Run every combination of shape and size
+	bool bAllPassed = true;
+	TArray<TSharedPtr<FJsonValue>> Cases;
+	for (const FString& ShapeName : ShapeNames)
+	{
+		EDialogueBenchmarkShape Shape;
+		if (!FDialogueBenchmarkGraphs::ParseShape(ShapeName.TrimStartAndEnd(), Shape))
+		{
+			UE_LOG(
+				LogDialogueTree,
+				Error,
+				TEXT("Unknown dialogue benchmark shape [%s]."),
+				*ShapeName
+			);
+			bAllPassed = false;
+			continue;
+		}
+
+		for (const FString& SizeString : SizeStrings)
+		{
+			const int32 Size = FCString::Atoi(*SizeString);
+			TSharedPtr<FJsonObject> Case = RunCase(Shape, Size);
+
+			if (Case)
+			{
+				Cases.Add(MakeShared<FJsonValueObject>(Case));
+				bAllPassed &= Case->GetBoolField(TEXT("Passed"));
+			}
+			else
+			{
+				bAllPassed = false;
+			}
+
+			CollectGarbage(RF_NoFlags);
+		}
+	}
+
+	World = nullptr;
+	BenchmarkWorld.Destroy();
+
+	//Write the results
+	TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+	TSharedPtr<IPlugin> Plugin =
+		IPluginManager::Get().FindPlugin(TEXT("DialogueTree"));
+	Results->SetStringField(
+		TEXT("PluginVersion"),
+		Plugin ? Plugin->GetDescriptor().VersionName : FString()
+	);
+	Results->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Results->SetNumberField(TEXT("Iterations"), Iterations);
+	Results->SetArrayField(TEXT("Cases"), Cases);
+
+	FString Output;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Results, Writer);
+
+	if (!FFileHelper::SaveStringToFile(Output, *OutputPath))
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Dialogue benchmark failed to write results to %s."),
+			*OutputPath
+		);
+		return 1;
+	}
+
+	UE_LOG(
+		LogDialogueTree,
+		Display,
+		TEXT("Dialogue benchmark results written to %s."),
+		*OutputPath
+	);
+	return bAllPassed ? 0 : 1;
+}
+
+TSharedPtr<FJsonObject> UDialogueBenchmarkCommandlet::RunCase(
+	EDialogueBenchmarkShape InShape, int32 InSize)
+{
+	FDialogueBenchmarkGraph Graph =
+		FDialogueBenchmarkGraphs::Generate(InShape, InSize);
+	UDialogue* Dialogue = Graph.Dialogue;
+	Dialogue->AddToRoot();
+	ON_SCOPE_EXIT
+	{
+		Dialogue->RemoveFromRoot();
+	};
+
+	TSharedRef<FJsonObject> Case = MakeShared<FJsonObject>();
+	bool bCasePassed = true;
+	Case->SetStringField(
+		TEXT("Shape"),
+		FDialogueBenchmarkGraphs::GetShapeName(InShape)
+	);
+	Case->SetNumberField(TEXT("Size"), InSize);
+	Case->SetNumberField(TEXT("NumNodes"), Dialogue->GetNumNodes());
+
+	//Rebuild the editor graph from the asset, as opening the editor does
+	UDialogueEdGraph* DialogueGraph = nullptr;
+	const double RebuildMs = AverageMilliseconds(Iterations, [&]()
+		{
+			DialogueGraph = FDialogueBenchmarkGraphs::BuildEdGraph(Dialogue);
+		}
+	);
+	Dialogue->SetEdGraph(DialogueGraph);
+	Case->SetNumberField(TEXT("GraphRebuildMs"), RebuildMs);
+
+	//Compile everything from scratch
+	const double FullCompileMs = AverageMilliseconds(Iterations, [&]()
+		{
+			DialogueGraph->MarkNeedsFullCompile();
+			DialogueGraph->CompileAsset();
+		}
+	);
+	Case->SetNumberField(TEXT("CompileFullMs"), FullCompileMs);
+
+	if (Dialogue->GetCompileStatus() != EDialogueCompileStatus::Compiled)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Dialogue benchmark [%s %d] failed to compile."),
+			FDialogueBenchmarkGraphs::GetShapeName(InShape),
+			InSize
+		);
+		return nullptr;
+	}
+
+	//Compile again after editing a single speech
+	UGraphNodeDialogue* EditNode = DialogueGraph->GetNode(Graph.EditNodeID);
+	const double IncrementalCompileMs = AverageMilliseconds(Iterations, [&]()
+		{
+			DialogueGraph->MarkNodeDirty(EditNode);
+			DialogueGraph->CompileAsset();
+		}
+	);
+	Case->SetNumberField(TEXT("CompileIncrementalMs"), IncrementalCompileMs);
+
+	//Play the dialogue through, taking the first option each time
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	const int32 MaxHops = GetDefault<UDialogueSettings>()->MaxTraversalHops;
+	if (Graph.PathLength <= MaxHops)
+	{
+		ADialogueBenchmarkController* Controller = World->GetController();
+		const double PlayMs = AverageMilliseconds(Iterations, [&]()
+			{
+				const int32 Handle = Controller->StartAmbientDialogue(
+					Dialogue,
+					{ World->GetSpeaker() },
+					false
+				);
+				Controller->EndAmbientDialogue(Handle);
+			}
+		);
+
+		Case->SetNumberField(TEXT("PlaythroughMs"), PlayMs);
+		Case->SetNumberField(
+			TEXT("HopsPerSecond"),
+			PlayMs > 0.0 ? Graph.PathLength * 1000.0 / PlayMs : 0.0
+		);
+	}
+
+	//Replay a warm instance, which may only allocate for its option screens
+	if (Graph.PathLength <= MaxHops)
+	{
+		const FDialogueSteadyStateAllocations Allocations =
+			World->CountSteadyStateAllocations(Dialogue, Iterations);
+		Case->SetNumberField(
+			TEXT("SteadyStateAllocations"),
+			static_cast<double>(Allocations.NumAllocations) / Iterations
+		);
+		Case->SetNumberField(
+			TEXT("SteadyStateAllocationBudget"),
+			static_cast<double>(Allocations.GetBudget()) / Iterations
+		);
+
+		if (Allocations.NumAllocations == INDEX_NONE)
+		{
+			UE_LOG(
+				LogDialogueTree,
+				Error,
+				TEXT("Dialogue benchmark [%s %d] could not count allocations; the allocation counter is not installed."),
+				FDialogueBenchmarkGraphs::GetShapeName(InShape),
+				InSize
+			);
+			bCasePassed = false;
+		}
+		else if (Allocations.NumAllocations > Allocations.GetBudget())
+		{
+			UE_LOG(
+				LogDialogueTree,
+				Error,
+				TEXT("Dialogue benchmark [%s %d] allocated %lld times over %d warm playthroughs, over its budget of %lld."),
+				FDialogueBenchmarkGraphs::GetShapeName(InShape),
+				InSize,
+				Allocations.NumAllocations,
+				Iterations,
+				Allocations.GetBudget()
+			);
+			bCasePassed = false;
+		}
+	}
+
+	//Gather options the way an input transition does
+	const int32 OptionIndex = Program.FindNode(Graph.OptionNodeID);
+	if (OptionIndex != INDEX_NONE)
+	{
+		TArray<FResolvedDialogueOption> Options;
+		const double GatherMs = AverageMilliseconds(Iterations, [&]()
+			{
+				for (int32 i = 0; i < GathersPerIteration; ++i)
+				{
+					Program.GatherOptions(OptionIndex, Options);
+				}
+			}
+		);
+
+		Case->SetNumberField(
+			TEXT("OptionGatherUs"),
+			GatherMs * 1000.0 / GathersPerIteration
+		);
+		Case->SetNumberField(TEXT("NumOptions"), Options.Num());
+	}
+
+	//Memory the compiled dialogue holds at runtime
+	const int64 RuntimeBytes = CountRuntimeBytes(Dialogue);
+	Case->SetNumberField(TEXT("RuntimeBytes"), RuntimeBytes);
+	Case->SetNumberField(
+		TEXT("BytesPerNode"),
+		static_cast<double>(RuntimeBytes) / FMath::Max(Program.GetNumNodes(), 1)
+	);
+
+	Case->SetBoolField(TEXT("Passed"), bCasePassed);
+	return Case;
+}
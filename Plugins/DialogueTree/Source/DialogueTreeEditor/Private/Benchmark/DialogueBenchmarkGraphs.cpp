@@ -0,0 +1,276 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Benchmark/DialogueBenchmarkGraphs.h"
+//UE
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "UObject/Package.h"
+//Plugin
+#include "Conditionals/DialogueConditionBool.h"
+#include "Conditionals/Queries/NodeVisitedQuery.h"
+#include "Dialogue.h"
+#include "DialogueNodeSocket.h"
+#include "Graph/DialogueEdGraph.h"
+#include "Graph/DialogueEdGraphSchema.h"
+#include "Nodes/DialogueBranchNode.h"
+#include "Nodes/DialogueEntryNode.h"
+#include "Nodes/DialogueSpeechNode.h"
+#include "Transitions/AutoDialogueTransition.h"
+#include "Transitions/InputDialogueTransition.h"
+
+namespace
+{
+	/** The speaker role every generated speech is given */
+	const FName BenchmarkSpeakerRole = "NPC";
+
+	/**
+	* Adds asset nodes to a dialogue, placing them on a grid so that
+	* siblings keep their left to right order.
+	*/
+	struct FBenchmarkGraphBuilder
+	{
+		explicit FBenchmarkGraphBuilder(UDialogue* InDialogue)
+			: Dialogue(InDialogue)
+		{
+		}
+
+		template<typename NodeType>
+		NodeType* AddNode(const TCHAR* BaseID, int32 Column, int32 Row)
+		{
+			NodeType* NewNode = NewObject<NodeType>(Dialogue);
+			NewNode->SetNodeID(
+				*FString::Printf(TEXT("%s %d"), BaseID, ++NumNodes)
+			);
+			NewNode->SetGraphLocation(
+				FVector2D(Column * 400.f, Row * 250.f)
+			);
+			Dialogue->AddNode(NewNode);
+			return NewNode;
+		}
+
+		UDialogueSpeechNode* AddSpeech(int32 Column, int32 Row,
+			TSubclassOf<UDialogueTransition> TransitionType)
+		{
+			UDialogueSpeechNode* NewNode =
+				AddNode<UDialogueSpeechNode>(TEXT("Speech"), Column, Row);
+
+			FSpeechDetails Details;
+			Details.SpeakerName = BenchmarkSpeakerRole;
+			Details.SpeechText = FText::FromString(
+				FString::Printf(TEXT("Line %d"), NumNodes)
+			);
+			NewNode->InitSpeechData(Details, TransitionType);
+			return NewNode;
+		}
+
+		void SetBranch(UDialogueBranchNode* InBranch, UDialogueNode* InTrue,
+			UDialogueNode* InFalse, UDialogueNode* InVisitedTarget = nullptr)
+		{
+			TArray<UDialogueCondition*> Conditions;
+			if (InVisitedTarget)
+			{
+				UDialogueNodeSocket* Socket =
+					NewObject<UDialogueNodeSocket>(Dialogue);
+				Socket->SetDialogueNode(InVisitedTarget);
+
+				UDialogueConditionBool* Condition =
+					NewObject<UDialogueConditionBool>(Dialogue);
+				UNodeVisitedQuery* Query =
+					NewObject<UNodeVisitedQuery>(Condition);
+				Query->SetSocket(Socket);
+				Condition->SetQuery(Query);
+				Condition->SetDialogue(Dialogue);
+				Conditions.Add(Condition);
+			}
+
+			InBranch->InitBranchData(false, InTrue, InFalse, Conditions);
+			Link(InBranch, InTrue);
+			Link(InBranch, InFalse);
+		}
+
+		void Link(UDialogueNode* InParent, UDialogueNode* InChild)
+		{
+			if (InParent && InChild)
+			{
+				InParent->AddChild(InChild);
+				InChild->AddParent(InParent);
+			}
+		}
+
+		UDialogue* Dialogue;
+		int32 NumNodes = 0;
+	};
+}
+
+FDialogueBenchmarkGraph FDialogueBenchmarkGraphs::Generate(
+	EDialogueBenchmarkShape InShape, int32 InSize)
+{
+	const int32 Size = FMath::Max(InSize, 1);
+
+	FDialogueBenchmarkGraph Graph;
+	Graph.Dialogue = NewObject<UDialogue>(
+		GetTransientPackage(),
+		MakeUniqueObjectName(
+			GetTransientPackage(),
+			UDialogue::StaticClass(),
+			*FString::Printf(TEXT("Benchmark_%s_%d"), GetShapeName(InShape), Size)
+		)
+	);
+
+	FBenchmarkGraphBuilder Builder(Graph.Dialogue);
+	UDialogueEntryNode* Entry =
+		Builder.AddNode<UDialogueEntryNode>(TEXT("Entry"), 0, 0);
+	Graph.Dialogue->SetRootNode(Entry);
+
+	switch (InShape)
+	{
+	case EDialogueBenchmarkShape::Hub:
+	case EDialogueBenchmarkShape::VisitedQueries:
+	{
+		const bool bGuarded = InShape == EDialogueBenchmarkShape::VisitedQueries;
+
+		UDialogueSpeechNode* Hub = Builder.AddSpeech(
+			0, 1, UInputDialogueTransition::StaticClass()
+		);
+		Builder.Link(Entry, Hub);
+
+		//Guarded options only show once the entry has been visited
+		for (int32 i = 0; i < Size; ++i)
+		{
+			UDialogueSpeechNode* Option = Builder.AddSpeech(
+				i, bGuarded ? 3 : 2, UAutoDialogueTransition::StaticClass()
+			);
+
+			if (bGuarded)
+			{
+				UDialogueBranchNode* Branch =
+					Builder.AddNode<UDialogueBranchNode>(TEXT("Branch"), i, 2);
+				Builder.SetBranch(Branch, Option, nullptr, Entry);
+				Builder.Link(Hub, Branch);
+			}
+			else
+			{
+				Builder.Link(Hub, Option);
+			}
+
+			if (i == 0)
+			{
+				Graph.EditNodeID = Option->GetNodeID();
+			}
+		}
+
+		Graph.OptionNodeID = Hub->GetNodeID();
+		Graph.PathLength = bGuarded ? 4 : 3;
+		break;
+	}
+
+	case EDialogueBenchmarkShape::Chain:
+	{
+		UDialogueNode* Previous = Entry;
+		for (int32 i = 0; i < Size; ++i)
+		{
+			UDialogueSpeechNode* Speech = Builder.AddSpeech(
+				0, i + 1, UAutoDialogueTransition::StaticClass()
+			);
+			Builder.Link(Previous, Speech);
+			Previous = Speech;
+		}
+
+		Graph.EditNodeID = Previous->GetNodeID();
+		Graph.PathLength = Size + 1;
+		break;
+	}
+
+	case EDialogueBenchmarkShape::BranchLadder:
+	{
+		UDialogueSpeechNode* Fail = Builder.AddSpeech(
+			1, Size + 1, UAutoDialogueTransition::StaticClass()
+		);
+		UDialogueSpeechNode* Success = Builder.AddSpeech(
+			0, Size + 1, UAutoDialogueTransition::StaticClass()
+		);
+
+		//Create the rungs first so each can pass on to the next
+		TArray<UDialogueBranchNode*> Rungs;
+		for (int32 i = 0; i < Size; ++i)
+		{
+			Rungs.Add(
+				Builder.AddNode<UDialogueBranchNode>(TEXT("Branch"), 0, i + 1)
+			);
+		}
+
+		Builder.Link(Entry, Rungs[0]);
+		for (int32 i = 0; i < Size; ++i)
+		{
+			UDialogueNode* Next = Rungs.IsValidIndex(i + 1)
+				? static_cast<UDialogueNode*>(Rungs[i + 1])
+				: static_cast<UDialogueNode*>(Success);
+			Builder.SetBranch(Rungs[i], Next, Fail);
+		}
+
+		Graph.EditNodeID = Success->GetNodeID();
+		Graph.PathLength = Size + 2;
+		break;
+	}
+	}
+
+	Graph.EndNodeID = Graph.EditNodeID;
+	Graph.NumNodes = Builder.NumNodes;
+	return Graph;
+}
+
+UDialogueEdGraph* FDialogueBenchmarkGraphs::BuildEdGraph(UDialogue* InDialogue)
+{
+	UDialogueEdGraph* DialogueGraph = CastChecked<UDialogueEdGraph>(
+		FBlueprintEditorUtils::CreateNewGraph(
+			InDialogue,
+			NAME_None,
+			UDialogueEdGraph::StaticClass(),
+			UDialogueEdGraphSchema::StaticClass()
+		)
+	);
+	DialogueGraph->TryBuildGraphFromAsset(InDialogue);
+	return DialogueGraph;
+}
+
+FName FDialogueBenchmarkGraphs::GetSpeakerRole()
+{
+	return BenchmarkSpeakerRole;
+}
+
+bool FDialogueBenchmarkGraphs::ParseShape(const FString& InName,
+	EDialogueBenchmarkShape& OutShape)
+{
+	for (EDialogueBenchmarkShape Shape : {
+		EDialogueBenchmarkShape::Hub,
+		EDialogueBenchmarkShape::Chain,
+		EDialogueBenchmarkShape::BranchLadder,
+		EDialogueBenchmarkShape::VisitedQueries })
+	{
+		if (InName.Equals(GetShapeName(Shape), ESearchCase::IgnoreCase))
+		{
+			OutShape = Shape;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const TCHAR* FDialogueBenchmarkGraphs::GetShapeName(
+	EDialogueBenchmarkShape InShape)
+{
+	switch (InShape)
+	{
+	case EDialogueBenchmarkShape::Hub:
+		return TEXT("Hub");
+	case EDialogueBenchmarkShape::Chain:
+		return TEXT("Chain");
+	case EDialogueBenchmarkShape::BranchLadder:
+		return TEXT("BranchLadder");
+	case EDialogueBenchmarkShape::VisitedQueries:
+		return TEXT("VisitedQueries");
+	default:
+		return TEXT("Unknown");
+	}
+}
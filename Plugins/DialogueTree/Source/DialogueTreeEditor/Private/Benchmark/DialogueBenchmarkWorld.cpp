@@ -0,0 +1,163 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Benchmark/DialogueBenchmarkWorld.h"
+//UE
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+//Plugin
+#include "Benchmark/DialogueBenchmarkActors.h"
+#include "Benchmark/DialogueBenchmarkGraphs.h"
+#include "Dialogue.h"
+#include "DialogueAllocationCounter.h"
+#include "DialogueInstance.h"
+#include "DialogueProgram.h"
+
+FDialogueBenchmarkWorld::~FDialogueBenchmarkWorld()
+{
+	Destroy();
+}
+
+bool FDialogueBenchmarkWorld::Create()
+{
+	check(!World);
+
+	World = UWorld::CreateWorld(
+		EWorldType::Game,
+		false,
+		TEXT("DialogueBenchmarkWorld")
+	);
+	if (!World || !GEngine)
+	{
+		return false;
+	}
+
+	FWorldContext& WorldContext =
+		GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	Controller = World->SpawnActor<ADialogueBenchmarkController>();
+	AActor* SpeakerActor = World->SpawnActor<AActor>();
+	if (!Controller || !SpeakerActor)
+	{
+		return false;
+	}
+
+	Speaker = NewObject<UDialogueBenchmarkSpeaker>(SpeakerActor);
+	Speaker->SetDialogueName(FDialogueBenchmarkGraphs::GetSpeakerRole());
+	Speaker->RegisterComponent();
+	return true;
+}
+
+void FDialogueBenchmarkWorld::Destroy()
+{
+	if (!World)
+	{
+		return;
+	}
+
+	if (GEngine)
+	{
+		GEngine->DestroyWorldContext(World);
+	}
+	World->DestroyWorld(false);
+
+	World = nullptr;
+	Controller = nullptr;
+	Speaker = nullptr;
+}
+
+ADialogueBenchmarkController* FDialogueBenchmarkWorld::GetController() const
+{
+	return Controller;
+}
+
+UDialogueBenchmarkSpeaker* FDialogueBenchmarkWorld::GetSpeaker() const
+{
+	return Speaker;
+}
+
+FDialogueSteadyStateAllocations 
+	FDialogueBenchmarkWorld::CountSteadyStateAllocations(
+	UDialogue* InDialogue, int32 InPlaythroughs) const
+{
+	check(Controller && Speaker);
+
+	FDialogueSteadyStateAllocations Result;
+	if (!FDialogueAllocationCounter::IsInstalled())
+	{
+		return Result;
+	}
+
+	//The instance is driven directly, as the benchmark controller has no
+	//display for StartDialogue to open
+	TSharedRef<FDialogueInstance> Instance = MakeShared<FDialogueInstance>(
+		INDEX_NONE,
+		InDialogue,
+		Controller,
+		true
+	);
+
+	const FDialogueProgram& Program = InDialogue->GetProgram();
+	FDialogueSpeakerSlots Speakers;
+	Speakers.Init(nullptr, Program.GetNumSpeakerSlots());
+	const int32 SpeakerSlot = 
+		Program.FindSpeakerSlot(Speaker->GetDialogueName());
+	if (Speakers.IsValidIndex(SpeakerSlot))
+	{
+		Speakers[SpeakerSlot] = Speaker;
+	}
+	const int32 EntryIndex = Program.GetEntryIndex();
+	const int32 MaxSelections = Program.GetNumNodes();
+
+	int64 NumOptionScreens = 0;
+	auto PlayThrough = [&]()
+	{
+		Instance->Open(EntryIndex, Speakers);
+
+		//Every option screen has been displayed by the time it is reached
+		for (int32 i = 0; i < MaxSelections && Instance->IsActive(); ++i)
+		{
+			if (Instance->GetTransitionState().Options.IsEmpty())
+			{
+				break;
+			}
+
+			++NumOptionScreens;
+			Instance->SelectOption(0);
+		}
+
+		Instance->Close();
+	};
+
+	//The first playthrough sizes every buffer the instance reuses
+	PlayThrough();
+	NumOptionScreens = 0;
+
+	{
+		FDialogueAllocationCounter::FScope CountingScope;
+		for (int32 i = 0; i < InPlaythroughs; ++i)
+		{
+			PlayThrough();
+		}
+		Result.NumAllocations = CountingScope.GetNumAllocations();
+	}
+
+	Result.NumOptionScreens = NumOptionScreens;
+	return Result;
+}
+
+void FDialogueBenchmarkWorld::AddReferencedObjects(
+	FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(World);
+	Collector.AddReferencedObject(Controller);
+	Collector.AddReferencedObject(Speaker);
+}
+
+FString FDialogueBenchmarkWorld::GetReferencerName() const
+{
+	return TEXT("FDialogueBenchmarkWorld");
+}
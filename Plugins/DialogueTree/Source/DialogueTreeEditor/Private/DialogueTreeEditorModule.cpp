@@ -4,6 +4,8 @@
 #include "DialogueTreeEditorModule.h"
 //UE
 #include "AssetToolsModule.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
 #include "IAssetTypeActions.h"
 //Plugin
 #include "CustomDetails/DialogueGraphCustomization.h"
@@ -16,6 +18,7 @@
 #include "DialogueSpeakerSocket.h"
 #include "DialogueTreeStyle.h"
 #include "Graph/DialogueEdGraph.h"
+#include "Graph/DialogueEdGraphSchema.h"
 #include "Graph/DialogueGraphCondition.h"
 #include "Graph/DialogueTreeNodeFactory.h"
 #include "Graph/Nodes/GraphNodeDialogueBranch.h"
@@ -23,6 +26,7 @@
 #include "Graph/Nodes/GraphNodeDialogueSpeech.h"
 #include "Graph/PickableDialogueNode.h"
 #include "Graph/PickableDialogueSpeaker.h"
+#include "Transitions/DialogueTransition.h"
 
 #define LOCTEXT_NAMESPACE "FDialogueTreeEditorModule"
 
@@ -31,6 +35,7 @@ void FDialogueTreeEditorModule::StartupModule()
 	RegisterNodeFactory();
 	RegisterAssets();
 	RegisterDetailsCustomizers();
+	RegisterTransitionTypeInvalidation();
 
 	//Register Style Set
 	FDialogueTreeStyle::Initialize();
@@ -41,6 +46,7 @@ void FDialogueTreeEditorModule::ShutdownModule()
 	UnregisterNodeFactory();
 	UnregisterAssets();
 	UnregisterDetailsCustomizers();
+	UnregisterTransitionTypeInvalidation();
 
 	// Unregister Style Set
 	FDialogueTreeStyle::Shutdown();
@@ -127,6 +133,46 @@ void FDialogueTreeEditorModule::RegisterDetailsCustomizers()
 	);
 }
 
+void FDialogueTreeEditorModule::RegisterTransitionTypeInvalidation()
+{
+	//Hot reload and live coding can add or replace native types
+	ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate
+		.AddLambda([](EReloadCompleteReason)
+		{
+			UDialogueEdGraphSchema::InvalidateTransitionTypes();
+		});
+
+	//Newly loaded plugins can bring their own types
+	ModulesChangedHandle = FModuleManager::Get().OnModulesChanged()
+		.AddLambda([](FName, EModuleChangeReason)
+		{
+			UDialogueEdGraphSchema::InvalidateTransitionTypes();
+		});
+
+	//Blueprint types appear when created, compiled or loaded
+	AssetLoadedHandle = FCoreUObjectDelegates::OnAssetLoaded.AddRaw(
+		this,
+		&FDialogueTreeEditorModule::OnAssetLoaded
+	);
+
+	if (GEditor)
+	{
+		BlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddStatic(
+			&UDialogueEdGraphSchema::InvalidateTransitionTypes
+		);
+	}
+}
+
+void FDialogueTreeEditorModule::OnAssetLoaded(UObject* InAsset)
+{
+	const UBlueprint* Blueprint = Cast<UBlueprint>(InAsset);
+	if (Blueprint && Blueprint->GeneratedClass
+		&& Blueprint->GeneratedClass->IsChildOf<UDialogueTransition>())
+	{
+		UDialogueEdGraphSchema::InvalidateTransitionTypes();
+	}
+}
+
 void FDialogueTreeEditorModule::UnregisterNodeFactory()
 {
 	if (NodeFactory.IsValid())
@@ -196,6 +242,20 @@ void FDialogueTreeEditorModule::UnregisterDetailsCustomizers()
 	}
 }
 
+void FDialogueTreeEditorModule::UnregisterTransitionTypeInvalidation()
+{
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(
+		ReloadCompleteHandle
+	);
+	FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+	FCoreUObjectDelegates::OnAssetLoaded.Remove(AssetLoadedHandle);
+
+	if (GEditor)
+	{
+		GEditor->OnBlueprintCompiled().Remove(BlueprintCompiledHandle);
+	}
+}
+
 #undef LOCTEXT_NAMESPACE
 	
 IMPLEMENT_MODULE(FDialogueTreeEditorModule, DialogueTreeEditor)
\ No newline at end of file
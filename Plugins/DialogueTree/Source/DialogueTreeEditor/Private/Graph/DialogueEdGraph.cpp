@@ -53,6 +53,7 @@ bool UDialogueEdGraph::Modify(bool bAlwaysMarkDirty)
 void UDialogueEdGraph::PostEditUndo()
 {
 	Super::PostEditUndo();
+	MarkNeedsFullCompile();
 	NotifyGraphChanged();
 }
 
@@ -80,11 +81,13 @@ void UDialogueEdGraph::AddToNodeMap(UGraphNodeDialogue* InNode)
 {
 	check(InNode);
 	NodeMap.Add(InNode->GetID(), InNode);
+	MarkNeedsFullCompile();
 }
 
 void UDialogueEdGraph::RemoveFromNodeMap(FName RemoveID)
 {
 	NodeMap.Remove(RemoveID);
+	MarkNeedsFullCompile();
 }
 
 bool UDialogueEdGraph::ContainsNode(FName InID) const
@@ -152,19 +155,22 @@ void UDialogueEdGraph::CompileAsset()
 	UDialogue* Asset = GetDialogue();
 	check(Asset && Root);
 
-	//Prepare the dialogue to be compiled
-	Asset->PreCompileDialogue();
-
-	//Clear asset nodes
-	ClearAssetNodes();
+	//Only rebuild what changed if the graph's structure is intact
+	if (CanCompileIncrementally())
+	{
+		CompileDirtyNodes();
+	}
+	else
+	{
+		CompileAllNodes(Asset);
+	}
 
-	//Compile asset tree
-	CreateAssetNodes(Asset);
-	Asset->SetRootNode(Root->GetAssetNode());
+	DirtyNodeIDs.Empty();
+	DirtyLinkIDs.Empty();
+	bNeedsFullCompile = false;
 
-	TSet<UGraphNodeDialogue*> VisitedNodes;
-	UpdateAssetTreeRecursive(Root, VisitedNodes);
-	FinalizeAssetNodes();
+	//Bake the flat program the runtime traverses
+	Asset->BuildProgram();
 
 	//Determine if compilation was successful
 	if (CanCompileAsset())
@@ -177,6 +183,23 @@ void UDialogueEdGraph::CompileAsset()
 	}
 }
 
+void UDialogueEdGraph::MarkNodeDirty(UGraphNodeDialogue* InNode)
+{
+	check(InNode);
+	DirtyNodeIDs.Add(InNode->GetID());
+}
+
+void UDialogueEdGraph::MarkNodeLinksDirty(UGraphNodeDialogue* InNode)
+{
+	check(InNode);
+	DirtyLinkIDs.Add(InNode->GetID());
+}
+
+void UDialogueEdGraph::MarkNeedsFullCompile()
+{
+	bNeedsFullCompile = true;
+}
+
 bool UDialogueEdGraph::CanCompileAsset() const
 {
 	//Get all nodes
@@ -355,6 +378,7 @@ void UDialogueEdGraph::CreateAssetNodes(UDialogue* InAsset)
 		Entry.Value->CreateAssetNode(InAsset);
 		Entry.Value->AssignAssetNodeID();
 		Entry.Value->AssignAssetNodeCommonData();
+		Entry.Value->AssignAssetNodeData();
 		InAsset->AddNode(Entry.Value->GetAssetNode());
 	}
 }
@@ -368,38 +392,115 @@ void UDialogueEdGraph::FinalizeAssetNodes()
 	}
 }
 
-void UDialogueEdGraph::UpdateAssetTreeRecursive(UGraphNodeDialogue* InRoot,
-	TSet<UGraphNodeDialogue*> VisitedNodes)
+void UDialogueEdGraph::LinkAssetNodes()
 {
-	check(InRoot);
+	for (auto& Entry : NodeMap)
+	{
+		check(Entry.Value);
+		Entry.Value->LinkAssetNode();
+	}
+}
 
-	if (VisitedNodes.Contains(InRoot))
+void UDialogueEdGraph::CompileAllNodes(UDialogue* InAsset)
+{
+	//Prepare the dialogue to be compiled
+	InAsset->PreCompileDialogue();
+
+	//Clear asset nodes
+	ClearAssetNodes();
+
+	//Compile asset tree
+	CreateAssetNodes(InAsset);
+	InAsset->SetRootNode(Root->GetAssetNode());
+	LinkAssetNodes();
+	FinalizeAssetNodes();
+}
+
+void UDialogueEdGraph::CompileDirtyNodes()
+{
+	//Moved nodes may change the left to right order of their parents' links
+	TArray<UGraphNodeDialogue*> Parents;
+	for (auto& Entry : NodeMap)
 	{
-		return;
+		UGraphNodeDialogue* Node = Entry.Value;
+		const FVector2D GraphLocation(Node->NodePosX, Node->NodePosY);
+
+		if (Node->GetAssetNode()->GetGraphLocation() != GraphLocation)
+		{
+			Node->AssignAssetNodeCommonData();
+			Node->GetParents(Parents);
+			for (UGraphNodeDialogue* Parent : Parents)
+			{
+				DirtyLinkIDs.Add(Parent->GetID());
+			}
+		}
 	}
-	else
+
+	//Refresh the data of changed nodes in place
+	for (FName NodeID : DirtyNodeIDs)
+	{
+		UGraphNodeDialogue* Node = GetNode(NodeID);
+		Node->AssignAssetNodeCommonData();
+		Node->AssignAssetNodeData();
+	}
+
+	//Relink the outgoing connections of nodes whose connections changed
+	for (FName NodeID : DirtyLinkIDs)
+	{
+		UGraphNodeDialogue* Node = GetNode(NodeID);
+		Node->UnlinkAssetNode();
+		Node->LinkAssetNode();
+	}
+
+	//Finalizing reads both data and connections, so it covers both sets
+	for (FName NodeID : DirtyNodeIDs.Union(DirtyLinkIDs))
 	{
-		VisitedNodes.Add(InRoot);
+		GetNode(NodeID)->FinalizeAssetNode();
 	}
+}
 
-	//Link the asset root to its parents
-	InRoot->LinkAssetNode();
+bool UDialogueEdGraph::CanCompileIncrementally() const
+{
+	const UDialogue* Asset = GetDialogue();
+	if (bNeedsFullCompile || !Asset->GetRootNode() 
+		|| Root->GetAssetNode() != Asset->GetRootNode())
+	{
+		return false;
+	}
 
-	//Retrieve children and order left to right
-	TArray<UGraphNodeDialogue*> OutChildren;
-	InRoot->GetChildren(OutChildren);
-	UGraphNodeDialogue::SortNodesLeftToRight(OutChildren);
+	//Every node must still own the asset node it was last compiled into
+	for (const auto& Entry : NodeMap)
+	{
+		const UDialogueNode* AssetNode = Entry.Value 
+			? Entry.Value->GetAssetNode() : nullptr;
 
-	//Recur over children
-	for (UGraphNodeDialogue* Child : OutChildren)
+		if (!AssetNode || AssetNode->GetNodeID() != Entry.Key)
+		{
+			return false;
+		}
+	}
+
+	//Dirty nodes must all still be in the graph
+	for (FName NodeID : DirtyNodeIDs.Union(DirtyLinkIDs))
 	{
-		UpdateAssetTreeRecursive(Child, VisitedNodes);
+		if (!NodeMap.Contains(NodeID))
+		{
+			return false;
+		}
 	}
+
+	return true;
 }
 
 void UDialogueEdGraph::OnDialogueGraphChanged(
 	const FEdGraphEditAction& EditAction)
 {
+	//Added or removed nodes change the structure of the asset
+	if (EditAction.Action & (GRAPHACTION_AddNode | GRAPHACTION_RemoveNode))
+	{
+		MarkNeedsFullCompile();
+	}
+
 	//If removing a node, pull that node from the node map
 	if (EditAction.Action == GRAPHACTION_RemoveNode)
 	{ 
@@ -418,6 +519,8 @@ void UDialogueEdGraph::OnDialogueGraphChanged(
 
 void UDialogueEdGraph::OnSpeakerRolesChanged()
 {
+	MarkNeedsFullCompile();
+
 	CanCompileAsset(); //Check for error banners
 	UpdateAllNodeVisuals();
 }
@@ -5,6 +5,7 @@
 //UE
 #include "Framework/Commands/GenericCommands.h"
 #include "GraphEditorActions.h"
+#include "Kismet2/KismetEditorUtilities.h"
 #include "Settings/EditorStyleSettings.h"
 #include "Toolkits/IToolkit.h"
 #include "Toolkits/ToolkitManager.h"
@@ -30,6 +31,10 @@
 //Default value for cache refresh ID
 int32 UDialogueEdGraphSchema::CurrentCacheRefreshID = 0;
 
+//Transition types are gathered on first use
+TArray<TWeakObjectPtr<UClass>> UDialogueEdGraphSchema::TransitionTypes;
+bool UDialogueEdGraphSchema::bTransitionTypesDirty = true;
+
 /** 
 * NewDialogueNodeAction 
 */
@@ -113,6 +118,68 @@ void FNewDialogueNodeAction::SetNodeLocation(const FVector2D InLocation)
 	TemplateNode->SnapToGrid(GetDefault<UEditorStyleSettings>()->GridSnapSize);
 }
 
+/**
+* NewDialogueSpeechNodeAction
+*/
+
+FNewDialogueSpeechNodeAction::FNewDialogueSpeechNodeAction()
+	: FNewDialogueNodeAction()
+	, Speaker(nullptr)
+	, TransitionType(nullptr)
+{}
+
+FNewDialogueSpeechNodeAction::FNewDialogueSpeechNodeAction(
+	FText InNodeCategory, FText InMenuDesc, FText InToolTip,
+	UDialogueSpeakerSocket* InSpeaker,
+	TSubclassOf<UDialogueTransition> InTransitionType)
+	: FNewDialogueNodeAction()
+	, Speaker(InSpeaker)
+	, TransitionType(InTransitionType.Get())
+{
+	check(Speaker && TransitionType);
+	UpdateSearchData(
+		MoveTemp(InMenuDesc),
+		MoveTemp(InToolTip),
+		MoveTemp(InNodeCategory),
+		FText::GetEmpty()
+	);
+}
+
+UEdGraphNode* FNewDialogueSpeechNodeAction::PerformAction(
+	UEdGraph* ParentGraph, UEdGraphPin* FromPin, const FVector2D Location,
+	bool bSelectNewNode)
+{
+	//Speaker or transition type may have been removed since the menu opened
+	if (!ParentGraph || !Speaker || !TransitionType)
+	{
+		return nullptr;
+	}
+
+	//Build the template now that the node is actually wanted
+	SetTemplateNode(
+		UGraphNodeDialogueSpeech::MakeTemplate(
+			ParentGraph,
+			Speaker,
+			TransitionType.Get()
+		)
+	);
+
+	return FNewDialogueNodeAction::PerformAction(
+		ParentGraph,
+		FromPin,
+		Location,
+		bSelectNewNode
+	);
+}
+
+void FNewDialogueSpeechNodeAction::AddReferencedObjects(
+	FReferenceCollector& Collector)
+{
+	FNewDialogueNodeAction::AddReferencedObjects(Collector);
+	Collector.AddReferencedObject(Speaker);
+	Collector.AddReferencedObject(TransitionType);
+}
+
 /** Schema */
 
 FConnectionDrawingPolicy* UDialogueEdGraphSchema::CreateConnectionDrawingPolicy(
@@ -249,6 +316,46 @@ int32 UDialogueEdGraphSchema::GetCurrentVisualizationCacheID() const
 	return CurrentCacheRefreshID;
 }
 
+const TArray<TWeakObjectPtr<UClass>>& 
+	UDialogueEdGraphSchema::GetTransitionTypes()
+{
+	if (bTransitionTypesDirty)
+	{
+		TArray<UClass*> DerivedClasses;
+		GetDerivedClasses(
+			UDialogueTransition::StaticClass(),
+			DerivedClasses
+		);
+
+		//Skip abstract types and leftovers from Blueprint compiles
+		TransitionTypes.Reset();
+		for (UClass* DerivedClass : DerivedClasses)
+		{
+			if (DerivedClass->HasAnyClassFlags(
+					CLASS_Abstract 
+					| CLASS_Deprecated 
+					| CLASS_NewerVersionExists
+				)
+				|| FKismetEditorUtilities::IsClassABlueprintSkeleton(
+					DerivedClass))
+			{
+				continue;
+			}
+
+			TransitionTypes.Add(DerivedClass);
+		}
+
+		bTransitionTypesDirty = false;
+	}
+
+	return TransitionTypes;
+}
+
+void UDialogueEdGraphSchema::InvalidateTransitionTypes()
+{
+	bTransitionTypesDirty = true;
+}
+
 void UDialogueEdGraphSchema::ForceVisualizationCacheClear() const
 {
 	++CurrentCacheRefreshID;
@@ -442,20 +549,12 @@ void UDialogueEdGraphSchema::GetSpeechNodeMenuActions(
 		}
 
 		//Add one create node action for each transition type 
-		for (TObjectIterator<UClass> TypeIterator; TypeIterator; ++TypeIterator)
+		for (const TWeakObjectPtr<UClass>& Type : GetTransitionTypes())
 		{
-			if (TypeIterator->IsChildOf(UDialogueTransition::StaticClass())
-				&& !TypeIterator->HasAnyClassFlags(CLASS_Abstract))
+			if (UClass* CurrentType = Type.Get())
 			{
-				TSubclassOf<UDialogueTransition> CurrentType =
-					*TypeIterator;
-
 				TSharedPtr<FNewDialogueNodeAction> NewNodeAction =
-					MakeCreateSpeechNodeAction(
-						Speaker,
-						CurrentType,
-						ContextMenuBuilder.OwnerOfTemporaries
-					);
+					MakeCreateSpeechNodeAction(Speaker, CurrentType);
 				
 				//Create action and add to menu 
 				ContextMenuBuilder.AddAction(NewNodeAction);
@@ -466,9 +565,9 @@ void UDialogueEdGraphSchema::GetSpeechNodeMenuActions(
 
 TSharedPtr<FNewDialogueNodeAction> UDialogueEdGraphSchema::
 	MakeCreateSpeechNodeAction(UDialogueSpeakerSocket* Speaker, 
-		TSubclassOf<UDialogueTransition> TransitionType, UObject* Outer) const
+		TSubclassOf<UDialogueTransition> TransitionType) const
 {
-	check(Speaker && TransitionType && Outer);
+	check(Speaker && TransitionType);
 
 	//Get context menu text
 	UDialogueTransition* DefaultTransitionObj =
@@ -484,18 +583,14 @@ TSharedPtr<FNewDialogueNodeAction> UDialogueEdGraphSchema::
 	FText MenuTooltip =
 		DefaultTransitionObj->GetNodeCreationTooltip();
 
-	//Get template node
-	UGraphNodeDialogueSpeech* TemplateObject =
-		UGraphNodeDialogueSpeech::MakeTemplate(Outer, Speaker, TransitionType);
-	check(TemplateObject);
-
-	//Assemble action 
+	//Assemble action. The template node is made when it is performed.
 	TSharedPtr<FNewDialogueNodeAction> NewAction(
-		new FNewDialogueNodeAction(
+		new FNewDialogueSpeechNodeAction(
 			MenuCategory,
 			MenuText,
 			MenuTooltip,
-			TemplateObject
+			Speaker,
+			TransitionType
 		)
 	);
 
@@ -19,6 +19,12 @@ void UGraphNodeDialogue::PostEditUndo()
 	Super::PostEditUndo();
 	UpdateDialogueNode();
 	MarkDialogueDirty();
+
+	//Undo can touch anything, so the whole dialogue is recompiled
+	if (UDialogueEdGraph* DialogueGraph = GetDialogueGraph())
+	{
+		DialogueGraph->MarkNeedsFullCompile();
+	}
 }
 
 void UGraphNodeDialogue::PostEditChangeProperty(
@@ -27,6 +33,11 @@ void UGraphNodeDialogue::PostEditChangeProperty(
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 	UpdateDialogueNode();
 	MarkDialogueDirty();
+
+	if (UDialogueEdGraph* DialogueGraph = GetDialogueGraph())
+	{
+		DialogueGraph->MarkNodeDirty(this);
+	}
 }
 
 FLinearColor UGraphNodeDialogue::GetNodeTitleColor() const
@@ -50,6 +61,11 @@ void UGraphNodeDialogue::PinConnectionListChanged(UEdGraphPin* Pin)
 	Super::PinConnectionListChanged(Pin);
 	UpdateDialogueNode();
 	MarkDialogueDirty();
+
+	if (UDialogueEdGraph* DialogueGraph = GetDialogueGraph())
+	{
+		DialogueGraph->MarkNodeLinksDirty(this);
+	}
 }
 
 void UGraphNodeDialogue::ResizeNode(const FVector2D& NewSize)
@@ -126,22 +142,35 @@ void UGraphNodeDialogue::LinkAssetNode()
 {
 	check(AssetNode);
 	
-	//Retrieve parent nodes
-	TArray<UGraphNodeDialogue*> Parents; 
-	GetParents(Parents);
+	//Retrieve children and order left to right
+	TArray<UGraphNodeDialogue*> Children; 
+	GetChildren(Children);
+	SortNodesLeftToRight(Children);
 
-	//Link the asset node to its parents
-	for (UGraphNodeDialogue* Parent : Parents)
+	//Link the asset node to its children
+	for (UGraphNodeDialogue* Child : Children)
 	{
-		//Verify that the parent's asset node has been spawned
-		if (Parent->GetAssetNode())
+		//Verify that the child's asset node has been spawned
+		if (Child->GetAssetNode())
 		{
-			LinkToParent(Parent);
-			Parent->LinkToChild(this);
+			LinkToChild(Child);
+			Child->LinkToParent(this);
 		}
 	}
 }
 
+void UGraphNodeDialogue::UnlinkAssetNode()
+{
+	check(AssetNode);
+
+	for (UDialogueNode* Child : AssetNode->GetChildren())
+	{
+		Child->RemoveParent(AssetNode);
+	}
+
+	AssetNode->ClearChildren();
+}
+
 void UGraphNodeDialogue::LinkToParent(UGraphNodeDialogue* InParent)
 {
 	UDialogueNode* ParentAssetNode = InParent->GetAssetNode();
@@ -201,6 +230,37 @@ void UGraphNodeDialogue::GetPinChildren(UEdGraphPin* InPin,
 	GetChildren(LinkedNodes, OutNodes);
 }
 
+FText UGraphNodeDialogue::GetProfiledConditionOrderText() const
+{
+	UDialogueNode* Node = GetAssetNode();
+	UDialogue* Dialogue = Node ? Node->GetDialogue() : nullptr;
+	if (!Dialogue)
+	{
+		return FText::GetEmpty();
+	}
+
+	//Play in editor shares the asset, so its profile is visible here
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	TArray<int32> Order;
+	Program.GetConditionOrder(Program.IndexOf(Node), Order);
+	if (Order.IsEmpty())
+	{
+		return FText::GetEmpty();
+	}
+
+	const FString OrderString = FString::JoinBy(Order, TEXT(", "),
+		[](int32 Position)
+		{
+			return FString::FromInt(Position + 1);
+		}
+	);
+
+	return FText::Format(
+		LOCTEXT("ProfiledConditionOrder", "Profiled condition order: {0}"),
+		FText::FromString(OrderString)
+	);
+}
+
 void UGraphNodeDialogue::MarkDialogueDirty()
 {
 	UDialogueEdGraph* DialogueGraph = GetDialogueGraph();
@@ -228,6 +288,12 @@ void UGraphNodeDialogue::LoadNodeData(UDialogueNode* InNode)
 	NodePosY = GraphLocation.Y;
 	ID = InNode->GetNodeID();
 	AssetNode = InNode;
+
+	//Keep the stable ID of graphs rebuilt from asset data
+	if (InNode->GetNodeGuid().IsValid())
+	{
+		NodeGuid = InNode->GetNodeGuid();
+	}
 }
 
 void UGraphNodeDialogue::RegenerateNodeConnections(
@@ -245,8 +311,7 @@ void UGraphNodeDialogue::RegenerateNodeConnections(
 		TEXT("Base impl. of 'RegenerateNodeConnections' should not be used with multiple output pins.")
 	);
 
-	TArray<UDialogueNode*> ChildNodes = AssetNode->GetChildren();
-	for (UDialogueNode* Node : ChildNodes)
+	for (UDialogueNode* Node : AssetNode->GetChildren())
 	{
 		UGraphNodeDialogue* OtherGraphNode = 
 			DialogueGraph->GetNode(Node->GetNodeID());
@@ -280,6 +345,9 @@ void UGraphNodeDialogue::AssignAssetNodeCommonData() const
 {
 	check(AssetNode);
 	AssetNode->SetGraphLocation(FVector2D(NodePosX, NodePosY));
+
+	//Save data is keyed by the GUID, so renaming the node keeps it
+	AssetNode->SetNodeGuid(NodeGuid);
 }
 
 void UGraphNodeDialogue::InitNodeInDialogueGraph(UEdGraph* OwningGraph)
@@ -309,6 +377,11 @@ void UGraphNodeDialogue::InitNodeInDialogueGraph(UEdGraph* OwningGraph)
 	//Set the ID
 	ID = FName(IDText.ToString());
 	DialogueGraph->AddToNodeMap(this);
+
+	if (!NodeGuid.IsValid())
+	{
+		CreateNewGuid();
+	}
 }
 
 void UGraphNodeDialogue::ResetID()
@@ -22,10 +22,23 @@ UGraphNodeDialogueBranch* UGraphNodeDialogueBranch::MakeTemplate(UObject* Outer)
 
 FText UGraphNodeDialogueBranch::GetTooltipText() const
 {
-    return LOCTEXT(
+    const FText BaseTooltip = LOCTEXT(
         "NodeTooltip", 
         "If/Else; Branches based on a sequence of conditions"
     );
+
+    //Surface the order adaptive condition ordering settled on, if any
+    const FText OrderText = GetProfiledConditionOrderText();
+    if (OrderText.IsEmpty())
+    {
+        return BaseTooltip;
+    }
+
+    return FText::Format(
+        LOCTEXT("TooltipWithOrder", "{0}\n{1}"),
+        BaseTooltip,
+        OrderText
+    );
 }
 
 FName UGraphNodeDialogueBranch::GetBaseID() const
@@ -27,10 +27,23 @@ void UGraphNodeDialogueOptionLock::AllocateDefaultPins()
 
 FText UGraphNodeDialogueOptionLock::GetTooltipText() const
 {
-    return LOCTEXT(
+    const FText BaseTooltip = LOCTEXT(
         "NodeTooltip",
         "Allows the user to mark a dialogue child option as 'locked' unless a condition is passed."
     );
+
+    //Surface the order adaptive condition ordering settled on, if any
+    const FText OrderText = GetProfiledConditionOrderText();
+    if (OrderText.IsEmpty())
+    {
+        return BaseTooltip;
+    }
+
+    return FText::Format(
+        LOCTEXT("TooltipWithOrder", "{0}\n{1}"),
+        BaseTooltip,
+        OrderText
+    );
 }
 
 FName UGraphNodeDialogueOptionLock::GetBaseID() const
@@ -108,14 +108,20 @@ EDialogueConnectionLimit UGraphNodeDialogueSpeech::GetOutputConnectionLimit()
 
 void UGraphNodeDialogueSpeech::CreateAssetNode(UDialogue* InAsset)
 {
-    check(Speaker.Speaker);
-    check(TransitionType);
-
     //Create node
     UDialogueSpeechNode* NewNode = 
         NewObject<UDialogueSpeechNode>(InAsset);
     SetAssetNode(NewNode);
-    
+}
+
+void UGraphNodeDialogueSpeech::AssignAssetNodeData()
+{
+    check(Speaker.Speaker);
+    check(TransitionType);
+
+    UDialogueSpeechNode* TargetNode =
+        CastChecked<UDialogueSpeechNode>(GetAssetNode());
+
     //Init data 
     FSpeechDetails SpeechDetails;
     SpeechDetails.SpeechTitle = SpeechTitle;
@@ -127,7 +133,7 @@ void UGraphNodeDialogueSpeech::CreateAssetNode(UDialogue* InAsset)
     SpeechDetails.bCanSkip = bCanSkip;
     SpeechDetails.GameplayTags = GameplayTags;
 
-    NewNode->InitSpeechData(SpeechDetails, TransitionType);
+    TargetNode->InitSpeechData(SpeechDetails, TransitionType);
 }
 
 bool UGraphNodeDialogueSpeech::CanCompileNode()
@@ -0,0 +1,113 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//UE
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+//Plugin
+#include "Benchmark/DialogueBenchmarkActors.h"
+#include "Benchmark/DialogueBenchmarkGraphs.h"
+#include "Benchmark/DialogueBenchmarkWorld.h"
+#include "Dialogue.h"
+#include "DialogueOption.h"
+#include "DialogueProgram.h"
+#include "Graph/DialogueEdGraph.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Sizes each shape is generated at */
+	constexpr int32 ShapeSizes[] = { 1, 8, 64 };
+
+	/** Every shape the benchmark can generate */
+	constexpr EDialogueBenchmarkShape Shapes[] = {
+		EDialogueBenchmarkShape::Hub,
+		EDialogueBenchmarkShape::Chain,
+		EDialogueBenchmarkShape::BranchLadder,
+		EDialogueBenchmarkShape::VisitedQueries
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FDialogueGraphShapesTest,
+	"DialogueTree.Graph.Shapes",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter
+)
+
+bool FDialogueGraphShapesTest::RunTest(const FString& Parameters)
+{
+	FDialogueBenchmarkWorld World;
+	if (!TestTrue(TEXT("Created the test world"), World.Create()))
+	{
+		return false;
+	}
+	ADialogueBenchmarkController* Controller = World.GetController();
+
+	for (EDialogueBenchmarkShape Shape : Shapes)
+	{
+		for (int32 Size : ShapeSizes)
+		{
+			const FString Case = FString::Printf(
+				TEXT("%s %d"),
+				FDialogueBenchmarkGraphs::GetShapeName(Shape),
+				Size
+			);
+
+			FDialogueBenchmarkGraph Graph =
+				FDialogueBenchmarkGraphs::Generate(Shape, Size);
+			UDialogue* Dialogue = Graph.Dialogue;
+			Dialogue->AddToRoot();
+			ON_SCOPE_EXIT
+			{
+				Dialogue->RemoveFromRoot();
+			};
+
+			//Compile from a graph rebuilt off the asset, as the editor does
+			UDialogueEdGraph* DialogueGraph =
+				FDialogueBenchmarkGraphs::BuildEdGraph(Dialogue);
+			Dialogue->SetEdGraph(DialogueGraph);
+			DialogueGraph->MarkNeedsFullCompile();
+			DialogueGraph->CompileAsset();
+
+			if (!TestTrue(*(Case + TEXT(" compiles")),
+				Dialogue->GetCompileStatus() == EDialogueCompileStatus::Compiled))
+			{
+				continue;
+			}
+
+			const FDialogueProgram& Program = Dialogue->GetProgram();
+			TestEqual(*(Case + TEXT(" keeps every node")),
+				Dialogue->GetNumNodes(), Graph.NumNodes);
+			TestEqual(*(Case + TEXT(" compiles every node")),
+				Program.GetNumNodes(), Graph.NumNodes);
+
+			//An unguarded hub offers every option
+			if (Shape == EDialogueBenchmarkShape::Hub)
+			{
+				TArray<FResolvedDialogueOption> Options;
+				Program.GatherOptions(
+					Program.FindNode(Graph.OptionNodeID),
+					Options
+				);
+				TestEqual(*(Case + TEXT(" gathers every option")),
+					Options.Num(), Size);
+			}
+
+			//Nothing waits on time or audio, so taking the first option
+			//each time plays straight through to the end
+			const int32 Handle = Controller->StartAmbientDialogue(
+				Dialogue,
+				{ World.GetSpeaker() },
+				false
+			);
+			TestEqual(*(Case + TEXT(" plays through")), Handle, INDEX_NONE);
+			TestTrue(*(Case + TEXT(" reaches the end")),
+				Controller->WasNodeVisitedByID(Dialogue, Graph.EndNodeID));
+		}
+	}
+
+	World.Destroy();
+	return true;
+}
+
+#endif
@@ -0,0 +1,127 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//UE
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+//Plugin
+#include "Benchmark/DialogueBenchmarkActors.h"
+#include "Benchmark/DialogueBenchmarkGraphs.h"
+#include "Benchmark/DialogueBenchmarkWorld.h"
+#include "Dialogue.h"
+#include "Graph/DialogueEdGraph.h"
+#include "Nodes/DialogueSpeechNode.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Save slot the test writes to and deletes afterwards */
+	const TCHAR* RecordsTestSlot = TEXT("DialogueTreeRecordsTest");
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FDialogueRecordsSaveTest,
+	"DialogueTree.Records.SaveAndLoad",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter
+)
+
+bool FDialogueRecordsSaveTest::RunTest(const FString& Parameters)
+{
+	ISaveGameSystem* SaveSystem =
+		IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!TestNotNull(TEXT("Found the save game system"), SaveSystem))
+	{
+		return false;
+	}
+
+	FDialogueBenchmarkWorld World;
+	if (!TestTrue(TEXT("Created the test world"), World.Create()))
+	{
+		return false;
+	}
+	ADialogueBenchmarkController* Controller = World.GetController();
+
+	FDialogueBenchmarkGraph Graph =
+		FDialogueBenchmarkGraphs::Generate(EDialogueBenchmarkShape::Hub, 4);
+	UDialogue* Dialogue = Graph.Dialogue;
+	Dialogue->AddToRoot();
+	ON_SCOPE_EXIT
+	{
+		Dialogue->RemoveFromRoot();
+		SaveSystem->DeleteGame(false, RecordsTestSlot, 0);
+		World.Destroy();
+	};
+
+	//Hold the hub on screen so the dialogue is still running while saving.
+	//Nothing ticks the world, so its play time never runs out.
+	for (UDialogueNode* Node : Dialogue->GetAllNodes())
+	{
+		UDialogueSpeechNode* Hub = Cast<UDialogueSpeechNode>(Node);
+		if (Hub && Hub->GetNodeID() == Graph.OptionNodeID)
+		{
+			FSpeechDetails Details = Hub->GetDetails();
+			Details.MinimumPlayTime = 60.f;
+			Hub->InitSpeechData(Details, Hub->GetTransitionType());
+		}
+	}
+
+	UDialogueEdGraph* DialogueGraph =
+		FDialogueBenchmarkGraphs::BuildEdGraph(Dialogue);
+	Dialogue->SetEdGraph(DialogueGraph);
+	DialogueGraph->MarkNeedsFullCompile();
+	DialogueGraph->CompileAsset();
+	if (!TestTrue(TEXT("Dialogue compiles"),
+		Dialogue->GetCompileStatus() == EDialogueCompileStatus::Compiled))
+	{
+		return false;
+	}
+
+	//Record visits by playing up to the hub, then write the blackboard
+	Controller->ClearDialogueRecords();
+	const int32 Handle = Controller->StartAmbientDialogue(
+		Dialogue,
+		{ World.GetSpeaker() },
+		false
+	);
+	if (!TestNotEqual(TEXT("Dialogue rests on the hub"), Handle, INDEX_NONE))
+	{
+		return false;
+	}
+	TestTrue(TEXT("Hub is recorded visited"),
+		Controller->WasNodeVisitedByID(Dialogue, Graph.OptionNodeID));
+
+	Controller->SetBlackboardBool(TEXT("Test.Bool"), true);
+	Controller->SetBlackboardInt(TEXT("Test.Int"), 42);
+	Controller->SetBlackboardFloat(TEXT("Test.Float"), 0.5f);
+	Controller->SetBlackboardName(TEXT("Test.Name"), TEXT("Answer"));
+
+	//Changes made once the save is handed off must not reach it
+	const FDialogueRecords Expected = Controller->GetDialogueRecords();
+	Controller->SaveDialogueRecordsAsync(RecordsTestSlot, 0);
+	Controller->SetBlackboardInt(TEXT("Test.Int"), 7);
+	Controller->EndAmbientDialogue(Handle);
+	Controller->WaitForDialogueSaves();
+
+	//Load into empty records and compare
+	Controller->ClearDialogueRecords();
+	if (!TestTrue(TEXT("Records load from the slot"),
+		Controller->LoadDialogueRecordsFromSlot(RecordsTestSlot, 0)))
+	{
+		return false;
+	}
+
+	const FDialogueRecords Loaded = Controller->GetDialogueRecords();
+	TestTrue(TEXT("Loaded records match the saved records"),
+		FDialogueRecords::StaticStruct()->CompareScriptStruct(
+			&Loaded,
+			&Expected,
+			PPF_None
+		)
+	);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,101 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//UE
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+//Plugin
+#include "Benchmark/DialogueBenchmarkGraphs.h"
+#include "Benchmark/DialogueBenchmarkWorld.h"
+#include "Dialogue.h"
+#include "DialogueAllocationCounter.h"
+#include "Graph/DialogueEdGraph.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Size each shape is generated at */
+	constexpr int32 SteadyStateSize = 16;
+
+	/** Playthroughs counted after the warm-up */
+	constexpr int32 SteadyStatePlaythroughs = 8;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FDialogueSteadyStateTest,
+	"DialogueTree.Instance.SteadyState",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter
+)
+
+bool FDialogueSteadyStateTest::RunTest(const FString& Parameters)
+{
+	//Loaded with the plugin, so a missing counter must not pass silently
+	if (!FDialogueAllocationCounter::IsInstalled())
+	{
+		AddError(TEXT("The allocation counter is not installed."));
+		return false;
+	}
+
+	FDialogueBenchmarkWorld World;
+	if (!TestTrue(TEXT("Created the test world"), World.Create()))
+	{
+		return false;
+	}
+
+	const EDialogueBenchmarkShape Shapes[] = {
+		EDialogueBenchmarkShape::Hub,
+		EDialogueBenchmarkShape::Chain,
+		EDialogueBenchmarkShape::BranchLadder,
+		EDialogueBenchmarkShape::VisitedQueries
+	};
+
+	for (EDialogueBenchmarkShape Shape : Shapes)
+	{
+		const FString ShapeName = FDialogueBenchmarkGraphs::GetShapeName(Shape);
+
+		FDialogueBenchmarkGraph Graph =
+			FDialogueBenchmarkGraphs::Generate(Shape, SteadyStateSize);
+		UDialogue* Dialogue = Graph.Dialogue;
+		Dialogue->AddToRoot();
+		ON_SCOPE_EXIT
+		{
+			Dialogue->RemoveFromRoot();
+		};
+
+		UDialogueEdGraph* DialogueGraph =
+			FDialogueBenchmarkGraphs::BuildEdGraph(Dialogue);
+		Dialogue->SetEdGraph(DialogueGraph);
+		DialogueGraph->MarkNeedsFullCompile();
+		DialogueGraph->CompileAsset();
+
+		if (!TestTrue(*(ShapeName + TEXT(" compiles")),
+			Dialogue->GetCompileStatus() == EDialogueCompileStatus::Compiled))
+		{
+			continue;
+		}
+
+		//Speeches, branches and queries of a warm instance must not touch
+		//the heap. Only the DisplayOptions thunk's copy is allowed for.
+		const FDialogueSteadyStateAllocations Allocations =
+			World.CountSteadyStateAllocations(
+				Dialogue,
+				SteadyStatePlaythroughs
+			);
+		TestEqual(*(ShapeName + TEXT(" allocates only for its option screens")),
+			Allocations.NumAllocations, Allocations.GetBudget());
+
+		//The hub shapes must have gone through their option screen
+		if (Shape == EDialogueBenchmarkShape::Hub
+			|| Shape == EDialogueBenchmarkShape::VisitedQueries)
+		{
+			TestEqual(*(ShapeName + TEXT(" shows its options")),
+				Allocations.NumOptionScreens, 
+				int64(SteadyStatePlaythroughs));
+		}
+	}
+
+	World.Destroy();
+	return true;
+}
+
+#endif
@@ -0,0 +1,32 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "DialogueController.h"
+#include "DialogueSpeakerComponent.h"
+//Generated
+#include "DialogueBenchmarkActors.generated.h"
+
+/**
+* Bare dialogue controller used to play benchmark dialogues headless. It
+* has no display; benchmark dialogues play as ambient dialogues.
+*/
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class DIALOGUETREEEDITOR_API ADialogueBenchmarkController
+	: public ADialogueController
+{
+	GENERATED_BODY()
+};
+
+/**
+* Bare speaker component used to voice benchmark dialogues headless.
+*/
+UCLASS(NotBlueprintable, Transient)
+class DIALOGUETREEEDITOR_API UDialogueBenchmarkSpeaker
+	: public UDialogueSpeakerComponent
+{
+	GENERATED_BODY()
+};
@@ -0,0 +1,59 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+//Plugin
+#include "Benchmark/DialogueBenchmarkGraphs.h"
+//Generated
+#include "DialogueBenchmarkCommandlet.generated.h"
+
+class FDialogueBenchmarkWorld;
+class FJsonObject;
+
+/**
+* Headless benchmark for the dialogue pipeline. Generates synthetic
+* dialogues of each requested shape and size, then measures compiling,
+* rebuilding the editor graph, traversal, option gathering and memory, and
+* writes the results as JSON so runs can be compared across versions.
+* Fails if a warm dialogue allocates more while playing through than its
+* option screens are allowed to.
+*
+* Usage: UnrealEditor-Cmd <Project> -run=DialogueBenchmark -nullrhi
+* [-Shapes=Hub,Chain,BranchLadder,VisitedQueries] [-Sizes=8,64,512]
+* [-Iterations=10] [-Output=<Path>]
+*/
+UCLASS()
+class DIALOGUETREEEDITOR_API UDialogueBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	/** Constructor */
+	UDialogueBenchmarkCommandlet();
+
+	/** UCommandlet Impl. */
+	virtual int32 Main(const FString& Params) override;
+	/** End UCommandlet */
+
+private:
+	/**
+	* Runs every measurement on a dialogue of the given shape and size.
+	*
+	* @param InShape - EDialogueBenchmarkShape, the shape to generate.
+	* @param InSize - int32, the size to generate.
+	* @return TSharedPtr<FJsonObject> - the case's results. Nullptr if the
+	* dialogue failed to compile.
+	*/
+	TSharedPtr<FJsonObject> RunCase(EDialogueBenchmarkShape InShape,
+		int32 InSize);
+
+private:
+	/** Number of times each measurement is repeated */
+	int32 Iterations = 10;
+
+	/** The world benchmark dialogues play in. Owned by Main() */
+	FDialogueBenchmarkWorld* World = nullptr;
+};
@@ -0,0 +1,106 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+
+class UDialogue;
+class UDialogueEdGraph;
+
+/**
+* The shapes of synthetic dialogue the benchmark can generate.
+*/
+enum class EDialogueBenchmarkShape : uint8
+{
+	/** One speech offering every other speech as an option */
+	Hub,
+
+	/** Speeches following each other one after another */
+	Chain,
+
+	/** Branches nested one inside the other, each passing to the next */
+	BranchLadder,
+
+	/** A hub whose every option sits behind a node visited query */
+	VisitedQueries
+};
+
+/**
+* A generated dialogue, along with what the benchmark needs to know about
+* its layout.
+*/
+struct FDialogueBenchmarkGraph
+{
+	/** The generated dialogue. Not compiled yet */
+	UDialogue* Dialogue = nullptr;
+
+	/** The node whose options are gathered. None if the shape has none */
+	FName OptionNodeID;
+
+	/** A speech node to edit when measuring incremental compiles */
+	FName EditNodeID;
+
+	/** The speech a playthrough taking the first option ends on */
+	FName EndNodeID;
+
+	/** Number of nodes the dialogue holds */
+	int32 NumNodes = 0;
+
+	/** Number of nodes a playthrough taking the first option traverses */
+	int32 PathLength = 0;
+};
+
+/**
+* Generates synthetic dialogue assets of a given shape and size for
+* benchmarking. Asset nodes are laid out and linked the way a compiled
+* graph would leave them, so the editor graph can be rebuilt from them.
+*/
+class DIALOGUETREEEDITOR_API FDialogueBenchmarkGraphs
+{
+public:
+	/**
+	* Generates a dialogue of the given shape in the transient package.
+	*
+	* @param InShape - EDialogueBenchmarkShape, the shape to generate.
+	* @param InSize - int32, the number of repeated elements in the shape.
+	* @return FDialogueBenchmarkGraph - the generated dialogue.
+	*/
+	static FDialogueBenchmarkGraph Generate(EDialogueBenchmarkShape InShape,
+		int32 InSize);
+
+	/**
+	* Builds a new editor graph from a generated dialogue's asset nodes, as
+	* opening the dialogue editor does. The graph is not set on the 
+	* dialogue.
+	*
+	* @param InDialogue - UDialogue*, the generated dialogue.
+	* @return UDialogueEdGraph* - the built graph.
+	*/
+	static UDialogueEdGraph* BuildEdGraph(UDialogue* InDialogue);
+
+	/**
+	* Retrieves the speaker role every generated speech is given.
+	*
+	* @return FName - the role.
+	*/
+	static FName GetSpeakerRole();
+
+	/**
+	* Finds the shape with the given name.
+	*
+	* @param InName - const FString&, the shape's name.
+	* @param OutShape - EDialogueBenchmarkShape&, the found shape.
+	* @return bool - True if a shape was found. False otherwise.
+	*/
+	static bool ParseShape(const FString& InName,
+		EDialogueBenchmarkShape& OutShape);
+
+	/**
+	* Retrieves the name of the given shape.
+	*
+	* @param InShape - EDialogueBenchmarkShape, the shape.
+	* @return const TCHAR* - the shape's name.
+	*/
+	static const TCHAR* GetShapeName(EDialogueBenchmarkShape InShape);
+};
@@ -0,0 +1,114 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+class ADialogueBenchmarkController;
+class UDialogue;
+class UDialogueBenchmarkSpeaker;
+class UWorld;
+
+/**
+* Heap allocations the game thread made while a warm dialogue played.
+*/
+struct DIALOGUETREEEDITOR_API FDialogueSteadyStateAllocations
+{
+	/**
+	* Allocations an option screen may make. Playing a warm dialogue makes
+	* none of its own, but ADialogueController::DisplayOptions is a
+	* BlueprintImplementableEvent: its generated thunk copies the options
+	* array into the event's parameters, which allocates once per screen.
+	*/
+	static constexpr int64 AllocationsPerOptionScreen = 1;
+
+	/** Allocations counted. INDEX_NONE if they could not be counted */
+	int64 NumAllocations = INDEX_NONE;
+
+	/** Option screens displayed while counting */
+	int64 NumOptionScreens = 0;
+
+	/**
+	* Gets the allocations the counted playthroughs were allowed to make.
+	*
+	* @return int64 - the allocation budget.
+	*/
+	int64 GetBudget() const
+	{
+		return NumOptionScreens * AllocationsPerOptionScreen;
+	}
+};
+
+/**
+* A headless game world holding a dialogue controller and a single speaker
+* named after the role every generated speech is given. Lets generated
+* dialogues be played outside of a level, by the benchmark commandlet and
+* the automation tests alike.
+*/
+class DIALOGUETREEEDITOR_API FDialogueBenchmarkWorld : public FGCObject
+{
+public:
+	FDialogueBenchmarkWorld() = default;
+	virtual ~FDialogueBenchmarkWorld();
+
+	FDialogueBenchmarkWorld(const FDialogueBenchmarkWorld&) = delete;
+	FDialogueBenchmarkWorld& operator=(const FDialogueBenchmarkWorld&)
+		= delete;
+
+	/**
+	* Creates the world and spawns the controller and speaker in it.
+	*
+	* @return bool - True if the world was set up. False otherwise.
+	*/
+	bool Create();
+
+	/**
+	* Tears down the world, if created.
+	*/
+	void Destroy();
+
+	/**
+	* Retrieves the controller dialogues are played with.
+	*
+	* @return ADialogueBenchmarkController* - the controller.
+	*/
+	ADialogueBenchmarkController* GetController() const;
+
+	/**
+	* Retrieves the speaker voicing every generated speech.
+	*
+	* @return UDialogueBenchmarkSpeaker* - the speaker.
+	*/
+	UDialogueBenchmarkSpeaker* GetSpeaker() const;
+
+	/**
+	* Plays a warm instance of the dialogue through repeatedly with the
+	* display on, taking the first option at every option screen, and
+	* counts the heap allocations the game thread makes meanwhile. One
+	* playthrough is made first to size the buffers the instance reuses.
+	*
+	* @param InDialogue - UDialogue*, the compiled dialogue.
+	* @param InPlaythroughs - int32, the number of counted playthroughs.
+	* @return FDialogueSteadyStateAllocations - what was counted.
+	*/
+	FDialogueSteadyStateAllocations CountSteadyStateAllocations(
+		UDialogue* InDialogue, int32 InPlaythroughs) const;
+
+	/** FGCObject Impl. */
+	virtual void AddReferencedObjects(FReferenceCollector& Collector)
+		override;
+	virtual FString GetReferencerName() const override;
+	/** End FGCObject */
+
+private:
+	/** The world dialogues play in */
+	TObjectPtr<UWorld> World;
+
+	/** The controller playing dialogues */
+	TObjectPtr<ADialogueBenchmarkController> Controller;
+
+	/** The speaker voicing every speech */
+	TObjectPtr<UDialogueBenchmarkSpeaker> Speaker;
+};
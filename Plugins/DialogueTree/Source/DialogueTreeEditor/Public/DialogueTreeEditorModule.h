@@ -39,6 +39,12 @@ private:
 	*/
 	void RegisterDetailsCustomizers();
 
+	/**
+	* Binds the events that invalidate the graph schema's cached transition 
+	* types on startup. 
+	*/
+	void RegisterTransitionTypeInvalidation();
+
 	/**
 	* Unregisters the node factory on shutdown. 
 	*/
@@ -55,6 +61,19 @@ private:
 	*/
 	void UnregisterDetailsCustomizers();
 
+	/**
+	* Unbinds the transition type invalidation events on shutdown. 
+	*/
+	void UnregisterTransitionTypeInvalidation();
+
+	/**
+	* Invalidates the cached transition types if the loaded asset is a 
+	* transition Blueprint. 
+	* 
+	* @param InAsset - UObject*, the loaded asset. 
+	*/
+	void OnAssetLoaded(UObject* InAsset);
+
 private:
 	/** Asset category under which to situate the dialogue asset */
 	EAssetTypeCategories::Type DialogueAssetCategory;
@@ -64,4 +83,10 @@ private:
 
 	/** The factory for dialogue graph nodes */
 	TSharedPtr<FDialogueTreeNodeFactory> NodeFactory;
+
+	/** Handles of the transition type invalidation events */
+	FDelegateHandle ReloadCompleteHandle;
+	FDelegateHandle ModulesChangedHandle;
+	FDelegateHandle AssetLoadedHandle;
+	FDelegateHandle BlueprintCompiledHandle;
 };
@@ -116,9 +116,31 @@ public:
 	/**
 	* Attempts to compile the dialogue graph into its dialogue asset. Sets
 	* the asset's compile status to compiled if successful and failed otherwise.
+	* Only the nodes marked dirty since the last compile are recompiled when
+	* the graph's structure has not changed. 
 	*/
 	void CompileAsset();
 
+	/**
+	* Marks the given node's data as changed since the last compile. 
+	* 
+	* @param InNode - UGraphNodeDialogue*, the changed node. 
+	*/
+	void MarkNodeDirty(UGraphNodeDialogue* InNode);
+
+	/**
+	* Marks the given node's connections as changed since the last compile. 
+	* 
+	* @param InNode - UGraphNodeDialogue*, the changed node. 
+	*/
+	void MarkNodeLinksDirty(UGraphNodeDialogue* InNode);
+
+	/**
+	* Marks the graph as needing the whole asset recompiled on the next 
+	* compile, such as after nodes were added or removed. 
+	*/
+	void MarkNeedsFullCompile();
+
 	/**
 	* Used to determine successful compilation of the dialogue. Checks if the 
 	* dialogue graph is valid and can therefore be compiled. 
@@ -192,15 +214,33 @@ private:
 	void FinalizeAssetNodes();
 
 	/**
-	* Traverse the tree of graph nodes recursively, linking up their asset 
-	* nodes to construct an equivalent tree in the dialogue asset. 
+	* Links each asset node to its children to construct an equivalent tree 
+	* in the dialogue asset. Every node links only its own outgoing 
+	* connections, so each connection is linked exactly once. 
+	*/
+	void LinkAssetNodes();
+
+	/**
+	* Rebuilds every asset node in the dialogue from scratch. 
+	* 
+	* @param InAsset - UDialogue*, asset to populate. 
+	*/
+	void CompileAllNodes(UDialogue* InAsset);
+
+	/**
+	* Refreshes only the asset nodes of nodes marked dirty since the last
+	* compile, along with their connections. 
+	*/
+	void CompileDirtyNodes();
+
+	/**
+	* Checks if the changes since the last compile can be applied to the 
+	* existing asset nodes. 
 	* 
-	* @param InRoot - UGraphNodeDialogue*, the root of the current subtree.
-	* @param VisitedNodes - TSet<UGraphNodeDialogue*>, the nodes we have
-	* already visited. 
+	* @return bool - True if only dirty nodes need recompiling. False if the
+	* whole asset has to be rebuilt. 
 	*/
-	void UpdateAssetTreeRecursive(UGraphNodeDialogue* InRoot, 
-		TSet<UGraphNodeDialogue*> VisitedNodes);
+	bool CanCompileIncrementally() const;
 
 	/**
 	* Behaviors to trigger when the graph changes. 
@@ -224,4 +264,13 @@ private:
 	/** The collection of dialogue nodes, keyed to their IDs for easy access */
 	UPROPERTY()
 	TMap<FName, TObjectPtr<UGraphNodeDialogue>> NodeMap;
+
+	/** IDs of nodes whose data changed since the last compile */
+	TSet<FName> DirtyNodeIDs;
+
+	/** IDs of nodes whose connections changed since the last compile */
+	TSet<FName> DirtyLinkIDs;
+
+	/** Whether the next compile has to rebuild the whole asset */
+	bool bNeedsFullCompile = true;
 };
@@ -97,6 +97,52 @@ private:
 	void SetNodeLocation(const FVector2D InLocation);
 };
 
+/**
+* Schema action for creating a new speech node. The template node is only
+* built once the action is performed, so filling the context menu with one
+* action per speaker and transition type creates no objects.
+*/
+USTRUCT()
+struct DIALOGUETREEEDITOR_API FNewDialogueSpeechNodeAction :
+	public FNewDialogueNodeAction
+{
+public:
+	GENERATED_USTRUCT_BODY()
+
+	/** Default Constructor */
+	FNewDialogueSpeechNodeAction();
+
+	/**
+	* Constructor
+	* @param InNodeCategory - FText, Node category.
+	* @param InMenuDesc - FText, Menu description.
+	* @param InToolTip - FText, Tooltip.
+	* @param InSpeaker - UDialogueSpeakerSocket*, the node's speaker.
+	* @param InTransitionType - TSubclassOf<UDialogueTransition>, the type of
+	* transition for the node.
+	*/
+	FNewDialogueSpeechNodeAction(FText InNodeCategory, FText InMenuDesc,
+		FText InToolTip, UDialogueSpeakerSocket* InSpeaker,
+		TSubclassOf<UDialogueTransition> InTransitionType);
+
+	/** FEdGraphSchemaAction Implementation */
+	virtual UEdGraphNode* PerformAction(class UEdGraph* ParentGraph,
+		UEdGraphPin* FromPin, const FVector2D Location,
+		bool bSelectNewNode = true) override;
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+	/** End FEdGraphSchemaAction */
+
+private:
+	/** Speaker for the spawned node */
+	UPROPERTY()
+	TObjectPtr<UDialogueSpeakerSocket> Speaker;
+
+	/** Transition type for the spawned node */
+	UPROPERTY()
+	TObjectPtr<UClass> TransitionType;
+};
+
 /**
  * Schema that controls common behaviors for the dialogue graph.
  */
@@ -138,6 +184,22 @@ public:
 	*/
 	static TSharedPtr<FDialogueEditor> GetGraphEditor(const UEdGraph* InGraph);
 
+	/**
+	* Retrieves the transition types offered when creating speech nodes,
+	* gathering them on first use. Entries may go stale if a Blueprint
+	* transition is deleted. Static.
+	*
+	* @return const TArray<TWeakObjectPtr<UClass>>& - the transition types.
+	*/
+	static const TArray<TWeakObjectPtr<UClass>>& GetTransitionTypes();
+
+	/**
+	* Discards the cached transition types, so they are gathered again the
+	* next time they are needed. Called on hot reload, on module changes and
+	* when a transition Blueprint is compiled or loaded. Static.
+	*/
+	static void InvalidateTransitionTypes();
+
 private:
 	/**
 	* Sets up the context menu entry associated with the given
@@ -212,13 +274,11 @@ private:
 	* @param Speaker - UDialogueSpeakerSocket*, the speaker for the node.
 	* @param TransitionType - TSubclassOf<UDialogueTransition>, the type of 
 	* transition for the node. 
-	* @param Outer - UObject*, the outer. 
 	* @return TSharedPtr<FNewDialogueNodeAction>, the node spawner action. 
 	*/
 	TSharedPtr<FNewDialogueNodeAction> MakeCreateSpeechNodeAction(
 		UDialogueSpeakerSocket* Speaker, 
-		TSubclassOf<UDialogueTransition> TransitionType, 
-		UObject* Outer) const;
+		TSubclassOf<UDialogueTransition> TransitionType) const;
 
 	/**
 	* Sets up context menu for conditional node creation.
@@ -349,4 +409,10 @@ private:
 private:
 	/** Id number used to check if graph visualization is dirty */
 	static int32 CurrentCacheRefreshID;
+
+	/** Transition types offered when creating speech nodes */
+	static TArray<TWeakObjectPtr<UClass>> TransitionTypes;
+
+	/** Whether the transition types need to be gathered again */
+	static bool bTransitionTypesDirty;
 };
@@ -145,6 +145,13 @@ public:
 	*/
 	void AssignAssetNodeCommonData() const;
 
+	/**
+	* Virtual. Copies the node's own data onto the asset node. Called after
+	* creating the asset node, and again when the node is recompiled after
+	* its data changed. 
+	*/
+	virtual void AssignAssetNodeData() {};
+
 	/**
 	* Virtual. Performs last touches on the asset node after all asset nodes
 	* have been created and linked together. 
@@ -152,12 +159,17 @@ public:
 	virtual void FinalizeAssetNode() {};
 
 	/**
-	* Links the asset node into the asset tree. 
-	* 
-	* @param InAsset - UDialogue*, the target dialogue asset. 
+	* Links the asset node to the asset nodes of its children, ordered left 
+	* to right. 
 	*/
 	void LinkAssetNode();
 
+	/**
+	* Removes the links from the asset node to its children, so they can be
+	* linked again. 
+	*/
+	void UnlinkAssetNode();
+
 	/**
 	* Clears the asset node. 
 	*/
@@ -189,6 +201,15 @@ public:
 	void GetPinChildren(UEdGraphPin* InPin, 
 		TArray<UGraphNodeDialogue*>& OutNodes) const;
 
+	/**
+	* Describes the order the compiled node evaluates its conditions in, as
+	* chosen by adaptive condition ordering while the dialogue played. 
+	* 
+	* @return FText - the order, by authored position. Empty if the node's
+	* conditions were never profiled. 
+	*/
+	FText GetProfiledConditionOrderText() const;
+
 	/**
 	* Marks the dialogue as needing to be compiled. 
 	*/
@@ -57,6 +57,7 @@ public:
 
 	/** UGraphNodeDialogue Implementation */
 	virtual void CreateAssetNode(class UDialogue* InAsset) override;
+	virtual void AssignAssetNodeData() override;
 	virtual bool CanCompileNode() override;
 	virtual void LoadNodeData(UDialogueNode* InNode) override;
 	/** End UGraphNodeDialogue */
@@ -130,7 +131,7 @@ private:
 
 	/** The sound to play as audio for the speech */
 	UPROPERTY(EditAnywhere, Category = "SpeechContent")
-	USoundBase* SpeechAudio;
+	TSoftObjectPtr<USoundBase> SpeechAudio;
 
 	/** The minimum time for the speech to play before transitioning (unless
 	* skipped) */
@@ -3,6 +3,7 @@
 //Header
 #include "Conditionals/DialogueCondition.h"
 //Plugin
+#include "DialogueProgram.h"
 #include "LogDialogueTree.h"
 
 void UDialogueCondition::SetQuery(UDialogueQuery* InQuery)
@@ -43,6 +44,12 @@ bool UDialogueCondition::IsMet() const
     return false;
 }
 
+void UDialogueCondition::CompileCondition(FDialogueProgram& InProgram,
+    FDialogueConditionInstruction& OutInstruction) const
+{
+    OutInstruction.Op = EDialogueConditionOp::CallCondition;
+}
+
 FText UDialogueCondition::GetDisplayText(const TMap<FName,
     FText>& ArgTexts, const FText QueryText) const
 {
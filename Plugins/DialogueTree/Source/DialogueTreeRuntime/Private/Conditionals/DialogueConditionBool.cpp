@@ -4,6 +4,8 @@
 #include "Conditionals/DialogueConditionBool.h"
 //Plugin
 #include "Conditionals/Queries/Base/DialogueQueryBool.h"
+#include "DialogueProgram.h"
+#include "DialogueTreeStats.h"
 //UE
 #include "UObject/UObjectGlobals.h"
 
@@ -20,6 +22,12 @@ void UDialogueConditionBool::PostDuplicate(EDuplicateMode::Type DuplicateMode)
 bool UDialogueConditionBool::IsMet() const
 {
 	check(Query);
+
+	DIALOGUE_TRACE_SCOPE(
+		"ExecuteQuery",
+		Query->GetDialogue(),
+		Query->GetClass()->GetFName()
+	);
 	bool bQueryValue = Query->ExecuteQuery();
 	
 	if (QueryTrue)
@@ -45,6 +53,20 @@ void UDialogueConditionBool::SetDialogue(UDialogue* InDialogue)
 	Query->SetDialogue(InDialogue);
 }
 
+void UDialogueConditionBool::CompileCondition(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	OutInstruction.Compare = EDialogueConditionCompare::IsTrue;
+	OutInstruction.bNegate = !QueryTrue;
+
+	//Native queries are evaluated inline, anything else is called
+	if (!Query || !Query->CompileQuery(InProgram, OutInstruction))
+	{
+		OutInstruction.Op = EDialogueConditionOp::CallQueryBool;
+		OutInstruction.Operand = InProgram.AddConditionQuery(Query);
+	}
+}
+
 FText UDialogueConditionBool::GetDisplayText(const TMap<FName, FText>& ArgTexts,
 	const FText QueryText) const
 {
@@ -4,6 +4,8 @@
 #include "Conditionals/DialogueConditionFloat.h"
 //Plugin
 #include "Conditionals/Queries/Base/DialogueQueryFloat.h"
+#include "DialogueProgram.h"
+#include "DialogueTreeStats.h"
 //UE
 #include "UObject/UObjectGlobals.h"
 
@@ -20,6 +22,12 @@ void UDialogueConditionFloat::PostDuplicate(EDuplicateMode::Type DuplicateMode)
 bool UDialogueConditionFloat::IsMet() const
 {
 	check(Query);
+
+	DIALOGUE_TRACE_SCOPE(
+		"ExecuteQuery",
+		Query->GetDialogue(),
+		Query->GetClass()->GetFName()
+	);
 	double QueryValue = Query->ExecuteQuery();
 
 	if (Comparison == EFloatComparison::GreaterThan)
@@ -45,6 +53,21 @@ void UDialogueConditionFloat::SetDialogue(UDialogue* InDialogue)
 	Query->SetDialogue(InDialogue);
 }
 
+void UDialogueConditionFloat::CompileCondition(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	OutInstruction.Compare = Comparison == EFloatComparison::GreaterThan
+		? EDialogueConditionCompare::GreaterThan
+		: EDialogueConditionCompare::LessThan;
+	OutInstruction.Value = CompareValue;
+
+	if (!Query || !Query->CompileQuery(InProgram, OutInstruction))
+	{
+		OutInstruction.Op = EDialogueConditionOp::CallQueryFloat;
+		OutInstruction.Operand = InProgram.AddConditionQuery(Query);
+	}
+}
+
 FText UDialogueConditionFloat::GetDisplayText(const TMap<FName,
 	FText>& ArgTexts, const FText QueryText) const
 {
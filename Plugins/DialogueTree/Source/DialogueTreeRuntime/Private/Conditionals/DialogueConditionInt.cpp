@@ -4,6 +4,8 @@
 #include "Conditionals/DialogueConditionInt.h"
 //Plugin
 #include "Conditionals/Queries/Base/DialogueQueryInt.h"
+#include "DialogueProgram.h"
+#include "DialogueTreeStats.h"
 //UE
 #include "UObject/UObjectGlobals.h"
 
@@ -20,6 +22,12 @@ void UDialogueConditionInt::PostDuplicate(EDuplicateMode::Type DuplicateMode)
 bool UDialogueConditionInt::IsMet() const
 {
     check(Query);
+
+    DIALOGUE_TRACE_SCOPE(
+        "ExecuteQuery",
+        Query->GetDialogue(),
+        Query->GetClass()->GetFName()
+    );
     int32 QueryValue = Query->ExecuteQuery();
 
     if (Comparison == EIntComparison::GreaterThan)
@@ -49,6 +57,30 @@ void UDialogueConditionInt::SetDialogue(UDialogue* InDialogue)
     Query->SetDialogue(InDialogue);
 }
 
+void UDialogueConditionInt::CompileCondition(FDialogueProgram& InProgram,
+    FDialogueConditionInstruction& OutInstruction) const
+{
+    switch (Comparison)
+    {
+    case EIntComparison::GreaterThan:
+        OutInstruction.Compare = EDialogueConditionCompare::GreaterThan;
+        break;
+    case EIntComparison::LessThan:
+        OutInstruction.Compare = EDialogueConditionCompare::LessThan;
+        break;
+    default:
+        OutInstruction.Compare = EDialogueConditionCompare::EqualTo;
+        break;
+    }
+    OutInstruction.Value = CompareValue;
+
+    if (!Query || !Query->CompileQuery(InProgram, OutInstruction))
+    {
+        OutInstruction.Op = EDialogueConditionOp::CallQueryInt;
+        OutInstruction.Operand = InProgram.AddConditionQuery(Query);
+    }
+}
+
 FText UDialogueConditionInt::GetDisplayText(const TMap<FName, FText>& ArgTexts, 
     const FText QueryText) const
 {
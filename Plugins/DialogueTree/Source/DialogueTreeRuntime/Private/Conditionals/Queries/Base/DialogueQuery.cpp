@@ -27,3 +27,14 @@ bool UDialogueQuery::IsValidQuery() const
 {
     return true;
 }
+
+bool UDialogueQuery::CompileQuery(FDialogueProgram& InProgram,
+    FDialogueConditionInstruction& OutInstruction) const
+{
+    return false;
+}
+
+bool UDialogueQuery::IsCacheable() const
+{
+    return bCacheable;
+}
@@ -0,0 +1,49 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Conditionals/Queries/Blackboard/BlackboardBoolQuery.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueProgram.h"
+
+#define LOCTEXT_NAMESPACE "BlackboardBoolQuery"
+
+bool UBlackboardBoolQuery::ExecuteQuery()
+{
+	const FDialogueBlackboardValue Value = 
+		GetDialogue()->GetBlackboardValue(Key);
+	return Value.Number != 0.0;
+}
+
+FText UBlackboardBoolQuery::GetGraphDescription_Implementation() const
+{
+	if (Key.IsNone())
+	{
+		return LOCTEXT("InvalidKey", "Invalid Blackboard Key");
+	}
+
+	return FText::FromName(Key);
+}
+
+bool UBlackboardBoolQuery::IsValidQuery() const
+{
+	return !Key.IsNone();
+}
+
+bool UBlackboardBoolQuery::CompileQuery(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	const int32 KeyIndex = 
+		InProgram.AddBlackboardKey(Key, EDialogueBlackboardType::Bool);
+	if (KeyIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	//The owning condition already set the comparison
+	OutInstruction.Op = EDialogueConditionOp::BlackboardNumber;
+	OutInstruction.Operand = KeyIndex;
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,49 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Conditionals/Queries/Blackboard/BlackboardIntQuery.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueProgram.h"
+
+#define LOCTEXT_NAMESPACE "BlackboardIntQuery"
+
+int32 UBlackboardIntQuery::ExecuteQuery()
+{
+	const FDialogueBlackboardValue Value = 
+		GetDialogue()->GetBlackboardValue(Key);
+	return FMath::TruncToInt32(Value.Number);
+}
+
+FText UBlackboardIntQuery::GetGraphDescription_Implementation() const
+{
+	if (Key.IsNone())
+	{
+		return LOCTEXT("InvalidKey", "Invalid Blackboard Key");
+	}
+
+	return FText::FromName(Key);
+}
+
+bool UBlackboardIntQuery::IsValidQuery() const
+{
+	return !Key.IsNone();
+}
+
+bool UBlackboardIntQuery::CompileQuery(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	const int32 KeyIndex = 
+		InProgram.AddBlackboardKey(Key, EDialogueBlackboardType::Int);
+	if (KeyIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	//The owning condition already set the comparison
+	OutInstruction.Op = EDialogueConditionOp::BlackboardNumber;
+	OutInstruction.Operand = KeyIndex;
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,55 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Conditionals/Queries/Blackboard/BlackboardNameQuery.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueProgram.h"
+
+#define LOCTEXT_NAMESPACE "BlackboardNameQuery"
+
+bool UBlackboardNameQuery::ExecuteQuery()
+{
+	return GetDialogue()->GetBlackboardValue(Key).Name == Value;
+}
+
+FText UBlackboardNameQuery::GetGraphDescription_Implementation() const
+{
+	if (Key.IsNone())
+	{
+		return LOCTEXT("InvalidKey", "Invalid Blackboard Key");
+	}
+
+	FText BaseText = LOCTEXT("BaseText", "{0} is {1}");
+	return FText::Format(
+		BaseText, 
+		FText::FromName(Key), 
+		FText::FromName(Value)
+	);
+}
+
+bool UBlackboardNameQuery::IsValidQuery() const
+{
+	return !Key.IsNone();
+}
+
+bool UBlackboardNameQuery::CompileQuery(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	const int32 KeyIndex = 
+		InProgram.AddBlackboardKey(Key, EDialogueBlackboardType::Name);
+	if (KeyIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FDialogueBlackboardValue Constant;
+	Constant.Name = Value;
+
+	OutInstruction.Op = EDialogueConditionOp::BlackboardName;
+	OutInstruction.Operand = KeyIndex;
+	OutInstruction.SecondOperand = InProgram.AddBlackboardConstant(Constant);
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,55 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Conditionals/Queries/Blackboard/BlackboardTagQuery.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueProgram.h"
+
+#define LOCTEXT_NAMESPACE "BlackboardTagQuery"
+
+bool UBlackboardTagQuery::ExecuteQuery()
+{
+	return GetDialogue()->GetBlackboardValue(Key).Tag.MatchesTag(Tag);
+}
+
+FText UBlackboardTagQuery::GetGraphDescription_Implementation() const
+{
+	if (Key.IsNone())
+	{
+		return LOCTEXT("InvalidKey", "Invalid Blackboard Key");
+	}
+
+	FText BaseText = LOCTEXT("BaseText", "{0} matches {1}");
+	return FText::Format(
+		BaseText, 
+		FText::FromName(Key), 
+		FText::FromName(Tag.GetTagName())
+	);
+}
+
+bool UBlackboardTagQuery::IsValidQuery() const
+{
+	return !Key.IsNone() && Tag.IsValid();
+}
+
+bool UBlackboardTagQuery::CompileQuery(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	const int32 KeyIndex = 
+		InProgram.AddBlackboardKey(Key, EDialogueBlackboardType::Tag);
+	if (KeyIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	FDialogueBlackboardValue Constant;
+	Constant.Tag = Tag;
+
+	OutInstruction.Op = EDialogueConditionOp::BlackboardTag;
+	OutInstruction.Operand = KeyIndex;
+	OutInstruction.SecondOperand = InProgram.AddBlackboardConstant(Constant);
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
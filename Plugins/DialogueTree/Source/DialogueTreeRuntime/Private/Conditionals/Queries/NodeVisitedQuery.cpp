@@ -5,6 +5,7 @@
 //Plugin
 #include "Dialogue.h"
 #include "DialogueNodeSocket.h"
+#include "DialogueProgram.h"
 #include "LogDialogueTree.h"
 
 #define LOCTEXT_NAMESPACE "NodeVisitedQuery"
@@ -59,6 +60,23 @@ bool UNodeVisitedQuery::IsValidQuery() const
 	return TargetNode && bGraphNode;
 }
 
+bool UNodeVisitedQuery::CompileQuery(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	//Targets outside the program are left to fail loudly when executed
+	const int32 TargetIndex = TargetNode
+		? InProgram.IndexOf(TargetNode->GetDialogueNode())
+		: INDEX_NONE;
+	if (TargetIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutInstruction.Op = EDialogueConditionOp::NodeVisited;
+	OutInstruction.Operand = TargetIndex;
+	return true;
+}
+
 void UNodeVisitedQuery::PostDuplicate(bool bDuplicateForPIE)
 {
 	Super::PostDuplicate(bDuplicateForPIE);
@@ -75,4 +93,9 @@ UDialogueNodeSocket* UNodeVisitedQuery::GetSocket()
 	return TargetNode;
 }
 
+void UNodeVisitedQuery::SetSocket(UDialogueNodeSocket* InSocket)
+{
+	TargetNode = InSocket;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
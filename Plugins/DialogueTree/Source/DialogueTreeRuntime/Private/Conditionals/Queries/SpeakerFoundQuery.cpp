@@ -2,8 +2,13 @@
 
 //Header
 #include "Conditionals/Queries/SpeakerFoundQuery.h"
+//UE
+#include "Engine/World.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueManagerSubsystem.h"
+#include "DialogueProgram.h"
+#include "DialogueSpeakerComponent.h"
 #include "DialogueSpeakerSocket.h"
 
 #define LOCTEXT_NAMESPACE "SpeakerFoundQuery"
@@ -12,7 +17,45 @@ bool USpeakerFoundQuery::ExecuteQuery()
 {
 	check(Speaker);
 
-	return GetDialogue()->SpeakerIsPresent(Speaker->GetSpeakerName());
+	UDialogue* Dialogue = GetDialogue();
+	UDialogueSpeakerComponent* Found = Speaker->GetSpeakerComponent(Dialogue);
+	if (Range <= 0.f)
+	{
+		return Found != nullptr;
+	}
+
+	//Distance is measured from another speaker in the dialogue
+	UDialogueSpeakerComponent* Origin = RangeOrigin
+		? RangeOrigin->GetSpeakerComponent(Dialogue)
+		: nullptr;
+	if (!Origin)
+	{
+		return false;
+	}
+
+	const FVector OriginLocation = Origin->GetComponentLocation();
+	if (Found)
+	{
+		return FVector::DistSquared(Found->GetComponentLocation(), 
+			OriginLocation) <= FMath::Square(Range);
+	}
+
+	if (!bIncludeUnboundSpeakers)
+	{
+		return false;
+	}
+
+	//Ask the registry rather than sweeping the world
+	UWorld* World = Origin->GetWorld();
+	UDialogueManagerSubsystem* DialogueSubsystem = World
+		? World->GetSubsystem<UDialogueManagerSubsystem>()
+		: nullptr;
+
+	return DialogueSubsystem && DialogueSubsystem->FindNearestSpeaker(
+		Speaker->GetSpeakerName(), 
+		OriginLocation, 
+		Range
+	) != nullptr;
 }
 
 FText USpeakerFoundQuery::GetGraphDescription_Implementation() const
@@ -26,12 +69,28 @@ FText USpeakerFoundQuery::GetGraphDescription_Implementation() const
 	FText SpeakerNameText = FText::FromName(Speaker->GetSpeakerName());
 
 	//Construct and return the display text
-	FText BaseText = LOCTEXT("BaseText", "{0} found");
-	return FText::Format(BaseText, SpeakerNameText);
+	if (Range <= 0.f || !RangeOrigin)
+	{
+		FText BaseText = LOCTEXT("BaseText", "{0} found");
+		return FText::Format(BaseText, SpeakerNameText);
+	}
+
+	FText RangeText = LOCTEXT("RangeText", "{0} found within {1} of {2}");
+	return FText::Format(
+		RangeText, 
+		SpeakerNameText, 
+		FText::AsNumber(Range),
+		FText::FromName(RangeOrigin->GetSpeakerName())
+	);
 }
 
 bool USpeakerFoundQuery::IsValidQuery() const
 {
+	if (Range > 0.f && (!RangeOrigin || !RangeOrigin->IsValidSocket()))
+	{
+		return false;
+	}
+
 	if (Speaker && Speaker->IsValidSocket())
 	{
 		return true;
@@ -40,6 +99,32 @@ bool USpeakerFoundQuery::IsValidQuery() const
 	return false;
 }
 
+bool USpeakerFoundQuery::CompileQuery(FDialogueProgram& InProgram,
+	FDialogueConditionInstruction& OutInstruction) const
+{
+	if (!Speaker)
+	{
+		return false;
+	}
+
+	//Roles that have no slot yet are left to be looked up by name
+	const int32 Slot = InProgram.FindSpeakerSlot(Speaker->GetSpeakerName());
+	const int32 OriginSlot = RangeOrigin
+		? InProgram.FindSpeakerSlot(RangeOrigin->GetSpeakerName())
+		: INDEX_NONE;
+	if (Slot == INDEX_NONE || (Range > 0.f && OriginSlot == INDEX_NONE))
+	{
+		return false;
+	}
+
+	OutInstruction.Op = EDialogueConditionOp::SpeakerFound;
+	OutInstruction.Operand = Slot;
+	OutInstruction.SecondOperand = OriginSlot;
+	OutInstruction.Value = Range;
+	OutInstruction.bIncludeUnbound = bIncludeUnboundSpeakers;
+	return true;
+}
+
 void USpeakerFoundQuery::PostDuplicate(bool bDuplicateForPIE)
 {
 	Super::PostDuplicate(bDuplicateForPIE);
@@ -6,6 +6,7 @@
 #include "Dialogue.h"
 #include "DialogueSpeakerComponent.h"
 #include "DialogueSpeakerSocket.h"
+#include "DialogueTreeStats.h"
 #include "LogDialogueTree.h"
 
 double USpeakerQueryFloat::ExecuteQuery()
@@ -28,8 +29,8 @@ double USpeakerQueryFloat::ExecuteQuery()
     //Convert main speaker to entry struct
     FSpeakerActorEntry TargetSpeaker = SpeakerComponent->ToSpeakerActorEntry();
 
-    //Repeat with any additional speakers
-    TArray<FSpeakerActorEntry> OtherSpeakers;
+    //Repeat with any additional speakers, reusing the entries' allocation
+    OtherSpeakerEntries.Reset();
     for (UDialogueSpeakerSocket* Socket : AdditionalSpeakers)
     {
         UDialogueSpeakerComponent* SocketComponent =
@@ -46,11 +47,12 @@ double USpeakerQueryFloat::ExecuteQuery()
 
         FSpeakerActorEntry SocketEntry =
             SocketComponent->ToSpeakerActorEntry();
-        OtherSpeakers.Add(SocketEntry);
+        OtherSpeakerEntries.Add(SocketEntry);
     }
 
     //Query the speaker
-    return QuerySpeaker(TargetSpeaker, OtherSpeakers);
+    INC_DWORD_STAT(STAT_DialogueTree_BlueprintQueryCalls);
+    return QuerySpeaker(TargetSpeaker, OtherSpeakerEntries);
 }
 
 bool USpeakerQueryFloat::IsValidQuery() const
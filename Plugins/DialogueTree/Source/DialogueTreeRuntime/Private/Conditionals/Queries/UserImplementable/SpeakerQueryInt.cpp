@@ -6,6 +6,7 @@
 #include "Dialogue.h"
 #include "DialogueSpeakerComponent.h"
 #include "DialogueSpeakerSocket.h"
+#include "DialogueTreeStats.h"
 #include "LogDialogueTree.h"
 
 int32 USpeakerQueryInt::ExecuteQuery()
@@ -30,8 +31,8 @@ int32 USpeakerQueryInt::ExecuteQuery()
     //Convert main speaker to entry struct
     FSpeakerActorEntry TargetSpeaker = SpeakerComponent->ToSpeakerActorEntry();
 
-    //Repeat with any additional speakers
-    TArray<FSpeakerActorEntry> OtherSpeakers;
+    //Repeat with any additional speakers, reusing the entries' allocation
+    OtherSpeakerEntries.Reset();
     for (UDialogueSpeakerSocket* Socket : AdditionalSpeakers)
     {
         UDialogueSpeakerComponent* SocketComponent =
@@ -48,11 +49,12 @@ int32 USpeakerQueryInt::ExecuteQuery()
 
         FSpeakerActorEntry SocketEntry =
             SocketComponent->ToSpeakerActorEntry();
-        OtherSpeakers.Add(SocketEntry);
+        OtherSpeakerEntries.Add(SocketEntry);
     }
 
     //Query the speaker
-    return QuerySpeaker(TargetSpeaker, OtherSpeakers);
+    INC_DWORD_STAT(STAT_DialogueTree_BlueprintQueryCalls);
+    return QuerySpeaker(TargetSpeaker, OtherSpeakerEntries);
 }
 
 bool USpeakerQueryInt::IsValidQuery() const
@@ -4,14 +4,44 @@
 #include "Dialogue.h"
 //UE
 #include "EdGraph/EdGraph.h"
+#include "Hash/CityHash.h"
 #include "Kismet/GameplayStatics.h"
 //Plugin
 #include "DialogueController.h"
+#include "DialogueInstance.h"
 #include "DialogueSpeakerComponent.h"
 #include "DialogueSpeakerSocket.h"
 #include "LogDialogueTree.h"
 #include "Nodes/DialogueEntryNode.h"
 
+namespace
+{
+	/**
+	* Hashes the given bytes into a dialogue key. 
+	* 
+	* @param InData - const void*, the bytes. 
+	* @param InSize - int32, the number of bytes. 
+	* @return uint64 - the key. Never 0. 
+	*/
+	uint64 MakeDialogueKey(const void* InData, int32 InSize)
+	{
+		const uint64 Key = 
+			CityHash64(static_cast<const char*>(InData), InSize);
+		return Key != 0 ? Key : 1;
+	}
+
+	/**
+	* Makes a fresh dialogue key for a new asset. 
+	* 
+	* @return uint64 - the key. 
+	*/
+	uint64 MakeUniqueDialogueKey()
+	{
+		const FGuid Guid = FGuid::NewGuid();
+		return MakeDialogueKey(&Guid, sizeof(FGuid));
+	}
+}
+
 FColor FDefaultDialogueColors::PopColor()
 {
 	FColor TargetColor = Colors[ColorIndex];
@@ -27,6 +57,54 @@ UDialogue::UDialogue()
 	AddDefaultSpeakers();
 }
 
+void UDialogue::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	//Loaded dialogues bring their own key
+	if (!HasAnyFlags(RF_ClassDefaultObject | RF_NeedLoad | RF_WasLoaded))
+	{
+		DialogueKey = MakeUniqueDialogueKey();
+	}
+}
+
+void UDialogue::PostLoad()
+{
+	Super::PostLoad();
+
+	//Dialogues saved before keys existed derive one from their path, which
+	//sticks once they are saved again
+	if (DialogueKey == 0)
+	{
+		const FTCHARToUTF8 Path(*GetPathName());
+		DialogueKey = MakeDialogueKey(Path.Get(), Path.Length());
+	}
+
+	//Before renames were tracked every node ID had its own slot
+	if (NumVisitSlots == 0)
+	{
+		NumVisitSlots = VisitSlots.Num();
+	}
+
+	//Dialogues compiled before the program existed have to bake it now
+	if (CompileStatus == EDialogueCompileStatus::Compiled 
+		&& (Program.IsEmpty() || !Program.IsUpToDate()))
+	{
+		BuildProgram();
+	}
+}
+
+void UDialogue::PostDuplicate(bool bDuplicateForPIE)
+{
+	Super::PostDuplicate(bDuplicateForPIE);
+
+	//A duplicated asset is a different dialogue with its own save data
+	if (!bDuplicateForPIE)
+	{
+		DialogueKey = MakeUniqueDialogueKey();
+	}
+}
+
 #if WITH_EDITOR
 
 void UDialogue::PostEditChangeProperty(
@@ -47,155 +125,265 @@ void UDialogue::PostEditChangeProperty(
 
 void UDialogue::SetSpeaker(FName InName, UDialogueSpeakerComponent* InSpeaker)
 {
-	if (Speakers.Contains(InName))
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("SetSpeaker"));
+	if (Instance)
 	{
-		Speakers[InName] = InSpeaker;
+		Instance->SetSpeaker(InName, InSpeaker);
 	}
 }
 
 UDialogueSpeakerComponent* UDialogue::GetSpeaker(FName InName) const
 {
-	if (Speakers.Contains(InName))
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("GetSpeaker"));
+	if (Instance)
 	{
-		return Speakers[InName];
+		return Instance->GetSpeaker(InName);
 	}
 
 	return nullptr;
 }
 
-void UDialogue::AddSpeakerEntry(FName InName)
+UDialogueSpeakerComponent* UDialogue::GetSpeakerAt(int32 InSlot) const
 {
-	if (!Speakers.Contains(InName))
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("GetSpeakerAt"));
+	if (Instance)
 	{
-		Speakers.Add(InName, nullptr);
+		return Instance->GetSpeakerAt(InSlot);
 	}
+
+	return nullptr;
 }
 
-void UDialogue::OpenDialogueAt(FName InNodeID, ADialogueController* InController, TMap<FName, UDialogueSpeakerComponent*> InSpeakers)
+FDialogueInstance* UDialogue::GetActiveInstance() const
 {
-	//Make sure we can start the dialogue 
-	FString ErrorMessage;
-	if (!CanPlay(InController, ErrorMessage))
-	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Cannot play dialogue. %s"),
-			*ErrorMessage
-		);
-		return;
-	}
+	//Outside of an execution any of several running instances could be 
+	//meant, so there is none to act on
+	FDialogueInstance* Executing = FDialogueInstance::GetExecuting();
+	return Executing && Executing->GetDialogue() == this
+		? Executing : nullptr;
+}
+
+int32 UDialogue::GetExecutingHandle() const
+{
+	FDialogueInstance* Instance = GetActiveInstance();
+	return Instance ? Instance->GetHandle() : INDEX_NONE;
+}
 
-	if (!HasNode(InNodeID))
+FDialogueInstance* UDialogue::GetActiveInstanceOrWarn(
+	const TCHAR* InFunction) const
+{
+	FDialogueInstance* Instance = GetActiveInstance();
+	if (!Instance)
 	{
 		UE_LOG(
 			LogDialogueTree,
-			Error,
-			TEXT("Cannot play dialogue starting from Node %s. No such node exists."),
-			*InNodeID.ToString()
+			Warning,
+			TEXT("%s called on dialogue [%s] outside of its execution, so no instance was addressed. Keep the handle from GetExecutingHandle and go through the dialogue controller instead."),
+			InFunction,
+			*GetName()
 		);
-		return;
 	}
 
-	//Store the controller 
-	DialogueController = InController;
-
-	//Fill the speakers with the provided values 
-	FillSpeakers(InSpeakers);
-
-	//Traverse the first node 
-	UDialogueNode* StartNode = DialogueNodes[InNodeID];
-	check(StartNode);
-	TraverseNode(StartNode);
+	return Instance;
 }
 
-void UDialogue::ClearController()
+bool UDialogue::CanPlay(FString& OutErrorMessage) const
 {
-	DialogueController = nullptr;
+	if (CompileStatus != EDialogueCompileStatus::Compiled)
+	{
+		OutErrorMessage = "Dialogue is not compiled.";
+		return false;
+	}
+	if (!RootNode || Program.IsEmpty())
+	{
+		OutErrorMessage = "Entry node does not exist.";
+		return false;
+	}
+
+	return true;
 }
 
 void UDialogue::EndDialogue() const
 {
 	//End the dialogue
-	if (DialogueController)
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("EndDialogue"));
+	if (Instance)
 	{
-		DialogueController->EndDialogue();
+		Instance->End();
 	}
 }
 
-void UDialogue::DisplaySpeech(const FSpeechDetails& InDetails) const
+void UDialogue::DisplaySpeech(const FSpeechDetails& InDetails,
+	UDialogueSpeakerComponent* InSpeaker) const
 {
-	if (!Speakers[InDetails.SpeakerName] || !DialogueController)
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("DisplaySpeech"));
+	if (Instance)
 	{
-		EndDialogue();
-		return;
+		Instance->DisplaySpeech(InDetails, InSpeaker);
 	}
-
-	DialogueController->DisplaySpeech(
-		InDetails,
-		Speakers[InDetails.SpeakerName]
-	);
-	DialogueController->OnDialogueSpeechDisplayed.Broadcast(InDetails);
 }
 
-void UDialogue::DisplayOptions(TArray<FDialogueOption> InOptions) const
+void UDialogue::DisplayOptions(
+	const TArray<FResolvedDialogueOption>& InOptions) const
 {
-	if (!DialogueController)
+	FDialogueInstance* Instance = GetActiveInstance();
+	if (!Instance)
 	{
 		UE_LOG(
 			LogDialogueTree,
 			Error,
-			TEXT("Attempting to display options via missing dialogue controller. Aborting dialogue.")
+			TEXT("Attempting to display options without an active dialogue instance.")
 		);
 		return;
 	}
 
-	TArray<FSpeechDetails> AllDetails;
-	for (FDialogueOption Option : InOptions)
-	{
-		AllDetails.Add(Option.Details);
-	}
-
-	DialogueController->DisplayOptions(AllDetails);
+	Instance->DisplayOptions(InOptions);
 }
 
 void UDialogue::SelectOption(int32 InOptionIndex) const
 {
-	if (ActiveNode)
+	if (FDialogueInstance* Instance = GetActiveInstance())
 	{
-		ActiveNode->SelectOption(InOptionIndex);
+		Instance->SelectOption(InOptionIndex);
 	}
 }
 
 void UDialogue::Skip() const
 {
-	if (ActiveNode)
+	if (FDialogueInstance* Instance = GetActiveInstance())
+	{
+		Instance->Skip();
+	}
+}
+
+void UDialogue::TraverseNode(UDialogueNode* InNode) const
+{
+	TraverseNodeAt(InNode ? InNode->GetNodeIndex() : INDEX_NONE);
+}
+
+void UDialogue::TraverseNodeAt(int32 NodeIndex) const
+{
+	if (FDialogueInstance* Instance = GetActiveInstance())
 	{
-		ActiveNode->Skip();
+		Instance->TraverseNodeAt(NodeIndex);
 	}
 }
 
-void UDialogue::TraverseNode(UDialogueNode* InNode)
+const FDialogueProgram& UDialogue::GetProgram() const
 {
-	//return if the dialogue is already closed
-	if (!DialogueController)
+	return Program;
+}
+
+void UDialogue::BuildProgram()
+{
+	Program.Reset();
+
+	if (!RootNode)
 	{
 		return;
 	}
 
-	//If no node provided, end the dialogue
-	if (!InNode)
+	//Declared roles take the first speaker slots, in declaration order
+	for (auto& Entry : SpeakerRoles)
 	{
-		EndDialogue();
-		return;
+		const int32 Slot = Program.AddSpeakerRole(Entry.Key);
+		if (Entry.Value.SpeakerSocket)
+		{
+			Entry.Value.SpeakerSocket->SetSpeakerSlot(Slot);
+		}
+	}
+
+	//Reserve indices first so links can be resolved, entry node first
+	Program.SetEntryIndex(Program.AddNode(RootNode));
+	for (auto& Pair : DialogueNodes)
+	{
+		if (Pair.Value && Pair.Value != RootNode)
+		{
+			Program.AddNode(Pair.Value);
+		}
 	}
 
-	//Mark the node visited 
-	DialogueController->MarkNodeVisited(this, InNode->GetNodeID());
+	//Slots owned by a stable ID are never taken over by name
+	TSet<int32> StableSlots;
+	StableSlots.Reserve(StableVisitSlots.Num());
+	for (const auto& Entry : StableVisitSlots)
+	{
+		StableSlots.Add(Entry.Value);
+	}
+
+	//Compile each node into its entry
+	for (int32 i = 0; i < Program.GetNumNodes(); ++i)
+	{
+		UDialogueNode* Node = Program.GetNodeObject(i);
+		FDialogueProgramNode& CompiledNode = Program.GetMutableNode(i);
+		Node->CompileNode(Program, CompiledNode);
+		CompiledNode.VisitIndex = AssignVisitSlot(
+			Node->GetNodeID(), 
+			CompiledNode.StableID, 
+			StableSlots
+		);
+	}
+	Program.SetNumVisitSlots(NumVisitSlots);
 
-	//Traverse the target node 
-	ActiveNode = InNode;
-	ActiveNode->EnterNode();
+	//Visits saved under a node's old ID still find it after a rename
+	for (const auto& Entry : VisitSlots)
+	{
+		if (Program.FindNode(Entry.Key) == INDEX_NONE)
+		{
+			Program.AddRenamedNode(Entry.Key, Entry.Value);
+		}
+	}
+
+	//Input transitions read their options from routes built up front
+	Program.CompileOptionRoutes();
+}
+
+int32 UDialogue::AssignVisitSlot(FName InNodeID, uint32 InStableID,
+	TSet<int32>& InOutStableSlots)
+{
+	int32 VisitSlot = INDEX_NONE;
+	if (const int32* StableSlot = StableVisitSlots.Find(InStableID))
+	{
+		VisitSlot = *StableSlot;
+	}
+
+	//Nodes compiled before stable IDs existed are found by their node ID,
+	//unless the slot went to the node that held the ID before
+	if (VisitSlot == INDEX_NONE)
+	{
+		const int32* NamedSlot = VisitSlots.Find(InNodeID);
+		if (NamedSlot && (InStableID == 0 
+			|| !InOutStableSlots.Contains(*NamedSlot)))
+		{
+			VisitSlot = *NamedSlot;
+		}
+	}
+
+	//New nodes get the next unused visit slot
+	if (VisitSlot == INDEX_NONE)
+	{
+		VisitSlot = NumVisitSlots++;
+	}
+
+	if (InStableID != 0)
+	{
+		StableVisitSlots.Add(InStableID, VisitSlot);
+		InOutStableSlots.Add(VisitSlot);
+	}
+
+	//Older IDs of the node stay mapped to the slot
+	VisitSlots.Add(InNodeID, VisitSlot);
+	return VisitSlot;
+}
+
+uint64 UDialogue::GetDialogueKey() const
+{
+	return DialogueKey;
 }
 
 EDialogueCompileStatus UDialogue::GetCompileStatus() const
@@ -205,65 +393,90 @@ EDialogueCompileStatus UDialogue::GetCompileStatus() const
 
 TMap<FName, UDialogueSpeakerComponent*> UDialogue::GetAllSpeakers() const
 {
-	//Have to manually copy to handle conversion from TObjectPtr
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("GetAllSpeakers"));
+	if (!Instance)
+	{
+		return TMap<FName, UDialogueSpeakerComponent*>();
+	}
+
+	//Native code should read FDialogueInstance::GetSpeakers() instead
+	const TArray<TObjectPtr<UDialogueSpeakerComponent>>& Slots = 
+		Instance->GetSpeakers();
 	TMap<FName, UDialogueSpeakerComponent*> AllSpeakers;
-	for (auto& Speaker : Speakers)
+	AllSpeakers.Reserve(Slots.Num());
+	for (int32 i = 0; i < Slots.Num(); ++i)
 	{
-		AllSpeakers.Add(Speaker.Key, Speaker.Value);
+		if (Slots[i])
+		{
+			AllSpeakers.Add(Program.GetSpeakerRole(i), Slots[i]);
+		}
 	}
 	return AllSpeakers;
 }
 
 bool UDialogue::SpeakerIsPresent(const FName SpeakerName) const
 {
-	return GetSpeaker(SpeakerName) != nullptr;
+	FDialogueInstance* Instance = 
+		GetActiveInstanceOrWarn(TEXT("SpeakerIsPresent"));
+	return Instance && Instance->GetSpeaker(SpeakerName) != nullptr;
 }
 
 bool UDialogue::WasNodeVisited(UDialogueNode* TargetNode) const
 {
-	if (!DialogueController || !TargetNode
-		|| !DialogueNodes.Contains(TargetNode->GetNodeID()))
+	FDialogueInstance* Instance = GetActiveInstance();
+	const int32 NodeIndex = Program.IndexOf(TargetNode);
+	if (!Instance || NodeIndex == INDEX_NONE)
 	{
 		return false;
 	}
 
-	return DialogueController->WasNodeVisited(
-		this,
-		TargetNode->GetNodeID()
-	);
+	return Instance->GetController()->WasNodeVisited(this, NodeIndex);
 }
 
-void UDialogue::MarkNodeVisited(UDialogueNode* TargetNode, bool bVisited)
+void UDialogue::MarkNodeVisited(UDialogueNode* TargetNode, bool bVisited) const
 {
-	if (!DialogueController || !TargetNode)
+	FDialogueInstance* Instance = GetActiveInstance();
+	const int32 NodeIndex = Program.IndexOf(TargetNode);
+	if (!Instance || NodeIndex == INDEX_NONE)
 	{
 		return;
 	}
 
 	if (bVisited)
 	{
-		DialogueController->MarkNodeVisited(
-			this,
-			TargetNode->GetNodeID()
+		Instance->GetController()->MarkNodeVisited(
+			Instance->GetDialogue(),
+			NodeIndex
 		);
 	}
 	else
 	{
-		DialogueController->MarkNodeUnvisited(
-			this,
-			TargetNode->GetNodeID()
+		Instance->GetController()->MarkNodeUnvisited(
+			Instance->GetDialogue(),
+			NodeIndex
 		);
 	}
 }
 
-void UDialogue::ClearAllNodeVisits()
+void UDialogue::ClearAllNodeVisits() const
 {
-	if (!DialogueController)
+	if (FDialogueInstance* Instance = GetActiveInstance())
 	{
-		return;
+		Instance->GetController()->ClearAllNodeVisitsForDialogue(
+			Instance->GetDialogue()
+		);
 	}
+}
 
-	DialogueController->ClearAllNodeVisitsForDialogue(this);
+FDialogueBlackboardValue UDialogue::GetBlackboardValue(FName InKey) const
+{
+	FDialogueInstance* Instance = GetActiveInstance();
+	const FDialogueBlackboardValue* Value = Instance
+		? Instance->GetController()->GetBlackboard().Find(InKey)
+		: nullptr;
+
+	return Value ? *Value : FDialogueBlackboardValue();
 }
 
 bool UDialogue::HasNode(FName NodeID) const
@@ -271,12 +484,15 @@ bool UDialogue::HasNode(FName NodeID) const
 	return DialogueNodes.Contains(NodeID);
 }
 
-void UDialogue::SetResumeNode(UDialogueNode* InNode)
+void UDialogue::SetResumeNode(UDialogueNode* InNode) const
 {
-	if (InNode && DialogueNodes.Contains(InNode->GetNodeID())
-		&& DialogueController)
+	FDialogueInstance* Instance = GetActiveInstance();
+	if (InNode && DialogueNodes.Contains(InNode->GetNodeID()) && Instance)
 	{
-		DialogueController->SetResumeNode(this, InNode->GetNodeID());
+		Instance->GetController()->SetResumeNode(
+			Instance->GetDialogue(),
+			InNode->GetNodeID()
+		);
 	}
 }
 
@@ -307,6 +523,11 @@ const TArray<UDialogueNode*> UDialogue::GetAllNodes() const
 	return AllNodes;
 }
 
+const TMap<FName, FSpeakerField>& UDialogue::GetSpeakerRoles() const
+{
+	return SpeakerRoles;
+}
+
 #if WITH_EDITOR
 
 UEdGraph* UDialogue::GetEdGraph() const
@@ -319,11 +540,6 @@ void UDialogue::SetEdGraph(UEdGraph* InEdGraph)
 	EdGraph = InEdGraph;
 }
 
-const TMap<FName, FSpeakerField>& UDialogue::GetSpeakerRoles() const
-{
-	return SpeakerRoles;
-}
-
 void UDialogue::AddNode(UDialogueNode* InNode)
 {
 	if (InNode && !DialogueNodes.Contains(InNode->GetNodeID()))
@@ -355,19 +571,13 @@ void UDialogue::ClearDialogue()
 {
 	RootNode = nullptr;
 	DialogueNodes.Empty();
-	Speakers.Empty();
+	Program.Reset();
 	CompileStatus = EDialogueCompileStatus::Uncompiled;
 }
 
 void UDialogue::PreCompileDialogue()
 {
 	ClearDialogue();
-
-	//Refresh the accessible speaker component entries from their roles
-	for (auto& Entry : SpeakerRoles)
-	{
-		AddSpeakerEntry(Entry.Key);
-	}
 }
 
 void UDialogue::SetCompileStatus(EDialogueCompileStatus InStatus)
@@ -462,53 +672,3 @@ void UDialogue::OnChangeSingleSpeaker()
 		}
 	}
 }
-
-bool UDialogue::CanPlay(ADialogueController* InController,
-	FString& OutErrorMessage) const
-{
-	if (CompileStatus != EDialogueCompileStatus::Compiled)
-	{
-		OutErrorMessage = "Dialogue is not compiled.";
-		return false;
-	}
-	if (!InController)
-	{
-		OutErrorMessage = "No valid controller provided.";
-		return false;
-	}
-	if (!RootNode)
-	{
-		OutErrorMessage = "Entry node does not exist.";
-		return false;
-	}
-
-	return true;
-}
-
-void UDialogue::FillSpeakers(TMap<FName, UDialogueSpeakerComponent*> InSpeakers)
-{
-	//Clear speakers 
-	for (auto& Entry : Speakers)
-	{
-		Entry.Value = nullptr;
-	}
-
-	//Set speakers
-	for (auto& Entry : InSpeakers)
-	{
-		if (Speakers.Contains(Entry.Key) &&
-			Entry.Value != nullptr)
-		{
-			Speakers[Entry.Key] = Entry.Value;
-		}
-	}
-
-	//Verify that no speakers are missing 
-	for (auto& Entry : Speakers)
-	{
-		if (!Entry.Value)
-		{
-			DialogueController->HandleMissingSpeaker(Entry.Key);
-		}
-	}
-}
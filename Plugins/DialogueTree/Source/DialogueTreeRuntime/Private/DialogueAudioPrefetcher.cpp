@@ -0,0 +1,231 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueAudioPrefetcher.h"
+//UE
+#include "Engine/AssetManager.h"
+//Plugin
+#include "DialogueProgram.h"
+#include "DialogueSettings.h"
+#include "DialogueTreeStats.h"
+
+int64 FDialogueAudioPrefetcher::PrefetchedBytes = 0;
+
+FDialogueAudioPrefetcher::~FDialogueAudioPrefetcher()
+{
+	Release();
+}
+
+void FDialogueAudioPrefetcher::Update(const FDialogueProgram& InProgram,
+	int32 FromIndex)
+{
+	const UDialogueSettings* Settings = GetDefault<UDialogueSettings>();
+	const int32 MaxDepth = Settings->SpeechAudioPrefetchDepth;
+	const int64 Budget =
+		static_cast<int64>(Settings->SpeechAudioPrefetchBudgetMB) << 20;
+	const int64 Estimate =
+		static_cast<int64>(Settings->SpeechAudioPrefetchEstimateKB) << 10;
+
+	for (auto& Entry : Entries)
+	{
+		Entry.Value.bReachable = false;
+	}
+
+	if (MaxDepth > 0 && InProgram.IsValidNode(FromIndex))
+	{
+		//Only resize when the program changed, so warm dialogues never
+		//allocate
+		if (Searched.Num() == InProgram.GetNumNodes())
+		{
+			Searched.SetRange(0, Searched.Num(), false);
+		}
+		else
+		{
+			Searched.Init(false, InProgram.GetNumNodes());
+		}
+
+		//Breadth first so nearer lines are requested before the budget is
+		//spent. Only speeches count toward the depth.
+		SearchQueue.Reset();
+		SearchQueue.Emplace(FromIndex, 0);
+		Searched[FromIndex] = true;
+
+		for (int32 Head = 0; Head < SearchQueue.Num(); ++Head)
+		{
+			const int32 NodeIndex = SearchQueue[Head].Key;
+			int32 Depth = SearchQueue[Head].Value;
+
+			if (const FSpeechDetails* Speech = InProgram.GetSpeech(NodeIndex))
+			{
+				Want(Speech->SpeechAudio, Budget, Estimate);
+
+				if (NodeIndex != FromIndex)
+				{
+					++Depth;
+				}
+			}
+
+			if (Depth >= MaxDepth)
+			{
+				continue;
+			}
+
+			for (int32 LinkedIndex : InProgram.GetLinks(NodeIndex))
+			{
+				if (InProgram.IsValidNode(LinkedIndex)
+					&& !Searched[LinkedIndex])
+				{
+					Searched[LinkedIndex] = true;
+					SearchQueue.Emplace(LinkedIndex, Depth);
+				}
+			}
+		}
+	}
+
+	//Let go of anything the dialogue can no longer reach
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().bReachable)
+		{
+			ReleaseEntry(It.Value());
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool FDialogueAudioPrefetcher::RequestNow(
+	const TSoftObjectPtr<USoundBase>& InAudio, FStreamableDelegate InOnLoaded)
+{
+	ReleaseHandle(ImmediateHandle);
+
+	if (InAudio.IsNull() || !UAssetManager::IsInitialized())
+	{
+		return false;
+	}
+
+	ImmediateHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		InAudio.ToSoftObjectPath(),
+		MoveTemp(InOnLoaded),
+		FStreamableManager::AsyncLoadHighPriority
+	);
+	return ImmediateHandle.IsValid();
+}
+
+void FDialogueAudioPrefetcher::Release()
+{
+	ReleaseHandle(ImmediateHandle);
+
+	for (auto& Entry : Entries)
+	{
+		ReleaseEntry(Entry.Value);
+	}
+	Entries.Reset();
+}
+
+int64 FDialogueAudioPrefetcher::GetPrefetchedBytes()
+{
+	return PrefetchedBytes;
+}
+
+void FDialogueAudioPrefetcher::Want(const TSoftObjectPtr<USoundBase>& InAudio,
+	int64 InBudget, int64 InEstimate)
+{
+	if (InAudio.IsNull())
+	{
+		return;
+	}
+
+	const FSoftObjectPath& Path = InAudio.ToSoftObjectPath();
+	if (FPrefetchEntry* Existing = Entries.Find(Path))
+	{
+		Existing->bReachable = true;
+		return;
+	}
+
+	//Lines past the budget are left for the speech to request itself
+	if (PrefetchedBytes >= InBudget || !UAssetManager::IsInitialized())
+	{
+		return;
+	}
+
+	FPrefetchEntry& Entry = Entries.Add(Path);
+	Entry.bReachable = true;
+
+	//Charge the line as it is requested, so a wide hub cannot request
+	//past the budget before anything has loaded
+	if (USoundBase* Loaded = Cast<USoundBase>(Path.ResolveObject()))
+	{
+		SetEntryBytes(Entry,
+			Loaded->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+		Entry.bSizeKnown = true;
+	}
+	else
+	{
+		SetEntryBytes(Entry, InEstimate);
+	}
+
+	//Lines already in memory complete straight away, so only look the
+	//entry up again once the request has been made
+	TSharedPtr<FStreamableHandle> Handle =
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			Path,
+			FStreamableDelegate::CreateRaw(
+				this,
+				&FDialogueAudioPrefetcher::OnPrefetched,
+				Path
+			)
+		);
+	Entries.FindChecked(Path).Handle = MoveTemp(Handle);
+}
+
+void FDialogueAudioPrefetcher::OnPrefetched(FSoftObjectPath InPath)
+{
+	FPrefetchEntry* Entry = Entries.Find(InPath);
+	if (!Entry || Entry->bSizeKnown)
+	{
+		return;
+	}
+
+	//Swap the estimate for the real size. A line that failed to load
+	//holds nothing.
+	USoundBase* Sound = Cast<USoundBase>(InPath.ResolveObject());
+	SetEntryBytes(*Entry, Sound
+		? Sound->GetResourceSizeBytes(EResourceSizeMode::Exclusive)
+		: 0);
+	Entry->bSizeKnown = true;
+}
+
+void FDialogueAudioPrefetcher::ReleaseEntry(FPrefetchEntry& InEntry)
+{
+	ReleaseHandle(InEntry.Handle);
+	SetEntryBytes(InEntry, 0);
+}
+
+void FDialogueAudioPrefetcher::SetEntryBytes(FPrefetchEntry& InEntry,
+	int64 InBytes)
+{
+	PrefetchedBytes += InBytes - InEntry.Bytes;
+	DEC_MEMORY_STAT_BY(STAT_DialogueTree_PrefetchedAudio, InEntry.Bytes);
+	INC_MEMORY_STAT_BY(STAT_DialogueTree_PrefetchedAudio, InBytes);
+	InEntry.Bytes = InBytes;
+}
+
+void FDialogueAudioPrefetcher::ReleaseHandle(
+	TSharedPtr<FStreamableHandle>& InHandle)
+{
+	if (!InHandle.IsValid())
+	{
+		return;
+	}
+
+	//Cancelling also drops the completion callback
+	if (InHandle->IsLoadingInProgress())
+	{
+		InHandle->CancelHandle();
+	}
+	else
+	{
+		InHandle->ReleaseHandle();
+	}
+	InHandle.Reset();
+}
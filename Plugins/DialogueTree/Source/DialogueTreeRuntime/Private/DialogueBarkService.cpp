@@ -0,0 +1,311 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueBarkService.h"
+//UE
+#include "Algo/BinarySearch.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueController.h"
+#include "DialogueManagerSubsystem.h"
+#include "DialogueSettings.h"
+#include "DialogueSpeakerComponent.h"
+#include "DialogueTreeStats.h"
+
+void FDialogueBarkService::Initialize(UDialogueManagerSubsystem* InOwner)
+{
+	Owner = InOwner;
+}
+
+bool FDialogueBarkService::RequestBark(UDialogueSpeakerComponent* InSpeaker,
+	UDialogue* InDialogue, const FDialogueBarkParams& InParams)
+{
+	if (!InSpeaker || !InDialogue)
+	{
+		return false;
+	}
+
+	//Still cooling down from the last time
+	const double Now = GetNow();
+	const TPair<TObjectKey<UDialogueSpeakerComponent>, TObjectKey<UDialogue>>
+		CooldownKey(InSpeaker, InDialogue);
+	if (const double* ReadyTime = Cooldowns.Find(CooldownKey))
+	{
+		if (*ReadyTime > Now)
+		{
+			return false;
+		}
+		Cooldowns.Remove(CooldownKey);
+	}
+
+	//A speaker only queues its most important bark
+	const int32 Existing = Pending.IndexOfByPredicate(
+		[InSpeaker](const FPendingBark& Bark)
+		{
+			return Bark.Speaker.Get() == InSpeaker;
+		}
+	);
+	if (Existing != INDEX_NONE)
+	{
+		if (Pending[Existing].Params.Priority >= InParams.Priority)
+		{
+			return false;
+		}
+		Pending.RemoveAt(Existing, 1, EAllowShrinking::No);
+	}
+
+	//Make room by dropping the least important bark, if this one outranks it
+	const int32 MaxPending = GetDefault<UDialogueSettings>()->MaxPendingBarks;
+	if (Pending.Num() >= MaxPending)
+	{
+		if (Pending.IsEmpty()
+			|| Pending.Last().Params.Priority >= InParams.Priority)
+		{
+			INC_DWORD_STAT(STAT_DialogueTree_BarksCulled);
+			return false;
+		}
+
+		Pending.Pop(EAllowShrinking::No);
+		INC_DWORD_STAT(STAT_DialogueTree_BarksCulled);
+	}
+
+	//Keep the queue highest priority first, and first come first served
+	//among equals
+	FPendingBark NewBark;
+	NewBark.Speaker = InSpeaker;
+	NewBark.Dialogue = InDialogue;
+	NewBark.Params = InParams;
+	NewBark.RequestTime = Now;
+
+	const int32 InsertIndex = Algo::UpperBoundBy(
+		Pending,
+		-InParams.Priority,
+		[](const FPendingBark& Bark)
+		{
+			return -Bark.Params.Priority;
+		}
+	);
+	Pending.Insert(MoveTemp(NewBark), InsertIndex);
+	return true;
+}
+
+void FDialogueBarkService::CancelBark(
+	const UDialogueSpeakerComponent* InSpeaker)
+{
+	Pending.RemoveAll([InSpeaker](const FPendingBark& Bark)
+		{
+			return Bark.Speaker.Get() == InSpeaker;
+		}
+	);
+}
+
+void FDialogueBarkService::Tick()
+{
+	UDialogueManagerSubsystem* Subsystem = Owner.Get();
+	if (Pending.IsEmpty() || !Subsystem || !Subsystem->GetCurrentController())
+	{
+		return;
+	}
+
+	const UDialogueSettings* Settings = GetDefault<UDialogueSettings>();
+	const double Now = GetNow();
+	const double BudgetEnd =
+		FPlatformTime::Seconds() + Settings->BarkStartBudgetMs / 1000.0;
+
+	for (int32 i = 0; i < Pending.Num();)
+	{
+		const FPendingBark& Bark = Pending[i];
+		UDialogueSpeakerComponent* Speaker = Bark.Speaker.Get();
+
+		//Drop barks whose speaker left or that waited too long for a voice
+		if (!Speaker || !Bark.Dialogue.IsValid()
+			|| Now - Bark.RequestTime > Bark.Params.MaxDelay)
+		{
+			Pending.RemoveAt(i, 1, EAllowShrinking::No);
+			INC_DWORD_STAT(STAT_DialogueTree_BarksCulled);
+			continue;
+		}
+
+		//Whatever is left waits for the next frame
+		if (FPlatformTime::Seconds() > BudgetEnd)
+		{
+			break;
+		}
+
+		//A speaker only voices one bark at a time, and only so many barks
+		//play at once. Either may make room by cutting off a lesser bark.
+		const bool bSpeakerBusy = Running.ContainsByPredicate(
+			[Speaker](const FRunningBark& Other)
+			{
+				return Other.Speaker.Get() == Speaker;
+			}
+		);
+		int32 Victim = INDEX_NONE;
+		if (bSpeakerBusy || Running.Num() >= Settings->MaxConcurrentBarks)
+		{
+			Victim = FindInterruptible(
+				Bark.Params.Priority,
+				bSpeakerBusy ? Speaker : nullptr
+			);
+			if (Victim == INDEX_NONE)
+			{
+				++i;
+				continue;
+			}
+		}
+
+		//Take the bark off the queue first. Interrupting ends a dialogue,
+		//whose handlers may request or cancel barks.
+		FPendingBark ToStart = MoveTemp(Pending[i]);
+		Pending.RemoveAt(i, 1, EAllowShrinking::No);
+
+		if (Victim != INDEX_NONE)
+		{
+			Interrupt(Victim);
+		}
+		StartBark(ToStart, Now);
+	}
+
+	//Forget cooldowns that ran out for speakers that never barked again
+	if (Cooldowns.Num() > 2 * Settings->MaxPendingBarks)
+	{
+		for (auto It = Cooldowns.CreateIterator(); It; ++It)
+		{
+			if (It.Value() <= Now)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+void FDialogueBarkService::OnBarkEnded(int32 Handle)
+{
+	const int32 Index = Running.IndexOfByPredicate(
+		[Handle](const FRunningBark& Bark)
+		{
+			return Bark.Handle == Handle;
+		}
+	);
+
+	if (Index != INDEX_NONE)
+	{
+		Running.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+}
+
+int32 FDialogueBarkService::GetNumPending() const
+{
+	return Pending.Num();
+}
+
+int32 FDialogueBarkService::GetNumRunning() const
+{
+	return Running.Num();
+}
+
+void FDialogueBarkService::Reset()
+{
+	Pending.Reset();
+	Running.Reset();
+	Cooldowns.Reset();
+}
+
+int32 FDialogueBarkService::FindInterruptible(int32 InPriority,
+	const UDialogueSpeakerComponent* InSpeaker) const
+{
+	int32 Found = INDEX_NONE;
+	for (int32 i = 0; i < Running.Num(); ++i)
+	{
+		const FRunningBark& Bark = Running[i];
+		if (!Bark.bInterruptible || Bark.Priority >= InPriority)
+		{
+			continue;
+		}
+
+		if (InSpeaker && Bark.Speaker.Get() != InSpeaker)
+		{
+			continue;
+		}
+
+		if (Found == INDEX_NONE || Bark.Priority < Running[Found].Priority)
+		{
+			Found = i;
+		}
+	}
+
+	return Found;
+}
+
+void FDialogueBarkService::Interrupt(int32 InIndex)
+{
+	//Forget the bark first, so the end notification finds nothing to do
+	const int32 Handle = Running[InIndex].Handle;
+	Running.RemoveAtSwap(InIndex, 1, EAllowShrinking::No);
+
+	UDialogueManagerSubsystem* Subsystem = Owner.Get();
+	if (ADialogueController* Controller =
+		Subsystem ? Subsystem->GetCurrentController() : nullptr)
+	{
+		Controller->EndAmbientDialogue(Handle);
+	}
+}
+
+void FDialogueBarkService::StartBark(const FPendingBark& InBark, double InNow)
+{
+	UDialogueManagerSubsystem* Subsystem = Owner.Get();
+	ADialogueController* Controller =
+		Subsystem ? Subsystem->GetCurrentController() : nullptr;
+	UDialogueSpeakerComponent* Speaker = InBark.Speaker.Get();
+	UDialogue* Dialogue = InBark.Dialogue.Get();
+	if (!Controller || !Speaker || !Dialogue)
+	{
+		return;
+	}
+
+	if (InBark.Params.Cooldown > 0.f)
+	{
+		Cooldowns.Add(
+			TPair<TObjectKey<UDialogueSpeakerComponent>, TObjectKey<UDialogue>>(
+				Speaker,
+				Dialogue
+			),
+			InNow + InBark.Params.Cooldown
+		);
+	}
+
+	//The barking speaker takes its own role, and anyone nearby fills in
+	FDialogueSpeakerSlots Slots;
+	Subsystem->BindNearestSpeakerSlots(
+		Dialogue,
+		Speaker,
+		InBark.Params.SearchRadius,
+		Slots
+	);
+
+	const int32 Handle = Controller->StartAmbientDialogueInSlots(
+		Dialogue,
+		Controller->GetStartNodeID(Dialogue, false),
+		Slots
+	);
+	INC_DWORD_STAT(STAT_DialogueTree_BarksStarted);
+
+	//Barks that ran straight to their end hold no voice
+	if (Handle != INDEX_NONE)
+	{
+		FRunningBark& NewBark = Running.AddDefaulted_GetRef();
+		NewBark.Handle = Handle;
+		NewBark.Speaker = Speaker;
+		NewBark.Priority = InBark.Params.Priority;
+		NewBark.bInterruptible = InBark.Params.bInterruptible;
+	}
+}
+
+double FDialogueBarkService::GetNow() const
+{
+	const UDialogueManagerSubsystem* Subsystem = Owner.Get();
+	const UWorld* World = Subsystem ? Subsystem->GetWorld() : nullptr;
+	return World ? World->GetTimeSeconds() : 0.0;
+}
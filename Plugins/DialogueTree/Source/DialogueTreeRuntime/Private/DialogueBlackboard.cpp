@@ -0,0 +1,104 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueBlackboard.h"
+
+int32 FDialogueBlackboard::FindSlot(FName InKey) const
+{
+	UpdateSlotLookup();
+
+	const int32* Slot = SlotLookup.Find(InKey);
+	return Slot ? *Slot : INDEX_NONE;
+}
+
+int32 FDialogueBlackboard::FindOrAddSlot(FName InKey,
+	EDialogueBlackboardType InType)
+{
+	if (InKey.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ExistingSlot = FindSlot(InKey);
+	if (ExistingSlot != INDEX_NONE)
+	{
+		return ExistingSlot;
+	}
+
+	FDialogueBlackboardEntry& NewEntry = Entries.AddDefaulted_GetRef();
+	NewEntry.Key = InKey;
+	NewEntry.Type = InType;
+
+	const int32 NewSlot = Entries.Num() - 1;
+	SlotLookup.Add(InKey, NewSlot);
+	bDirty = true;
+	return NewSlot;
+}
+
+bool FDialogueBlackboard::IsValidSlot(int32 InSlot) const
+{
+	return Entries.IsValidIndex(InSlot);
+}
+
+const FDialogueBlackboardValue& FDialogueBlackboard::GetValue(int32 InSlot)
+	const
+{
+	return Entries[InSlot].Value;
+}
+
+void FDialogueBlackboard::SetValue(int32 InSlot,
+	const FDialogueBlackboardValue& InValue)
+{
+	Entries[InSlot].Value = InValue;
+	bDirty = true;
+}
+
+const FDialogueBlackboardValue* FDialogueBlackboard::Find(FName InKey) const
+{
+	const int32 Slot = FindSlot(InKey);
+	return Slot != INDEX_NONE ? &Entries[Slot].Value : nullptr;
+}
+
+TConstArrayView<FDialogueBlackboardEntry> FDialogueBlackboard::GetEntries()
+	const
+{
+	return Entries;
+}
+
+int32 FDialogueBlackboard::Num() const
+{
+	return Entries.Num();
+}
+
+void FDialogueBlackboard::Reset()
+{
+	Entries.Empty();
+	SlotLookup.Empty();
+	bDirty = true;
+}
+
+bool FDialogueBlackboard::IsDirty() const
+{
+	return bDirty;
+}
+
+void FDialogueBlackboard::ClearDirty()
+{
+	bDirty = false;
+}
+
+void FDialogueBlackboard::UpdateSlotLookup() const
+{
+	//Entries only ever grow, so a size mismatch means they were replaced
+	if (SlotLookup.Num() == Entries.Num())
+	{
+		return;
+	}
+
+	SlotLookup.Reset();
+	SlotLookup.Reserve(Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		SlotLookup.Add(Entries[i].Key, i);
+	}
+}
@@ -2,205 +2,1210 @@
 
 //Header
 #include "DialogueController.h"
+//UE
+#include "Engine/AssetManager.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueInstance.h"
+#include "DialogueManagerSubsystem.h"
+#include "DialogueRecordsSerializer.h"
+#include "DialogueSettings.h"
 #include "DialogueSpeakerComponent.h"
 #include "LogDialogueTree.h"
 //Engine
+#include "Engine/World.h"
 #include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+#include "TimerManager.h"
 #include "UObject/UObjectIterator.h"
 
 
+bool FDialogueNodeVisits::IsVisited(int32 VisitIndex) const
+{
+	const int32 WordIndex = VisitIndex / 32;
+	return VisitIndex >= 0 && VisitedNodeBits.IsValidIndex(WordIndex)
+		&& (VisitedNodeBits[WordIndex] & (1u << (VisitIndex % 32))) != 0;
+}
+
+void FDialogueNodeVisits::SetVisited(int32 VisitIndex, bool bVisited)
+{
+	if (VisitIndex < 0)
+	{
+		return;
+	}
+
+	const int32 WordIndex = VisitIndex / 32;
+	const uint32 Mask = 1u << (VisitIndex % 32);
+
+	if (bVisited)
+	{
+		if (WordIndex >= VisitedNodeBits.Num())
+		{
+			VisitedNodeBits.SetNumZeroed(WordIndex + 1);
+		}
+		VisitedNodeBits[WordIndex] |= Mask;
+	}
+	else if (VisitedNodeBits.IsValidIndex(WordIndex))
+	{
+		VisitedNodeBits[WordIndex] &= ~Mask;
+	}
+}
+
+void FDialogueNodeVisits::ClearVisits()
+{
+	FMemory::Memzero(
+		VisitedNodeBits.GetData(),
+		VisitedNodeBits.Num() * sizeof(uint32)
+	);
+	VisitedNodeIDs.Empty();
+}
+
+void FDialogueNodeVisits::MigrateLegacyVisits(const FDialogueProgram& InProgram)
+{
+	if (VisitedNodeIDs.IsEmpty())
+	{
+		return;
+	}
+
+	//Node IDs that no longer exist in the dialogue are dropped
+	for (FName NodeID : VisitedNodeIDs)
+	{
+		SetVisited(InProgram.FindVisitIndex(NodeID), true);
+	}
+
+	VisitedNodeIDs.Empty();
+}
+
 // Sets default values
 ADialogueController::ADialogueController()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
-#if WITH_EDITORONLY_DATA
-	bIsSpatiallyLoaded = false;
-#endif
+#if WITH_EDITORONLY_DATA
+	bIsSpatiallyLoaded = false;
+#endif
+}
+
+void ADialogueController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	//Stop anything still playing so no timers outlive the controller
+	CancelPendingRestore();
+	if (CurrentInstance)
+	{
+		CurrentInstance->Close();
+		CurrentInstance.Reset();
+	}
+
+	for (TSharedPtr<FDialogueInstance>& Instance : AmbientInstances)
+	{
+		Instance->Close();
+	}
+	AmbientInstances.Empty();
+	GetWorldTimerManager().ClearTimer(AmbientFidelityHandle);
+
+	//Let the last save finish writing before the game moves on
+	WaitForDialogueSaves();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADialogueController::AddReferencedObjects(UObject* InThis,
+	FReferenceCollector& Collector)
+{
+	ADialogueController* This = CastChecked<ADialogueController>(InThis);
+
+	//Instances are not UObjects, so report what they hold on to
+	if (This->CurrentInstance)
+	{
+		This->CurrentInstance->AddReferencedObjects(Collector);
+	}
+
+	for (TSharedPtr<FDialogueInstance>& Instance : This->AmbientInstances)
+	{
+		Instance->AddReferencedObjects(Collector);
+	}
+
+	Super::AddReferencedObjects(InThis, Collector);
+}
+
+void ADialogueController::SelectOption(int32 InOptionIndex) const
+{
+	if (CurrentInstance)
+	{
+		CurrentInstance->SelectOption(InOptionIndex);
+	}
+}
+
+TMap<FName, UDialogueSpeakerComponent*> ADialogueController::GetSpeakers() const
+{
+	return GetSpeakersInDialogue(GetCurrentDialogueHandle());
+}
+
+UDialogueSpeakerComponent* ADialogueController::GetSpeaker(FName InName) 
+	const
+{
+	return CurrentInstance ? CurrentInstance->GetSpeaker(InName) : nullptr;
+}
+
+int32 ADialogueController::GetCurrentDialogueHandle() const
+{
+	return CurrentInstance ? CurrentInstance->GetHandle() : INDEX_NONE;
+}
+
+void ADialogueController::SetSpeakerInDialogue(int32 Handle, FName InName,
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	FDialogueInstance* Instance = FindInstance(Handle);
+	if (Instance && InSpeaker)
+	{
+		Instance->SetSpeaker(InName, InSpeaker);
+	}
+}
+
+UDialogueSpeakerComponent* ADialogueController::GetSpeakerInDialogue(
+	int32 Handle, FName InName) const
+{
+	FDialogueInstance* Instance = FindInstance(Handle);
+	return Instance ? Instance->GetSpeaker(InName) : nullptr;
+}
+
+TMap<FName, UDialogueSpeakerComponent*> 
+	ADialogueController::GetSpeakersInDialogue(int32 Handle) const
+{
+	TMap<FName, UDialogueSpeakerComponent*> Speakers;
+
+	if (FDialogueInstance* Instance = FindInstance(Handle))
+	{
+		//Key each bound slot by its role
+		const FDialogueProgram& Program = 
+			Instance->GetDialogue()->GetProgram();
+		const TArray<TObjectPtr<UDialogueSpeakerComponent>>& Slots = 
+			Instance->GetSpeakers();
+		for (int32 i = 0; i < Slots.Num(); ++i)
+		{
+			if (Slots[i])
+			{
+				Speakers.Add(Program.GetSpeakerRole(i), Slots[i]);
+			}
+		}
+	}
+
+	return Speakers;
+}
+
+void ADialogueController::StartDialogueWithNames(UDialogue* InDialogue,
+	const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers, bool bResume)
+{
+	if (!InDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start dialogue. Provided dialogue null.")
+		);
+		return;
+	}
+
+	StartDialogueWithNamesAt(
+		InDialogue,
+		GetStartNodeID(InDialogue, bResume),
+		InSpeakers
+	);
+}
+
+void ADialogueController::StartDialogue(UDialogue* InDialogue,
+	const TArray<UDialogueSpeakerComponent*>& InSpeakers, bool bResume)
+{
+	FDialogueSpeakerSlots Slots;
+	if (!BindSpeakerSlots(InDialogue, InSpeakers, Slots))
+	{
+		return;
+	}
+
+	StartDialogueInSlots(
+		InDialogue, 
+		GetStartNodeID(InDialogue, bResume), 
+		Slots
+	);
+}
+
+void ADialogueController::StartDialogueWithNamesAt(UDialogue* InDialogue, FName NodeID, const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers)
+{
+	if (!InDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start dialogue. Provided dialogue null.")
+		);
+		return;
+	}
+
+	FDialogueSpeakerSlots Slots;
+	BindNamedSpeakerSlots(InDialogue, InSpeakers, Slots);
+	StartDialogueInSlots(InDialogue, NodeID, Slots);
+}
+
+void ADialogueController::StartDialogueInSlots(UDialogue* InDialogue,
+	FName NodeID, TConstArrayView<UDialogueSpeakerComponent*> InSlots)
+{
+	if (!InDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start dialogue. Provided dialogue null.")
+		);
+		return;
+	}
+
+	if (InDialogue->GetCompileStatus() != EDialogueCompileStatus::Compiled)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start dialogue [%s]. Dialogue not compiled."),
+			*InDialogue->GetName()
+		);
+		return;
+	}
+
+	if (!CanOpenDisplay())
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start dialogue. Display could not be opened.")
+		);
+		return;
+	}
+
+	if (!InDialogue->HasNode(NodeID))
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start dialogue from Node: %s. No such node exists."),
+			*NodeID.ToString()
+		);
+		return;
+	}
+
+	TSharedPtr<FDialogueInstance> NewInstance = 
+		CreateInstance(InDialogue, true);
+	if (!NewInstance)
+	{
+		return;
+	}
+
+	//A restore still loading would replace this dialogue when it lands
+	CancelPendingRestore();
+
+	//Replace whatever was playing before without closing the display
+	if (CurrentInstance)
+	{
+		CurrentInstance->Close();
+	}
+
+	CurrentDialogue = InDialogue;
+	CurrentInstance = NewInstance;
+
+	OpenDisplay();
+	NewInstance->Open(
+		InDialogue->GetProgram().FindNode(NodeID), 
+		InSlots
+	);
+	OnDialogueStarted.Broadcast();
+}
+
+void ADialogueController::StartDialogueAt(UDialogue* InDialogue, FName NodeID, const TArray<UDialogueSpeakerComponent*>& InSpeakers)
+{
+	FDialogueSpeakerSlots Slots;
+	if (!BindSpeakerSlots(InDialogue, InSpeakers, Slots))
+	{
+		return;
+	}
+
+	StartDialogueInSlots(InDialogue, NodeID, Slots);
+}
+
+bool ADialogueController::SnapshotDialogue(
+	FDialogueInstanceSnapshot& OutSnapshot) const
+{
+	return CurrentInstance && CurrentInstance->TakeSnapshot(OutSnapshot);
+}
+
+bool ADialogueController::RestoreDialogue(
+	const FDialogueInstanceSnapshot& InSnapshot,
+	const TArray<UDialogueSpeakerComponent*>& InSpeakers)
+{
+	//Loading here would hitch the game thread, mid level stream at worst
+	UDialogue* RestoredDialogue = InSnapshot.Dialogue.Get();
+	if (!RestoredDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not restore dialogue [%s]. Dialogue not loaded; use RestoreDialogueAsync to stream it in."),
+			*InSnapshot.Dialogue.ToString()
+		);
+		return false;
+	}
+
+	if (RestoredDialogue->GetCompileStatus() 
+		!= EDialogueCompileStatus::Compiled)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not restore dialogue [%s]. Dialogue not compiled."),
+			*InSnapshot.Dialogue.ToString()
+		);
+		return false;
+	}
+
+	const FDialogueProgram& Program = RestoredDialogue->GetProgram();
+	if (FDialogueInstance::FindSnapshotNode(Program, InSnapshot) 
+		== INDEX_NONE)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not restore dialogue [%s]. Node %s no longer exists."),
+			*RestoredDialogue->GetName(),
+			*InSnapshot.ActiveNodeID.ToString()
+		);
+		return false;
+	}
+
+	if (!CanOpenDisplay())
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not restore dialogue. Display could not be opened.")
+		);
+		return false;
+	}
+
+	//Bind each role to the speaker that filled it, by dialogue name
+	UDialogueManagerSubsystem* DialogueSubsystem = GetWorld()
+		? GetWorld()->GetSubsystem<UDialogueManagerSubsystem>()
+		: nullptr;
+	FDialogueSpeakerSlots Slots;
+	Slots.SetNumZeroed(Program.GetNumSpeakerSlots());
+	for (int32 i = 0; i < InSnapshot.SpeakerRoles.Num(); ++i)
+	{
+		const int32 Slot = 
+			Program.FindSpeakerSlot(InSnapshot.SpeakerRoles[i]);
+		const FName SpeakerName = InSnapshot.SpeakerNames.IsValidIndex(i)
+			? InSnapshot.SpeakerNames[i] : NAME_None;
+		if (!Slots.IsValidIndex(Slot) || SpeakerName.IsNone())
+		{
+			continue;
+		}
+
+		UDialogueSpeakerComponent* const* Found = InSpeakers.FindByPredicate(
+			[SpeakerName](const UDialogueSpeakerComponent* Speaker)
+			{
+				return Speaker && Speaker->GetDialogueName() == SpeakerName;
+			}
+		);
+		if (Found)
+		{
+			Slots[Slot] = *Found;
+		}
+		else if (DialogueSubsystem)
+		{
+			TConstArrayView<UDialogueSpeakerComponent*> Registered = 
+				DialogueSubsystem->GetSpeakerRegistry().FindByName(
+					SpeakerName
+				);
+			Slots[Slot] = Registered.IsEmpty() ? nullptr : Registered[0];
+		}
+	}
+
+	TSharedPtr<FDialogueInstance> NewInstance = 
+		CreateInstance(RestoredDialogue, true);
+	if (!NewInstance)
+	{
+		return false;
+	}
+
+	CancelPendingRestore();
+
+	//Replace whatever was playing before without closing the display
+	if (CurrentInstance)
+	{
+		CurrentInstance->Close();
+	}
+
+	CurrentDialogue = RestoredDialogue;
+	CurrentInstance = NewInstance;
+
+	OpenDisplay();
+	const bool bRestored = NewInstance->Restore(InSnapshot, Slots);
+	OnDialogueStarted.Broadcast();
+	return bRestored;
+}
+
+bool ADialogueController::RestoreDialogueAsync(
+	const FDialogueInstanceSnapshot& InSnapshot,
+	const TArray<UDialogueSpeakerComponent*>& InSpeakers)
+{
+	if (InSnapshot.Dialogue.IsNull())
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not restore dialogue. Snapshot names no dialogue.")
+		);
+		return false;
+	}
+
+	if (!InSnapshot.Dialogue.IsPending() || !UAssetManager::IsInitialized())
+	{
+		return RestoreDialogue(InSnapshot, InSpeakers);
+	}
+
+	//The speakers may be gone by the time the dialogue arrives
+	TArray<TWeakObjectPtr<UDialogueSpeakerComponent>> WeakSpeakers;
+	WeakSpeakers.Reserve(InSpeakers.Num());
+	for (UDialogueSpeakerComponent* Speaker : InSpeakers)
+	{
+		WeakSpeakers.Add(Speaker);
+	}
+
+	CancelPendingRestore();
+	RestoreLoadHandle = 
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			InSnapshot.Dialogue.ToSoftObjectPath(),
+			FStreamableDelegate::CreateWeakLambda(
+				this,
+				[this, Snapshot = InSnapshot, 
+					WeakSpeakers = MoveTemp(WeakSpeakers)]()
+				{
+					RestoreLoadHandle.Reset();
+
+					TArray<UDialogueSpeakerComponent*> Speakers;
+					Speakers.Reserve(WeakSpeakers.Num());
+					for (const auto& Speaker : WeakSpeakers)
+					{
+						if (UDialogueSpeakerComponent* Valid = Speaker.Get())
+						{
+							Speakers.Add(Valid);
+						}
+					}
+
+					RestoreDialogue(Snapshot, Speakers);
+				}
+			),
+			FStreamableManager::AsyncLoadHighPriority
+		);
+
+	return true;
+}
+
+void ADialogueController::CancelPendingRestore()
+{
+	if (!RestoreLoadHandle.IsValid())
+	{
+		return;
+	}
+
+	//Cancelling also drops the completion callback
+	if (RestoreLoadHandle->IsLoadingInProgress())
+	{
+		RestoreLoadHandle->CancelHandle();
+	}
+	else
+	{
+		RestoreLoadHandle->ReleaseHandle();
+	}
+	RestoreLoadHandle.Reset();
+}
+
+void ADialogueController::EndDialogue()
+{
+	CloseDisplay();
+	OnDialogueEnded.Broadcast();
+
+	if (CurrentInstance)
+	{
+		//Clear the instance first so closing cannot re-enter this
+		TSharedPtr<FDialogueInstance> EndedInstance = 
+			MoveTemp(CurrentInstance);
+		EndedInstance->Close();
+	}
+
+	CurrentDialogue = nullptr;
+}
+
+int32 ADialogueController::StartAmbientDialogue(UDialogue* InDialogue,
+	const TArray<UDialogueSpeakerComponent*>& InSpeakers, bool bResume)
+{
+	if (!InDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start ambient dialogue. Provided dialogue null.")
+		);
+		return INDEX_NONE;
+	}
+
+	FDialogueSpeakerSlots Slots;
+	if (!BindSpeakerSlots(InDialogue, InSpeakers, Slots))
+	{
+		return INDEX_NONE;
+	}
+
+	return StartAmbientDialogueInSlots(
+		InDialogue, 
+		GetStartNodeID(InDialogue, bResume),
+		Slots
+	);
+}
+
+int32 ADialogueController::StartAmbientDialogueInSlots(UDialogue* InDialogue,
+	FName NodeID, TConstArrayView<UDialogueSpeakerComponent*> InSlots)
+{
+	if (!InDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not start ambient dialogue. Provided dialogue null.")
+		);
+		return INDEX_NONE;
+	}
+
+	TSharedPtr<FDialogueInstance> NewInstance = 
+		CreateInstance(InDialogue, false);
+	if (!NewInstance)
+	{
+		return INDEX_NONE;
+	}
+
+	//Pick the fidelity up front so a far away dialogue never starts audio
+	NewInstance->SetFidelity(
+		EvaluateAmbientFidelityFor(NewInstance->GetHandle(), InSlots)
+	);
+
+	AmbientInstances.Add(NewInstance);
+	if (!AmbientFidelityHandle.IsValid())
+	{
+		GetWorldTimerManager().SetTimer(
+			AmbientFidelityHandle,
+			this,
+			&ADialogueController::UpdateAmbientFidelity,
+			GetDefault<UDialogueSettings>()->AmbientFidelityUpdateInterval,
+			true
+		);
+	}
+
+	NewInstance->Open(InDialogue->GetProgram().FindNode(NodeID), InSlots);
+
+	//The dialogue may have run to its end without waiting on anything
+	return NewInstance->IsActive() ? NewInstance->GetHandle() : INDEX_NONE;
+}
+
+void ADialogueController::EndAmbientDialogue(int32 Handle)
+{
+	const int32 FoundIndex = AmbientInstances.IndexOfByPredicate(
+		[Handle](const TSharedPtr<FDialogueInstance>& Instance)
+		{
+			return Instance->GetHandle() == Handle;
+		}
+	);
+
+	if (FoundIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	//Remove the instance first so closing cannot re-enter this
+	TSharedPtr<FDialogueInstance> EndedInstance = AmbientInstances[FoundIndex];
+	AmbientInstances.RemoveAtSwap(FoundIndex);
+	EndedInstance->Close();
+
+	OnAmbientDialogueEnded.Broadcast(Handle);
+}
+
+int32 ADialogueController::GetNumAmbientDialogues() const
+{
+	return AmbientInstances.Num();
+}
+
+EDialogueFidelity ADialogueController::GetAmbientDialogueFidelity(
+	int32 Handle) const
+{
+	const FDialogueInstance* Instance = FindAmbientInstance(Handle);
+	return Instance ? Instance->GetFidelity() : EDialogueFidelity::StateOnly;
+}
+
+void ADialogueController::SetDialogueTimeScale(float InTimeScale)
+{
+	if (CurrentInstance)
+	{
+		CurrentInstance->SetTimeScale(InTimeScale);
+	}
+}
+
+void ADialogueController::SetAmbientDialogueTimeScale(int32 Handle, 
+	float InTimeScale)
+{
+	if (FDialogueInstance* Instance = FindAmbientInstance(Handle))
+	{
+		Instance->SetTimeScale(InTimeScale);
+	}
+}
+
+EDialogueFidelity ADialogueController::EvaluateAmbientFidelity_Implementation(
+	int32 Handle, float DistanceToViewer) const
+{
+	const UDialogueSettings* Settings = GetDefault<UDialogueSettings>();
+	if (DistanceToViewer <= Settings->AmbientFullFidelityDistance)
+	{
+		return EDialogueFidelity::Full;
+	}
+
+	if (DistanceToViewer <= Settings->AmbientTextFidelityDistance)
+	{
+		return EDialogueFidelity::TextOnly;
+	}
+
+	return EDialogueFidelity::StateOnly;
+}
+
+void ADialogueController::EndDialogueInstance(FDialogueInstance& InInstance)
+{
+	if (CurrentInstance.Get() == &InInstance)
+	{
+		EndDialogue();
+	}
+	else
+	{
+		EndAmbientDialogue(InInstance.GetHandle());
+	}
+}
+
+FDialogueInstance* ADialogueController::FindAmbientInstance(int32 Handle) 
+	const
+{
+	for (const TSharedPtr<FDialogueInstance>& Instance : AmbientInstances)
+	{
+		if (Instance->GetHandle() == Handle)
+		{
+			return Instance.Get();
+		}
+	}
+
+	return nullptr;
+}
+
+FDialogueInstance* ADialogueController::FindInstance(int32 Handle) const
+{
+	if (Handle == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	if (CurrentInstance && CurrentInstance->GetHandle() == Handle)
+	{
+		return CurrentInstance.Get();
+	}
+
+	return FindAmbientInstance(Handle);
+}
+
+void ADialogueController::UpdateAmbientFidelity()
+{
+	if (AmbientInstances.IsEmpty())
+	{
+		GetWorldTimerManager().ClearTimer(AmbientFidelityHandle);
+		return;
+	}
+
+	//Cutting off a line can move a dialogue on to its end, so work from a
+	//copy of the list
+	TArray<TSharedPtr<FDialogueInstance>, TInlineAllocator<64>> Instances(
+		AmbientInstances
+	);
+
+	for (const TSharedPtr<FDialogueInstance>& Instance : Instances)
+	{
+		if (Instance->IsActive())
+		{
+			Instance->SetFidelity(EvaluateAmbientFidelityFor(
+				Instance->GetHandle(),
+				Instance->GetSpeakers()
+			));
+		}
+	}
+}
+
+template<typename SpeakerRangeType>
+EDialogueFidelity ADialogueController::EvaluateAmbientFidelityFor(
+	int32 Handle, const SpeakerRangeType& InSpeakers) const
+{
+	//Without a local player there is no one to present to, so keep to the
+	//full dialogue as before
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	APlayerController* Player = GetWorld()->GetFirstPlayerController();
+	if (!Player)
+	{
+		return EvaluateAmbientFidelity(Handle, 0.f);
+	}
+	Player->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	double MinDistSq = MAX_dbl;
+	for (UDialogueSpeakerComponent* Speaker : InSpeakers)
+	{
+		if (Speaker)
+		{
+			MinDistSq = FMath::Min(MinDistSq, FVector::DistSquared(
+				Speaker->GetComponentLocation(), 
+				ViewLocation
+			));
+		}
+	}
+
+	const float Distance = MinDistSq == MAX_dbl 
+		? 0.f : static_cast<float>(FMath::Sqrt(MinDistSq));
+	return EvaluateAmbientFidelity(Handle, Distance);
+}
+
+void ADialogueController::Skip() const
+{
+	if (CurrentInstance)
+	{
+		CurrentInstance->Skip();
+	}
+}
+
+void ADialogueController::ClearNodeVisits()
+{
+	if (CurrentDialogue)
+	{
+		ClearAllNodeVisitsForDialogue(CurrentDialogue);
+	}
+}
+
+void ADialogueController::SetSpeaker(FName InName,
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	if (CurrentInstance && InSpeaker)
+	{
+		CurrentInstance->SetSpeaker(InName, InSpeaker);
+	}
+}
+
+FDialogueRecords ADialogueController::GetDialogueRecords() const
+{
+	return DialogueRecords;
+}
+
+void ADialogueController::ClearDialogueRecords()
+{
+	DialogueRecords.Records.Empty();
+	DialogueRecords.KeyedRecords.Empty();
+	DialogueRecords.Blackboard.Reset();
+	++BlackboardGeneration;
+	NotifyDialogueStateChanged();
+	DirtyRecordKeys.Reset();
+	bAllRecordsDirty = true;
+
+	if (Journal)
+	{
+		Journal->RecordReplace(DialogueRecords);
+	}
+}
+
+void ADialogueController::ImportDialogueRecords(
+	const FDialogueRecords& InRecords)
+{
+	DialogueRecords = InRecords;
+	++BlackboardGeneration;
+	NotifyDialogueStateChanged();
+	DirtyRecordKeys.Reset();
+	bAllRecordsDirty = true;
+
+	if (Journal)
+	{
+		Journal->RecordReplace(DialogueRecords);
+	}
+}
+
+void ADialogueController::SaveDialogueRecordsToBytes(bool bOnlyChanged,
+	TArray<uint8>& OutBytes)
+{
+	//Records replaced since the last save can only be written in full
+	const bool bPartial = bOnlyChanged && !bAllRecordsDirty;
+	FDialogueRecordsSerializer::Save(
+		DialogueRecords,
+		bPartial ? &DirtyRecordKeys : nullptr,
+		!bPartial || DialogueRecords.Blackboard.IsDirty(),
+		OutBytes
+	);
+
+	ClearDirtyRecords();
+}
+
+bool ADialogueController::LoadDialogueRecordsFromBytes(
+	const TArray<uint8>& InBytes)
+{
+	bool bPartial = false;
+	if (!FDialogueRecordsSerializer::Load(InBytes, DialogueRecords, bPartial))
+	{
+		return false;
+	}
+
+	++BlackboardGeneration;
+	NotifyDialogueStateChanged();
+	ClearDirtyRecords();
+
+	if (Journal)
+	{
+		Journal->RecordReplace(DialogueRecords);
+	}
+	return true;
+}
+
+void ADialogueController::SaveDialogueRecordsAsync(const FString& InSlotName,
+	int32 InUserIndex)
+{
+	if (!Journal)
+	{
+		Journal = MakeShared<FDialogueRecordsJournal>(DialogueRecords);
+	}
+
+	Journal->SaveAsync(InSlotName, InUserIndex);
+}
+
+bool ADialogueController::LoadDialogueRecordsFromSlot(
+	const FString& InSlotName, int32 InUserIndex)
+{
+	//The slot may still be being written
+	WaitForDialogueSaves();
+
+	TArray<uint8> Bytes;
+	return FDialogueRecordsJournal::LoadFromSlot(InSlotName, InUserIndex,
+		Bytes) && LoadDialogueRecordsFromBytes(Bytes);
+}
+
+void ADialogueController::WaitForDialogueSaves() const
+{
+	if (Journal)
+	{
+		Journal->WaitForSaves();
+	}
+}
+
+bool ADialogueController::HasDialogueRecord(UDialogue* InDialogue) const
+{
+	return InDialogue && FindRecord(InDialogue);
+}
+
+bool ADialogueController::WasNodeVisitedByID(UDialogue* InDialogue,
+	FName InNodeID) const
+{
+	return InDialogue && WasNodeVisited(
+		InDialogue, 
+		InDialogue->GetProgram().FindNode(InNodeID)
+	);
+}
+
+FName ADialogueController::GetResumeNodeID(UDialogue* InDialogue) const
+{
+	const FDialogueNodeVisits* Record = 
+		InDialogue ? FindRecord(InDialogue) : nullptr;
+	return Record ? Record->ResumeNodeID : NAME_None;
+}
+
+void ADialogueController::SetBlackboardBool(FName InKey, bool bInValue)
+{
+	FDialogueBlackboardValue Value;
+	Value.Number = bInValue ? 1.0 : 0.0;
+	WriteBlackboard(InKey, EDialogueBlackboardType::Bool, Value);
+}
+
+void ADialogueController::SetBlackboardInt(FName InKey, int32 InValue)
+{
+	FDialogueBlackboardValue Value;
+	Value.Number = InValue;
+	WriteBlackboard(InKey, EDialogueBlackboardType::Int, Value);
+}
+
+void ADialogueController::SetBlackboardFloat(FName InKey, float InValue)
+{
+	FDialogueBlackboardValue Value;
+	Value.Number = InValue;
+	WriteBlackboard(InKey, EDialogueBlackboardType::Float, Value);
+}
+
+void ADialogueController::SetBlackboardName(FName InKey, FName InValue)
+{
+	FDialogueBlackboardValue Value;
+	Value.Name = InValue;
+	WriteBlackboard(InKey, EDialogueBlackboardType::Name, Value);
+}
+
+void ADialogueController::SetBlackboardTag(FName InKey, FGameplayTag InValue)
+{
+	FDialogueBlackboardValue Value;
+	Value.Tag = InValue;
+	WriteBlackboard(InKey, EDialogueBlackboardType::Tag, Value);
+}
+
+bool ADialogueController::GetBlackboardBool(FName InKey) const
+{
+	const FDialogueBlackboardValue* Value = 
+		DialogueRecords.Blackboard.Find(InKey);
+	return Value && Value->Number != 0.0;
+}
+
+int32 ADialogueController::GetBlackboardInt(FName InKey) const
+{
+	const FDialogueBlackboardValue* Value = 
+		DialogueRecords.Blackboard.Find(InKey);
+	return Value ? FMath::TruncToInt32(Value->Number) : 0;
+}
+
+float ADialogueController::GetBlackboardFloat(FName InKey) const
+{
+	const FDialogueBlackboardValue* Value = 
+		DialogueRecords.Blackboard.Find(InKey);
+	return Value ? static_cast<float>(Value->Number) : 0.f;
+}
+
+FName ADialogueController::GetBlackboardName(FName InKey) const
+{
+	const FDialogueBlackboardValue* Value = 
+		DialogueRecords.Blackboard.Find(InKey);
+	return Value ? Value->Name : NAME_None;
+}
+
+FGameplayTag ADialogueController::GetBlackboardTag(FName InKey) const
+{
+	const FDialogueBlackboardValue* Value = 
+		DialogueRecords.Blackboard.Find(InKey);
+	return Value ? Value->Tag : FGameplayTag();
+}
+
+FDialogueBlackboard& ADialogueController::GetBlackboard()
+{
+	return DialogueRecords.Blackboard;
+}
+
+uint32 ADialogueController::GetBlackboardGeneration() const
+{
+	return BlackboardGeneration;
+}
+
+void ADialogueController::NotifyDialogueStateChanged()
+{
+	++DialogueStateEpoch;
+}
+
+uint32 ADialogueController::GetDialogueStateEpoch() const
+{
+	return DialogueStateEpoch;
 }
 
-void ADialogueController::SelectOption(int32 InOptionIndex) const
+int32 ADialogueController::FindOrAddBlackboardSlot(FName InKey,
+	EDialogueBlackboardType InType)
 {
-	if (CurrentDialogue)
+	FDialogueBlackboard& Blackboard = DialogueRecords.Blackboard;
+	const int32 NumKeys = Blackboard.Num();
+	const int32 Slot = Blackboard.FindOrAddSlot(InKey, InType);
+
+	//Saves need to know about added keys, even unwritten ones
+	if (Blackboard.Num() != NumKeys)
 	{
-		CurrentDialogue->SelectOption(InOptionIndex);
+		JournalBlackboardSlot(Slot);
 	}
+
+	return Slot;
 }
 
-TMap<FName, UDialogueSpeakerComponent*> ADialogueController::GetSpeakers() const
+void ADialogueController::WriteBlackboardSlot(int32 InSlot,
+	const FDialogueBlackboardValue& InValue)
 {
-	if (CurrentDialogue)
+	if (DialogueRecords.Blackboard.IsValidSlot(InSlot))
 	{
-		return CurrentDialogue->GetAllSpeakers();
+		DialogueRecords.Blackboard.SetValue(InSlot, InValue);
+		JournalBlackboardSlot(InSlot);
+		NotifyDialogueStateChanged();
 	}
+}
 
-	return TMap<FName, UDialogueSpeakerComponent*>();
+void ADialogueController::WriteBlackboard(FName InKey, 
+	EDialogueBlackboardType InType, const FDialogueBlackboardValue& InValue)
+{
+	WriteBlackboardSlot(FindOrAddBlackboardSlot(InKey, InType), InValue);
 }
 
-void ADialogueController::StartDialogueWithNames(UDialogue* InDialogue,
-	TMap<FName, UDialogueSpeakerComponent*> InSpeakers, bool bResume)
+bool ADialogueController::SpeakerInCurrentDialogue(UDialogueSpeakerComponent* TargetSpeaker) const
 {
-	if (!InDialogue)
+	//If no active dialogue, then automatically false
+	return CurrentInstance && CurrentInstance->HasSpeaker(TargetSpeaker);
+}
+
+void ADialogueController::MarkNodeVisited(UDialogue* TargetDialogue, int32 NodeIndex)
+{
+	if (!TargetDialogue || TargetDialogue->GetDialogueKey() == 0)
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Could not start dialogue. Provided dialogue null.")
-		);
 		return;
 	}
 
-	if (InDialogue->GetCompileStatus() != EDialogueCompileStatus::Compiled)
+	const int32 VisitIndex = 
+		TargetDialogue->GetProgram().GetVisitIndex(NodeIndex);
+	if (VisitIndex == INDEX_NONE)
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Could not start dialogue [%s]. Dialogue not compiled."),
-			*InDialogue->GetName()
-		);
 		return;
 	}
 
-	if (!CanOpenDisplay())
+	//Mark the node visited in the record. Revisits change nothing queries
+	//could read, so they keep cached results.
+	FDialogueNodeVisits& Record = FindOrAddRecord(TargetDialogue);
+	if (!Record.IsVisited(VisitIndex))
+	{
+		Record.SetVisited(VisitIndex, true);
+		MarkRecordDirty(TargetDialogue);
+		NotifyDialogueStateChanged();
+
+		if (Journal)
+		{
+			Journal->RecordSetVisited(TargetDialogue->GetDialogueKey(),
+				VisitIndex, true);
+		}
+	}
+}
+
+void ADialogueController::MarkNodeUnvisited(UDialogue* TargetDialogue, int32 NodeIndex)
+{
+	if (!TargetDialogue)
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Could not start dialogue. CanOpenDisplay() was false.")
-		);
 		return;
 	}
 
-	//Set the target dialogue 
-	CurrentDialogue = InDialogue;
+	//Nodes without a visit slot were never recorded
+	const int32 VisitIndex = 
+		TargetDialogue->GetProgram().GetVisitIndex(NodeIndex);
+	if (VisitIndex == INDEX_NONE)
+	{
+		return;
+	}
 
-	//Get start node 
-	FName StartNodeID = CurrentDialogue->GetRootNode()->GetNodeID();
-	FName RecordName = CurrentDialogue->GetFName();
-	if (bResume
-		&& DialogueRecords.Records.Contains(RecordName))
+	//If there is no record of that dialogue, do nothing
+	if (!FindRecord(TargetDialogue))
 	{
-		const FDialogueNodeVisits& Record =
-			DialogueRecords.Records[RecordName];
-		StartNodeID = CurrentDialogue->HasNode(Record.ResumeNodeID) ?
-			Record.ResumeNodeID : StartNodeID;
+		return;
 	}
 
-	//Start the dialogue 
-	OpenDisplay();
-	CurrentDialogue->OpenDialogueAt(StartNodeID, this, InSpeakers);
-	OnDialogueStarted.Broadcast();
+	//If there is a record, clear the node's bit
+	FindOrAddRecord(TargetDialogue).SetVisited(VisitIndex, false);
+	MarkRecordDirty(TargetDialogue);
+	NotifyDialogueStateChanged();
+
+	if (Journal)
+	{
+		Journal->RecordSetVisited(TargetDialogue->GetDialogueKey(),
+			VisitIndex, false);
+	}
 }
 
-void ADialogueController::StartDialogue(UDialogue* InDialogue,
-	TArray<UDialogueSpeakerComponent*> InSpeakers, bool bResume)
+void ADialogueController::ClearAllNodeVisitsForDialogue(UDialogue* TargetDialogue)
 {
-	if (InSpeakers.IsEmpty())
+	if (!TargetDialogue)
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Warning,
-			TEXT("No speakers provided on dialogue start.")
-		);
 		return;
 	}
 
-	TMap<FName, UDialogueSpeakerComponent*> TargetSpeakers;
-	for (UDialogueSpeakerComponent* Speaker : InSpeakers)
+	//If there is no record of that dialogue, do nothing
+	if (!FindRecord(TargetDialogue))
 	{
-		if (Speaker == nullptr)
-		{
-			UE_LOG(
-				LogDialogueTree,
-				Error,
-				TEXT("Could not start dialogue. Invalid speaker provided.")
-			);
-			return;
-		}
-
-		if (Speaker->GetDialogueName().IsNone())
-		{
-			UE_LOG(
-				LogDialogueTree,
-				Error,
-				TEXT("Could not start dialogue. A provided speaker has an"
-					" unfilled DialogueName.")
-			);
-			return;
-		}
+		return;
+	}
 
-		if (TargetSpeakers.Contains(Speaker->GetDialogueName()))
-		{
-			UE_LOG(
-				LogDialogueTree,
-				Error,
-				TEXT("Could not start dialogue. Multiple provided speakers "
-					"share a DialogueName.")
-			);
-			return;
-		}
+	FindOrAddRecord(TargetDialogue).ClearVisits();
+	MarkRecordDirty(TargetDialogue);
+	NotifyDialogueStateChanged();
 
-		TargetSpeakers.Add(Speaker->GetDialogueName(), Speaker);
+	if (Journal)
+	{
+		Journal->RecordClearVisits(TargetDialogue->GetDialogueKey());
 	}
-
-	StartDialogueWithNames(InDialogue, TargetSpeakers, bResume);
 }
 
-void ADialogueController::StartDialogueWithNamesAt(UDialogue* InDialogue, FName NodeID, TMap<FName, UDialogueSpeakerComponent*> InSpeakers)
+bool ADialogueController::WasNodeVisited(const UDialogue* TargetDialogue,
+	int32 NodeIndex) const
 {
-	if (!InDialogue)
+	if (!TargetDialogue)
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Could not start dialogue. Provided dialogue null.")
-		);
-		return;
+		return false;
 	}
 
-	if (InDialogue->GetCompileStatus() != EDialogueCompileStatus::Compiled)
+	const FDialogueNodeVisits* Record = FindRecord(TargetDialogue);
+	if (!Record)
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Could not start dialogue [%s]. Dialogue not compiled."),
-			*InDialogue->GetName()
-		);
-		return;
+		return false;
 	}
 
-	if (!CanOpenDisplay())
+	const FDialogueProgram& Program = TargetDialogue->GetProgram();
+	if (Record->IsVisited(Program.GetVisitIndex(NodeIndex)))
 	{
-		UE_LOG(
-			LogDialogueTree,
-			Error,
-			TEXT("Could not start dialogue. Display could not be opened.")
+		return true;
+	}
+
+	//Records imported from older saves are only migrated on first write
+	return !Record->VisitedNodeIDs.IsEmpty() && Program.IsValidNode(NodeIndex)
+		&& Record->VisitedNodeIDs.Contains(
+			Program.GetNodeObject(NodeIndex)->GetNodeID()
 		);
+}
+
+void ADialogueController::SetResumeNode(UDialogue* InDialogue, FName InNodeID)
+{
+	if (!InDialogue || InNodeID.IsNone())
+	{
 		return;
 	}
 
-	if (!InDialogue->HasNode(NodeID))
+	//Set the record's resume node, by stable ID where the node has one
+	const FDialogueProgram& Program = InDialogue->GetProgram();
+	FDialogueNodeVisits& Record = FindOrAddRecord(InDialogue);
+	Record.ResumeNodeID = InNodeID;
+	Record.ResumeNodeKey = Program.GetStableID(Program.FindNode(InNodeID));
+	MarkRecordDirty(InDialogue);
+
+	if (Journal)
+	{
+		Journal->RecordSetResumeNode(InDialogue->GetDialogueKey(), 
+			Record.ResumeNodeID, Record.ResumeNodeKey);
+	}
+}
+
+bool ADialogueController::BindSpeakerSlots(const UDialogue* InDialogue,
+	TConstArrayView<UDialogueSpeakerComponent*> InSpeakers,
+	FDialogueSpeakerSlots& OutSlots) const
+{
+	if (!InDialogue)
 	{
 		UE_LOG(
 			LogDialogueTree,
 			Error,
-			TEXT("Could not start dialogue from Node: %s. No such node exists."),
-			*NodeID.ToString()
+			TEXT("Could not start dialogue. Provided dialogue null.")
 		);
-		return;
+		return false;
 	}
 
-	CurrentDialogue = InDialogue;
-
-	OpenDisplay();
-	CurrentDialogue->OpenDialogueAt(NodeID, this, InSpeakers);
-	OnDialogueStarted.Broadcast();
-}
+	const FDialogueProgram& Program = InDialogue->GetProgram();
+	OutSlots.Reset();
+	OutSlots.SetNumZeroed(Program.GetNumSpeakerSlots());
 
-void ADialogueController::StartDialogueAt(UDialogue* InDialogue, FName NodeID, TArray<UDialogueSpeakerComponent*> InSpeakers)
-{
 	if (InSpeakers.IsEmpty())
 	{
 		UE_LOG(
@@ -208,10 +1213,9 @@ void ADialogueController::StartDialogueAt(UDialogue* InDialogue, FName NodeID, T
 			Warning,
 			TEXT("No speakers provided on dialogue start.")
 		);
-		return;
+		return false;
 	}
 
-	TMap<FName, UDialogueSpeakerComponent*> TargetSpeakers;
 	for (UDialogueSpeakerComponent* Speaker : InSpeakers)
 	{
 		if (Speaker == nullptr)
@@ -221,7 +1225,7 @@ void ADialogueController::StartDialogueAt(UDialogue* InDialogue, FName NodeID, T
 				Error,
 				TEXT("Could not start dialogue. Invalid speaker provided.")
 			);
-			return;
+			return false;
 		}
 
 		if (Speaker->GetDialogueName().IsNone())
@@ -232,21 +1236,17 @@ void ADialogueController::StartDialogueAt(UDialogue* InDialogue, FName NodeID, T
 				TEXT("Could not start dialogue. A provided speaker has an"
 					" unfilled DialogueName.")
 			);
-			return;
+			return false;
 		}
 
-		if (!InDialogue->HasNode(NodeID))
+		//Speakers the dialogue has no role for sit the conversation out
+		const int32 Slot = Program.FindSpeakerSlot(Speaker->GetDialogueName());
+		if (Slot == INDEX_NONE)
 		{
-			UE_LOG(
-				LogDialogueTree,
-				Error,
-				TEXT("Could not start dialogue from Node: %s. No such node exists."),
-				*NodeID.ToString()
-			);
-			return;
+			continue;
 		}
 
-		if (TargetSpeakers.Contains(Speaker->GetDialogueName()))
+		if (OutSlots[Slot] != nullptr)
 		{
 			UE_LOG(
 				LogDialogueTree,
@@ -254,207 +1254,150 @@ void ADialogueController::StartDialogueAt(UDialogue* InDialogue, FName NodeID, T
 				TEXT("Could not start dialogue. Multiple provided speakers "
 					"share a DialogueName.")
 			);
-			return;
+			return false;
 		}
 
-		TargetSpeakers.Add(Speaker->GetDialogueName(), Speaker);
+		OutSlots[Slot] = Speaker;
 	}
 
-	StartDialogueWithNamesAt(InDialogue, NodeID, TargetSpeakers);
+	return true;
 }
 
-void ADialogueController::EndDialogue()
+void ADialogueController::BindNamedSpeakerSlots(const UDialogue* InDialogue,
+	const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers,
+	FDialogueSpeakerSlots& OutSlots) const
 {
-	CloseDisplay();
-	OnDialogueEnded.Broadcast();
+	const FDialogueProgram& Program = InDialogue->GetProgram();
+	OutSlots.Reset();
+	OutSlots.SetNumZeroed(Program.GetNumSpeakerSlots());
 
-	if (CurrentDialogue)
+	for (const auto& Entry : InSpeakers)
 	{
-		//Clear any behavior flags from the speakers and stop speaking
-		for (auto& Entry : CurrentDialogue->GetAllSpeakers())
+		const int32 Slot = Program.FindSpeakerSlot(Entry.Key);
+		if (Slot != INDEX_NONE && Entry.Value != nullptr)
 		{
-			if (Entry.Value)
-			{
-				Entry.Value->Stop();
-				Entry.Value->ClearGameplayTags();
-			}
+			OutSlots[Slot] = Entry.Value;
 		}
-
-		CurrentDialogue->ClearController();
-		CurrentDialogue = nullptr;
-	}
-}
-
-void ADialogueController::Skip() const
-{
-	if (CurrentDialogue)
-	{
-		CurrentDialogue->Skip();
 	}
 }
 
-void ADialogueController::ClearNodeVisits()
+FName ADialogueController::GetStartNodeID(UDialogue* InDialogue,
+	bool bResume) const
 {
-	if (CurrentDialogue)
-	{
-		ClearAllNodeVisitsForDialogue(CurrentDialogue);
-	}
-}
+	UDialogueNode* RootNode = InDialogue->GetRootNode();
+	const FName StartNodeID = RootNode ? RootNode->GetNodeID() : NAME_None;
 
-void ADialogueController::SetSpeaker(FName InName,
-	UDialogueSpeakerComponent* InSpeaker)
-{
-	if (CurrentDialogue && InSpeaker)
+	const FDialogueNodeVisits* Record = 
+		bResume ? FindRecord(InDialogue) : nullptr;
+	if (!Record)
 	{
-		CurrentDialogue->SetSpeaker(InName, InSpeaker);
+		return StartNodeID;
 	}
-}
-
-FDialogueRecords ADialogueController::GetDialogueRecords() const
-{
-	return DialogueRecords;
-}
-
-void ADialogueController::ClearDialogueRecords()
-{
-	DialogueRecords.Records.Empty();
-}
-
-void ADialogueController::ImportDialogueRecords(FDialogueRecords InRecords)
-{
-	DialogueRecords = InRecords;
-}
 
-bool ADialogueController::SpeakerInCurrentDialogue(UDialogueSpeakerComponent* TargetSpeaker) const
-{
-	//If no active dialogue, then automatically false
-	if (!CurrentDialogue)
+	//The stable ID follows the node through renames; the ID is only there
+	//for records that predate it
+	const FDialogueProgram& Program = InDialogue->GetProgram();
+	int32 ResumeIndex = Record->ResumeNodeKey != 0
+		? Program.FindNodeByStableID(Record->ResumeNodeKey)
+		: INDEX_NONE;
+	if (ResumeIndex == INDEX_NONE)
 	{
-		return false;
+		ResumeIndex = Program.FindNode(Record->ResumeNodeID);
 	}
-
-	//Retrieve speakers
-	TMap<FName, UDialogueSpeakerComponent*> Speakers =
-		CurrentDialogue->GetAllSpeakers();
-	TArray<FName> SpeakerRoles;
-	Speakers.GetKeys(SpeakerRoles);
-
-	//If any one speaker matches the target, true
-	for (FName NextRole : SpeakerRoles)
+	if (ResumeIndex == INDEX_NONE)
 	{
-		if (Speakers[NextRole] == TargetSpeaker)
-		{
-			return true;
-		}
+		ResumeIndex = Program.FindRenamedNode(Record->ResumeNodeID);
 	}
 
-	//No speakers matched the target, false
-	return false;
+	return ResumeIndex != INDEX_NONE
+		? Program.GetNodeObject(ResumeIndex)->GetNodeID()
+		: StartNodeID;
 }
 
-void ADialogueController::MarkNodeVisited(UDialogue* TargetDialogue, FName TargetNodeID)
+TSharedPtr<FDialogueInstance> ADialogueController::CreateInstance(
+	UDialogue* InDialogue, bool bUsesDisplay)
 {
-	if (!TargetDialogue)
-	{
-		return;
-	}
-
-	FName TargetDialogueName = TargetDialogue->GetFName();
-
-	if (TargetDialogueName.IsEqual(NAME_None))
-	{
-		return;
-	}
-
-	//Create a new record if the target record does not exist
-	if (!DialogueRecords.Records.Contains(TargetDialogueName))
+	//Make sure we can start the dialogue 
+	FString ErrorMessage;
+	if (!InDialogue->CanPlay(ErrorMessage))
 	{
-		FDialogueNodeVisits NewRecord;
-		NewRecord.DialogueFName = TargetDialogueName;
-
-		DialogueRecords.Records.Add(TargetDialogueName, NewRecord);
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Cannot play dialogue. %s"),
+			*ErrorMessage
+		);
+		return nullptr;
 	}
 
-	//Mark the node visited in the record 
-	DialogueRecords.Records[TargetDialogueName].VisitedNodeIDs.Add(
-		TargetNodeID
+	return MakeShared<FDialogueInstance>(
+		++NextInstanceHandle,
+		InDialogue,
+		this,
+		bUsesDisplay
 	);
 }
 
-void ADialogueController::MarkNodeUnvisited(UDialogue* TargetDialogue, FName TargetNodeID)
+FDialogueNodeVisits& ADialogueController::FindOrAddRecord(
+	const UDialogue* InDialogue)
 {
-	if (!TargetDialogue)
-	{
-		return;
-	}
-
-	FName TargetDialogueName = TargetDialogue->GetFName();
+	const uint64 Key = InDialogue->GetDialogueKey();
 
-	//If there is no record of that dialogue, do nothing
-	if (!DialogueRecords.Records.Contains(TargetDialogueName))
+	//Create a new record if the target record does not exist, taking over
+	//any record older saves stored by name
+	FDialogueNodeVisits* Record = DialogueRecords.KeyedRecords.Find(Key);
+	const bool bChanged = !Record || !Record->VisitedNodeIDs.IsEmpty();
+	if (!Record)
 	{
-		return;
-	}
-
-	//If there is a record, remove the target index from the visited nodes
-	DialogueRecords.Records[TargetDialogueName].VisitedNodeIDs.Remove(
-		TargetNodeID
-	);
-}
+		const FName RecordName = InDialogue->GetFName();
+		FDialogueNodeVisits LegacyRecord;
+		DialogueRecords.Records.RemoveAndCopyValue(RecordName, LegacyRecord);
 
-void ADialogueController::ClearAllNodeVisitsForDialogue(UDialogue* TargetDialogue)
-{
-	if (!TargetDialogue)
-	{
-		return;
+		Record = &DialogueRecords.KeyedRecords.Add(
+			Key, 
+			MoveTemp(LegacyRecord)
+		);
+		Record->DialogueFName = RecordName;
 	}
 
-	FName TargetDialogueName = TargetDialogue->GetFName();
+	Record->MigrateLegacyVisits(InDialogue->GetProgram());
 
-	//If there is no record of that dialogue, do nothing
-	if (!DialogueRecords.Records.Contains(TargetDialogueName))
+	//Saves cannot migrate on their own, so hand them the result
+	if (bChanged && Journal)
 	{
-		return;
+		Journal->RecordSetRecord(Key, *Record);
 	}
-
-	DialogueRecords.Records[TargetDialogueName].VisitedNodeIDs.Empty();
+	return *Record;
 }
 
-bool ADialogueController::WasNodeVisited(const UDialogue* TargetDialogue,
-	FName TargetNodeID) const
+const FDialogueNodeVisits* ADialogueController::FindRecord(
+	const UDialogue* InDialogue) const
 {
-	if (!TargetDialogue)
-	{
-		return false;
-	}
-
-	FName TargetDialogueName = TargetDialogue->GetFName();
-
-	if (!DialogueRecords.Records.Contains(TargetDialogueName))
-	{
-		return false;
-	}
-
-	FDialogueNodeVisits TargetRecord =
-		DialogueRecords.Records[TargetDialogueName];
+	const FDialogueNodeVisits* Record = 
+		DialogueRecords.KeyedRecords.Find(InDialogue->GetDialogueKey());
+	return Record 
+		? Record 
+		: DialogueRecords.Records.Find(InDialogue->GetFName());
+}
 
-	return TargetRecord.VisitedNodeIDs.Contains(TargetNodeID);
+void ADialogueController::MarkRecordDirty(const UDialogue* InDialogue)
+{
+	DirtyRecordKeys.Add(InDialogue->GetDialogueKey());
 }
 
-void ADialogueController::SetResumeNode(UDialogue* InDialogue, FName InNodeID)
+void ADialogueController::ClearDirtyRecords()
 {
-	if (!InDialogue || InNodeID.IsNone())
-	{
-		return;
-	}
+	DirtyRecordKeys.Reset();
+	bAllRecordsDirty = false;
+	DialogueRecords.Blackboard.ClearDirty();
+}
 
-	//Ensure there is a record
-	FName RecordName = InDialogue->GetFName();
-	if (!DialogueRecords.Records.Contains(RecordName))
+void ADialogueController::JournalBlackboardSlot(int32 InSlot)
+{
+	if (Journal && DialogueRecords.Blackboard.IsValidSlot(InSlot))
 	{
-		DialogueRecords.Records.Add(RecordName);
+		const FDialogueBlackboardEntry& Entry = 
+			DialogueRecords.Blackboard.GetEntries()[InSlot];
+		Journal->RecordSetBlackboard(Entry.Key, Entry.Type, Entry.Value);
 	}
-
-	//Set the record's resume node 
-	DialogueRecords.Records[RecordName].ResumeNodeID = InNodeID;
 }
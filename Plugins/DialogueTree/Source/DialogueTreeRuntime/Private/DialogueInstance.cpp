@@ -0,0 +1,1055 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueInstance.h"
+//UE
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueBlackboard.h"
+#include "DialogueController.h"
+#include "DialogueManagerSubsystem.h"
+#include "DialogueSettings.h"
+#include "DialogueSpeakerComponent.h"
+#include "DialogueTreeStats.h"
+#include "LogDialogueTree.h"
+#include "Nodes/DialogueEventNode.h"
+#include "Nodes/DialogueSpeechNode.h"
+#include "Transitions/DialogueTransition.h"
+
+namespace
+{
+	/**
+	* Fills a buffer sized per compiled element with the given value if the
+	* program's size changed since it was last filled. Warm dialogues keep
+	* the allocation, so they never allocate.
+	*
+	* @param InOutBuffer - BufferType&, a TArray or TBitArray.
+	* @param InValue - const ValueType&, the value to fill with.
+	* @param InNum - int32, the number of elements the program needs.
+	* @return bool - True if the buffer was refilled. False if the size
+	* already matched and the contents were left alone.
+	*/
+	template<typename BufferType, typename ValueType>
+	bool InitIfProgramChanged(BufferType& InOutBuffer, 
+		const ValueType& InValue, int32 InNum)
+	{
+		if (InOutBuffer.Num() == InNum)
+		{
+			return false;
+		}
+
+		InOutBuffer.Init(InValue, InNum);
+		return true;
+	}
+}
+
+FDialogueInstance* FDialogueInstance::Executing = nullptr;
+
+FDialogueInstance::FScope::FScope(FDialogueInstance& InInstance)
+	: Previous(FDialogueInstance::Executing)
+{
+	check(IsInGameThread());
+	FDialogueInstance::Executing = &InInstance;
+}
+
+FDialogueInstance::FScope::~FScope()
+{
+	FDialogueInstance::Executing = Previous;
+}
+
+FDialogueInstance::FDialogueInstance(int32 InHandle, UDialogue* InDialogue,
+	ADialogueController* InController, bool bInUsesDisplay)
+	: Handle(InHandle)
+	, Dialogue(InDialogue)
+	, Controller(InController)
+	, bUsesDisplay(bInUsesDisplay)
+{
+	check(Dialogue && Controller);
+
+	UWorld* World = Controller->GetWorld();
+	UDialogueManagerSubsystem* DialogueSubsystem = World
+		? World->GetSubsystem<UDialogueManagerSubsystem>()
+		: nullptr;
+	if (DialogueSubsystem)
+	{
+		Scheduler = &DialogueSubsystem->GetScheduler();
+	}
+	else
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Warning,
+			TEXT("Dialogue [%s] found no dialogue subsystem to schedule with. Speeches will not wait on play time or audio."),
+			*Dialogue->GetName()
+		);
+	}
+}
+
+FDialogueInstance::~FDialogueInstance()
+{
+	Close();
+}
+
+FDialogueInstance* FDialogueInstance::GetExecuting()
+{
+	return Executing;
+}
+
+int32 FDialogueInstance::GetHandle() const
+{
+	return Handle;
+}
+
+UDialogue* FDialogueInstance::GetDialogue() const
+{
+	return Dialogue;
+}
+
+ADialogueController* FDialogueInstance::GetController() const
+{
+	return Controller;
+}
+
+bool FDialogueInstance::UsesDisplay() const
+{
+	return bUsesDisplay;
+}
+
+void FDialogueInstance::SetFidelity(EDialogueFidelity InFidelity)
+{
+	const EDialogueFidelity OldFidelity = Fidelity;
+	if (InFidelity == OldFidelity)
+	{
+		return;
+	}
+
+	Fidelity = InFidelity;
+	if (!bActive)
+	{
+		return;
+	}
+
+	TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+
+	//Stop holding audio the dialogue will no longer play, and let the 
+	//active speech move on without the line it was waiting on
+	if (!PlaysAudio())
+	{
+		AudioPrefetcher.Release();
+		++SpeechAudioRequest;
+		bLoadingSpeechAudio = false;
+
+		//Cut off the line already being spoken
+		if (Program.IsValidNode(ActiveNodeIndex)
+			&& Program.GetSpeech(ActiveNodeIndex))
+		{
+			if (UDialogueSpeakerComponent* Speaker = 
+				GetSpeakerAt(Program.GetNode(ActiveNodeIndex).SpeakerSlot))
+			{
+				Speaker->Stop();
+			}
+		}
+
+		if (bWaitingOnAudio)
+		{
+			OnSpeechAudioFinished(AudioSpeaker.Get());
+		}
+	}
+	else if (Program.IsValidNode(ActiveNodeIndex))
+	{
+		AudioPrefetcher.Update(Program, ActiveNodeIndex);
+	}
+
+	//Catch the display up on the line already being spoken
+	const FSpeechDetails* Speech = Program.IsValidNode(ActiveNodeIndex)
+		? Program.GetSpeech(ActiveNodeIndex) : nullptr;
+	if (bActive && Speech && !Speech->bIgnoreContent
+		&& OldFidelity == EDialogueFidelity::StateOnly)
+	{
+		UDialogueSpeakerComponent* Speaker = 
+			GetSpeakerAt(Program.GetNode(ActiveNodeIndex).SpeakerSlot);
+		if (Speaker)
+		{
+			DisplaySpeech(*Speech, Speaker);
+		}
+	}
+}
+
+EDialogueFidelity FDialogueInstance::GetFidelity() const
+{
+	return Fidelity;
+}
+
+bool FDialogueInstance::PlaysAudio() const
+{
+	return Fidelity == EDialogueFidelity::Full;
+}
+
+bool FDialogueInstance::ShowsText() const
+{
+	return Fidelity != EDialogueFidelity::StateOnly;
+}
+
+bool FDialogueInstance::IsActive() const
+{
+	return bActive;
+}
+
+void FDialogueInstance::Open(int32 StartIndex,
+	TConstArrayView<UDialogueSpeakerComponent*> InSpeakers)
+{
+	bActive = true;
+	INC_DWORD_STAT(STAT_DialogueTree_ActiveDialogues);
+
+	//Fill the speakers with the provided values
+	FillSpeakers(InSpeakers);
+
+	//Traverse the first node
+	TraverseNodeAt(StartIndex);
+}
+
+bool FDialogueInstance::Restore(const FDialogueInstanceSnapshot& InSnapshot,
+	TConstArrayView<UDialogueSpeakerComponent*> InSpeakers)
+{
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	const int32 NodeIndex = FindSnapshotNode(Program, InSnapshot);
+	if (NodeIndex == INDEX_NONE)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not restore dialogue [%s]. Node %s no longer exists."),
+			*Dialogue->GetName(),
+			*InSnapshot.ActiveNodeID.ToString()
+		);
+		return false;
+	}
+
+	bActive = true;
+	INC_DWORD_STAT(STAT_DialogueTree_ActiveDialogues);
+
+	Fidelity = InSnapshot.Fidelity;
+	TimeScale = FMath::Max(InSnapshot.TimeScale, 0.f);
+	FillSpeakers(InSpeakers);
+
+	TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+	FScope ExecutionScope(*this);
+
+	ActiveNodeIndex = NodeIndex;
+	if (PlaysAudio())
+	{
+		AudioPrefetcher.Update(Program, NodeIndex);
+	}
+
+	//Put the transition back where it was
+	TransitionState.bMinPlayTimeElapsed = InSnapshot.bMinPlayTimeElapsed;
+	TransitionState.bAudioFinished = InSnapshot.bAudioFinished;
+	if (!InSnapshot.bMinPlayTimeElapsed)
+	{
+		StartMinPlayTimer(InSnapshot.MinPlayTimeLeft);
+	}
+
+	//Options are routed again, keeping the lock states they were shown with
+	if (Program.GetNode(NodeIndex).bResolvesOptions)
+	{
+		Program.GatherOptions(NodeIndex, TransitionState.Options);
+		for (FResolvedDialogueOption& Option : TransitionState.Options)
+		{
+			const uint32 TargetKey = Program.GetStableID(Option.TargetIndex);
+			const FName TargetID = 
+				Program.GetNodeObject(Option.TargetIndex)->GetNodeID();
+			const FDialogueOptionSnapshot* Saved = 
+				InSnapshot.Options.FindByPredicate(
+					[TargetKey, TargetID](const FDialogueOptionSnapshot& Other)
+					{
+						return TargetKey != 0 
+							? Other.TargetKey == TargetKey 
+							: Other.TargetID == TargetID;
+					}
+				);
+			if (Saved)
+			{
+				Option.bIsLocked = Saved->bIsLocked;
+			}
+		}
+	}
+
+	Program.GetNodeObject(NodeIndex)->RestoreNode(InSnapshot);
+	return bActive;
+}
+
+bool FDialogueInstance::TakeSnapshot(
+	FDialogueInstanceSnapshot& OutSnapshot) const
+{
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	if (!bActive || bTraversing || !Program.IsValidNode(ActiveNodeIndex))
+	{
+		return false;
+	}
+
+	UDialogueNode* ActiveNode = Program.GetNodeObject(ActiveNodeIndex);
+	OutSnapshot = FDialogueInstanceSnapshot();
+	OutSnapshot.Dialogue = Dialogue.Get();
+	OutSnapshot.ActiveNodeKey = Program.GetStableID(ActiveNodeIndex);
+	OutSnapshot.ActiveNodeID = ActiveNode->GetNodeID();
+	OutSnapshot.Fidelity = Fidelity;
+	OutSnapshot.TimeScale = TimeScale;
+
+	//Speakers are saved by dialogue name, to be found again on restore
+	TConstArrayView<FName> Roles = Program.GetSpeakerRoles();
+	OutSnapshot.SpeakerRoles.Append(Roles.GetData(), Roles.Num());
+	OutSnapshot.SpeakerNames.Reserve(Speakers.Num());
+	for (const UDialogueSpeakerComponent* Speaker : Speakers)
+	{
+		OutSnapshot.SpeakerNames.Add(
+			Speaker ? Speaker->GetDialogueName() : NAME_None
+		);
+	}
+
+	OutSnapshot.bMinPlayTimeElapsed = TransitionState.bMinPlayTimeElapsed;
+	OutSnapshot.bAudioFinished = TransitionState.bAudioFinished;
+	OutSnapshot.MinPlayTimeLeft = TransitionState.HeldMinPlayTime;
+	if (Scheduler && TransitionState.MinPlayTimeWake.IsValid())
+	{
+		OutSnapshot.MinPlayTimeLeft = TimeScale * 
+			Scheduler->GetRemaining(TransitionState.MinPlayTimeWake);
+	}
+
+	OutSnapshot.Options.Reserve(TransitionState.Options.Num());
+	for (const FResolvedDialogueOption& Option : TransitionState.Options)
+	{
+		FDialogueOptionSnapshot& SavedOption = 
+			OutSnapshot.Options.AddDefaulted_GetRef();
+		SavedOption.TargetKey = Program.GetStableID(Option.TargetIndex);
+		SavedOption.TargetID = 
+			Program.GetNodeObject(Option.TargetIndex)->GetNodeID();
+		SavedOption.bIsLocked = Option.bIsLocked;
+	}
+
+	if (const UDialogueEventNode* EventNode = 
+		Cast<UDialogueEventNode>(ActiveNode))
+	{
+		EventNode->GetBlockingEvents(OutSnapshot.BlockingEvents);
+	}
+
+	return true;
+}
+
+int32 FDialogueInstance::FindSnapshotNode(const FDialogueProgram& InProgram,
+	const FDialogueInstanceSnapshot& InSnapshot)
+{
+	int32 NodeIndex = InProgram.FindNodeByStableID(InSnapshot.ActiveNodeKey);
+	if (NodeIndex == INDEX_NONE)
+	{
+		NodeIndex = InProgram.FindNode(InSnapshot.ActiveNodeID);
+	}
+
+	//Only content nodes can be rested on
+	const bool bContent = InProgram.IsValidNode(NodeIndex)
+		&& (InProgram.GetNode(NodeIndex).Kind == EDialogueNodeKind::Speech
+		|| InProgram.GetNode(NodeIndex).Kind == EDialogueNodeKind::Event);
+	return bContent ? NodeIndex : INDEX_NONE;
+}
+
+void FDialogueInstance::End()
+{
+	if (!bActive)
+	{
+		return;
+	}
+
+	//Let the controller tear down anything it owns for the instance
+	if (Controller)
+	{
+		Controller->EndDialogueInstance(*this);
+	}
+	else
+	{
+		Close();
+	}
+}
+
+void FDialogueInstance::Close()
+{
+	if (!bActive)
+	{
+		return;
+	}
+
+	bActive = false;
+	ResetTransitionState();
+
+	//Clear any behavior flags from the speakers and stop speaking
+	for (UDialogueSpeakerComponent* Speaker : Speakers)
+	{
+		if (Speaker)
+		{
+			Speaker->Stop();
+			Speaker->ClearGameplayTags();
+			Speaker->RemoveActiveInstance(this);
+		}
+	}
+
+	ActiveNodeIndex = INDEX_NONE;
+	AudioPrefetcher.Release();
+	DEC_DWORD_STAT(STAT_DialogueTree_ActiveDialogues);
+}
+
+void FDialogueInstance::TraverseNodeAt(int32 NodeIndex)
+{
+	//If already traversing, hand the node to the running loop
+	if (bTraversing)
+	{
+		PendingNodeIndex = NodeIndex;
+		bHasPendingNode = true;
+		return;
+	}
+
+	//Ending the instance mid-traversal must not free it under us
+	TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+	FScope ExecutionScope(*this);
+
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	TGuardValue<bool> TraversalGuard(bTraversing, true);
+
+	//Start the step with no node traversed
+	const int32 NumNodes = Program.GetNumNodes();
+	if (!InitIfProgramChanged(TraversedThisStep, false, NumNodes))
+	{
+		TraversedThisStep.SetRange(0, TraversedThisStep.Num(), false);
+	}
+
+	const int32 MaxHops = GetDefault<UDialogueSettings>()->MaxTraversalHops;
+	int32 CurrentIndex = NodeIndex;
+
+	for (int32 Hops = 0; ; ++Hops)
+	{
+		//return if the dialogue is already closed
+		if (!bActive)
+		{
+			return;
+		}
+
+		//If no node provided, end the dialogue
+		if (!Program.IsValidNode(CurrentIndex))
+		{
+			End();
+			return;
+		}
+
+		UDialogueNode* Node = Program.GetNodeObject(CurrentIndex);
+		if (Hops >= MaxHops)
+		{
+			UE_LOG(
+				LogDialogueTree,
+				Error,
+				TEXT("Exiting dialogue: Passed through %d nodes without stopping at Node %s. Check for speeches that loop back on themselves without waiting, or raise MaxTraversalHops in the project settings."),
+				Hops,
+				*Node->GetNodeID().ToString()
+			);
+			End();
+			return;
+		}
+
+		INC_DWORD_STAT(STAT_DialogueTree_Hops);
+		DIALOGUE_TRACE_SCOPE("TraverseNode", Dialogue, Node->GetNodeID());
+
+		//Mark the node visited
+		Controller->MarkNodeVisited(Dialogue, CurrentIndex);
+
+		switch (Program.GetNode(CurrentIndex).Kind)
+		{
+		//Logic nodes resolve straight from the program
+		case EDialogueNodeKind::Entry:
+		case EDialogueNodeKind::Reroute:
+		case EDialogueNodeKind::Jump:
+		case EDialogueNodeKind::Branch:
+		case EDialogueNodeKind::OptionLock:
+		{
+			if (MarkTraversedThisStep(CurrentIndex))
+			{
+				UE_LOG(
+					LogDialogueTree,
+					Error,
+					TEXT("Exiting dialogue: Node %s loops back to itself without reaching a speech or event."),
+					*Node->GetNodeID().ToString()
+				);
+				End();
+				return;
+			}
+
+			const int32 NextIndex = Program.ResolveNext(CurrentIndex);
+			if (!Program.IsValidNode(NextIndex))
+			{
+				UE_LOG(
+					LogDialogueTree,
+					Warning,
+					TEXT("Exiting dialogue: Node %s has nowhere to go..."),
+					*Node->GetNodeID().ToString()
+				);
+				End();
+				return;
+			}
+
+			CurrentIndex = NextIndex;
+			break;
+		}
+
+		//Content nodes play through their node objects
+		case EDialogueNodeKind::Speech:
+		case EDialogueNodeKind::Event:
+		{
+			//Content may change state, so earlier nodes may now lead elsewhere
+			//and earlier query results may no longer hold
+			TraversedThisStep.SetRange(0, TraversedThisStep.Num(), false);
+			InvalidateQueryResults();
+
+			//Drop anything the previous speech was still waiting on
+			ResetTransitionState();
+
+			bHasPendingNode = false;
+			ActiveNodeIndex = CurrentIndex;
+			if (PlaysAudio())
+			{
+				AudioPrefetcher.Update(Program, CurrentIndex);
+			}
+			{
+				DIALOGUE_TRACE_SCOPE("EnterNode", Dialogue, Node->GetNodeID());
+				Node->EnterNode();
+			}
+
+			//Stop if the node is waiting on something before moving on
+			if (!bHasPendingNode)
+			{
+				return;
+			}
+
+			bHasPendingNode = false;
+			CurrentIndex = PendingNodeIndex;
+			break;
+		}
+
+		default:
+			UE_LOG(
+				LogDialogueTree,
+				Error,
+				TEXT("Exiting dialogue: Node %s was not compiled correctly. Try recompiling the dialogue."),
+				*Node->GetNodeID().ToString()
+			);
+			End();
+			return;
+		}
+	}
+}
+
+void FDialogueInstance::SelectOption(int32 InOptionIndex)
+{
+	if (UDialogueNode* ActiveNode = GetActiveNode())
+	{
+		TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+		FScope ExecutionScope(*this);
+		ActiveNode->SelectOption(InOptionIndex);
+	}
+}
+
+void FDialogueInstance::Skip()
+{
+	if (UDialogueNode* ActiveNode = GetActiveNode())
+	{
+		TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+		FScope ExecutionScope(*this);
+		ActiveNode->Skip();
+	}
+}
+
+UDialogueNode* FDialogueInstance::GetActiveNode() const
+{
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	return bActive && Program.IsValidNode(ActiveNodeIndex)
+		? Program.GetNodeObject(ActiveNodeIndex) : nullptr;
+}
+
+UDialogueSpeakerComponent* FDialogueInstance::GetActiveSpeaker() const
+{
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	return bActive && Program.IsValidNode(ActiveNodeIndex)
+		&& Program.GetSpeech(ActiveNodeIndex)
+		? GetSpeakerAt(Program.GetNode(ActiveNodeIndex).SpeakerSlot)
+		: nullptr;
+}
+
+void FDialogueInstance::DisplaySpeech(const FSpeechDetails& InDetails,
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	if (!InSpeaker)
+	{
+		End();
+		return;
+	}
+
+	if (!ShowsText())
+	{
+		return;
+	}
+
+	if (!bUsesDisplay)
+	{
+		Controller->DisplayAmbientSpeech(
+			Handle, 
+			InDetails, 
+			InSpeaker, 
+			Fidelity
+		);
+		return;
+	}
+
+	Controller->DisplaySpeech(InDetails, InSpeaker);
+	Controller->OnDialogueSpeechDisplayed.Broadcast(InDetails);
+}
+
+void FDialogueInstance::DisplayOptions(
+	const TArray<FResolvedDialogueOption>& InOptions)
+{
+	if (!bUsesDisplay)
+	{
+		return;
+	}
+
+	//Details are only copied out of the program for the display itself
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	OptionDetails.SetNum(InOptions.Num(), EAllowShrinking::No);
+	for (int32 i = 0; i < InOptions.Num(); ++i)
+	{
+		Program.GetOptionDetails(InOptions[i], OptionDetails[i]);
+	}
+
+	Controller->DisplayOptions(OptionDetails);
+}
+
+void FDialogueInstance::SetSpeaker(FName InName,
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	SetSpeakerAt(Dialogue->GetProgram().FindSpeakerSlot(InName), InSpeaker);
+}
+
+UDialogueSpeakerComponent* FDialogueInstance::GetSpeaker(FName InName) const
+{
+	return GetSpeakerAt(Dialogue->GetProgram().FindSpeakerSlot(InName));
+}
+
+void FDialogueInstance::SetSpeakerAt(int32 InSlot,
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	if (!Speakers.IsValidIndex(InSlot))
+	{
+		return;
+	}
+
+	//Cached results were keyed by the speakers bound when they ran
+	UDialogueSpeakerComponent* OldSpeaker = Speakers[InSlot];
+	Speakers[InSlot] = InSpeaker;
+	InvalidateQueryResults();
+	if (InSpeaker)
+	{
+		InSpeaker->AddActiveInstance(AsShared());
+	}
+
+	//A replaced speaker leaves unless it fills another role too
+	if (OldSpeaker && OldSpeaker != InSpeaker && !HasSpeaker(OldSpeaker))
+	{
+		OldSpeaker->RemoveActiveInstance(this);
+	}
+}
+
+UDialogueSpeakerComponent* FDialogueInstance::GetSpeakerAt(int32 InSlot) 
+	const
+{
+	return Speakers.IsValidIndex(InSlot) ? Speakers[InSlot].Get() : nullptr;
+}
+
+const TArray<TObjectPtr<UDialogueSpeakerComponent>>&
+	FDialogueInstance::GetSpeakers() const
+{
+	return Speakers;
+}
+
+bool FDialogueInstance::HasSpeaker(
+	const UDialogueSpeakerComponent* InSpeaker) const
+{
+	if (!InSpeaker)
+	{
+		return false;
+	}
+
+	return Speakers.Contains(InSpeaker);
+}
+
+const FDialogueBlackboardValue& FDialogueInstance::ReadBlackboard(
+	int32 InKeyIndex)
+{
+	static const FDialogueBlackboardValue DefaultValue;
+
+	const int32 Slot = ResolveBlackboardSlot(InKeyIndex);
+	return Slot != INDEX_NONE
+		? Controller->GetBlackboard().GetValue(Slot)
+		: DefaultValue;
+}
+
+void FDialogueInstance::WriteBlackboard(int32 InKeyIndex,
+	const FDialogueBlackboardValue& InValue)
+{
+	const int32 Slot = ResolveBlackboardSlot(InKeyIndex);
+	if (Slot != INDEX_NONE)
+	{
+		Controller->WriteBlackboardSlot(Slot, InValue);
+	}
+}
+
+bool FDialogueInstance::FindQueryResult(int32 InQueryIndex, double& OutValue)
+{
+	RefreshQueryResults();
+
+	if (!QueryResults.IsValidIndex(InQueryIndex)
+		|| QueryResults[InQueryIndex].Value != QueryResultEpoch)
+	{
+		return false;
+	}
+
+	OutValue = QueryResults[InQueryIndex].Key;
+	return true;
+}
+
+void FDialogueInstance::StoreQueryResult(int32 InQueryIndex, double InValue)
+{
+	RefreshQueryResults();
+
+	InitIfProgramChanged(
+		QueryResults, 
+		TPair<double, uint32>(0.0, 0), 
+		Dialogue->GetProgram().GetNumConditionQueries()
+	);
+
+	if (QueryResults.IsValidIndex(InQueryIndex))
+	{
+		QueryResults[InQueryIndex] = 
+			TPair<double, uint32>(InValue, QueryResultEpoch);
+	}
+}
+
+void FDialogueInstance::InvalidateQueryResults()
+{
+	//Skip 0, which fresh entries are stamped with
+	if (++QueryResultEpoch == 0)
+	{
+		++QueryResultEpoch;
+	}
+}
+
+void FDialogueInstance::RefreshQueryResults()
+{
+	const uint32 StateEpoch = Controller->GetDialogueStateEpoch();
+	if (QueryResultFrame != GFrameCounter
+		|| QueryResultStateEpoch != StateEpoch)
+	{
+		QueryResultFrame = GFrameCounter;
+		QueryResultStateEpoch = StateEpoch;
+		InvalidateQueryResults();
+	}
+}
+
+int32 FDialogueInstance::ResolveBlackboardSlot(int32 InKeyIndex)
+{
+	//Slots only move when the blackboard is cleared or replaced
+	if (BlackboardGeneration != Controller->GetBlackboardGeneration())
+	{
+		BlackboardGeneration = Controller->GetBlackboardGeneration();
+		BlackboardSlots.Reset();
+	}
+
+	TConstArrayView<FDialogueBlackboardKey> Keys = 
+		Dialogue->GetProgram().GetBlackboardKeys();
+	if (!Keys.IsValidIndex(InKeyIndex))
+	{
+		return INDEX_NONE;
+	}
+
+	if (BlackboardSlots.Num() != Keys.Num())
+	{
+		BlackboardSlots.Init(INDEX_NONE, Keys.Num());
+	}
+
+	int32& Slot = BlackboardSlots[InKeyIndex];
+	if (Slot == INDEX_NONE)
+	{
+		Slot = Controller->FindOrAddBlackboardSlot(
+			Keys[InKeyIndex].Name,
+			Keys[InKeyIndex].Type
+		);
+	}
+
+	return Slot;
+}
+
+FDialogueTransitionState& FDialogueInstance::GetTransitionState()
+{
+	return TransitionState;
+}
+
+void FDialogueInstance::StartMinPlayTimer(float InSeconds)
+{
+	StopMinPlayTimer();
+
+	//Nothing to count the time down with, so let the speech move on
+	if (!Scheduler)
+	{
+		TransitionState.bMinPlayTimeElapsed = true;
+		return;
+	}
+
+	if (TimeScale <= 0.f)
+	{
+		TransitionState.HeldMinPlayTime = InSeconds;
+		return;
+	}
+
+	TransitionState.MinPlayTimeWake = Scheduler->ScheduleWake(
+		AsShared(),
+		InSeconds / TimeScale
+	);
+}
+
+void FDialogueInstance::StopMinPlayTimer()
+{
+	if (Scheduler)
+	{
+		Scheduler->CancelWake(TransitionState.MinPlayTimeWake);
+	}
+
+	TransitionState.HeldMinPlayTime = 0.0;
+}
+
+void FDialogueInstance::SetTimeScale(float InTimeScale)
+{
+	InTimeScale = FMath::Max(InTimeScale, 0.f);
+	if (InTimeScale == TimeScale)
+	{
+		return;
+	}
+
+	//Carry over whatever is left of the running timer
+	double Remaining = TransitionState.HeldMinPlayTime;
+	if (Scheduler && TransitionState.MinPlayTimeWake.IsValid())
+	{
+		Remaining = 
+			Scheduler->GetRemaining(TransitionState.MinPlayTimeWake) * TimeScale;
+	}
+
+	TimeScale = InTimeScale;
+	if (Remaining > 0.0)
+	{
+		StartMinPlayTimer(Remaining);
+	}
+}
+
+float FDialogueInstance::GetTimeScale() const
+{
+	return TimeScale;
+}
+
+void FDialogueInstance::WaitForSpeechAudio(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	StopWaitingForSpeechAudio();
+
+	//Nothing to poll the audio with, so let the speech move on
+	if (!Scheduler)
+	{
+		TransitionState.bAudioFinished = true;
+		return;
+	}
+
+	AudioSpeaker = InSpeaker;
+	bWaitingOnAudio = true;
+	InSpeaker->AddActiveInstance(AsShared());
+	Scheduler->WatchAudio(AsShared());
+}
+
+void FDialogueInstance::StopWaitingForSpeechAudio()
+{
+	//The scheduler stops polling by itself
+	AudioSpeaker.Reset();
+	bWaitingOnAudio = false;
+}
+
+void FDialogueInstance::PlaySpeechAudioWhenLoaded(
+	UDialogueSpeakerComponent* InSpeaker,
+	const TSoftObjectPtr<USoundBase>& InAudio)
+{
+	const int32 Request = ++SpeechAudioRequest;
+	TWeakObjectPtr<UDialogueSpeakerComponent> WeakSpeaker = InSpeaker;
+
+	bLoadingSpeechAudio = true;
+	const bool bRequested = AudioPrefetcher.RequestNow(
+		InAudio,
+		FStreamableDelegate::CreateSPLambda(
+			AsShared(),
+			[this, Request, WeakSpeaker, InAudio]()
+			{
+				OnSpeechAudioLoaded(Request, WeakSpeaker.Get(), InAudio.Get());
+			}
+		)
+	);
+
+	if (!bRequested && Request == SpeechAudioRequest)
+	{
+		bLoadingSpeechAudio = false;
+	}
+}
+
+bool FDialogueInstance::IsLoadingSpeechAudio() const
+{
+	return bLoadingSpeechAudio;
+}
+
+void FDialogueInstance::OnSpeechAudioFinished(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	if (!bActive || !bWaitingOnAudio || AudioSpeaker.Get() != InSpeaker)
+	{
+		return;
+	}
+
+	if (UDialogueTransition* Transition = GetActiveTransition())
+	{
+		TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+		FScope ExecutionScope(*this);
+		Transition->OnDonePlayingContent();
+	}
+}
+
+void FDialogueInstance::AddReferencedObjects(FReferenceCollector& Collector)
+{
+	Collector.AddReferencedObject(Dialogue);
+	Collector.AddReferencedObject(Controller);
+	Collector.AddReferencedObjects(Speakers);
+}
+
+void FDialogueInstance::FillSpeakers(
+	TConstArrayView<UDialogueSpeakerComponent*> InSpeakers)
+{
+	//Start from an empty slot per compiled role
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	Speakers.Reset();
+	Speakers.SetNumZeroed(Program.GetNumSpeakerSlots());
+
+	//Set speakers
+	const int32 NumBound = FMath::Min(InSpeakers.Num(), Speakers.Num());
+	for (int32 i = 0; i < NumBound; ++i)
+	{
+		if (InSpeakers[i] != nullptr)
+		{
+			SetSpeakerAt(i, InSpeakers[i]);
+		}
+	}
+
+	//Verify that no speakers are missing
+	for (int32 i = 0; i < Speakers.Num(); ++i)
+	{
+		if (!Speakers[i])
+		{
+			Controller->HandleMissingSpeaker(Program.GetSpeakerRole(i));
+		}
+	}
+}
+
+void FDialogueInstance::ResetTransitionState()
+{
+	StopMinPlayTimer();
+	StopWaitingForSpeechAudio();
+
+	//Audio still loading for the previous speech is no longer wanted
+	++SpeechAudioRequest;
+	bLoadingSpeechAudio = false;
+
+	TransitionState.bMinPlayTimeElapsed = false;
+	TransitionState.bAudioFinished = false;
+	TransitionState.Options.Reset();
+}
+
+void FDialogueInstance::OnMinPlayTimeElapsed()
+{
+	if (!bActive)
+	{
+		return;
+	}
+
+	if (UDialogueTransition* Transition = GetActiveTransition())
+	{
+		TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+		FScope ExecutionScope(*this);
+		Transition->OnMinPlayTimeElapsed();
+	}
+}
+
+void FDialogueInstance::OnSpeechAudioLoaded(int32 InRequest,
+	UDialogueSpeakerComponent* InSpeaker, USoundBase* InAudio)
+{
+	//Ignore loads for speeches that have since moved on or been skipped
+	if (InRequest != SpeechAudioRequest || !bLoadingSpeechAudio)
+	{
+		return;
+	}
+
+	bLoadingSpeechAudio = false;
+	if (!bActive || !InSpeaker || TransitionState.bAudioFinished)
+	{
+		return;
+	}
+
+	TSharedRef<FDialogueInstance> KeepAlive = AsShared();
+	FScope ExecutionScope(*this);
+
+	if (InAudio)
+	{
+		InSpeaker->PlaySpeechAudioClip(InAudio);
+	}
+	else
+	{
+		//Nothing to play, so let a transition waiting on the line move on
+		OnSpeechAudioFinished(InSpeaker);
+	}
+}
+
+bool FDialogueInstance::IsSpeechAudioDone() const
+{
+	if (bLoadingSpeechAudio)
+	{
+		return false;
+	}
+
+	const UDialogueSpeakerComponent* Speaker = AudioSpeaker.Get();
+	return !Speaker || !Speaker->IsPlaying();
+}
+
+UDialogueTransition* FDialogueInstance::GetActiveTransition() const
+{
+	UDialogueSpeechNode* SpeechNode = Cast<UDialogueSpeechNode>(
+		GetActiveNode()
+	);
+	return SpeechNode ? SpeechNode->GetTransition() : nullptr;
+}
+
+bool FDialogueInstance::MarkTraversedThisStep(int32 NodeIndex)
+{
+	FBitReference Traversed = TraversedThisStep[NodeIndex];
+	if (Traversed)
+	{
+		return true;
+	}
+
+	Traversed = true;
+	return false;
+}
@@ -3,20 +3,58 @@
 //Header
 #include "DialogueManagerSubsystem.h"
 //UE
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 #include "Engine/World.h"
-#include "Kismet/GameplayStatics.h"
+#include "EngineUtils.h"
 //Plugin
+#include "Dialogue.h"
 #include "DialogueController.h"
 #include "DialogueSettings.h"
+#include "DialogueSpeakerComponent.h"
+#include "DialogueTreeStats.h"
 #include "LogDialogueTree.h"
 
 void UDialogueManagerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
+
+	BarkService.Initialize(this);
+	SpeakerRegistry.SetCellSize(
+		GetDefault<UDialogueSettings>()->SpeakerRegistryCellSize
+	);
+
+	//The world is still loading, so get the classes in before it begins play
+	UWorld* World = GetWorld();
+	if (World && World->IsGameWorld())
+	{
+		bControllerPending = true;
+		RequestControllerClasses();
+	}
 }
 
 void UDialogueManagerSubsystem::Deinitialize()
 {
+	//Cancelling also drops the completion callback
+	if (ControllerClassesHandle.IsValid())
+	{
+		if (ControllerClassesHandle->IsLoadingInProgress())
+		{
+			ControllerClassesHandle->CancelHandle();
+		}
+		else
+		{
+			ControllerClassesHandle->ReleaseHandle();
+		}
+		ControllerClassesHandle.Reset();
+	}
+
+	bControllerPending = false;
+	ControllerReadyDelegate.Clear();
+	SpeakerRegistry.Reset();
+	Scheduler.Reset();
+	BarkService.Reset();
+
 	Super::Deinitialize();
 }
 
@@ -24,15 +62,8 @@ void UDialogueManagerSubsystem::OnWorldBeginPlay(UWorld& InWorld)
 {
 	Super::OnWorldBeginPlay(InWorld);
 
-	//Remove any existing dialogue controllers from the world 
-	TArray<AActor*> ExtantControllers;
-	UGameplayStatics::GetAllActorsOfClass(
-		&InWorld,
-		ADialogueController::StaticClass(),
-		ExtantControllers
-	);
-
-	for (AActor* OldController : ExtantControllers)
+	//Remove any existing dialogue controllers from the world
+	for (TActorIterator<ADialogueController> It(&InWorld); It; ++It)
 	{
 		UE_LOG(
 			LogDialogueTree,
@@ -40,25 +71,268 @@ void UDialogueManagerSubsystem::OnWorldBeginPlay(UWorld& InWorld)
 			TEXT("Removing existing dialogue controller from world. Note that dialogue controllers manually placed in the level will not be used and can be safely deleted.")
 		);
 
-		OldController->Destroy();
+		It->Destroy();
+	}
+
+	bControllerPending = true;
+	bWorldBegunPlay = true;
+	TrySpawnController();
+}
+
+void UDialogueManagerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	Scheduler.Tick(DeltaTime);
+	BarkService.Tick();
+}
+
+TStatId UDialogueManagerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(
+		UDialogueManagerSubsystem, 
+		STATGROUP_DialogueTree
+	);
+}
+
+ADialogueController* UDialogueManagerSubsystem::GetCurrentController()
+{
+	return DialogueController;
+}
+
+bool UDialogueManagerSubsystem::IsControllerPending() const
+{
+	return bControllerPending;
+}
+
+FDialogueControllerReadySignature&
+	UDialogueManagerSubsystem::OnControllerReady()
+{
+	return ControllerReadyDelegate;
+}
+
+const UDialogueSettings* UDialogueManagerSubsystem::GetSettings()
+{
+	return GetDefault<UDialogueSettings>();
+}
+
+void UDialogueManagerSubsystem::RegisterSpeaker(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	SpeakerRegistry.Register(InSpeaker);
+}
+
+void UDialogueManagerSubsystem::UnregisterSpeaker(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	SpeakerRegistry.Unregister(InSpeaker);
+}
+
+void UDialogueManagerSubsystem::UpdateSpeakerLocation(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	SpeakerRegistry.UpdateLocation(InSpeaker);
+}
+
+UDialogueSpeakerComponent* UDialogueManagerSubsystem::FindNearestSpeaker(
+	FName InDialogueName, FVector InLocation, float InMaxDistance) const
+{
+	return SpeakerRegistry.FindNearest(
+		InDialogueName, 
+		InLocation, 
+		InMaxDistance
+	);
+}
+
+TArray<UDialogueSpeakerComponent*> 
+	UDialogueManagerSubsystem::GetSpeakersWithName(FName InDialogueName) const
+{
+	return TArray<UDialogueSpeakerComponent*>(
+		SpeakerRegistry.FindByName(InDialogueName)
+	);
+}
+
+TArray<UDialogueSpeakerComponent*> 
+	UDialogueManagerSubsystem::GetSpeakersInRange(FVector InLocation,
+	float InMaxDistance) const
+{
+	TArray<UDialogueSpeakerComponent*> Speakers;
+	SpeakerRegistry.FindInRange(InLocation, InMaxDistance, Speakers);
+	return Speakers;
+}
+
+void UDialogueManagerSubsystem::BindNearestSpeakerSlots(
+	const UDialogue* InDialogue, UDialogueSpeakerComponent* InInstigator,
+	float InMaxDistance, FDialogueSpeakerSlots& OutSlots) const
+{
+	OutSlots.Reset();
+	if (!InDialogue || !InInstigator)
+	{
+		return;
+	}
+
+	const FDialogueProgram& Program = InDialogue->GetProgram();
+	const FVector Origin = InInstigator->GetComponentLocation();
+	const FName InstigatorName = InInstigator->GetDialogueName();
+
+	OutSlots.SetNumZeroed(Program.GetNumSpeakerSlots());
+	for (int32 Slot = 0; Slot < OutSlots.Num(); ++Slot)
+	{
+		const FName Role = Program.GetSpeakerRole(Slot);
+		if (Role == InstigatorName)
+		{
+			OutSlots[Slot] = InInstigator;
+			continue;
+		}
+
+		OutSlots[Slot] = SpeakerRegistry.FindNearest(
+			Role, 
+			Origin, 
+			InMaxDistance, 
+			InInstigator
+		);
+	}
+}
+
+void UDialogueManagerSubsystem::SetDialoguePaused(bool bInPaused)
+{
+	Scheduler.SetPaused(bInPaused);
+}
+
+bool UDialogueManagerSubsystem::IsDialoguePaused() const
+{
+	return Scheduler.IsPaused();
+}
+
+void UDialogueManagerSubsystem::SetDialogueTimeScale(float InTimeScale)
+{
+	Scheduler.SetTimeScale(InTimeScale);
+}
+
+float UDialogueManagerSubsystem::GetDialogueTimeScale() const
+{
+	return Scheduler.GetTimeScale();
+}
+
+bool UDialogueManagerSubsystem::RequestBark(
+	UDialogueSpeakerComponent* InSpeaker, UDialogue* InDialogue, 
+	const FDialogueBarkParams& InParams)
+{
+	return BarkService.RequestBark(InSpeaker, InDialogue, InParams);
+}
+
+void UDialogueManagerSubsystem::CancelBark(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	BarkService.CancelBark(InSpeaker);
+}
+
+FDialogueBarkService& UDialogueManagerSubsystem::GetBarkService()
+{
+	return BarkService;
+}
+
+FDialogueScheduler& UDialogueManagerSubsystem::GetScheduler()
+{
+	return Scheduler;
+}
+
+const FDialogueSpeakerRegistry& 
+	UDialogueManagerSubsystem::GetSpeakerRegistry() const
+{
+	return SpeakerRegistry;
+}
+
+void UDialogueManagerSubsystem::OnAmbientDialogueEnded(int32 Handle)
+{
+	BarkService.OnBarkEnded(Handle);
+}
+
+void UDialogueManagerSubsystem::RequestControllerClasses()
+{
+	if (!UAssetManager::IsInitialized())
+	{
+		return;
+	}
+
+	const UDialogueSettings* DLGSettings = GetDefault<UDialogueSettings>();
+	TArray<FSoftObjectPath> ClassPaths;
+	for (const FSoftObjectPath& Path : {
+		DLGSettings->DialogueControllerType.ToSoftObjectPath(),
+		DLGSettings->DialogueWidgetType.ToSoftObjectPath(),
+		DLGSettings->DialogueOptionWidgetType.ToSoftObjectPath() })
+	{
+		if (!Path.IsNull())
+		{
+			ClassPaths.Add(Path);
+		}
+	}
+
+	if (ClassPaths.IsEmpty())
+	{
+		return;
+	}
+
+	ControllerClassesHandle =
+		UAssetManager::GetStreamableManager().RequestAsyncLoad(
+			MoveTemp(ClassPaths),
+			FStreamableDelegate::CreateUObject(
+				this,
+				&UDialogueManagerSubsystem::OnControllerClassesLoaded
+			),
+			FStreamableManager::AsyncLoadHighPriority
+		);
+}
+
+void UDialogueManagerSubsystem::OnControllerClassesLoaded()
+{
+	TrySpawnController();
+}
+
+void UDialogueManagerSubsystem::TrySpawnController()
+{
+	if (!bControllerPending || !bWorldBegunPlay)
+	{
+		return;
+	}
+
+	if (ControllerClassesHandle.IsValid()
+		&& ControllerClassesHandle->IsLoadingInProgress())
+	{
+		return;
 	}
 
 	//Get settings
 	TSubclassOf<ADialogueController> ControllerType;
 	UDialogueSettings* DLGSettings = GetMutableDefault<UDialogueSettings>();
 
-	//Attempt to load controller type
+	//Attempt to get the loaded controller type. Only loads on the spot if
+	//the asset manager was not around to stream it in
 	if (DLGSettings)
 	{
-		ControllerType = 
-			DLGSettings->DialogueControllerType.LoadSynchronous();
+		ControllerType = DLGSettings->DialogueControllerType.Get();
+		if (!ControllerType && !ControllerClassesHandle.IsValid())
+		{
+			ControllerType =
+				DLGSettings->DialogueControllerType.LoadSynchronous();
+		}
 	}
 
 	//Attempt to spawn controller
-	if (ControllerType)
+	UWorld* World = GetWorld();
+	if (ControllerType && World)
 	{
 		DialogueController =
-			InWorld.SpawnActor<ADialogueController>(ControllerType);
+			World->SpawnActor<ADialogueController>(ControllerType);
+	}
+
+	//Free the voices of barks as they end
+	if (DialogueController)
+	{
+		DialogueController->OnAmbientDialogueEnded.AddDynamic(
+			this,
+			&UDialogueManagerSubsystem::OnAmbientDialogueEnded
+		);
 	}
 
 	//If no controller was spawned, print error message
@@ -70,14 +344,11 @@ void UDialogueManagerSubsystem::OnWorldBeginPlay(UWorld& InWorld)
 			TEXT("Failed to spawn dialogue controller. Please specify a controller type under ProjectSettings>>DialogueTree>>DialogueControllerType")
 		);
 	}
-}
 
-ADialogueController* UDialogueManagerSubsystem::GetCurrentController()
-{
-	return DialogueController;
-}
-
-const UDialogueSettings* UDialogueManagerSubsystem::GetSettings()
-{
-	return GetDefault<UDialogueSettings>();
+	//Hand the controller to anything that queued up waiting for it
+	bControllerPending = false;
+	FDialogueControllerReadySignature ReadyDelegate =
+		MoveTemp(ControllerReadyDelegate);
+	ControllerReadyDelegate.Clear();
+	ReadyDelegate.Broadcast(DialogueController);
 }
@@ -0,0 +1,1104 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueProgram.h"
+//UE
+#include "Algo/IsSorted.h"
+#include "Algo/Sort.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+//Plugin
+#include "Conditionals/DialogueCondition.h"
+#include "Conditionals/Queries/Base/DialogueQueryBool.h"
+#include "Conditionals/Queries/Base/DialogueQueryFloat.h"
+#include "Conditionals/Queries/Base/DialogueQueryInt.h"
+#include "Dialogue.h"
+#include "DialogueController.h"
+#include "DialogueInstance.h"
+#include "DialogueManagerSubsystem.h"
+#include "DialogueSettings.h"
+#include "DialogueSpeakerComponent.h"
+#include "DialogueTreeStats.h"
+#include "LogDialogueTree.h"
+#include "Nodes/DialogueNode.h"
+
+namespace
+{
+	/** Past this many samples a condition's profile is halved, so the 
+	* order follows pass rates that change over a playthrough */
+	constexpr uint32 MaxConditionSamples = 1024;
+
+	/**
+	* Compares a value read by a condition instruction to its constant.
+	*
+	* @param InValue - double, the value read.
+	* @param InCompare - EDialogueConditionCompare, the comparison.
+	* @param InConstant - double, the instruction's constant.
+	* @return bool - the outcome of the comparison.
+	*/
+	bool CompareConditionValue(double InValue, 
+		EDialogueConditionCompare InCompare, double InConstant)
+	{
+		switch (InCompare)
+		{
+		case EDialogueConditionCompare::GreaterThan:
+			return InValue > InConstant;
+		case EDialogueConditionCompare::LessThan:
+			return InValue < InConstant;
+		case EDialogueConditionCompare::EqualTo:
+			return InValue == InConstant;
+		default:
+			return InValue != 0.0;
+		}
+	}
+
+	/**
+	* Checks if two queries are of the same class and hold the same 
+	* settings, and so return the same result.
+	*
+	* @param InA - const UDialogueQuery*, the first query.
+	* @param InB - const UDialogueQuery*, the second query.
+	* @return bool - True if the queries are identical.
+	*/
+	bool AreQueriesIdentical(const UDialogueQuery* InA, 
+		const UDialogueQuery* InB)
+	{
+		if (InA->GetClass() != InB->GetClass())
+		{
+			return false;
+		}
+
+		for (TFieldIterator<FProperty> It(InA->GetClass()); It; ++It)
+		{
+			if (!It->Identical_InContainer(InA, InB))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+void FDialogueProgram::Reset()
+{
+	Nodes.Empty();
+	NodeObjects.Empty();
+	Links.Empty();
+	Conditions.Empty();
+	ConditionCode.Empty();
+	ConditionQueries.Empty();
+	ConditionProfiles.Empty();
+	ConditionOrder.Empty();
+	ConditionRuns.Empty();
+	BlackboardKeys.Empty();
+	BlackboardConstants.Empty();
+	Speeches.Empty();
+	Messages.Empty();
+	NodeIndices.Empty();
+	StableNodeIndices.Empty();
+	RenamedVisitSlots.Empty();
+	EntryIndex = INDEX_NONE;
+	OptionRoutes.Empty();
+	OptionGuards.Empty();
+	SpeakerRoles.Empty();
+	NumVisitSlots = 0;
+	Version = (int32)EDialogueProgramVersion::Latest;
+}
+
+bool FDialogueProgram::IsEmpty() const
+{
+	return Nodes.IsEmpty();
+}
+
+bool FDialogueProgram::IsUpToDate() const
+{
+	return Version == (int32)EDialogueProgramVersion::Latest;
+}
+
+bool FDialogueProgram::IsValidNode(int32 NodeIndex) const
+{
+	return Nodes.IsValidIndex(NodeIndex);
+}
+
+int32 FDialogueProgram::GetNumNodes() const
+{
+	return Nodes.Num();
+}
+
+int32 FDialogueProgram::GetEntryIndex() const
+{
+	return EntryIndex;
+}
+
+int32 FDialogueProgram::FindNode(FName NodeID) const
+{
+	const int32* FoundIndex = NodeIndices.Find(NodeID);
+	return FoundIndex ? *FoundIndex : INDEX_NONE;
+}
+
+int32 FDialogueProgram::FindNodeByStableID(uint32 InStableID) const
+{
+	const int32* FoundIndex = StableNodeIndices.Find(InStableID);
+	return FoundIndex ? *FoundIndex : INDEX_NONE;
+}
+
+int32 FDialogueProgram::FindRenamedNode(FName OldNodeID) const
+{
+	const int32* VisitIndex = RenamedVisitSlots.Find(OldNodeID);
+	if (!VisitIndex)
+	{
+		return INDEX_NONE;
+	}
+
+	//Only used for old save data, so a scan is fine
+	return Nodes.IndexOfByPredicate(
+		[VisitIndex](const FDialogueProgramNode& Node)
+		{
+			return Node.VisitIndex == *VisitIndex;
+		}
+	);
+}
+
+uint32 FDialogueProgram::GetStableID(int32 NodeIndex) const
+{
+	return IsValidNode(NodeIndex) ? Nodes[NodeIndex].StableID : 0;
+}
+
+int32 FDialogueProgram::GetNumVisitSlots() const
+{
+	return NumVisitSlots;
+}
+
+int32 FDialogueProgram::GetVisitIndex(int32 NodeIndex) const
+{
+	return IsValidNode(NodeIndex) ? Nodes[NodeIndex].VisitIndex : INDEX_NONE;
+}
+
+int32 FDialogueProgram::FindVisitIndex(FName NodeID) const
+{
+	const int32 NodeIndex = FindNode(NodeID);
+	if (NodeIndex != INDEX_NONE)
+	{
+		return GetVisitIndex(NodeIndex);
+	}
+
+	const int32* RenamedSlot = RenamedVisitSlots.Find(NodeID);
+	return RenamedSlot ? *RenamedSlot : INDEX_NONE;
+}
+
+int32 FDialogueProgram::IndexOf(const UDialogueNode* InNode) const
+{
+	const int32 NodeIndex = InNode ? InNode->GetNodeIndex() : INDEX_NONE;
+	return NodeObjects.IsValidIndex(NodeIndex)
+		&& NodeObjects[NodeIndex] == InNode ? NodeIndex : INDEX_NONE;
+}
+
+int32 FDialogueProgram::GetNumSpeakerSlots() const
+{
+	return SpeakerRoles.Num();
+}
+
+int32 FDialogueProgram::FindSpeakerSlot(FName InRole) const
+{
+	//Roles are declared by hand and seldom more than a few, so scanning 
+	//the slot order is as quick as a map and keeps no second copy
+	return InRole.IsNone() ? INDEX_NONE : SpeakerRoles.IndexOfByKey(InRole);
+}
+
+FName FDialogueProgram::GetSpeakerRole(int32 InSlot) const
+{
+	return SpeakerRoles.IsValidIndex(InSlot) ? SpeakerRoles[InSlot] : NAME_None;
+}
+
+TConstArrayView<FName> FDialogueProgram::GetSpeakerRoles() const
+{
+	return SpeakerRoles;
+}
+
+TConstArrayView<FDialogueBlackboardKey> FDialogueProgram::GetBlackboardKeys()
+	const
+{
+	return BlackboardKeys;
+}
+
+int32 FDialogueProgram::GetNumConditionQueries() const
+{
+	return ConditionQueries.Num();
+}
+
+const FDialogueProgramNode& FDialogueProgram::GetNode(int32 NodeIndex) const
+{
+	return Nodes[NodeIndex];
+}
+
+UDialogueNode* FDialogueProgram::GetNodeObject(int32 NodeIndex) const
+{
+	return NodeObjects[NodeIndex];
+}
+
+TConstArrayView<int32> FDialogueProgram::GetLinks(int32 NodeIndex) const
+{
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+	return TConstArrayView<int32>(
+		Links.GetData() + Node.LinkStart,
+		Node.LinkCount
+	);
+}
+
+int32 FDialogueProgram::GetFirstLink(int32 NodeIndex) const
+{
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+	return Node.LinkCount > 0 ? Links[Node.LinkStart] : INDEX_NONE;
+}
+
+const FSpeechDetails* FDialogueProgram::GetSpeech(int32 NodeIndex) const
+{
+	const int32 SpeechIndex = Nodes[NodeIndex].SpeechIndex;
+	return Speeches.IsValidIndex(SpeechIndex)
+		? &Speeches[SpeechIndex] : nullptr;
+}
+
+bool FDialogueProgram::PassesConditions(int32 NodeIndex) const
+{
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+	if (Node.ConditionCount == 0)
+	{
+		return !Node.bIfAny;
+	}
+
+	const UDialogue* Dialogue = NodeObjects[NodeIndex]->GetDialogue();
+	DIALOGUE_TRACE_SCOPE(
+		"IsMet",
+		Dialogue,
+		NodeObjects[NodeIndex]->GetNodeID()
+	);
+
+	//Look the instance up once for every condition of the node
+	FDialogueInstance* Instance = Dialogue->GetActiveInstance();
+	const int32 ConditionEnd = Node.ConditionStart + Node.ConditionCount;
+
+	//Timing every condition has a cost of its own, so profiling is opt in
+	const UDialogueSettings* Settings = GetDefault<UDialogueSettings>();
+	const bool bAdaptive = 
+		Node.ConditionCount > 1 && Settings->bAdaptiveConditionOrder;
+	if (bAdaptive && ConditionOrder.Num() != Conditions.Num())
+	{
+		InitConditionProfiles();
+	}
+
+	//No condition decides the outcome early unless it short circuits
+	bool bOutcome = !Node.bIfAny;
+
+	for (int32 Slot = Node.ConditionStart; Slot < ConditionEnd; ++Slot)
+	{
+		INC_DWORD_STAT(STAT_DialogueTree_ConditionEvaluations);
+		const int32 i = bAdaptive ? ConditionOrder[Slot] : Slot;
+		const uint64 StartCycles = bAdaptive ? FPlatformTime::Cycles64() : 0;
+		const bool bMet = EvaluateCondition(i, Dialogue, Instance);
+
+		if (bAdaptive)
+		{
+			FDialogueConditionProfile& Profile = ConditionProfiles[i];
+			Profile.Cycles += FPlatformTime::Cycles64() - StartCycles;
+			Profile.Passes += bMet ? 1 : 0;
+			++Profile.Samples;
+		}
+
+		//Short circuit as soon as the outcome is known
+		if (bMet == Node.bIfAny)
+		{
+			bOutcome = bMet;
+			break;
+		}
+	}
+
+	const uint32 OrderInterval = Settings->ConditionOrderInterval;
+	if (bAdaptive && ++ConditionRuns[NodeIndex] >= OrderInterval)
+	{
+		ConditionRuns[NodeIndex] = 0;
+		UpdateConditionOrder(NodeIndex);
+	}
+
+	return bOutcome;
+}
+
+void FDialogueProgram::GetConditionOrder(int32 NodeIndex, 
+	TArray<int32>& OutOrder) const
+{
+	OutOrder.Reset();
+	if (!IsValidNode(NodeIndex) || ConditionOrder.Num() != Conditions.Num())
+	{
+		return;
+	}
+
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+	const int32 ConditionEnd = Node.ConditionStart + Node.ConditionCount;
+	for (int32 Slot = Node.ConditionStart; Slot < ConditionEnd; ++Slot)
+	{
+		OutOrder.Add(ConditionOrder[Slot] - Node.ConditionStart);
+	}
+}
+
+int32 FDialogueProgram::ResolveNext(int32 NodeIndex) const
+{
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+
+	if (Node.Kind == EDialogueNodeKind::Branch)
+	{
+		const int32 LinkOffset = PassesConditions(NodeIndex) ? 0 : 1;
+		return LinkOffset < Node.LinkCount
+			? Links[Node.LinkStart + LinkOffset] : INDEX_NONE;
+	}
+
+	return GetFirstLink(NodeIndex);
+}
+
+bool FDialogueProgram::ResolveOption(int32 NodeIndex,
+	FResolvedDialogueOption& OutOption) const
+{
+	int32 TargetIndex = INDEX_NONE;
+	int32 LockIndex = INDEX_NONE;
+	int32 Current = NodeIndex;
+
+	//Every node can be passed at most once before we know we are cycling
+	for (int32 Hops = 0; Hops < Nodes.Num() && IsValidNode(Current); ++Hops)
+	{
+		const FDialogueProgramNode& Node = Nodes[Current];
+
+		switch (Node.Kind)
+		{
+		case EDialogueNodeKind::Speech:
+			OutOption.TargetIndex = 
+				TargetIndex == INDEX_NONE ? Current : TargetIndex;
+			OutOption.SpeechIndex = Node.SpeechIndex;
+			OutOption.LockIndex = LockIndex;
+
+			//The outermost lock decides the option's lock state
+			OutOption.bIsLocked = 
+				LockIndex != INDEX_NONE && !PassesConditions(LockIndex);
+			return true;
+
+		//These nodes become the option's target themselves
+		case EDialogueNodeKind::Event:
+		case EDialogueNodeKind::Jump:
+		case EDialogueNodeKind::Branch:
+			if (TargetIndex == INDEX_NONE)
+			{
+				TargetIndex = Current;
+			}
+			break;
+
+		case EDialogueNodeKind::OptionLock:
+			if (LockIndex == INDEX_NONE)
+			{
+				LockIndex = Current;
+			}
+			break;
+
+		case EDialogueNodeKind::Reroute:
+			break;
+
+		default:
+			return false;
+		}
+
+		Current = ResolveNext(Current);
+	}
+
+	return false;
+}
+
+void FDialogueProgram::GatherOptions(int32 NodeIndex,
+	TArray<FResolvedDialogueOption>& OutOptions) const
+{
+	DIALOGUE_TRACE_SCOPE(
+		"GatherOptions",
+		NodeObjects[NodeIndex]->GetDialogue(),
+		NodeObjects[NodeIndex]->GetNodeID()
+	);
+
+	OutOptions.Reset();
+
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+	const int32 RouteEnd = Node.RouteStart + Node.RouteCount;
+	int32 ResolvedSlot = INDEX_NONE;
+
+	for (int32 i = Node.RouteStart; i < RouteEnd; ++i)
+	{
+		const FDialogueOptionRoute& Route = OptionRoutes[i];
+
+		//Routes of a link are consecutive; the first one taken wins
+		if (Route.LinkSlot == ResolvedSlot)
+		{
+			continue;
+		}
+
+		//Links too tangled to precompute are walked instead
+		if (Route.SpeechIndex == INDEX_NONE)
+		{
+			ResolvedSlot = Route.LinkSlot;
+			FResolvedDialogueOption& Option = OutOptions.AddDefaulted_GetRef();
+
+			if (!ResolveOption(Links[Node.LinkStart + Route.LinkSlot], Option)
+				|| Speeches[Option.SpeechIndex].SpeechText.IsEmpty())
+			{
+				OutOptions.Pop(EAllowShrinking::No);
+			}
+			continue;
+		}
+
+		if (!PassesGuards(Route))
+		{
+			continue;
+		}
+
+		ResolvedSlot = Route.LinkSlot;
+		FResolvedDialogueOption& Option = OutOptions.AddDefaulted_GetRef();
+		Option.TargetIndex = Route.TargetIndex;
+		Option.SpeechIndex = Route.SpeechIndex;
+		Option.LockIndex = Route.LockIndex;
+		Option.bIsLocked = Route.LockIndex != INDEX_NONE
+			&& !PassesConditions(Route.LockIndex);
+	}
+}
+
+const FSpeechDetails& FDialogueProgram::GetOptionSpeech(
+	const FResolvedDialogueOption& InOption) const
+{
+	return Speeches[InOption.SpeechIndex];
+}
+
+void FDialogueProgram::GetOptionDetails(
+	const FResolvedDialogueOption& InOption, FSpeechDetails& OutDetails) const
+{
+	OutDetails = Speeches[InOption.SpeechIndex];
+
+	if (InOption.LockIndex != INDEX_NONE)
+	{
+		const int32 MessageIndex = Nodes[InOption.LockIndex].MessageIndex;
+		OutDetails.bIsLocked = InOption.bIsLocked;
+		OutDetails.OptionMessage = InOption.bIsLocked
+			? Messages[MessageIndex]
+			: Messages[MessageIndex + 1];
+	}
+}
+
+int32 FDialogueProgram::AddNode(UDialogueNode* InNode)
+{
+	check(InNode);
+
+	const int32 NewIndex = Nodes.AddDefaulted();
+	NodeObjects.Add(InNode);
+	NodeIndices.Add(InNode->GetNodeID(), NewIndex);
+	InNode->SetNodeIndex(NewIndex);
+
+	const uint32 StableID = InNode->GetStableID();
+	if (StableID == 0)
+	{
+		return NewIndex;
+	}
+
+	//A clash leaves the later node keyed by its node ID alone
+	if (StableNodeIndices.Contains(StableID))
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Warning,
+			TEXT("Node %s shares its stable ID with another node. Its save data will be keyed by node ID instead."),
+			*InNode->GetNodeID().ToString()
+		);
+		return NewIndex;
+	}
+
+	Nodes[NewIndex].StableID = StableID;
+	StableNodeIndices.Add(StableID, NewIndex);
+	return NewIndex;
+}
+
+void FDialogueProgram::AddLink(UDialogueNode* InLinked,
+	FDialogueProgramNode& OutNode)
+{
+	if (OutNode.LinkCount == 0)
+	{
+		OutNode.LinkStart = Links.Num();
+	}
+	check(OutNode.LinkStart + OutNode.LinkCount == Links.Num());
+
+	Links.Add(IndexOf(InLinked));
+	++OutNode.LinkCount;
+}
+
+void FDialogueProgram::AddCondition(UDialogueCondition* InCondition,
+	FDialogueProgramNode& OutNode)
+{
+	if (OutNode.ConditionCount == 0)
+	{
+		OutNode.ConditionStart = Conditions.Num();
+	}
+	check(OutNode.ConditionStart + OutNode.ConditionCount == Conditions.Num());
+
+	Conditions.Add(InCondition);
+	++OutNode.ConditionCount;
+
+	//Added before compiling, as the condition may add its query
+	const int32 InstructionIndex = ConditionCode.AddDefaulted();
+	FDialogueConditionInstruction Instruction;
+	if (InCondition)
+	{
+		InCondition->CompileCondition(*this, Instruction);
+	}
+	ConditionCode[InstructionIndex] = Instruction;
+}
+
+int32 FDialogueProgram::AddConditionQuery(UDialogueQuery* InQuery)
+{
+	//Copies of a pure query share a result, so evaluate them as one
+	if (InQuery && InQuery->IsCacheable())
+	{
+		const int32 Existing = ConditionQueries.IndexOfByPredicate(
+			[InQuery](const UDialogueQuery* Other)
+			{
+				return Other && AreQueriesIdentical(InQuery, Other);
+			}
+		);
+		if (Existing != INDEX_NONE)
+		{
+			return Existing;
+		}
+	}
+
+	return ConditionQueries.Add(InQuery);
+}
+
+void FDialogueProgram::AddSpeech(const FSpeechDetails& InDetails,
+	FDialogueProgramNode& OutNode)
+{
+	OutNode.SpeechIndex = Speeches.Add(InDetails);
+	OutNode.SpeakerSlot = FindSpeakerSlot(InDetails.SpeakerName);
+}
+
+int32 FDialogueProgram::AddBlackboardKey(FName InKey,
+	EDialogueBlackboardType InType)
+{
+	if (InKey.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	//Only runs while compiling, and the array index is the key's slot, so
+	//a map would just be a second index to keep in step
+	const int32 ExistingIndex = BlackboardKeys.IndexOfByPredicate(
+		[InKey](const FDialogueBlackboardKey& Key)
+		{
+			return Key.Name == InKey;
+		}
+	);
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	FDialogueBlackboardKey NewKey;
+	NewKey.Name = InKey;
+	NewKey.Type = InType;
+	return BlackboardKeys.Add(NewKey);
+}
+
+int32 FDialogueProgram::AddBlackboardConstant(
+	const FDialogueBlackboardValue& InValue)
+{
+	return BlackboardConstants.Add(InValue);
+}
+
+int32 FDialogueProgram::AddSpeakerRole(FName InRole)
+{
+	if (InRole.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ExistingSlot = FindSpeakerSlot(InRole);
+	return ExistingSlot != INDEX_NONE ? ExistingSlot : SpeakerRoles.Add(InRole);
+}
+
+void FDialogueProgram::AddMessages(const FText& LockedText,
+	const FText& UnlockedText, FDialogueProgramNode& OutNode)
+{
+	OutNode.MessageIndex = Messages.Add(LockedText);
+	Messages.Add(UnlockedText);
+}
+
+void FDialogueProgram::SetEntryIndex(int32 InIndex)
+{
+	EntryIndex = InIndex;
+}
+
+void FDialogueProgram::AddRenamedNode(FName OldNodeID, int32 InVisitIndex)
+{
+	RenamedVisitSlots.Add(OldNodeID, InVisitIndex);
+}
+
+void FDialogueProgram::SetNumVisitSlots(int32 InNum)
+{
+	NumVisitSlots = InNum;
+}
+
+void FDialogueProgram::CompileOptionRoutes()
+{
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		if (!Nodes[NodeIndex].bResolvesOptions)
+		{
+			continue;
+		}
+
+		Nodes[NodeIndex].RouteStart = OptionRoutes.Num();
+		for (int32 Slot = 0; Slot < Nodes[NodeIndex].LinkCount; ++Slot)
+		{
+			CompileOptionRoutesForLink(
+				Slot, 
+				Links[Nodes[NodeIndex].LinkStart + Slot]
+			);
+		}
+		Nodes[NodeIndex].RouteCount = 
+			OptionRoutes.Num() - Nodes[NodeIndex].RouteStart;
+	}
+}
+
+FDialogueProgramNode& FDialogueProgram::GetMutableNode(int32 NodeIndex)
+{
+	return Nodes[NodeIndex];
+}
+
+void FDialogueProgram::CompileOptionRoutesForLink(int32 LinkSlot,
+	int32 LinkedIndex)
+{
+	//Past this many walks the link is left to be resolved at runtime
+	constexpr int32 MaxWalks = 64;
+
+	/** A path being followed from the link, split off at each branch */
+	struct FRouteWalk
+	{
+		int32 Current = INDEX_NONE;
+		int32 TargetIndex = INDEX_NONE;
+		int32 LockIndex = INDEX_NONE;
+		int32 NumGuards = 0;
+		int32 Hops = 0;
+		FDialogueOptionGuard Guard;
+	};
+
+	const int32 FirstRoute = OptionRoutes.Num();
+	const int32 FirstGuard = OptionGuards.Num();
+
+	TArray<FRouteWalk, TInlineAllocator<8>> Walks;
+	TArray<FDialogueOptionGuard, TInlineAllocator<8>> Guards;
+	Walks.AddDefaulted_GetRef().Current = LinkedIndex;
+
+	int32 NumWalks = 0;
+	while (!Walks.IsEmpty())
+	{
+		if (++NumWalks > MaxWalks)
+		{
+			OptionRoutes.SetNum(FirstRoute);
+			OptionGuards.SetNum(FirstGuard);
+
+			FDialogueOptionRoute& Route = OptionRoutes.AddDefaulted_GetRef();
+			Route.LinkSlot = LinkSlot;
+			return;
+		}
+
+		FRouteWalk Walk = Walks.Pop(EAllowShrinking::No);
+
+		//Guards are shared with the walk this one split off from
+		Guards.SetNum(Walk.NumGuards, EAllowShrinking::No);
+		if (Walk.Guard.NodeIndex != INDEX_NONE)
+		{
+			Guards.Add(Walk.Guard);
+		}
+
+		//Follow the path until it reaches a speech, splits or dies out
+		bool bWalking = true;
+		for (; bWalking && Walk.Hops < Nodes.Num() 
+			&& IsValidNode(Walk.Current); ++Walk.Hops)
+		{
+			const FDialogueProgramNode& Node = Nodes[Walk.Current];
+
+			switch (Node.Kind)
+			{
+			case EDialogueNodeKind::Speech:
+			{
+				bWalking = false;
+
+				//Options without text are never shown
+				if (Speeches[Node.SpeechIndex].SpeechText.IsEmpty())
+				{
+					break;
+				}
+
+				FDialogueOptionRoute& Route = 
+					OptionRoutes.AddDefaulted_GetRef();
+				Route.LinkSlot = LinkSlot;
+				Route.TargetIndex = Walk.TargetIndex == INDEX_NONE 
+					? Walk.Current : Walk.TargetIndex;
+				Route.SpeechIndex = Node.SpeechIndex;
+				Route.LockIndex = Walk.LockIndex;
+				Route.GuardStart = OptionGuards.Num();
+				Route.GuardCount = Guards.Num();
+				OptionGuards.Append(Guards);
+				break;
+			}
+
+			case EDialogueNodeKind::Branch:
+			{
+				bWalking = false;
+
+				if (Walk.TargetIndex == INDEX_NONE)
+				{
+					Walk.TargetIndex = Walk.Current;
+				}
+
+				//Split the walk, pushing false first so true is taken first
+				for (int32 Outcome = Node.LinkCount - 1; Outcome >= 0; 
+					--Outcome)
+				{
+					if (Outcome > 1)
+					{
+						continue;
+					}
+
+					FRouteWalk& Split = Walks.Add_GetRef(Walk);
+					Split.Current = Links[Node.LinkStart + Outcome];
+					Split.NumGuards = Guards.Num();
+					Split.Hops = Walk.Hops + 1;
+					Split.Guard.NodeIndex = Walk.Current;
+					Split.Guard.bPasses = Outcome == 0;
+				}
+				break;
+			}
+
+			case EDialogueNodeKind::Event:
+			case EDialogueNodeKind::Jump:
+				if (Walk.TargetIndex == INDEX_NONE)
+				{
+					Walk.TargetIndex = Walk.Current;
+				}
+				Walk.Current = GetFirstLink(Walk.Current);
+				break;
+
+			case EDialogueNodeKind::OptionLock:
+				if (Walk.LockIndex == INDEX_NONE)
+				{
+					Walk.LockIndex = Walk.Current;
+				}
+				Walk.Current = GetFirstLink(Walk.Current);
+				break;
+
+			case EDialogueNodeKind::Reroute:
+				Walk.Current = GetFirstLink(Walk.Current);
+				break;
+
+			default:
+				bWalking = false;
+				break;
+			}
+		}
+	}
+}
+
+bool FDialogueProgram::EvaluateCondition(int32 InIndex, 
+	const UDialogue* InDialogue, FDialogueInstance* InInstance) const
+{
+	const FDialogueConditionInstruction& Instruction = ConditionCode[InIndex];
+	bool bResult = false;
+
+	switch (Instruction.Op)
+	{
+	case EDialogueConditionOp::NodeVisited:
+		bResult = InInstance && InInstance->GetController()->WasNodeVisited(
+			InDialogue, 
+			Instruction.Operand
+		);
+		break;
+
+	case EDialogueConditionOp::SpeakerFound:
+		bResult = IsSpeakerFound(Instruction, InInstance);
+		break;
+
+	case EDialogueConditionOp::BlackboardNumber:
+		bResult = InInstance && CompareConditionValue(
+			InInstance->ReadBlackboard(Instruction.Operand).Number,
+			Instruction.Compare,
+			Instruction.Value
+		);
+		break;
+
+	case EDialogueConditionOp::BlackboardName:
+		bResult = InInstance 
+			&& InInstance->ReadBlackboard(Instruction.Operand).Name
+				== BlackboardConstants[Instruction.SecondOperand].Name;
+		break;
+
+	case EDialogueConditionOp::BlackboardTag:
+		bResult = InInstance 
+			&& InInstance->ReadBlackboard(Instruction.Operand).Tag.MatchesTag(
+				BlackboardConstants[Instruction.SecondOperand].Tag
+			);
+		break;
+
+	case EDialogueConditionOp::CallQueryBool:
+	case EDialogueConditionOp::CallQueryInt:
+	case EDialogueConditionOp::CallQueryFloat:
+		bResult = CompareConditionValue(
+			ExecuteConditionQuery(Instruction, InDialogue, InInstance),
+			Instruction.Compare, 
+			Instruction.Value
+		);
+		break;
+
+	default:
+		bResult = Conditions[InIndex] && Conditions[InIndex]->IsMet();
+		break;
+	}
+
+	return bResult != Instruction.bNegate;
+}
+
+bool FDialogueProgram::IsConditionPure(int32 InIndex) const
+{
+	const FDialogueConditionInstruction& Instruction = ConditionCode[InIndex];
+
+	switch (Instruction.Op)
+	{
+	//Custom conditions may do anything
+	case EDialogueConditionOp::CallCondition:
+		return false;
+
+	case EDialogueConditionOp::CallQueryBool:
+	case EDialogueConditionOp::CallQueryInt:
+	case EDialogueConditionOp::CallQueryFloat:
+	{
+		const UDialogueQuery* Query = ConditionQueries[Instruction.Operand];
+		return Query && Query->IsCacheable();
+	}
+
+	//Everything lowered to a native check only reads
+	default:
+		return true;
+	}
+}
+
+void FDialogueProgram::InitConditionProfiles() const
+{
+	ConditionProfiles.Reset();
+	ConditionProfiles.SetNum(Conditions.Num());
+
+	ConditionOrder.Reset(Conditions.Num());
+	for (int32 i = 0; i < Conditions.Num(); ++i)
+	{
+		ConditionOrder.Add(i);
+	}
+
+	ConditionRuns.Init(0, Nodes.Num());
+}
+
+void FDialogueProgram::UpdateConditionOrder(int32 NodeIndex) const
+{
+	const FDialogueProgramNode& Node = Nodes[NodeIndex];
+	const int32 ConditionEnd = Node.ConditionStart + Node.ConditionCount;
+
+	//Expected cost of reaching the outcome through the condition. Running
+	//conditions from the lowest rank up minimizes the expected total.
+	TArray<double, TInlineAllocator<16>> Ranks;
+	Ranks.SetNumUninitialized(Node.ConditionCount);
+	for (int32 i = Node.ConditionStart; i < ConditionEnd; ++i)
+	{
+		const FDialogueConditionProfile& Profile = ConditionProfiles[i];
+		double& Rank = Ranks[i - Node.ConditionStart];
+
+		//Conditions that never ran yet go first, so they get measured
+		if (Profile.Samples == 0)
+		{
+			Rank = 0.0;
+			continue;
+		}
+
+		const double Cost = (double)Profile.Cycles / Profile.Samples;
+		const double PassRate = 
+			(Profile.Passes + 1.0) / (Profile.Samples + 2.0);
+		Rank = Cost / (Node.bIfAny ? PassRate : 1.0 - PassRate);
+	}
+
+	auto ByRank = [&Ranks, &Node](int32 A, int32 B)
+	{
+		const double RankA = Ranks[A - Node.ConditionStart];
+		const double RankB = Ranks[B - Node.ConditionStart];
+		return RankA < RankB || (RankA == RankB && A < B);
+	};
+
+	//Impure conditions stay put and only the pure runs between them are
+	//sorted. Each run reaches the same outcome in any order, so impure
+	//conditions still run exactly when they would have as authored.
+	bool bReordered = false;
+	int32 RunStart = Node.ConditionStart;
+	for (int32 Slot = Node.ConditionStart; Slot <= ConditionEnd; ++Slot)
+	{
+		if (Slot < ConditionEnd && IsConditionPure(ConditionOrder[Slot]))
+		{
+			continue;
+		}
+
+		TArrayView<int32> Run(
+			ConditionOrder.GetData() + RunStart, 
+			Slot - RunStart
+		);
+		if (!Algo::IsSorted(Run, ByRank))
+		{
+			Algo::Sort(Run, ByRank);
+			bReordered = true;
+		}
+
+		RunStart = Slot + 1;
+	}
+
+	for (int32 i = Node.ConditionStart; i < ConditionEnd; ++i)
+	{
+		FDialogueConditionProfile& Profile = ConditionProfiles[i];
+		if (Profile.Samples > MaxConditionSamples)
+		{
+			Profile.Cycles /= 2;
+			Profile.Samples /= 2;
+			Profile.Passes /= 2;
+		}
+	}
+
+	if (bReordered)
+	{
+		TArray<int32> Order;
+		GetConditionOrder(NodeIndex, Order);
+		UE_LOG(
+			LogDialogueTree,
+			Verbose,
+			TEXT("Reordered conditions of node %s to [%s]."),
+			*NodeObjects[NodeIndex]->GetNodeID().ToString(),
+			*FString::JoinBy(Order, TEXT(", "), [](int32 Position)
+				{
+					//Count from one, as the editor tooltip does
+					return FString::FromInt(Position + 1);
+				}
+			)
+		);
+	}
+}
+
+bool FDialogueProgram::IsSpeakerFound(
+	const FDialogueConditionInstruction& InInstruction,
+	FDialogueInstance* InInstance) const
+{
+	if (!InInstance)
+	{
+		return false;
+	}
+
+	UDialogueSpeakerComponent* Found = 
+		InInstance->GetSpeakerAt(InInstruction.Operand);
+	if (InInstruction.Value <= 0.0)
+	{
+		return Found != nullptr;
+	}
+
+	//Distance is measured from another speaker in the dialogue
+	UDialogueSpeakerComponent* Origin = 
+		InInstance->GetSpeakerAt(InInstruction.SecondOperand);
+	if (!Origin)
+	{
+		return false;
+	}
+
+	const FVector OriginLocation = Origin->GetComponentLocation();
+	if (Found)
+	{
+		return FVector::DistSquared(Found->GetComponentLocation(), 
+			OriginLocation) <= FMath::Square(InInstruction.Value);
+	}
+
+	if (!InInstruction.bIncludeUnbound)
+	{
+		return false;
+	}
+
+	UWorld* World = Origin->GetWorld();
+	UDialogueManagerSubsystem* DialogueSubsystem = World
+		? World->GetSubsystem<UDialogueManagerSubsystem>()
+		: nullptr;
+
+	return DialogueSubsystem && DialogueSubsystem->FindNearestSpeaker(
+		GetSpeakerRole(InInstruction.Operand),
+		OriginLocation,
+		InInstruction.Value
+	) != nullptr;
+}
+
+double FDialogueProgram::ExecuteConditionQuery(
+	const FDialogueConditionInstruction& InInstruction,
+	const UDialogue* InDialogue, FDialogueInstance* InInstance) const
+{
+	UDialogueQuery* Query = ConditionQueries[InInstruction.Operand];
+	if (!Query)
+	{
+		return 0.0;
+	}
+
+	//Results are cached per instance, which keys them by bound speakers
+	const bool bCacheable = InInstance && Query->IsCacheable();
+	double Value = 0.0;
+	if (bCacheable 
+		&& InInstance->FindQueryResult(InInstruction.Operand, Value))
+	{
+		INC_DWORD_STAT(STAT_DialogueTree_QueryCacheHits);
+		return Value;
+	}
+
+	DIALOGUE_TRACE_SCOPE(
+		"ExecuteQuery", 
+		InDialogue, 
+		Query->GetClass()->GetFName()
+	);
+
+	//The compiler only emits these over queries of the matching type
+	if (InInstruction.Op == EDialogueConditionOp::CallQueryBool)
+	{
+		Value = static_cast<UDialogueQueryBool*>(Query)->ExecuteQuery();
+	}
+	else if (InInstruction.Op == EDialogueConditionOp::CallQueryInt)
+	{
+		Value = static_cast<UDialogueQueryInt*>(Query)->ExecuteQuery();
+	}
+	else
+	{
+		Value = static_cast<UDialogueQueryFloat*>(Query)->ExecuteQuery();
+	}
+
+	if (bCacheable)
+	{
+		InInstance->StoreQueryResult(InInstruction.Operand, Value);
+	}
+
+	return Value;
+}
+
+bool FDialogueProgram::PassesGuards(const FDialogueOptionRoute& InRoute) const
+{
+	const int32 GuardEnd = InRoute.GuardStart + InRoute.GuardCount;
+
+	for (int32 i = InRoute.GuardStart; i < GuardEnd; ++i)
+	{
+		const FDialogueOptionGuard& Guard = OptionGuards[i];
+		if (PassesConditions(Guard.NodeIndex) != Guard.bPasses)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
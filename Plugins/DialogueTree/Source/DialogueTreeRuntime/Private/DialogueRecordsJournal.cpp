@@ -0,0 +1,281 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueRecordsJournal.h"
+//UE
+#include "Misc/Compression.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Tasks/Task.h"
+//Plugin
+#include "DialogueController.h"
+#include "DialogueRecordsSerializer.h"
+#include "LogDialogueTree.h"
+
+namespace
+{
+	/** Compression used for saved records */
+	const FName RecordsCompression = NAME_Zlib;
+
+	/** Largest records blob a save slot may claim to hold */
+	constexpr int32 MaxRecordsSize = 64 * 1024 * 1024;
+
+	/** Size of the uncompressed size written ahead of saved records */
+	constexpr int32 SizeHeaderBytes = sizeof(int32);
+
+	void ApplyEntry(FDialogueRecords& OutRecords,
+		const FDialogueJournalEntry& InEntry)
+	{
+		switch (InEntry.Op)
+		{
+		case EDialogueJournalOp::Replace:
+			OutRecords = *InEntry.Records;
+			break;
+
+		case EDialogueJournalOp::SetRecord:
+			//The record takes over any stored under its name by older saves
+			OutRecords.Records.Remove(InEntry.Record->DialogueFName);
+			OutRecords.KeyedRecords.Add(InEntry.DialogueKey, *InEntry.Record);
+			break;
+
+		case EDialogueJournalOp::SetVisited:
+			OutRecords.KeyedRecords.FindOrAdd(InEntry.DialogueKey)
+				.SetVisited(InEntry.VisitIndex, InEntry.bVisited);
+			break;
+
+		case EDialogueJournalOp::ClearVisits:
+			OutRecords.KeyedRecords.FindOrAdd(InEntry.DialogueKey)
+				.ClearVisits();
+			break;
+
+		case EDialogueJournalOp::SetResumeNode:
+		{
+			FDialogueNodeVisits& Record =
+				OutRecords.KeyedRecords.FindOrAdd(InEntry.DialogueKey);
+			Record.ResumeNodeID = InEntry.Name;
+			Record.ResumeNodeKey = InEntry.NodeKey;
+			break;
+		}
+
+		case EDialogueJournalOp::SetBlackboard:
+		{
+			const int32 Slot = OutRecords.Blackboard.FindOrAddSlot(
+				InEntry.Name,
+				InEntry.Type
+			);
+			if (OutRecords.Blackboard.IsValidSlot(Slot))
+			{
+				OutRecords.Blackboard.SetValue(Slot, InEntry.Value);
+			}
+			break;
+		}
+		}
+	}
+
+	bool CompressRecords(const TArray<uint8>& InBytes,
+		TArray<uint8>& OutBytes)
+	{
+		//The uncompressed size comes first, so loading can allocate once
+		int32 UncompressedSize = InBytes.Num();
+		int32 CompressedSize = FCompression::CompressMemoryBound(
+			RecordsCompression,
+			UncompressedSize
+		);
+
+		OutBytes.SetNumUninitialized(SizeHeaderBytes + CompressedSize);
+		FMemory::Memcpy(OutBytes.GetData(), &UncompressedSize,
+			SizeHeaderBytes);
+
+		if (!FCompression::CompressMemory(RecordsCompression,
+			OutBytes.GetData() + SizeHeaderBytes, CompressedSize,
+			InBytes.GetData(), UncompressedSize))
+		{
+			return false;
+		}
+
+		OutBytes.SetNum(SizeHeaderBytes + CompressedSize);
+		return true;
+	}
+
+	bool DecompressRecords(const TArray<uint8>& InBytes,
+		TArray<uint8>& OutBytes)
+	{
+		if (InBytes.Num() < SizeHeaderBytes)
+		{
+			return false;
+		}
+
+		int32 UncompressedSize = 0;
+		FMemory::Memcpy(&UncompressedSize, InBytes.GetData(),
+			SizeHeaderBytes);
+		if (UncompressedSize < 0 || UncompressedSize > MaxRecordsSize)
+		{
+			return false;
+		}
+
+		OutBytes.SetNumUninitialized(UncompressedSize);
+		return FCompression::UncompressMemory(RecordsCompression,
+			OutBytes.GetData(), UncompressedSize,
+			InBytes.GetData() + SizeHeaderBytes,
+			InBytes.Num() - SizeHeaderBytes);
+	}
+}
+
+FDialogueRecordsJournal::FDialogueRecordsJournal(
+	const FDialogueRecords& InRecords)
+	: SavedRecords(MakeShared<FDialogueRecords>(InRecords))
+{
+}
+
+FDialogueRecordsJournal::~FDialogueRecordsJournal()
+{
+	WaitForSaves();
+}
+
+void FDialogueRecordsJournal::RecordReplace(
+	const FDialogueRecords& InRecords)
+{
+	//Everything before a replace is moot
+	Pending.Reset();
+
+	FDialogueJournalEntry& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Op = EDialogueJournalOp::Replace;
+	Entry.Records = MakeShared<FDialogueRecords>(InRecords);
+}
+
+void FDialogueRecordsJournal::RecordSetRecord(uint64 InKey,
+	const FDialogueNodeVisits& InRecord)
+{
+	FDialogueJournalEntry& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Op = EDialogueJournalOp::SetRecord;
+	Entry.DialogueKey = InKey;
+	Entry.Record = MakeShared<FDialogueNodeVisits>(InRecord);
+}
+
+void FDialogueRecordsJournal::RecordSetVisited(uint64 InKey,
+	int32 InVisitIndex, bool bInVisited)
+{
+	FDialogueJournalEntry& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Op = EDialogueJournalOp::SetVisited;
+	Entry.DialogueKey = InKey;
+	Entry.VisitIndex = InVisitIndex;
+	Entry.bVisited = bInVisited;
+}
+
+void FDialogueRecordsJournal::RecordClearVisits(uint64 InKey)
+{
+	FDialogueJournalEntry& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Op = EDialogueJournalOp::ClearVisits;
+	Entry.DialogueKey = InKey;
+}
+
+void FDialogueRecordsJournal::RecordSetResumeNode(uint64 InKey,
+	FName InNodeID, uint32 InNodeKey)
+{
+	FDialogueJournalEntry& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Op = EDialogueJournalOp::SetResumeNode;
+	Entry.DialogueKey = InKey;
+	Entry.Name = InNodeID;
+	Entry.NodeKey = InNodeKey;
+}
+
+void FDialogueRecordsJournal::RecordSetBlackboard(FName InKey,
+	EDialogueBlackboardType InType, const FDialogueBlackboardValue& InValue)
+{
+	FDialogueJournalEntry& Entry = Pending.AddDefaulted_GetRef();
+	Entry.Op = EDialogueJournalOp::SetBlackboard;
+	Entry.Name = InKey;
+	Entry.Type = InType;
+	Entry.Value = InValue;
+}
+
+UE::Tasks::FTask FDialogueRecordsJournal::SaveAsync(
+	const FString& InSlotName, int32 InUserIndex)
+{
+	//Module lookups are game thread only, so find the save system here
+	ISaveGameSystem* SaveSystem =
+		IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!SaveSystem)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Could not save dialogue records. No save game system.")
+		);
+		return LastSave;
+	}
+
+	auto SaveTask =
+		[
+			SaveSystem,
+			Records = SavedRecords,
+			Entries = MoveTemp(Pending),
+			SlotName = InSlotName,
+			InUserIndex
+		]()
+		{
+			for (const FDialogueJournalEntry& Entry : Entries)
+			{
+				ApplyEntry(*Records, Entry);
+			}
+
+			TArray<uint8> Bytes;
+			FDialogueRecordsSerializer::Save(*Records, nullptr, true, Bytes);
+
+			TArray<uint8> Compressed;
+			if (!CompressRecords(Bytes, Compressed)
+				|| !SaveSystem->SaveGame(false, *SlotName, InUserIndex,
+					Compressed))
+			{
+				UE_LOG(
+					LogDialogueTree,
+					Error,
+					TEXT("Could not save dialogue records to slot %s."),
+					*SlotName
+				);
+			}
+		};
+	Pending.Reset();
+
+	//Each save replays onto the records the one before it left
+	LastSave = LastSave.IsValid()
+		? UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(SaveTask),
+			UE::Tasks::Prerequisites(LastSave))
+		: UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(SaveTask));
+
+	return LastSave;
+}
+
+void FDialogueRecordsJournal::WaitForSaves() const
+{
+	if (LastSave.IsValid())
+	{
+		LastSave.Wait();
+	}
+}
+
+bool FDialogueRecordsJournal::LoadFromSlot(const FString& InSlotName,
+	int32 InUserIndex, TArray<uint8>& OutBytes)
+{
+	ISaveGameSystem* SaveSystem =
+		IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	TArray<uint8> Compressed;
+	if (!SaveSystem
+		|| !SaveSystem->LoadGame(false, *InSlotName, InUserIndex, Compressed))
+	{
+		return false;
+	}
+
+	if (!DecompressRecords(Compressed, OutBytes))
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Dialogue records in slot %s are corrupt."),
+			*InSlotName
+		);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,578 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueRecordsSerializer.h"
+//UE
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+//Plugin
+#include "DialogueController.h"
+#include "LogDialogueTree.h"
+
+namespace
+{
+	/** Marks the start of a dialogue records blob ("DTRC") */
+	constexpr uint32 RecordsMagic = 0x43525444;
+
+	/** Flags stored in the blob header */
+	enum ERecordsFlags : uint8
+	{
+		RF_Partial = 1 << 0,
+		RF_Blackboard = 1 << 1
+	};
+
+	/** How a dialogue's visits are written */
+	enum class EVisitsForm : uint8
+	{
+		Bits,
+		Slots
+	};
+
+	/** Which fields of a blackboard value are written */
+	enum EValueFields : uint8
+	{
+		VF_Integer = 1 << 0,
+		VF_Double = 1 << 1,
+		VF_Name = 1 << 2,
+		VF_Tag = 1 << 3
+	};
+
+	/** Largest magnitude at which every integer is exact as a double */
+	constexpr double MaxExactInteger = 9007199254740992.0;
+
+	/** Highest visit slot a dialogue can have, one per node */
+	constexpr int64 MaxVisitSlot = MAX_uint16 * 32;
+
+	void WriteVarInt(FArchive& Ar, uint64 InValue)
+	{
+		do
+		{
+			uint8 Byte = InValue & 0x7f;
+			InValue >>= 7;
+			if (InValue != 0)
+			{
+				Byte |= 0x80;
+			}
+			Ar << Byte;
+		} while (InValue != 0);
+	}
+
+	uint64 ReadVarInt(FArchive& Ar)
+	{
+		uint64 Value = 0;
+		for (int32 Shift = 0; Shift < 64 && !Ar.IsError(); Shift += 7)
+		{
+			uint8 Byte = 0;
+			Ar << Byte;
+			Value |= uint64(Byte & 0x7f) << Shift;
+			if ((Byte & 0x80) == 0)
+			{
+				return Value;
+			}
+		}
+
+		Ar.SetError();
+		return 0;
+	}
+
+	int32 GetVarIntSize(uint64 InValue)
+	{
+		int32 Size = 1;
+		while (InValue >>= 7)
+		{
+			++Size;
+		}
+		return Size;
+	}
+
+	/** Reads a count, failing if that many entries cannot fit in the rest
+	* of the blob */
+	int32 ReadCount(FArchive& Ar, int32 InMinEntrySize = 1)
+	{
+		const uint64 Count = ReadVarInt(Ar);
+		const int64 Remaining = Ar.TotalSize() - Ar.Tell();
+		if (Ar.IsError() || Count * InMinEntrySize > uint64(Remaining))
+		{
+			Ar.SetError();
+			return 0;
+		}
+		return static_cast<int32>(Count);
+	}
+
+	/** Reads a name table entry, failing if its claimed length cannot fit
+	* in the rest of the blob */
+	FName ReadNameString(FArchive& Ar)
+	{
+		int32 Length = 0;
+		Ar << Length;
+
+		//Negative lengths mark UTF-16 strings
+		const int64 Bytes = Length < 0
+			? -static_cast<int64>(Length) * sizeof(UTF16CHAR)
+			: static_cast<int64>(Length);
+		if (Ar.IsError() || Bytes > Ar.TotalSize() - Ar.Tell())
+		{
+			Ar.SetError();
+			return NAME_None;
+		}
+
+		//Let the string read its own header again
+		Ar.Seek(Ar.Tell() - sizeof(int32));
+		FString NameString;
+		Ar << NameString;
+		return FName(*NameString);
+	}
+
+	/** Writes the body of a blob, collecting its names into a table */
+	class FRecordsWriter
+	{
+	public:
+		explicit FRecordsWriter(TArray<uint8>& OutBody)
+			: Ar(OutBody) {}
+
+		void WriteName(FName InName)
+		{
+			const int32 Index = NameIndices.FindOrAdd(InName, Names.Num());
+			if (Index == Names.Num())
+			{
+				Names.Add(InName);
+			}
+			WriteVarInt(Ar, Index);
+		}
+
+		void WriteRecord(const FDialogueNodeVisits& InRecord)
+		{
+			WriteName(InRecord.DialogueFName);
+			WriteName(InRecord.ResumeNodeID);
+			WriteVarInt(Ar, InRecord.ResumeNodeKey);
+			WriteVisits(InRecord.VisitedNodeBits);
+
+			WriteVarInt(Ar, InRecord.VisitedNodeIDs.Num());
+			for (FName NodeID : InRecord.VisitedNodeIDs)
+			{
+				WriteName(NodeID);
+			}
+		}
+
+		void WriteBlackboard(const FDialogueBlackboard& InBlackboard)
+		{
+			TConstArrayView<FDialogueBlackboardEntry> Entries =
+				InBlackboard.GetEntries();
+			WriteVarInt(Ar, Entries.Num());
+			for (const FDialogueBlackboardEntry& Entry : Entries)
+			{
+				WriteName(Entry.Key);
+				uint8 Type = static_cast<uint8>(Entry.Type);
+				Ar << Type;
+				WriteValue(Entry.Value);
+			}
+		}
+
+		FMemoryWriter Ar;
+		TArray<FName> Names;
+
+	private:
+		void WriteVisits(const TArray<uint32>& InBits)
+		{
+			//Trailing empty words carry nothing
+			int32 NumWords = InBits.Num();
+			while (NumWords > 0 && InBits[NumWords - 1] == 0)
+			{
+				--NumWords;
+			}
+
+			TArray<int32, TInlineAllocator<64>> Slots;
+			for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+			{
+				for (uint32 Word = InBits[WordIndex]; Word; Word &= Word - 1)
+				{
+					Slots.Add(WordIndex * 32
+						+ FMath::CountTrailingZeros(Word));
+				}
+			}
+
+			//Few visits in a large dialogue are cheaper as slot deltas
+			int32 SlotsSize = GetVarIntSize(Slots.Num());
+			int32 PreviousSlot = -1;
+			for (int32 Slot : Slots)
+			{
+				SlotsSize += GetVarIntSize(Slot - PreviousSlot - 1);
+				PreviousSlot = Slot;
+			}
+			const int32 BitsSize = GetVarIntSize(NumWords)
+				+ NumWords * sizeof(uint32);
+
+			if (SlotsSize < BitsSize)
+			{
+				uint8 Form = static_cast<uint8>(EVisitsForm::Slots);
+				Ar << Form;
+				WriteVarInt(Ar, Slots.Num());
+				PreviousSlot = -1;
+				for (int32 Slot : Slots)
+				{
+					WriteVarInt(Ar, Slot - PreviousSlot - 1);
+					PreviousSlot = Slot;
+				}
+				return;
+			}
+
+			uint8 Form = static_cast<uint8>(EVisitsForm::Bits);
+			Ar << Form;
+			WriteVarInt(Ar, NumWords);
+			for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+			{
+				uint32 Word = InBits[WordIndex];
+				Ar << Word;
+			}
+		}
+
+		void WriteValue(const FDialogueBlackboardValue& InValue)
+		{
+			//A key keeps its first type, so write every field that is set
+			uint8 Fields = 0;
+			const double Number = InValue.Number;
+			const bool bInteger = FMath::Abs(Number) < MaxExactInteger
+				&& FMath::RoundToDouble(Number) == Number;
+			if (Number != 0.0)
+			{
+				Fields |= bInteger ? VF_Integer : VF_Double;
+			}
+			if (!InValue.Name.IsNone())
+			{
+				Fields |= VF_Name;
+			}
+			if (InValue.Tag.IsValid())
+			{
+				Fields |= VF_Tag;
+			}
+			Ar << Fields;
+
+			if (Fields & VF_Integer)
+			{
+				//Zigzag so small negative values stay small
+				const int64 Integer = static_cast<int64>(Number);
+				WriteVarInt(Ar,
+					(static_cast<uint64>(Integer) << 1) ^ (Integer >> 63));
+			}
+			if (Fields & VF_Double)
+			{
+				double Double = Number;
+				Ar << Double;
+			}
+			if (Fields & VF_Name)
+			{
+				WriteName(InValue.Name);
+			}
+			if (Fields & VF_Tag)
+			{
+				WriteName(InValue.Tag.GetTagName());
+			}
+		}
+
+		TMap<FName, int32> NameIndices;
+	};
+
+	/** Reads the body of a blob against its name table */
+	class FRecordsReader
+	{
+	public:
+		FRecordsReader(FArchive& InAr, const TArray<FName>& InNames)
+			: Ar(InAr), Names(InNames) {}
+
+		FName ReadName()
+		{
+			const uint64 Index = ReadVarInt(Ar);
+			if (Index >= static_cast<uint64>(Names.Num()))
+			{
+				Ar.SetError();
+				return NAME_None;
+			}
+			return Names[Index];
+		}
+
+		void ReadRecord(FDialogueNodeVisits& OutRecord)
+		{
+			OutRecord.DialogueFName = ReadName();
+			OutRecord.ResumeNodeID = ReadName();
+			OutRecord.ResumeNodeKey = static_cast<uint32>(ReadVarInt(Ar));
+			ReadVisits(OutRecord.VisitedNodeBits);
+
+			const int32 NumNodeIDs = ReadCount(Ar);
+			OutRecord.VisitedNodeIDs.Reserve(NumNodeIDs);
+			for (int32 i = 0; i < NumNodeIDs && !Ar.IsError(); ++i)
+			{
+				OutRecord.VisitedNodeIDs.Add(ReadName());
+			}
+		}
+
+		void ReadBlackboard(FDialogueBlackboard& OutBlackboard)
+		{
+			const int32 NumEntries = ReadCount(Ar, 3);
+			for (int32 i = 0; i < NumEntries && !Ar.IsError(); ++i)
+			{
+				const FName Key = ReadName();
+				uint8 Type = 0;
+				Ar << Type;
+				if (Type > static_cast<uint8>(EDialogueBlackboardType::Tag))
+				{
+					Ar.SetError();
+					return;
+				}
+
+				FDialogueBlackboardValue Value;
+				ReadValue(Value);
+				const int32 Slot = OutBlackboard.FindOrAddSlot(Key,
+					static_cast<EDialogueBlackboardType>(Type));
+				if (OutBlackboard.IsValidSlot(Slot))
+				{
+					OutBlackboard.SetValue(Slot, Value);
+				}
+			}
+		}
+
+	private:
+		void ReadVisits(TArray<uint32>& OutBits)
+		{
+			uint8 Form = 0;
+			Ar << Form;
+
+			if (Form == static_cast<uint8>(EVisitsForm::Bits))
+			{
+				const int32 NumWords = ReadCount(Ar, sizeof(uint32));
+				OutBits.SetNumZeroed(NumWords);
+				for (uint32& Word : OutBits)
+				{
+					Ar << Word;
+				}
+				return;
+			}
+
+			if (Form != static_cast<uint8>(EVisitsForm::Slots))
+			{
+				Ar.SetError();
+				return;
+			}
+
+			const int32 NumSlots = ReadCount(Ar);
+			int64 Slot = -1;
+			for (int32 i = 0; i < NumSlots && !Ar.IsError(); ++i)
+			{
+				//Slots can never outnumber the nodes of a dialogue, so
+				//bound the delta before it can wrap the slot
+				const uint64 Delta = ReadVarInt(Ar);
+				if (Slot >= MaxVisitSlot
+					|| Delta > static_cast<uint64>(MaxVisitSlot - Slot - 1))
+				{
+					Ar.SetError();
+					return;
+				}
+
+				Slot += static_cast<int64>(Delta) + 1;
+				if (Slot < 0)
+				{
+					Ar.SetError();
+					return;
+				}
+
+				const int32 WordIndex = static_cast<int32>(Slot / 32);
+				if (WordIndex >= OutBits.Num())
+				{
+					OutBits.SetNumZeroed(WordIndex + 1);
+				}
+				OutBits[WordIndex] |= 1u << (Slot % 32);
+			}
+		}
+
+		void ReadValue(FDialogueBlackboardValue& OutValue)
+		{
+			uint8 Fields = 0;
+			Ar << Fields;
+
+			if (Fields & VF_Integer)
+			{
+				const uint64 Zigzag = ReadVarInt(Ar);
+				const int64 Integer = static_cast<int64>(Zigzag >> 1)
+					^ -static_cast<int64>(Zigzag & 1);
+				OutValue.Number = static_cast<double>(Integer);
+			}
+			if (Fields & VF_Double)
+			{
+				Ar << OutValue.Number;
+			}
+			if (Fields & VF_Name)
+			{
+				OutValue.Name = ReadName();
+			}
+			if (Fields & VF_Tag)
+			{
+				//Tags removed from the project since saving are dropped
+				OutValue.Tag = FGameplayTag::RequestGameplayTag(
+					ReadName(), false);
+			}
+		}
+
+		FArchive& Ar;
+		const TArray<FName>& Names;
+	};
+}
+
+void FDialogueRecordsSerializer::Save(const FDialogueRecords& InRecords,
+	const TSet<uint64>* InOnlyKeys, bool bInWriteBlackboard,
+	TArray<uint8>& OutBytes)
+{
+	//Write the body first to learn which names it needs
+	TArray<uint8> Body;
+	FRecordsWriter Writer(Body);
+
+	TArray<uint64, TInlineAllocator<16>> Keys;
+	for (const TPair<uint64, FDialogueNodeVisits>& Pair
+		: InRecords.KeyedRecords)
+	{
+		if (!InOnlyKeys || InOnlyKeys->Contains(Pair.Key))
+		{
+			Keys.Add(Pair.Key);
+		}
+	}
+
+	WriteVarInt(Writer.Ar, Keys.Num());
+	for (uint64 Key : Keys)
+	{
+		Writer.Ar << Key;
+		Writer.WriteRecord(InRecords.KeyedRecords[Key]);
+	}
+
+	//Records of older saves are never touched again, so only full
+	//blobs need them
+	if (InOnlyKeys)
+	{
+		WriteVarInt(Writer.Ar, 0);
+	}
+	else
+	{
+		WriteVarInt(Writer.Ar, InRecords.Records.Num());
+		for (const TPair<FName, FDialogueNodeVisits>& Pair
+			: InRecords.Records)
+		{
+			Writer.WriteName(Pair.Key);
+			Writer.WriteRecord(Pair.Value);
+		}
+	}
+
+	if (bInWriteBlackboard)
+	{
+		Writer.WriteBlackboard(InRecords.Blackboard);
+	}
+
+	//Header, then the name table, then the body
+	OutBytes.Reset();
+	FMemoryWriter Ar(OutBytes);
+
+	uint32 Magic = RecordsMagic;
+	uint8 Version = static_cast<uint8>(EDialogueRecordsVersion::Latest);
+	uint8 Flags = (InOnlyKeys ? RF_Partial : 0)
+		| (bInWriteBlackboard ? RF_Blackboard : 0);
+	Ar << Magic;
+	Ar << Version;
+	Ar << Flags;
+
+	WriteVarInt(Ar, Writer.Names.Num());
+	for (FName Name : Writer.Names)
+	{
+		FString NameString = Name.ToString();
+		Ar << NameString;
+	}
+
+	Ar.Serialize(Body.GetData(), Body.Num());
+}
+
+bool FDialogueRecordsSerializer::Load(TConstArrayView<uint8> InBytes,
+	FDialogueRecords& OutRecords, bool& bOutPartial)
+{
+	FMemoryReaderView Ar(InBytes);
+
+	uint32 Magic = 0;
+	uint8 Version = 0;
+	uint8 Flags = 0;
+	Ar << Magic;
+	Ar << Version;
+	Ar << Flags;
+
+	if (Ar.IsError() || Magic != RecordsMagic)
+	{
+		UE_LOG(LogDialogueTree, Error,
+			TEXT("Dialogue records blob is not valid. Nothing loaded."));
+		return false;
+	}
+
+	if (Version > static_cast<uint8>(EDialogueRecordsVersion::Latest))
+	{
+		UE_LOG(LogDialogueTree, Error,
+			TEXT("Dialogue records blob has version %d, newer than the "
+			"supported version %d. Nothing loaded."), Version,
+			static_cast<uint8>(EDialogueRecordsVersion::Latest));
+		return false;
+	}
+
+	//Name table
+	TArray<FName> Names;
+	const int32 NumNames = ReadCount(Ar, sizeof(int32));
+	Names.Reserve(NumNames);
+	for (int32 i = 0; i < NumNames && !Ar.IsError(); ++i)
+	{
+		Names.Add(ReadNameString(Ar));
+	}
+
+	//Read into a scratch copy so a bad blob leaves the records alone
+	FRecordsReader Reader(Ar, Names);
+	FDialogueRecords Loaded;
+
+	const int32 NumKeyed = ReadCount(Ar, sizeof(uint64));
+	for (int32 i = 0; i < NumKeyed && !Ar.IsError(); ++i)
+	{
+		uint64 Key = 0;
+		Ar << Key;
+		Reader.ReadRecord(Loaded.KeyedRecords.Add(Key));
+	}
+
+	const int32 NumLegacy = ReadCount(Ar);
+	for (int32 i = 0; i < NumLegacy && !Ar.IsError(); ++i)
+	{
+		const FName DialogueName = Reader.ReadName();
+		Reader.ReadRecord(Loaded.Records.Add(DialogueName));
+	}
+
+	if (Flags & RF_Blackboard)
+	{
+		Reader.ReadBlackboard(Loaded.Blackboard);
+	}
+
+	if (Ar.IsError())
+	{
+		UE_LOG(LogDialogueTree, Error,
+			TEXT("Dialogue records blob is malformed. Nothing loaded."));
+		return false;
+	}
+
+	bOutPartial = (Flags & RF_Partial) != 0;
+	if (!bOutPartial)
+	{
+		OutRecords = MoveTemp(Loaded);
+		return true;
+	}
+
+	//A partial blob only replaces what it holds
+	for (TPair<uint64, FDialogueNodeVisits>& Pair : Loaded.KeyedRecords)
+	{
+		OutRecords.KeyedRecords.Add(Pair.Key, MoveTemp(Pair.Value));
+	}
+	for (TPair<FName, FDialogueNodeVisits>& Pair : Loaded.Records)
+	{
+		OutRecords.Records.Add(Pair.Key, MoveTemp(Pair.Value));
+	}
+	if (Flags & RF_Blackboard)
+	{
+		OutRecords.Blackboard = MoveTemp(Loaded.Blackboard);
+	}
+
+	return true;
+}
@@ -0,0 +1,189 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueScheduler.h"
+//Plugin
+#include "DialogueInstance.h"
+#include "DialogueTreeStats.h"
+
+void FDialogueScheduler::Tick(float DeltaSeconds)
+{
+	if (bPaused)
+	{
+		return;
+	}
+
+	Now += static_cast<double>(DeltaSeconds) * TimeScale;
+
+	//Pull everything due before waking anyone, since waking an instance
+	//moves it on to its next speech and may schedule again
+	DueMinPlayTime.Reset();
+	while (!Queue.IsEmpty() && Queue.HeapTop().Deadline <= Now)
+	{
+		FWake Wake;
+		Queue.HeapPop(Wake, EAllowShrinking::No);
+
+		TWeakPtr<FDialogueInstance> Instance;
+		if (PendingWakes.RemoveAndCopyValue(Wake.Id, Instance))
+		{
+			if (TSharedPtr<FDialogueInstance> Pinned = Instance.Pin())
+			{
+				DueMinPlayTime.Emplace(MoveTemp(Pinned), Wake.Id);
+			}
+		}
+	}
+
+	DueAudio.Reset();
+	for (int32 i = AudioWatchers.Num() - 1; i >= 0; --i)
+	{
+		TSharedPtr<FDialogueInstance> Instance = AudioWatchers[i].Pin();
+		const bool bWaiting = Instance && Instance->bWaitingOnAudio;
+		if (bWaiting && !Instance->IsSpeechAudioDone())
+		{
+			continue;
+		}
+
+		AudioWatchers.RemoveAtSwap(i, 1, EAllowShrinking::No);
+		if (Instance)
+		{
+			Instance->bAudioWatched = false;
+			if (bWaiting)
+			{
+				DueAudio.Add(MoveTemp(Instance));
+			}
+		}
+	}
+
+	//Wake the batch. An instance woken earlier in the batch may already 
+	//have moved on, so check each is still waiting on the same thing.
+	for (const TSharedPtr<FDialogueInstance>& Instance : DueAudio)
+	{
+		if (Instance->bWaitingOnAudio && Instance->IsSpeechAudioDone())
+		{
+			Instance->OnSpeechAudioFinished(Instance->AudioSpeaker.Get());
+		}
+	}
+
+	for (const TPair<TSharedPtr<FDialogueInstance>, uint64>& Due 
+		: DueMinPlayTime)
+	{
+		FDialogueWakeHandle& Wake = Due.Key->TransitionState.MinPlayTimeWake;
+		if (Wake.Id == Due.Value)
+		{
+			Wake = FDialogueWakeHandle();
+			Due.Key->OnMinPlayTimeElapsed();
+		}
+	}
+
+	DueMinPlayTime.Reset();
+	DueAudio.Reset();
+}
+
+FDialogueWakeHandle FDialogueScheduler::ScheduleWake(
+	const TSharedRef<FDialogueInstance>& InInstance, double InDelay)
+{
+	FDialogueWakeHandle Handle;
+	Handle.Id = NextWakeId++;
+
+	Queue.HeapPush(FWake{ Now + FMath::Max(InDelay, 0.0), Handle.Id });
+	PendingWakes.Add(Handle.Id, InInstance);
+	return Handle;
+}
+
+void FDialogueScheduler::CancelWake(FDialogueWakeHandle& InHandle)
+{
+	if (!InHandle.IsValid())
+	{
+		return;
+	}
+
+	//The queue entry is skipped when it comes up
+	PendingWakes.Remove(InHandle.Id);
+	InHandle = FDialogueWakeHandle();
+	CompactQueue();
+}
+
+double FDialogueScheduler::GetRemaining(
+	const FDialogueWakeHandle& InHandle) const
+{
+	if (!PendingWakes.Contains(InHandle.Id))
+	{
+		return 0.0;
+	}
+
+	for (const FWake& Wake : Queue)
+	{
+		if (Wake.Id == InHandle.Id)
+		{
+			return FMath::Max(Wake.Deadline - Now, 0.0);
+		}
+	}
+
+	return 0.0;
+}
+
+void FDialogueScheduler::WatchAudio(
+	const TSharedRef<FDialogueInstance>& InInstance)
+{
+	if (!InInstance->bAudioWatched)
+	{
+		InInstance->bAudioWatched = true;
+		AudioWatchers.Add(InInstance);
+	}
+}
+
+void FDialogueScheduler::SetPaused(bool bInPaused)
+{
+	bPaused = bInPaused;
+}
+
+bool FDialogueScheduler::IsPaused() const
+{
+	return bPaused;
+}
+
+void FDialogueScheduler::SetTimeScale(float InTimeScale)
+{
+	TimeScale = FMath::Max(InTimeScale, 0.f);
+}
+
+float FDialogueScheduler::GetTimeScale() const
+{
+	return TimeScale;
+}
+
+int32 FDialogueScheduler::GetNumPendingWakes() const
+{
+	return PendingWakes.Num();
+}
+
+void FDialogueScheduler::Reset()
+{
+	for (TWeakPtr<FDialogueInstance>& Watcher : AudioWatchers)
+	{
+		if (TSharedPtr<FDialogueInstance> Instance = Watcher.Pin())
+		{
+			Instance->bAudioWatched = false;
+		}
+	}
+
+	Queue.Reset();
+	PendingWakes.Reset();
+	AudioWatchers.Reset();
+}
+
+void FDialogueScheduler::CompactQueue()
+{
+	if (Queue.Num() <= 2 * PendingWakes.Num() + 32)
+	{
+		return;
+	}
+
+	Queue.RemoveAllSwap([this](const FWake& Wake)
+		{
+			return !PendingWakes.Contains(Wake.Id);
+		},
+		EAllowShrinking::No
+	);
+	Queue.Heapify();
+}
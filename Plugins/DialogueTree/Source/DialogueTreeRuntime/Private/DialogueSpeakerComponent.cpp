@@ -7,6 +7,7 @@
 //Plugin
 #include "Dialogue.h"
 #include "DialogueController.h"
+#include "DialogueInstance.h"
 #include "DialogueManagerSubsystem.h"
 #include "LogDialogueTree.h"
 
@@ -24,7 +25,25 @@ void UDialogueSpeakerComponent::BeginPlay()
 		GetWorld()->GetSubsystem<UDialogueManagerSubsystem>();
 	check(DialogueSubsystem);
 
+	//Make the speaker findable by name and location
+	DialogueSubsystem->RegisterSpeaker(this);
+	TransformUpdated.AddUObject(
+		this, 
+		&UDialogueSpeakerComponent::OnSpeakerMoved
+	);
+
 	DialogueController = DialogueSubsystem->GetCurrentController();
+
+	//The controller class may still be streaming in
+	if (!DialogueController && DialogueSubsystem->IsControllerPending())
+	{
+		DialogueSubsystem->OnControllerReady().AddUObject(
+			this,
+			&UDialogueSpeakerComponent::OnControllerReady
+		);
+		return;
+	}
+
 	if (!DialogueController)
 	{
 		UE_LOG(
@@ -36,6 +55,19 @@ void UDialogueSpeakerComponent::BeginPlay()
 	}
 }
 
+void UDialogueSpeakerComponent::EndPlay(
+	const EEndPlayReason::Type EndPlayReason)
+{
+	TransformUpdated.RemoveAll(this);
+	if (UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem())
+	{
+		DialogueSubsystem->UnregisterSpeaker(this);
+		DialogueSubsystem->CancelBark(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UDialogueSpeakerComponent::SetDisplayName(FText InDisplayName)
 {
 	if (InDisplayName.IsEmpty())
@@ -54,6 +86,13 @@ void UDialogueSpeakerComponent::SetDialogueName(FName InDialogueName)
 	}
 
 	DialogueName = InDialogueName;
+
+	//File the speaker under its new name
+	UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem();
+	if (HasBegunPlay() && DialogueSubsystem)
+	{
+		DialogueSubsystem->RegisterSpeaker(this);
+	}
 }
 
 FText UDialogueSpeakerComponent::GetDisplayName() const
@@ -83,24 +122,28 @@ FGameplayTagContainer UDialogueSpeakerComponent::GetCurrentGameplayTags()
 
 void UDialogueSpeakerComponent::EndCurrentDialogue()
 {
-	if (!DialogueController 
-		|| !DialogueController->SpeakerInCurrentDialogue(this))
+	//Ending an instance removes it from the speaker, so work from a copy
+	TArray<TSharedPtr<FDialogueInstance>> Instances;
+	GetActiveInstances(Instances);
+	for (const TSharedPtr<FDialogueInstance>& Instance : Instances)
 	{
-		return;
+		Instance->End();
 	}
-
-	DialogueController->EndDialogue();
 }
 
 void UDialogueSpeakerComponent::TrySkipSpeech()
 {
-	if (!DialogueController || 
-		!DialogueController->SpeakerInCurrentDialogue(this))
+	//Only skip lines this speaker is voicing, not another speaker's line 
+	//in a conversation it also takes part in
+	TArray<TSharedPtr<FDialogueInstance>> Instances;
+	GetActiveInstances(Instances);
+	for (const TSharedPtr<FDialogueInstance>& Instance : Instances)
 	{
-		return;
+		if (Instance->GetActiveSpeaker() == this)
+		{
+			Instance->Skip();
+		}
 	}
-
-	DialogueController->Skip();
 }
 
 void UDialogueSpeakerComponent::PlaySpeechAudioClip_Implementation(
@@ -110,7 +153,8 @@ void UDialogueSpeakerComponent::PlaySpeechAudioClip_Implementation(
 	Play();
 }
 
-void UDialogueSpeakerComponent::SetCurrentGameplayTags(FGameplayTagContainer InTags)
+void UDialogueSpeakerComponent::SetCurrentGameplayTags(
+	const FGameplayTagContainer& InTags)
 {
 	GameplayTags.Reset();
 	GameplayTags.AppendTags(InTags);
@@ -124,7 +168,7 @@ void UDialogueSpeakerComponent::ClearGameplayTags()
 }
 
 void UDialogueSpeakerComponent::StartOwnedDialogueWithNames(
-	TMap<FName, UDialogueSpeakerComponent*> InSpeakers, bool bResume)
+	const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers, bool bResume)
 {
 	if (OwnedDialogue)
 	{
@@ -142,7 +186,7 @@ void UDialogueSpeakerComponent::StartOwnedDialogue(
 }
 
 void UDialogueSpeakerComponent::StartDialogueWithNames(UDialogue* InDialogue, 
-	TMap<FName, UDialogueSpeakerComponent*> InSpeakers, bool bResume)
+	const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers, bool bResume)
 {	 
 	if (!InDialogue)
 	{
@@ -154,6 +198,15 @@ void UDialogueSpeakerComponent::StartDialogueWithNames(UDialogue* InDialogue,
 		return;
 	}
 
+	//Wait for the controller if its class is still loading
+	if (DeferUntilControllerReady([this, InDialogue, InSpeakers, bResume]()
+		{
+			StartDialogueWithNames(InDialogue, InSpeakers, bResume);
+		}))
+	{
+		return;
+	}
+
 	//Validate the controller
 	if (!DialogueController)
 	{
@@ -166,7 +219,11 @@ void UDialogueSpeakerComponent::StartDialogueWithNames(UDialogue* InDialogue,
 	}
 
 	//Start the dialogue 
-	DialogueController->StartDialogueWithNames(InDialogue, InSpeakers);
+	DialogueController->StartDialogueWithNames(
+		InDialogue, 
+		InSpeakers, 
+		bResume
+	);
 }
 
 void UDialogueSpeakerComponent::StartDialogue(UDialogue* InDialogue,
@@ -183,6 +240,15 @@ void UDialogueSpeakerComponent::StartDialogue(UDialogue* InDialogue,
 		return;
 	}
 
+	//Wait for the controller if its class is still loading
+	if (DeferUntilControllerReady([this, InDialogue, InSpeakers, bResume]()
+		{
+			StartDialogue(InDialogue, InSpeakers, bResume);
+		}))
+	{
+		return;
+	}
+
 	//Validate the controller
 	if (!DialogueController)
 	{
@@ -203,7 +269,7 @@ void UDialogueSpeakerComponent::StartDialogue(UDialogue* InDialogue,
 	DialogueController->StartDialogue(InDialogue, InSpeakers, bResume);
 }
 
-void UDialogueSpeakerComponent::StartOwnedDialogueWithNamesAt(FName InNodeID, TMap<FName, UDialogueSpeakerComponent*> InSpeakers)
+void UDialogueSpeakerComponent::StartOwnedDialogueWithNamesAt(FName InNodeID, const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers)
 {
 	if (OwnedDialogue)
 	{
@@ -219,7 +285,7 @@ void UDialogueSpeakerComponent::StartOwnedDialogueAt(FName InNodeID, TArray<UDia
 	}
 }
 
-void UDialogueSpeakerComponent::StartDialogueWithNamesAt(UDialogue* InDialogue, FName InNodeID, TMap<FName, UDialogueSpeakerComponent*> InSpeakers)
+void UDialogueSpeakerComponent::StartDialogueWithNamesAt(UDialogue* InDialogue, FName InNodeID, const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers)
 {
 	if (!InDialogue)
 	{
@@ -231,6 +297,15 @@ void UDialogueSpeakerComponent::StartDialogueWithNamesAt(UDialogue* InDialogue,
 		return;
 	}
 
+	//Wait for the controller if its class is still loading
+	if (DeferUntilControllerReady([this, InDialogue, InNodeID, InSpeakers]()
+		{
+			StartDialogueWithNamesAt(InDialogue, InNodeID, InSpeakers);
+		}))
+	{
+		return;
+	}
+
 	//Validate the controller
 	if (!DialogueController)
 	{
@@ -263,6 +338,15 @@ void UDialogueSpeakerComponent::StartDialogueAt(UDialogue* InDialogue, FName InN
 		return;
 	}
 
+	//Wait for the controller if its class is still loading
+	if (DeferUntilControllerReady([this, InDialogue, InNodeID, InSpeakers]()
+		{
+			StartDialogueAt(InDialogue, InNodeID, InSpeakers);
+		}))
+	{
+		return;
+	}
+
 	//Validate the controller
 	if (!DialogueController)
 	{
@@ -283,6 +367,83 @@ void UDialogueSpeakerComponent::StartDialogueAt(UDialogue* InDialogue, FName InN
 	DialogueController->StartDialogueAt(InDialogue, InNodeID, InSpeakers);
 }
 
+void UDialogueSpeakerComponent::StartOwnedDialogueWithNearbySpeakers(
+	float InSearchRadius, bool bResume)
+{
+	if (OwnedDialogue)
+	{
+		StartDialogueWithNearbySpeakers(OwnedDialogue, InSearchRadius, bResume);
+	}
+}
+
+void UDialogueSpeakerComponent::StartDialogueWithNearbySpeakers(
+	UDialogue* InDialogue, float InSearchRadius, bool bResume)
+{
+	//Validate that a dialogue was provided 
+	if (!InDialogue)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Warning,
+			TEXT("Speaker: No valid dialogue found to start")
+		);
+		return;
+	}
+
+	//Wait for the controller if its class is still loading
+	if (DeferUntilControllerReady([this, InDialogue, InSearchRadius, bResume]()
+		{
+			StartDialogueWithNearbySpeakers(InDialogue, InSearchRadius, bResume);
+		}))
+	{
+		return;
+	}
+
+	//Validate the controller
+	UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem();
+	if (!DialogueController || !DialogueSubsystem)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Speaker could not start dialogue because dialogue controller was invalid")
+		);
+		return;
+	}
+
+	//Fill the roles from the registry and start the dialogue
+	FDialogueSpeakerSlots Slots;
+	DialogueSubsystem->BindNearestSpeakerSlots(
+		InDialogue, 
+		this, 
+		InSearchRadius, 
+		Slots
+	);
+
+	DialogueController->StartDialogueInSlots(
+		InDialogue,
+		DialogueController->GetStartNodeID(InDialogue, bResume),
+		Slots
+	);
+}
+
+bool UDialogueSpeakerComponent::RequestBark(UDialogue* InDialogue,
+	FDialogueBarkParams InParams)
+{
+	UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem();
+	if (!InDialogue || !DialogueSubsystem)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Warning,
+			TEXT("Speaker: No valid dialogue found to bark")
+		);
+		return false;
+	}
+
+	return DialogueSubsystem->RequestBark(this, InDialogue, InParams);
+}
+
 FSpeakerActorEntry UDialogueSpeakerComponent::ToSpeakerActorEntry()
 {
 	FSpeakerActorEntry Entry;
@@ -292,6 +453,54 @@ FSpeakerActorEntry UDialogueSpeakerComponent::ToSpeakerActorEntry()
 	return Entry;
 }
 
+void UDialogueSpeakerComponent::AddActiveInstance(
+	TWeakPtr<FDialogueInstance> InInstance)
+{
+	//Drop instances that went away without closing first
+	ActiveInstances.RemoveAll([](const TWeakPtr<FDialogueInstance>& Entry)
+		{
+			const TSharedPtr<FDialogueInstance> Instance = Entry.Pin();
+			return !Instance || !Instance->IsActive();
+		}
+	);
+
+	const bool bKnown = ActiveInstances.ContainsByPredicate(
+		[&InInstance](const TWeakPtr<FDialogueInstance>& Entry)
+		{
+			return Entry == InInstance;
+		}
+	);
+	if (!bKnown)
+	{
+		ActiveInstances.Add(MoveTemp(InInstance));
+	}
+}
+
+void UDialogueSpeakerComponent::RemoveActiveInstance(
+	const FDialogueInstance* InInstance)
+{
+	ActiveInstances.RemoveAll(
+		[InInstance](const TWeakPtr<FDialogueInstance>& Entry)
+		{
+			return Entry.HasSameObject(InInstance);
+		}
+	);
+}
+
+void UDialogueSpeakerComponent::GetActiveInstances(
+	TArray<TSharedPtr<FDialogueInstance>>& OutInstances) const
+{
+	OutInstances.Reset();
+	for (const TWeakPtr<FDialogueInstance>& Entry : ActiveInstances)
+	{
+		TSharedPtr<FDialogueInstance> Instance = Entry.Pin();
+		if (Instance && Instance->IsActive())
+		{
+			OutInstances.Add(MoveTemp(Instance));
+		}
+	}
+}
+
 void UDialogueSpeakerComponent::BroadcastSpeechSkipped(
 	FSpeechDetails SkippedSpeech)
 {
@@ -300,5 +509,77 @@ void UDialogueSpeakerComponent::BroadcastSpeechSkipped(
 
 void UDialogueSpeakerComponent::BroadcastCurrentGameplayTags()
 {
+	//Queries may read the tags, so results cached under the old ones go
+	UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem();
+	if (ADialogueController* Controller = DialogueSubsystem 
+		? DialogueSubsystem->GetCurrentController() : nullptr)
+	{
+		Controller->NotifyDialogueStateChanged();
+	}
+
 	OnGameplayTagsChanged.Broadcast(GameplayTags);
 }
+
+void UDialogueSpeakerComponent::OnSpeakerMoved(USceneComponent* InComponent,
+	EUpdateTransformFlags InFlags, ETeleportType InTeleport)
+{
+	if (UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem())
+	{
+		DialogueSubsystem->UpdateSpeakerLocation(this);
+	}
+}
+
+UDialogueManagerSubsystem* UDialogueSpeakerComponent::GetDialogueSubsystem()
+	const
+{
+	UWorld* World = GetWorld();
+	return World ? World->GetSubsystem<UDialogueManagerSubsystem>() : nullptr;
+}
+
+bool UDialogueSpeakerComponent::DeferUntilControllerReady(
+	TFunction<void()> InStart)
+{
+	if (DialogueController)
+	{
+		return false;
+	}
+
+	UDialogueManagerSubsystem* DialogueSubsystem = GetDialogueSubsystem();
+	if (!DialogueSubsystem || !DialogueSubsystem->IsControllerPending())
+	{
+		return false;
+	}
+
+	DialogueSubsystem->OnControllerReady().AddWeakLambda(
+		this,
+		[this, InStart](ADialogueController* InController)
+		{
+			DialogueController = InController;
+			if (InController)
+			{
+				InStart();
+			}
+		}
+	);
+
+	UE_LOG(
+		LogDialogueTree,
+		Verbose,
+		TEXT("Speaker queued a dialogue start until the dialogue controller is ready.")
+	);
+	return true;
+}
+
+void UDialogueSpeakerComponent::OnControllerReady(
+	ADialogueController* InController)
+{
+	DialogueController = InController;
+	if (!DialogueController)
+	{
+		UE_LOG(
+			LogDialogueTree, 
+			Error, 
+			TEXT("Speaker component failed to find an active dialogue controller")
+		);
+	}
+}
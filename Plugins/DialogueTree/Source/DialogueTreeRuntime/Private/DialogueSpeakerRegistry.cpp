@@ -0,0 +1,306 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueSpeakerRegistry.h"
+//Plugin
+#include "DialogueSpeakerComponent.h"
+
+void FDialogueSpeakerRegistry::SetCellSize(float InCellSize)
+{
+	InCellSize = FMath::Max(InCellSize, 1.f);
+	if (InCellSize == CellSize)
+	{
+		return;
+	}
+
+	CellSize = InCellSize;
+
+	//Every cell boundary moved, so file everyone again
+	SpeakersByCell.Reset();
+	for (auto& Entry : Entries)
+	{
+		UDialogueSpeakerComponent* Speaker = Entry.Key.ResolveObjectPtr();
+		if (!Speaker)
+		{
+			continue;
+		}
+
+		Entry.Value.Cell = GetCell(Speaker->GetComponentLocation());
+		SpeakersByCell.FindOrAdd(Entry.Value.Cell).Add(Speaker);
+	}
+}
+
+void FDialogueSpeakerRegistry::Register(UDialogueSpeakerComponent* InSpeaker)
+{
+	if (!InSpeaker)
+	{
+		return;
+	}
+
+	FSpeakerEntry NewEntry;
+	NewEntry.Name = InSpeaker->GetDialogueName();
+	NewEntry.Cell = GetCell(InSpeaker->GetComponentLocation());
+
+	if (FSpeakerEntry* Existing = Entries.Find(InSpeaker))
+	{
+		if (Existing->Name == NewEntry.Name && Existing->Cell == NewEntry.Cell)
+		{
+			return;
+		}
+
+		Remove(InSpeaker, *Existing);
+		*Existing = NewEntry;
+	}
+	else
+	{
+		Entries.Add(InSpeaker, NewEntry);
+	}
+
+	Insert(InSpeaker, NewEntry);
+}
+
+void FDialogueSpeakerRegistry::Unregister(UDialogueSpeakerComponent* InSpeaker)
+{
+	FSpeakerEntry Entry;
+	if (Entries.RemoveAndCopyValue(InSpeaker, Entry))
+	{
+		Remove(InSpeaker, Entry);
+	}
+}
+
+void FDialogueSpeakerRegistry::UpdateLocation(
+	UDialogueSpeakerComponent* InSpeaker)
+{
+	FSpeakerEntry* Entry = Entries.Find(InSpeaker);
+	if (!Entry)
+	{
+		return;
+	}
+
+	//Most moves stay inside the cell, so only re-file on a crossing
+	const FIntVector NewCell = GetCell(InSpeaker->GetComponentLocation());
+	if (NewCell == Entry->Cell)
+	{
+		return;
+	}
+
+	if (TArray<UDialogueSpeakerComponent*>* OldCell =
+		SpeakersByCell.Find(Entry->Cell))
+	{
+		OldCell->RemoveSingleSwap(InSpeaker, EAllowShrinking::No);
+		if (OldCell->IsEmpty())
+		{
+			SpeakersByCell.Remove(Entry->Cell);
+		}
+	}
+
+	Entry->Cell = NewCell;
+	SpeakersByCell.FindOrAdd(NewCell).Add(InSpeaker);
+}
+
+bool FDialogueSpeakerRegistry::IsRegistered(
+	const UDialogueSpeakerComponent* InSpeaker) const
+{
+	return Entries.Contains(InSpeaker);
+}
+
+TConstArrayView<UDialogueSpeakerComponent*>
+	FDialogueSpeakerRegistry::FindByName(FName InName) const
+{
+	if (const TArray<UDialogueSpeakerComponent*>* Speakers =
+		SpeakersByName.Find(InName))
+	{
+		return *Speakers;
+	}
+
+	return {};
+}
+
+UDialogueSpeakerComponent* FDialogueSpeakerRegistry::FindNearest(
+	FName InName, const FVector& InOrigin, float InMaxDistance,
+	const UDialogueSpeakerComponent* InIgnore) const
+{
+	const TArray<UDialogueSpeakerComponent*>* Named =
+		SpeakersByName.Find(InName);
+	if (!Named)
+	{
+		return nullptr;
+	}
+
+	const bool bLimited = InMaxDistance > 0.f;
+	double BestDistSq = bLimited ? FMath::Square(InMaxDistance) : MAX_dbl;
+	UDialogueSpeakerComponent* Best = nullptr;
+
+	auto Consider = [&](UDialogueSpeakerComponent* InSpeaker)
+	{
+		if (InSpeaker == InIgnore)
+		{
+			return;
+		}
+
+		const double DistSq =
+			FVector::DistSquared(InSpeaker->GetComponentLocation(), InOrigin);
+		if (DistSq <= BestDistSq)
+		{
+			BestDistSq = DistSq;
+			Best = InSpeaker;
+		}
+	};
+
+	//Walk whichever is shorter: the cells covering the radius or the list
+	//of speakers with the name
+	const int32 CellRadius = bLimited
+		? FMath::CeilToInt32(InMaxDistance / CellSize)
+		: MAX_int32;
+	const int64 CellSpan = 2 * static_cast<int64>(CellRadius) + 1;
+	if (!bLimited || CellRadius > 64
+		|| CellSpan * CellSpan * CellSpan >= Named->Num())
+	{
+		for (UDialogueSpeakerComponent* Speaker : *Named)
+		{
+			Consider(Speaker);
+		}
+		return Best;
+	}
+
+	const FIntVector Center = GetCell(InOrigin);
+	for (int32 X = -CellRadius; X <= CellRadius; ++X)
+	{
+		for (int32 Y = -CellRadius; Y <= CellRadius; ++Y)
+		{
+			for (int32 Z = -CellRadius; Z <= CellRadius; ++Z)
+			{
+				const TArray<UDialogueSpeakerComponent*>* Cell =
+					SpeakersByCell.Find(Center + FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (UDialogueSpeakerComponent* Speaker : *Cell)
+				{
+					const FSpeakerEntry* Entry = Entries.Find(Speaker);
+					if (Entry && Entry->Name == InName)
+					{
+						Consider(Speaker);
+					}
+				}
+			}
+		}
+	}
+
+	return Best;
+}
+
+void FDialogueSpeakerRegistry::FindInRange(const FVector& InOrigin,
+	float InMaxDistance, TArray<UDialogueSpeakerComponent*>& OutSpeakers) const
+{
+	if (InMaxDistance <= 0.f)
+	{
+		return;
+	}
+
+	const double MaxDistSq = FMath::Square(InMaxDistance);
+	auto Consider = [&](UDialogueSpeakerComponent* InSpeaker)
+	{
+		if (FVector::DistSquared(InSpeaker->GetComponentLocation(), InOrigin)
+			<= MaxDistSq)
+		{
+			OutSpeakers.Add(InSpeaker);
+		}
+	};
+
+	//A radius spanning more cells than there are speakers is cheaper to
+	//answer by checking everyone
+	const int32 CellRadius = FMath::CeilToInt32(InMaxDistance / CellSize);
+	const int64 CellSpan = 2 * static_cast<int64>(CellRadius) + 1;
+	if (CellRadius > 64 || CellSpan * CellSpan * CellSpan >= Entries.Num())
+	{
+		for (const auto& Cell : SpeakersByCell)
+		{
+			for (UDialogueSpeakerComponent* Speaker : Cell.Value)
+			{
+				Consider(Speaker);
+			}
+		}
+		return;
+	}
+
+	const FIntVector Center = GetCell(InOrigin);
+	for (int32 X = -CellRadius; X <= CellRadius; ++X)
+	{
+		for (int32 Y = -CellRadius; Y <= CellRadius; ++Y)
+		{
+			for (int32 Z = -CellRadius; Z <= CellRadius; ++Z)
+			{
+				const TArray<UDialogueSpeakerComponent*>* Cell =
+					SpeakersByCell.Find(Center + FIntVector(X, Y, Z));
+				if (!Cell)
+				{
+					continue;
+				}
+
+				for (UDialogueSpeakerComponent* Speaker : *Cell)
+				{
+					Consider(Speaker);
+				}
+			}
+		}
+	}
+}
+
+int32 FDialogueSpeakerRegistry::Num() const
+{
+	return Entries.Num();
+}
+
+void FDialogueSpeakerRegistry::Reset()
+{
+	Entries.Reset();
+	SpeakersByName.Reset();
+	SpeakersByCell.Reset();
+}
+
+FIntVector FDialogueSpeakerRegistry::GetCell(const FVector& InLocation) const
+{
+	return FIntVector(
+		FMath::FloorToInt32(InLocation.X / CellSize),
+		FMath::FloorToInt32(InLocation.Y / CellSize),
+		FMath::FloorToInt32(InLocation.Z / CellSize)
+	);
+}
+
+void FDialogueSpeakerRegistry::Insert(UDialogueSpeakerComponent* InSpeaker,
+	const FSpeakerEntry& InEntry)
+{
+	if (!InEntry.Name.IsNone())
+	{
+		SpeakersByName.FindOrAdd(InEntry.Name).Add(InSpeaker);
+	}
+
+	SpeakersByCell.FindOrAdd(InEntry.Cell).Add(InSpeaker);
+}
+
+void FDialogueSpeakerRegistry::Remove(UDialogueSpeakerComponent* InSpeaker,
+	const FSpeakerEntry& InEntry)
+{
+	if (TArray<UDialogueSpeakerComponent*>* Named =
+		SpeakersByName.Find(InEntry.Name))
+	{
+		Named->RemoveSingleSwap(InSpeaker, EAllowShrinking::No);
+		if (Named->IsEmpty())
+		{
+			SpeakersByName.Remove(InEntry.Name);
+		}
+	}
+
+	if (TArray<UDialogueSpeakerComponent*>* Cell =
+		SpeakersByCell.Find(InEntry.Cell))
+	{
+		Cell->RemoveSingleSwap(InSpeaker, EAllowShrinking::No);
+		if (Cell->IsEmpty())
+		{
+			SpeakersByCell.Remove(InEntry.Cell);
+		}
+	}
+}
@@ -15,6 +15,16 @@ FName UDialogueSpeakerSocket::GetSpeakerName() const
 	return SpeakerName;
 }
 
+void UDialogueSpeakerSocket::SetSpeakerSlot(int32 InSlot)
+{
+	SpeakerSlot = InSlot;
+}
+
+int32 UDialogueSpeakerSocket::GetSpeakerSlot() const
+{
+	return SpeakerSlot;
+}
+
 UDialogueSpeakerComponent* UDialogueSpeakerSocket::GetSpeakerComponent(
 	UDialogue* InDialogue) const
 {
@@ -23,6 +33,12 @@ UDialogueSpeakerComponent* UDialogueSpeakerSocket::GetSpeakerComponent(
 		return nullptr;
 	}
 
+	//Go straight to the compiled slot unless the role was renamed since
+	if (InDialogue->GetProgram().GetSpeakerRole(SpeakerSlot) == SpeakerName)
+	{
+		return InDialogue->GetSpeakerAt(SpeakerSlot);
+	}
+
 	return InDialogue->GetSpeaker(SpeakerName);
 }
 
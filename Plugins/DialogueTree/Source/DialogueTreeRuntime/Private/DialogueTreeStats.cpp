@@ -0,0 +1,36 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "DialogueTreeStats.h"
+//Plugin
+#include "Dialogue.h"
+
+DEFINE_STAT(STAT_DialogueTree_ActiveDialogues);
+DEFINE_STAT(STAT_DialogueTree_Hops);
+DEFINE_STAT(STAT_DialogueTree_ConditionEvaluations);
+DEFINE_STAT(STAT_DialogueTree_BlueprintQueryCalls);
+DEFINE_STAT(STAT_DialogueTree_QueryCacheHits);
+DEFINE_STAT(STAT_DialogueTree_BarksStarted);
+DEFINE_STAT(STAT_DialogueTree_BarksCulled);
+DEFINE_STAT(STAT_DialogueTree_PrefetchedAudio);
+
+UE_TRACE_CHANNEL_DEFINE(DialogueTreeChannel);
+
+bool DialogueTreeTrace::IsEnabled()
+{
+#if CPUPROFILERTRACE_ENABLED
+	return UE_TRACE_CHANNELEXPR_IS_ENABLED(DialogueTreeChannel | CpuChannel);
+#else
+	return false;
+#endif
+}
+
+FString DialogueTreeTrace::DescribeScope(const UDialogue* InDialogue,
+	FName InName)
+{
+	return FString::Printf(
+		TEXT("%s/%s"),
+		InDialogue ? *InDialogue->GetName() : TEXT("None"),
+		*InName.ToString()
+	);
+}
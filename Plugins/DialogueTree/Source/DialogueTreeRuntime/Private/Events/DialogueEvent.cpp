@@ -28,10 +28,10 @@ void UDialogueEvent::PlayEvent()
 		return;
 	}
 
-	
 	FSpeakerActorEntry TargetSpeaker = SpeakerComponent->ToSpeakerActorEntry();
-	
-	TArray<FSpeakerActorEntry> OtherSpeakers;
+
+	//Entries are kept between plays so their allocation is reused
+	OtherSpeakerEntries.Reset();
 	for (UDialogueSpeakerSocket* Socket : AdditionalSpeakers)
 	{
 		UDialogueSpeakerComponent* SocketComponent = 
@@ -48,10 +48,10 @@ void UDialogueEvent::PlayEvent()
 
 		FSpeakerActorEntry SocketEntry = 
 			SocketComponent->ToSpeakerActorEntry();
-		OtherSpeakers.Add(SocketEntry);
+		OtherSpeakerEntries.Add(SocketEntry);
 	}
 
-	OnPlayEvent(TargetSpeaker, OtherSpeakers);
+	OnPlayEvent(TargetSpeaker, OtherSpeakerEntries);
 }
 
 bool UDialogueEvent::HasAllRequirements() const
@@ -39,6 +39,10 @@ void UDialogueEventBase::PlayEvent()
 {
 }
 
+void UDialogueEventBase::CompileEvent(FDialogueProgram& InProgram)
+{
+}
+
 void UDialogueEventBase::SetDialogue(UDialogue* InDialogue)
 {
 	if (!InDialogue)
@@ -0,0 +1,100 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+//Header
+#include "Events/SetBlackboardValue.h"
+//Plugin
+#include "Dialogue.h"
+#include "DialogueInstance.h"
+#include "DialogueProgram.h"
+
+#define LOCTEXT_NAMESPACE "SetBlackboardValue"
+
+void USetBlackboardValue::PlayEvent()
+{
+	FDialogueInstance* Instance = 
+		Dialogue ? Dialogue->GetActiveInstance() : nullptr;
+	if (!Instance)
+	{
+		return;
+	}
+
+	FDialogueBlackboardValue NewValue = MakeValue();
+	if (bAdd && Type != EDialogueBlackboardType::Bool)
+	{
+		NewValue.Number += Instance->ReadBlackboard(KeyIndex).Number;
+	}
+
+	Instance->WriteBlackboard(KeyIndex, NewValue);
+}
+
+void USetBlackboardValue::CompileEvent(FDialogueProgram& InProgram)
+{
+	KeyIndex = InProgram.AddBlackboardKey(Key, Type);
+}
+
+bool USetBlackboardValue::HasAllRequirements() const
+{
+	return !Key.IsNone();
+}
+
+FText USetBlackboardValue::GetGraphDescription_Implementation() const
+{
+	if (Key.IsNone())
+	{
+		return LOCTEXT("DefaultText", "Invalid Event");
+	}
+
+	FText ValueText;
+	switch (Type)
+	{
+	case EDialogueBlackboardType::Bool:
+		ValueText = bBoolValue 
+			? LOCTEXT("TrueText", "true") 
+			: LOCTEXT("FalseText", "false");
+		break;
+	case EDialogueBlackboardType::Int:
+		ValueText = FText::AsNumber(IntValue);
+		break;
+	case EDialogueBlackboardType::Float:
+		ValueText = FText::AsNumber(FloatValue);
+		break;
+	case EDialogueBlackboardType::Name:
+		ValueText = FText::FromName(NameValue);
+		break;
+	default:
+		ValueText = FText::FromName(TagValue.GetTagName());
+		break;
+	}
+
+	FText BaseText = bAdd && Type != EDialogueBlackboardType::Bool
+		? LOCTEXT("AddText", "Add {1} to {0}")
+		: LOCTEXT("SetText", "Set {0} to {1}");
+	return FText::Format(BaseText, FText::FromName(Key), ValueText);
+}
+
+FDialogueBlackboardValue USetBlackboardValue::MakeValue() const
+{
+	FDialogueBlackboardValue Value;
+	switch (Type)
+	{
+	case EDialogueBlackboardType::Bool:
+		Value.Number = bBoolValue ? 1.0 : 0.0;
+		break;
+	case EDialogueBlackboardType::Int:
+		Value.Number = IntValue;
+		break;
+	case EDialogueBlackboardType::Float:
+		Value.Number = FloatValue;
+		break;
+	case EDialogueBlackboardType::Name:
+		Value.Name = NameValue;
+		break;
+	default:
+		Value.Tag = TagValue;
+		break;
+	}
+
+	return Value;
+}
+
+#undef LOCTEXT_NAMESPACE
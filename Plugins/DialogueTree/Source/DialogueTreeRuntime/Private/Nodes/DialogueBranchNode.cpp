@@ -5,6 +5,7 @@
 //Plugin
 #include "Conditionals/DialogueCondition.h"
 #include "Dialogue.h"
+#include "DialogueProgram.h"
 
 FDialogueOption UDialogueBranchNode::GetAsOption()
 {
@@ -42,12 +43,29 @@ void UDialogueBranchNode::EnterNode()
     if (!NextNode)
     {
         GetDialogue()->EndDialogue();
+        return;
     }
 
     //Next node found, transition to it 
     GetDialogue()->TraverseNode(NextNode);
 }
 
+void UDialogueBranchNode::CompileNode(FDialogueProgram& InProgram,
+    FDialogueProgramNode& OutNode) const
+{
+    OutNode.Kind = EDialogueNodeKind::Branch;
+    OutNode.bIfAny = bIfAny;
+
+    //Links are always stored as the true node followed by the false node
+    InProgram.AddLink(TrueNode, OutNode);
+    InProgram.AddLink(FalseNode, OutNode);
+
+    for (UDialogueCondition* Condition : Conditions)
+    {
+        InProgram.AddCondition(Condition, OutNode);
+    }
+}
+
 void UDialogueBranchNode::InitBranchData(bool InIfAny, 
     UDialogueNode* InTrueNode, UDialogueNode* InFalseNode, 
     TArray<UDialogueCondition*>& InConditions)
@@ -4,6 +4,7 @@
 #include "Nodes/DialogueEntryNode.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueProgram.h"
 #include "LogDialogueTree.h"
 
 void UDialogueEntryNode::EnterNode()
@@ -28,3 +29,10 @@ void UDialogueEntryNode::EnterNode()
 	//Otherwise, get first (only) child and enter that node 
 	Dialogue->TraverseNode(Children[0]);
 }
+
+void UDialogueEntryNode::CompileNode(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	Super::CompileNode(InProgram, OutNode);
+	OutNode.Kind = EDialogueNodeKind::Entry;
+}
\ No newline at end of file
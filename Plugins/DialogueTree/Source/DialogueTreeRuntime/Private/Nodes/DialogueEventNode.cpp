@@ -4,6 +4,10 @@
 #include "Nodes/DialogueEventNode.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueInstance.h"
+#include "DialogueProgram.h"
+#include "DialogueInstanceSnapshot.h"
+#include "DialogueTreeStats.h"
 #include "Events/DialogueEventBase.h"
 
 void UDialogueEventNode::EnterNode()
@@ -34,6 +38,30 @@ void UDialogueEventNode::Skip()
 	}
 }
 
+void UDialogueEventNode::RestoreNode(
+	const FDialogueInstanceSnapshot& InSnapshot)
+{
+	RestoreEvents(InSnapshot);
+
+	//Move on if nothing was left to wait for
+	TransitionIfNotBlocking();
+}
+
+void UDialogueEventNode::CompileNode(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	Super::CompileNode(InProgram, OutNode);
+	OutNode.Kind = EDialogueNodeKind::Event;
+
+	for (UDialogueEventBase* Event : Events)
+	{
+		if (Event)
+		{
+			Event->CompileEvent(InProgram);
+		}
+	}
+}
+
 void UDialogueEventNode::SetEvents(TArray<UDialogueEventBase*>& InEvents)
 {
 	Events = InEvents;
@@ -57,19 +85,77 @@ bool UDialogueEventNode::GetIsBlocking() const
 	return false;
 }
 
+void UDialogueEventNode::GetBlockingEvents(TArray<int32>& OutEvents) const
+{
+	OutEvents.Reset();
+	for (int32 i = 0; i < Events.Num(); ++i)
+	{
+		if (Events[i] && Events[i]->GetIsBlocking())
+		{
+			OutEvents.Add(i);
+		}
+	}
+}
+
 void UDialogueEventNode::PlayEvents()
 {
 	for (UDialogueEventBase* Event : Events)
 	{
-		// Subscribe to the event's callback for stopping blocking
-		Event->OnStoppedBlocking.BindUFunction(
-			this,
-			"TransitionIfNotBlocking"
-		);
-
-		// Play the event
-		Event->PlayEvent();
+		PlayEvent(Event);
+	}
+}
+
+void UDialogueEventNode::RestoreEvents(
+	const FDialogueInstanceSnapshot& InSnapshot)
+{
+	for (int32 EventIndex : InSnapshot.BlockingEvents)
+	{
+		if (Events.IsValidIndex(EventIndex) && Events[EventIndex])
+		{
+			PlayEvent(Events[EventIndex]);
+		}
+	}
+}
+
+void UDialogueEventNode::PlayEvent(UDialogueEventBase* InEvent)
+{
+	TWeakPtr<FDialogueInstance> WeakInstance;
+	if (FDialogueInstance* Instance = Dialogue->GetActiveInstance())
+	{
+		WeakInstance = Instance->AsShared();
 	}
+
+	// Drop any callback left over from a previous play
+	InEvent->OnStoppedBlocking.Unbind();
+
+	// Play the event
+	{
+		DIALOGUE_TRACE_SCOPE("PlayEvent", Dialogue, NodeID);
+		InEvent->PlayEvent();
+	}
+
+	// Only events still blocking need to call back, so events that
+	// finish straight away never allocate a binding
+	if (!InEvent->GetIsBlocking())
+	{
+		return;
+	}
+
+	// Subscribe to the event's callback for stopping blocking, making
+	// sure it resumes the instance that played the event
+	InEvent->OnStoppedBlocking.BindWeakLambda(
+		this,
+		[this, WeakInstance]()
+		{
+			TSharedPtr<FDialogueInstance> EventInstance = 
+				WeakInstance.Pin();
+			if (EventInstance && EventInstance->GetActiveNode() == this)
+			{
+				FDialogueInstance::FScope ExecutionScope(*EventInstance);
+				TransitionIfNotBlocking();
+			}
+		}
+	);
 }
 
 void UDialogueEventNode::TransitionIfNotBlocking() const
@@ -79,9 +165,10 @@ void UDialogueEventNode::TransitionIfNotBlocking() const
 		return;
 	}
 
-	if (!Children.IsEmpty())
+	const int32 NextIndex = Dialogue->GetProgram().GetFirstLink(NodeIndex);
+	if (NextIndex != INDEX_NONE)
 	{
-		Dialogue->TraverseNode(Children[0]);
+		Dialogue->TraverseNodeAt(NextIndex);
 	}
 	else
 	{
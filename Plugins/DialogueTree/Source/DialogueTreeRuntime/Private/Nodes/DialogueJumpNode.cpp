@@ -4,6 +4,7 @@
 #include "Nodes/DialogueJumpNode.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueProgram.h"
 
 void UDialogueJumpNode::EnterNode()
 {
@@ -23,6 +24,14 @@ FDialogueOption UDialogueJumpNode::GetAsOption()
 	return FDialogueOption();
 }
 
+void UDialogueJumpNode::CompileNode(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	//Jumps only ever hand control to their target
+	OutNode.Kind = EDialogueNodeKind::Jump;
+	InProgram.AddLink(JumpTarget, OutNode);
+}
+
 void UDialogueJumpNode::SetJumpTarget(UDialogueNode* InTarget)
 {
 	check(InTarget);
@@ -2,8 +2,11 @@
 
 //Header
 #include "Nodes/DialogueNode.h"
+//UE
+#include "Hash/CityHash.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueProgram.h"
 
 UDialogue* UDialogueNode::GetDialogue() const
 {
@@ -31,12 +34,22 @@ void UDialogueNode::AddChild(UDialogueNode* InChild)
     }
 }
 
-TArray<UDialogueNode*> UDialogueNode::GetParents() const
+void UDialogueNode::RemoveParent(UDialogueNode* InParent)
+{
+    Parents.Remove(InParent);
+}
+
+void UDialogueNode::ClearChildren()
+{
+    Children.Empty();
+}
+
+const TArray<TObjectPtr<UDialogueNode>>& UDialogueNode::GetParents() const
 {
     return Parents;
 }
 
-TArray<UDialogueNode*> UDialogueNode::GetChildren() const
+const TArray<TObjectPtr<UDialogueNode>>& UDialogueNode::GetChildren() const
 {
     return Children;
 }
@@ -46,6 +59,25 @@ FDialogueOption UDialogueNode::GetAsOption()
     return FDialogueOption();
 }
 
+void UDialogueNode::CompileNode(FDialogueProgram& InProgram,
+    FDialogueProgramNode& OutNode) const
+{
+    for (UDialogueNode* Child : Children)
+    {
+        InProgram.AddLink(Child, OutNode);
+    }
+}
+
+int32 UDialogueNode::GetNodeIndex() const
+{
+    return NodeIndex;
+}
+
+void UDialogueNode::SetNodeIndex(int32 InIndex)
+{
+    NodeIndex = InIndex;
+}
+
 FName UDialogueNode::GetNodeID() const
 {
     return NodeID;
@@ -56,6 +88,37 @@ void UDialogueNode::SetNodeID(FName InID)
     NodeID = InID;
 }
 
+FGuid UDialogueNode::GetNodeGuid() const
+{
+    return NodeGuid;
+}
+
+void UDialogueNode::SetNodeGuid(const FGuid& InGuid)
+{
+    NodeGuid = InGuid;
+    StableID = MakeStableID(InGuid);
+}
+
+uint32 UDialogueNode::GetStableID() const
+{
+    return StableID;
+}
+
+uint32 UDialogueNode::MakeStableID(const FGuid& InGuid)
+{
+    if (!InGuid.IsValid())
+    {
+        return 0;
+    }
+
+    //0 means "no stable ID", so it is never handed out
+    const uint32 Hash = CityHash32(
+        reinterpret_cast<const char*>(&InGuid), 
+        sizeof(FGuid)
+    );
+    return Hash != 0 ? Hash : 1;
+}
+
 void UDialogueNode::SetGraphLocation(FVector2D InLocation)
 {
     GraphLocation = InLocation;
@@ -5,6 +5,7 @@
 //Plugin
 #include "Conditionals/DialogueCondition.h"
 #include "Dialogue.h"
+#include "DialogueProgram.h"
 
 FDialogueOption UDialogueOptionLockNode::GetAsOption()
 {
@@ -40,12 +41,28 @@ void UDialogueOptionLockNode::EnterNode()
 	if (Children.Num() < 1 || Children[0] == nullptr)
 	{
 		Dialogue->EndDialogue();
+		return;
 	}
 
 	//Otherwise, get first (only) child and enter that node 
 	Dialogue->TraverseNode(Children[0]);
 }
 
+void UDialogueOptionLockNode::CompileNode(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	Super::CompileNode(InProgram, OutNode);
+	OutNode.Kind = EDialogueNodeKind::OptionLock;
+	OutNode.bIfAny = bIfAny;
+
+	for (UDialogueCondition* Condition : Conditions)
+	{
+		InProgram.AddCondition(Condition, OutNode);
+	}
+
+	InProgram.AddMessages(LockedMessage, UnlockedMessage, OutNode);
+}
+
 void UDialogueOptionLockNode::InitLockNodeData(bool InIfAny, 
 	TArray<UDialogueCondition*>& InConditions, const FText& LockedText, 
 	const FText& UnlockedText)
@@ -4,6 +4,7 @@
 #include "Nodes/DialogueRerouteNode.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueProgram.h"
 #include "LogDialogueTree.h"
 
 void UDialogueRerouteNode::EnterNode()
@@ -38,3 +39,10 @@ FDialogueOption UDialogueRerouteNode::GetAsOption()
 
 	return Children[0]->GetAsOption();
 }
+
+void UDialogueRerouteNode::CompileNode(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	Super::CompileNode(InProgram, OutNode);
+	OutNode.Kind = EDialogueNodeKind::Reroute;
+}
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "Nodes/DialogueSpeechNode.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueInstance.h"
+#include "DialogueInstanceSnapshot.h"
+#include "DialogueProgram.h"
 #include "DialogueSpeakerComponent.h"
 #include "LogDialogueTree.h"
 #include "Transitions/DialogueTransition.h"
@@ -17,13 +20,20 @@ void UDialogueSpeechNode::InitSpeechData(FSpeechDetails& InDetails,
 	Transition->SetOwningNode(this);
 }
 
-FSpeechDetails UDialogueSpeechNode::GetDetails() const
+const FSpeechDetails& UDialogueSpeechNode::GetDetails() const
 {
 	return Details;
 }
 
 UDialogueSpeakerComponent* UDialogueSpeechNode::GetSpeaker() const
 {
+	//Compiled nodes know their speaker's slot, so skip the name lookup
+	const FDialogueProgram& Program = Dialogue->GetProgram();
+	if (Program.IndexOf(this) != INDEX_NONE)
+	{
+		return Dialogue->GetSpeakerAt(Program.GetNode(NodeIndex).SpeakerSlot);
+	}
+
 	return Dialogue->GetSpeaker(Details.SpeakerName);
 }
 
@@ -43,7 +53,8 @@ void UDialogueSpeechNode::EnterNode()
 	PlayEvents();
 
 	//Verify speaker is actually present
-	if (!Dialogue->SpeakerIsPresent(Details.SpeakerName))
+	UDialogueSpeakerComponent* Speaker = GetSpeaker();
+	if (!Speaker)
 	{
 		UE_LOG(
 			LogDialogueTree,
@@ -58,7 +69,7 @@ void UDialogueSpeechNode::EnterNode()
 	if (!Details.bIgnoreContent)
 	{
 		//Display the current speech
-		Dialogue->DisplaySpeech(Details);
+		Dialogue->DisplaySpeech(Details, Speaker);
 
 		//Play any audio and set any flags for the speaker
 		StartAudio();
@@ -89,11 +100,66 @@ void UDialogueSpeechNode::Skip()
 	}
 }
 
+void UDialogueSpeechNode::RestoreNode(
+	const FDialogueInstanceSnapshot& InSnapshot)
+{
+	RestoreEvents(InSnapshot);
+
+	UDialogueSpeakerComponent* Speaker = GetSpeaker();
+	if (!Speaker || !Transition)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Error,
+			TEXT("Terminating restored dialogue: Speech %s is missing its speaker or transition."),
+			*NodeID.ToString()
+		);
+		Dialogue->EndDialogue();
+		return;
+	}
+
+	if (!Details.bIgnoreContent)
+	{
+		Dialogue->DisplaySpeech(Details, Speaker);
+
+		//A line cut off by the snapshot starts over; a finished one stays
+		//silent
+		if (InSnapshot.bAudioFinished)
+		{
+			Speaker->SetCurrentGameplayTags(Details.GameplayTags);
+		}
+		else
+		{
+			StartAudio();
+		}
+	}
+
+	Transition->RestoreTransition();
+}
+
+void UDialogueSpeechNode::CompileNode(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	Super::CompileNode(InProgram, OutNode);
+	OutNode.Kind = EDialogueNodeKind::Speech;
+	InProgram.AddSpeech(Details, OutNode);
+
+	if (Transition)
+	{
+		Transition->CompileTransition(InProgram, OutNode);
+	}
+}
+
 TSubclassOf<UDialogueTransition> UDialogueSpeechNode::GetTransitionType() const
 {
 	return Transition->GetClass();
 }
 
+UDialogueTransition* UDialogueSpeechNode::GetTransition() const
+{
+	return Transition;
+}
+
 void UDialogueSpeechNode::TransitionIfNotBlocking() const
 {
 	Transition->CheckTransitionConditions();
@@ -107,15 +173,25 @@ FDialogueOption UDialogueSpeechNode::GetAsOption()
 void UDialogueSpeechNode::StartAudio()
 {
 	UDialogueSpeakerComponent* Speaker = GetSpeaker();
+	FDialogueInstance* Instance = Dialogue->GetActiveInstance();
 
 	if (Speaker)
 	{
 		//Play any audio
 		Speaker->Stop();
 
-		if (Details.SpeechAudio)
+		//Lines are normally prefetched by now. Any that are not are 
+		//streamed in rather than loaded on the spot. Low fidelity dialogues
+		//stay silent.
+		const bool bPlaysAudio = !Instance || Instance->PlaysAudio();
+		USoundBase* Audio = bPlaysAudio ? Details.SpeechAudio.Get() : nullptr;
+		if (Audio)
+		{
+			Speaker->PlaySpeechAudioClip(Audio);
+		}
+		else if (bPlaysAudio && Instance && !Details.SpeechAudio.IsNull())
 		{
-			Speaker->PlaySpeechAudioClip(Details.SpeechAudio);
+			Instance->PlaySpeechAudioWhenLoaded(Speaker, Details.SpeechAudio);
 		}
 
 		//Set any behavior flags
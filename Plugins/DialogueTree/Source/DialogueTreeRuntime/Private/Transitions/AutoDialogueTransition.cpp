@@ -21,10 +21,13 @@ FText UAutoDialogueTransition::GetNodeCreationTooltip() const
 void UAutoDialogueTransition::TransitionOut()
 {
 	//Transition to the first linked node 
-	TArray<UDialogueNode*> Children = OwningNode->GetChildren();
-	if (!Children.IsEmpty() && Children[0])
+	UDialogue* Dialogue = OwningNode->GetDialogue();
+	const int32 NextIndex = 
+		Dialogue->GetProgram().GetFirstLink(OwningNode->GetNodeIndex());
+
+	if (NextIndex != INDEX_NONE)
 	{
-		OwningNode->GetDialogue()->TraverseNode(Children[0]);
+		Dialogue->TraverseNodeAt(NextIndex);
 	}
 	else
 	{
@@ -7,17 +7,12 @@
 //Plugin
 #include "Dialogue.h"
 #include "DialogueConnectionLimit.h"
+#include "DialogueInstance.h"
 #include "DialogueSpeakerComponent.h"
 #include "Nodes/DialogueNode.h"
 #include "Nodes/DialogueSpeechNode.h"
 #include "LogDialogueTree.h"
 
-UDialogueTransition::UDialogueTransition()
-{
-	OnContentEnd.BindUFunction(this, "OnDonePlayingContent");
-	OnTimerEnd.BindUFunction(this, "OnMinPlayTimeElapsed");
-}
-
 void UDialogueTransition::SetOwningNode(UDialogueSpeechNode* InNode)
 {
 	OwningNode = InNode;
@@ -25,22 +20,27 @@ void UDialogueTransition::SetOwningNode(UDialogueSpeechNode* InNode)
 
 void UDialogueTransition::StartTransition()
 {
-	//Reset end marker values
-	bMinPlayTimeElapsed = false;
-	bAudioFinished = false;
-
-	//Verify owning node exists
-	if (!OwningNode)
+	//Verify owning node and instance exist
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
 	{
 		UE_LOG(
 			LogDialogueTree,
 			Error,
-			TEXT("Transition failed to find owning node. Ending dialogue early."));
+			TEXT("Transition failed to find owning node or dialogue instance. Ending dialogue early."));
 
-		OwningNode->GetDialogue()->EndDialogue();
+		if (OwningNode)
+		{
+			OwningNode->GetDialogue()->EndDialogue();
+		}
 		return;
 	}
 
+	//Reset end marker values
+	FDialogueTransitionState& State = Instance->GetTransitionState();
+	State.bMinPlayTimeElapsed = false;
+	State.bAudioFinished = false;
+
 	//Get speaker
 	UDialogueSpeakerComponent* Speaker = OwningNode->GetSpeaker();
 	if (!Speaker)
@@ -59,45 +59,75 @@ void UDialogueTransition::StartTransition()
 
 	if (MinPlayTime > 0.01f)
 	{
-		Speaker->GetWorld()->GetTimerManager().SetTimer(
-			MinPlayTimeHandle,
-			OnTimerEnd,
-			MinPlayTime,
-			false
-		);
+		Instance->StartMinPlayTimer(MinPlayTime);
 	}
 	//No minimum time
 	else
 	{
-		bMinPlayTimeElapsed = true;
+		State.bMinPlayTimeElapsed = true;
 	}
 
-	//Start listening to see when the audio content finishes 
-	if (Speaker->IsPlaying())
+	//Start listening to see when the audio content finishes, including audio
+	//that is still streaming in
+	if (Speaker->IsPlaying() || Instance->IsLoadingSpeechAudio())
 	{
-		Speaker->OnAudioFinished.AddUnique(OnContentEnd);
+		Instance->WaitForSpeechAudio(Speaker);
 	}
 	//No audio playing 
 	else
 	{
-		bAudioFinished = true;
+		State.bAudioFinished = true;
 	}
 
 	//If no minimum time or audio content, just transition out 
-	if (bMinPlayTimeElapsed && bAudioFinished)
+	if (State.bMinPlayTimeElapsed && State.bAudioFinished)
 	{
 		TransitionOut();
 	}
 }
 
+void UDialogueTransition::RestoreTransition()
+{
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+
+	//The minimum play time left was rescheduled with the transition state,
+	//so only the audio needs watching again
+	FDialogueTransitionState& State = Instance->GetTransitionState();
+	UDialogueSpeakerComponent* Speaker = OwningNode->GetSpeaker();
+	if (!State.bAudioFinished)
+	{
+		if (Speaker && (Speaker->IsPlaying() 
+			|| Instance->IsLoadingSpeechAudio()))
+		{
+			Instance->WaitForSpeechAudio(Speaker);
+		}
+		else
+		{
+			State.bAudioFinished = true;
+		}
+	}
+
+	CheckTransitionConditions();
+}
+
 void UDialogueTransition::Skip()
 {
-	if (!bAudioFinished)
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+
+	if (!Instance->GetTransitionState().bAudioFinished)
 	{
 		OnDonePlayingContent();
 	}
 
-	if (!bMinPlayTimeElapsed)
+	if (!Instance->GetTransitionState().bMinPlayTimeElapsed)
 	{
 		OnMinPlayTimeElapsed();
 	}
@@ -125,7 +155,15 @@ EDialogueConnectionLimit UDialogueTransition::GetConnectionLimit() const
 
 void UDialogueTransition::CheckTransitionConditions()
 {
-	if (bAudioFinished && bMinPlayTimeElapsed && !OwningNode->GetIsBlocking())
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+
+	const FDialogueTransitionState& State = Instance->GetTransitionState();
+	if (State.bAudioFinished && State.bMinPlayTimeElapsed 
+		&& !OwningNode->GetIsBlocking())
 	{
 		TransitionOut();
 	}
@@ -133,17 +171,23 @@ void UDialogueTransition::CheckTransitionConditions()
 
 void UDialogueTransition::OnDonePlayingContent()
 {
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+
 	//Unbind from audio event 
 	UDialogueSpeakerComponent* Speaker = OwningNode->GetSpeaker();
 
 	if (Speaker)
 	{
 		Speaker->Stop();
-		Speaker->OnAudioFinished.Remove(OnContentEnd);
 	}
+	Instance->StopWaitingForSpeechAudio();
 
 	//Mark audio complete
-	bAudioFinished = true;
+	Instance->GetTransitionState().bAudioFinished = true;
 
 	//See if we should transition out
 	CheckTransitionConditions();
@@ -151,9 +195,22 @@ void UDialogueTransition::OnDonePlayingContent()
 
 void UDialogueTransition::OnMinPlayTimeElapsed()
 {
-	//Mark min play time elapsed
-	bMinPlayTimeElapsed = true;
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+
+	//Mark min play time elapsed, dropping the timer if skipped early
+	Instance->StopMinPlayTimer();
+	Instance->GetTransitionState().bMinPlayTimeElapsed = true;
 
 	//Check if we should transition out
 	CheckTransitionConditions();
 }
+
+FDialogueInstance* UDialogueTransition::GetInstance() const
+{
+	return OwningNode ? OwningNode->GetDialogue()->GetActiveInstance() 
+		: nullptr;
+}
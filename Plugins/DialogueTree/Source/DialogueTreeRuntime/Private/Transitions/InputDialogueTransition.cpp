@@ -4,6 +4,8 @@
 #include "Transitions/InputDialogueTransition.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueInstance.h"
+#include "DialogueProgram.h"
 #include "DialogueSpeakerComponent.h"
 #include "Nodes/DialogueNode.h"
 #include "Nodes/DialogueSpeechNode.h"
@@ -13,8 +15,15 @@
 
 void UInputDialogueTransition::StartTransition()
 {
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		Super::StartTransition();
+		return;
+	}
+
 	//Get any options
-	GetOptions();
+	GetOptions(Instance->GetTransitionState().Options);
 
 	//If the node is skippable, show options now
 	if (OwningNode->GetCanSkip())
@@ -25,10 +34,30 @@ void UInputDialogueTransition::StartTransition()
 	Super::StartTransition();
 }
 
+void UInputDialogueTransition::RestoreTransition()
+{
+	//Options of skippable speeches were showing from the start. The rest
+	//show once the transition is done, which the base checks.
+	if (OwningNode->GetCanSkip())
+	{
+		ShowOptions();
+	}
+
+	Super::RestoreTransition();
+}
+
 void UInputDialogueTransition::TransitionOut()
 {
 	Super::TransitionOut();
 
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+	const TArray<FResolvedDialogueOption>& Options = 
+		Instance->GetTransitionState().Options;
+
 	//If there are no options to transition to, end dialogue
 	if (Options.IsEmpty())
 	{
@@ -45,6 +74,11 @@ void UInputDialogueTransition::TransitionOut()
 		OwningNode->GetDialogue()->EndDialogue();
 		return;
 	}
+	//Nobody is there to choose in ambient dialogue
+	else if (!Instance->UsesDisplay())
+	{
+		SelectFirstUnlockedOption(Options);
+	}
 	//If the node is not skippable, display options now 
 	else if (!OwningNode->GetCanSkip())
 	{
@@ -54,6 +88,14 @@ void UInputDialogueTransition::TransitionOut()
 
 void UInputDialogueTransition::SelectOption(int32 InOptionIndex)
 {
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+	const TArray<FResolvedDialogueOption>& Options = 
+		Instance->GetTransitionState().Options;
+
 	//End the dialogue if fed a bad index
 	if (!Options.IsValidIndex(InOptionIndex))
 	{
@@ -66,7 +108,7 @@ void UInputDialogueTransition::SelectOption(int32 InOptionIndex)
 	}
 
 	//If option locked, do nothing more
-	if (Options[InOptionIndex].Details.bIsLocked)
+	if (Options[InOptionIndex].bIsLocked)
 	{
 		return;
 	}
@@ -79,8 +121,9 @@ void UInputDialogueTransition::SelectOption(int32 InOptionIndex)
 	}
 
 	//Transition to the selected node 
-	UDialogueNode* Selected = Options[InOptionIndex].TargetNode;
-	OwningNode->GetDialogue()->TraverseNode(Selected);
+	OwningNode->GetDialogue()->TraverseNodeAt(
+		Options[InOptionIndex].TargetIndex
+	);
 }
 
 FText UInputDialogueTransition::GetDisplayName() const
@@ -102,31 +145,62 @@ EDialogueConnectionLimit UInputDialogueTransition::GetConnectionLimit() const
 	return EDialogueConnectionLimit::Unlimited;
 }
 
+void UInputDialogueTransition::CompileTransition(FDialogueProgram& InProgram,
+	FDialogueProgramNode& OutNode) const
+{
+	//Options are routed ahead of time when the program is built
+	OutNode.bResolvesOptions = true;
+}
+
 void UInputDialogueTransition::ShowOptions()
 {
+	FDialogueInstance* Instance = GetInstance();
+	if (!Instance)
+	{
+		return;
+	}
+
 	//If valid options, display them 
+	const TArray<FResolvedDialogueOption>& Options = 
+		Instance->GetTransitionState().Options;
 	if (!Options.IsEmpty())
 	{
-		OwningNode->GetDialogue()->DisplayOptions(Options);
+		Instance->DisplayOptions(Options);
 	}
 }
 
-void UInputDialogueTransition::GetOptions()
+void UInputDialogueTransition::GetOptions(
+	TArray<FResolvedDialogueOption>& OutOptions) const
 {
-	//Retrieve all valid options 
-	Options.Empty();
-	TArray<UDialogueNode*> NodeChildren = OwningNode->GetChildren();
-
-	for (UDialogueNode* Node : NodeChildren)
-	{
-		FDialogueOption NodeOption = Node->GetAsOption();
+	//Retrieve all valid options from the precompiled routes
+	OwningNode->GetDialogue()->GetProgram().GatherOptions(
+		OwningNode->GetNodeIndex(),
+		OutOptions
+	);
+}
 
-		//If a valid option
-		if (!NodeOption.Details.SpeechText.IsEmpty() && NodeOption.TargetNode)
+void UInputDialogueTransition::SelectFirstUnlockedOption(
+	const TArray<FResolvedDialogueOption>& InOptions)
+{
+	const int32 OptionIndex = InOptions.IndexOfByPredicate(
+		[](const FResolvedDialogueOption& Option)
 		{
-			Options.Add(NodeOption);
+			return !Option.bIsLocked;
 		}
+	);
+
+	if (OptionIndex == INDEX_NONE)
+	{
+		UE_LOG(
+			LogDialogueTree,
+			Warning,
+			TEXT("Terminating ambient dialogue: every option is locked.")
+		);
+		OwningNode->GetDialogue()->EndDialogue();
+		return;
 	}
+
+	SelectOption(OptionIndex);
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
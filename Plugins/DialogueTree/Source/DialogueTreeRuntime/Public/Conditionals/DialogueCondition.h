@@ -10,6 +10,8 @@
 
 class UDialogue;
 class UDialogueQuery;
+struct FDialogueConditionInstruction;
+struct FDialogueProgram;
 
 /**
 * Abstract base class of dialogue conditions. 
@@ -48,6 +50,17 @@ public:
 	*/
 	virtual bool IsMet() const;
 
+	/**
+	* Lowers the condition into an instruction in the dialogue's compiled
+	* program. By default the instruction calls back into IsMet().
+	*
+	* @param InProgram - FDialogueProgram&, the program being built.
+	* @param OutInstruction - FDialogueConditionInstruction&, the 
+	* instruction to fill.
+	*/
+	virtual void CompileCondition(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const;
+
 	/**
 	* Assembles the display text for the condition
 	* @param ArgTexts - TMap pairing FName of the condition's
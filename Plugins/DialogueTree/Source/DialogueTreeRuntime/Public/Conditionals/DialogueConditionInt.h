@@ -39,6 +39,8 @@ public:
 	virtual bool IsMet() const override;
 	virtual void SetQuery(UDialogueQuery* InQuery) override;
 	virtual void SetDialogue(UDialogue* InDialogue) override;
+	virtual void CompileCondition(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
 	virtual FText GetDisplayText(const TMap<FName, FText>& ArgTexts, 
 		const FText QueryText) const override;
 	virtual FText GetGraphDescription(FText QueryText) override;
@@ -9,6 +9,8 @@
 #include "DialogueQuery.generated.h"
 
 class UDialogue;
+struct FDialogueConditionInstruction;
+struct FDialogueProgram;
 
 /**
 * Abstract base class for all dialogue queries. 
@@ -51,6 +53,40 @@ public:
 	*/
 	virtual bool IsValidQuery() const;
 
+	/**
+	* Lowers the query into the given condition instruction, so it is 
+	* evaluated inline instead of through ExecuteQuery(). The instruction's
+	* comparison has already been set by the owning condition. 
+	* 
+	* @param InProgram - FDialogueProgram&, the program being built.
+	* @param OutInstruction - FDialogueConditionInstruction&, the 
+	* instruction to fill.
+	* @return bool - True if the query was lowered. False if it has to be
+	* executed through its object.
+	*/
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const;
+
+	/**
+	* Checks if the query's result may be reused within a frame for as long
+	* as the dialogue's state does not change. 
+	* 
+	* @return bool - True if cacheable, False otherwise. 
+	*/
+	virtual bool IsCacheable() const;
+
+protected:
+	/** 
+	* Whether the query is pure: given the same speakers, visits, blackboard
+	* and speaker tags it always returns the same result. Pure queries run
+	* at most once per frame and dialogue state, and identical copies of 
+	* them in a dialogue share one result. Games whose own state is read 
+	* should call NotifyDialogueStateChanged on the controller when it 
+	* changes. 
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Dialogue")
+	bool bCacheable = false;
+
 private:
 	UPROPERTY()
 	TObjectPtr<UDialogue> Dialogue;
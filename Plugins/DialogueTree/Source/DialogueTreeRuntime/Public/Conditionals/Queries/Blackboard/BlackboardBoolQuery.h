@@ -0,0 +1,34 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "Conditionals/Queries/Base/DialogueQueryBool.h"
+//Generated
+#include "BlackboardBoolQuery.generated.h"
+
+/**
+ * Dialogue query that checks a bool key on the dialogue blackboard. 
+ * Compiled into a direct read of the key's blackboard slot. 
+ */
+UCLASS(EditInlineNew)
+class DIALOGUETREERUNTIME_API UBlackboardBoolQuery : public UDialogueQueryBool
+{
+	GENERATED_BODY()
+
+public:
+	/** IDialogueQueryBool Impl. */
+	virtual bool ExecuteQuery() override;
+	virtual FText GetGraphDescription_Implementation() const override;
+	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
+	/** End IDialogueQueryBool */
+
+private:
+	/** The blackboard key to read */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Key;
+};
@@ -0,0 +1,34 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "Conditionals/Queries/Base/DialogueQueryFloat.h"
+//Generated
+#include "BlackboardFloatQuery.generated.h"
+
+/**
+ * Dialogue query that reads a float key from the dialogue blackboard. 
+ * Compiled into a direct read of the key's blackboard slot. 
+ */
+UCLASS(EditInlineNew)
+class DIALOGUETREERUNTIME_API UBlackboardFloatQuery : public UDialogueQueryFloat
+{
+	GENERATED_BODY()
+
+public:
+	/** IDialogueQueryFloat Impl. */
+	virtual double ExecuteQuery() override;
+	virtual FText GetGraphDescription_Implementation() const override;
+	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
+	/** End IDialogueQueryFloat */
+
+private:
+	/** The blackboard key to read */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Key;
+};
@@ -0,0 +1,34 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "Conditionals/Queries/Base/DialogueQueryInt.h"
+//Generated
+#include "BlackboardIntQuery.generated.h"
+
+/**
+ * Dialogue query that reads an int key from the dialogue blackboard. 
+ * Compiled into a direct read of the key's blackboard slot. 
+ */
+UCLASS(EditInlineNew)
+class DIALOGUETREERUNTIME_API UBlackboardIntQuery : public UDialogueQueryInt
+{
+	GENERATED_BODY()
+
+public:
+	/** IDialogueQueryInt Impl. */
+	virtual int32 ExecuteQuery() override;
+	virtual FText GetGraphDescription_Implementation() const override;
+	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
+	/** End IDialogueQueryInt */
+
+private:
+	/** The blackboard key to read */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Key;
+};
@@ -0,0 +1,39 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "Conditionals/Queries/Base/DialogueQueryBool.h"
+//Generated
+#include "BlackboardNameQuery.generated.h"
+
+/**
+ * Dialogue query that checks if a name key on the dialogue blackboard
+ * holds the given name. Compiled 
+ * into a direct read of the key's blackboard slot. 
+ */
+UCLASS(EditInlineNew)
+class DIALOGUETREERUNTIME_API UBlackboardNameQuery : public UDialogueQueryBool
+{
+	GENERATED_BODY()
+
+public:
+	/** IDialogueQueryBool Impl. */
+	virtual bool ExecuteQuery() override;
+	virtual FText GetGraphDescription_Implementation() const override;
+	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
+	/** End IDialogueQueryBool */
+
+private:
+	/** The blackboard key to read */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Key;
+
+	/** The name the key has to hold */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Value;
+};
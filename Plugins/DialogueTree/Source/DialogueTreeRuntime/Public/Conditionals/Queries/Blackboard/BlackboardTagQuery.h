@@ -0,0 +1,40 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+//Plugin
+#include "Conditionals/Queries/Base/DialogueQueryBool.h"
+//Generated
+#include "BlackboardTagQuery.generated.h"
+
+/**
+ * Dialogue query that checks if the tag held by a tag key on the 
+ * dialogue blackboard matches the given tag, counting parent tags. Compiled 
+ * into a direct read of the key's blackboard slot. 
+ */
+UCLASS(EditInlineNew)
+class DIALOGUETREERUNTIME_API UBlackboardTagQuery : public UDialogueQueryBool
+{
+	GENERATED_BODY()
+
+public:
+	/** IDialogueQueryBool Impl. */
+	virtual bool ExecuteQuery() override;
+	virtual FText GetGraphDescription_Implementation() const override;
+	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
+	/** End IDialogueQueryBool */
+
+private:
+	/** The blackboard key to read */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Key;
+
+	/** The tag the key's tag has to match */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FGameplayTag Tag;
+};
@@ -26,6 +26,8 @@ public:
 	virtual bool ExecuteQuery() override;
 	virtual FText GetGraphDescription_Implementation() const override;
 	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
 	/** End IDialogueQueryBool */
 
 	/** UObject Impl. */
@@ -39,6 +41,13 @@ public:
 	*/
 	UDialogueNodeSocket* GetSocket();
 
+	/**
+	* Sets the node socket for this query. 
+	* 
+	* @param InSocket - UDialogueNodeSocket*, the socket. 
+	*/
+	void SetSocket(UDialogueNodeSocket* InSocket);
+
 private: 
 	/** Node to check */
 	UPROPERTY(EditAnywhere, Category = "Dialogue")
@@ -15,6 +15,9 @@ class UDialogueSpeakerSocket;
  * Query that checks if an expected speaker component is present in
  * the dialogue. This is useful when a dialogue can have variable 
  * speakers as participants (in a party based CRPG for example). 
+ * Can optionally require the speaker to be within range of another, and
+ * count speakers nearby in the world that were not brought into the
+ * dialogue.
  */
 UCLASS(EditInlineNew)
 class DIALOGUETREERUNTIME_API USpeakerFoundQuery : public UDialogueQueryBool
@@ -26,6 +29,8 @@ public:
 	virtual bool ExecuteQuery() override;
 	virtual FText GetGraphDescription_Implementation() const override;
 	virtual bool IsValidQuery() const override;
+	virtual bool CompileQuery(FDialogueProgram& InProgram,
+		FDialogueConditionInstruction& OutInstruction) const override;
 	/** End IDialogueQueryBool */
 
 	/** UObject Impl. */
@@ -36,4 +41,21 @@ private:
 	/** The speaker socket associated with the target speaker */
 	UPROPERTY(EditAnywhere, Category = "Dialogue")
 	TObjectPtr<UDialogueSpeakerSocket> Speaker;
+
+	/** How close the speaker has to be to the range origin. 0 ignores 
+	* distance. */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", 
+		meta = (ClampMin = 0, Units = "Centimeters"))
+	float Range = 0.f;
+
+	/** The speaker the range is measured from */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", 
+		meta = (EditCondition = "Range > 0"))
+	TObjectPtr<UDialogueSpeakerSocket> RangeOrigin;
+
+	/** Whether a speaker with the target's dialogue name that was not 
+	* brought into the dialogue also counts, if it is within range */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", 
+		meta = (EditCondition = "Range > 0"))
+	bool bIncludeUnboundSpeakers = false;
 };
@@ -74,4 +74,8 @@ private:
 	/** Optional additional speakers to attach to the event */
 	UPROPERTY(EditAnywhere, Category = "Dialogue")
 	TArray<TObjectPtr<UDialogueSpeakerSocket>> AdditionalSpeakers;
+
+	/** Entries for the additional speakers, kept between executions */
+	UPROPERTY(Transient)
+	TArray<FSpeakerActorEntry> OtherSpeakerEntries;
 };
@@ -6,6 +6,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 //Plugin
+#include "DialogueProgram.h"
 #include "Nodes/DialogueSpeechNode.h"
 //Generated
 #include "Dialogue.generated.h"
@@ -16,6 +17,7 @@ class UDialogueNode;
 class UDialogueSpeakerComponent;
 class UDialogueSpeakerSocket;
 class UEdGraph;
+class FDialogueInstance;
 
 DECLARE_DELEGATE(FSpeakerRolesChangedSignature);
 
@@ -106,84 +108,121 @@ public:
 	UDialogue();
 
 public: 
-#if WITH_EDITOR
 	/** UObject Impl. */
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+	virtual void PostDuplicate(bool bDuplicateForPIE) override;
+#if WITH_EDITOR
 	virtual void PostEditChangeProperty(
 		struct FPropertyChangedEvent& PropertyChangedEvent) override;
-	/** End UObject */
 #endif
+	/** End UObject */
 
 	/**
 	* Sets the component value associated with the given name 
-	* to the provided speaker component. BlueprintCallable. 
+	* to the provided speaker component in the active instance. 
+	* Does nothing outside of the dialogue's execution, such as its events
+	* and speaker callbacks, and warns. BlueprintCallable. Deprecated for 
+	* Blueprints in favor of ADialogueController::SetSpeakerInDialogue().
 	* 
 	* @param InName - FName, the dialogue's name for the speaker. 
 	* Can differ from the component's display name. 
 	* @param InSpeaker - UDialogueSpeakerComponent*, the component 
 	* associated with the speaker. 
 	*/
-	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	UFUNCTION(BlueprintCallable, Category = "Dialogue", meta = (
+		DeprecatedFunction,
+		DeprecationMessage = "Use the dialogue controller's SetSpeakerInDialogue or SetSpeaker instead."))
 	void SetSpeaker(FName InName, UDialogueSpeakerComponent* InSpeaker);
 
 	/**
 	* Retrieves the speaker component associated with the given 
-	* name by the dialogue. BlueprintCallable. 
+	* name by the active instance. Returns nullptr outside of the 
+	* dialogue's execution, and warns. BlueprintCallable. Deprecated for 
+	* Blueprints in favor of ADialogueController::GetSpeakerInDialogue().
 	* 
 	* @param InName - FName, name associated with the desired 
 	* speaker
 	* @return UDialogueSpeakerComponent*, component associated with 
 	* the given speaker name. Nullptr if none found. 
 	*/
-	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	UFUNCTION(BlueprintCallable, Category = "Dialogue", meta = (
+		DeprecatedFunction,
+		DeprecationMessage = "Use the dialogue controller's GetSpeakerInDialogue or GetSpeaker instead."))
 	UDialogueSpeakerComponent* GetSpeaker(FName InName) const;
 
 	/**
-	* Adds a speaker entry for the given name with a component value
-	* of nullptr. 
+	* Retrieves the speaker component bound to the given speaker slot by 
+	* the active instance. 
 	* 
-	* @param InName - FName, name to create an entry for.
+	* @param InSlot - int32, the slot of the speaker's role in the compiled 
+	* program.
+	* @return UDialogueSpeakerComponent*, component bound to the slot. 
+	* Nullptr if none, or outside of the dialogue's execution, which warns. 
 	*/
-	void AddSpeakerEntry(FName InName);
+	UDialogueSpeakerComponent* GetSpeakerAt(int32 InSlot) const;
 
 	/**
-	* Opens the dialogue at the given node ID. 
+	* Retrieves the instance that calls on the dialogue are routed to: the 
+	* instance currently executing, if it plays this dialogue. Nodes, 
+	* transitions and events are shared by every instance, so they reach 
+	* their instance's state through here. 
 	* 
-	* @param InNodeID - FName, the target node to start at. 
-	* @param InController - ADialogueController*, DialogueController
-	* actor. 
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>, 
-	* components to associate with expected speaker names. 
+	* @return FDialogueInstance* - the active instance. Nullptr outside of
+	* an execution of this dialogue. 
 	*/
-	void OpenDialogueAt(FName InNodeID, ADialogueController* InController,
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers);
+	FDialogueInstance* GetActiveInstance() const;
 
 	/**
-	* Clears the current dialogue controller. Used when closing 
-	* dialogue. 
+	* Retrieves the handle of the instance currently executing the 
+	* dialogue, such as the one playing an event. Keep it to address the 
+	* instance through the controller once the execution is over, such as 
+	* after a delay. BlueprintPure.
+	* 
+	* @return int32 - the instance's handle. INDEX_NONE outside of an 
+	* execution of this dialogue.
 	*/
-	void ClearController();
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	int32 GetExecutingHandle() const;
 
 	/**
-	* Calls on the controller to end the dialogue. 
+	* Checks if the dialogue is ready to play. Fills the provided 
+	* error message if not. 
+	* 
+	* @param OutErrorMessage - FString&, error message to fill if
+	* the dialogue cannot play. 
+	* @return bool, whether the dialogue can play or not. 
+	*/
+	bool CanPlay(FString& OutErrorMessage) const;
+
+	/**
+	* Calls on the controller to end the active instance. Warns outside 
+	* of the dialogue's execution; end a dialogue through its controller 
+	* there.
 	*/
 	void EndDialogue() const;
 
 	/**
-	* Calls on the controller to display the given speech. 
+	* Calls on the controller to display the given speech. Warns outside 
+	* of the dialogue's execution.
 	* 
 	* @param InDetails - const FSpeechDetails&, details for the 
 	* target speech. 
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker voicing 
+	* the speech.
 	*/
-	void DisplaySpeech(const FSpeechDetails& InDetails) const;
+	void DisplaySpeech(const FSpeechDetails& InDetails, 
+		UDialogueSpeakerComponent* InSpeaker) const;
 
 	/**
 	* Calls on the controller to display the given dialogue options
 	* for the user to select from. 
 	* 
-	* @param InOptions - TArray<FDialogueOption>, options to
-	* display.
+	* @param InOptions - const TArray<FResolvedDialogueOption>&, options 
+	* to display.
 	*/
-	void DisplayOptions(TArray<FDialogueOption> InOptions) const;
+	void DisplayOptions(const TArray<FResolvedDialogueOption>& InOptions) 
+		const;
 
 	/**
 	* Attempts to select a dialogue option at the given index. 
@@ -204,7 +243,42 @@ public:
 	* 
 	* @param InNode - UDialogueNode*, node to traverse. 
 	*/
-	void TraverseNode(UDialogueNode* InNode);
+	void TraverseNode(UDialogueNode* InNode) const;
+
+	/**
+	* Attempts to traverse the node at the given index of the compiled 
+	* program in the active instance. Closes the dialogue if anything goes 
+	* wrong. 
+	* 
+	* @param NodeIndex - int32, index of the node to traverse. 
+	*/
+	void TraverseNodeAt(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the flat program compiled from the dialogue's nodes. 
+	* 
+	* @return const FDialogueProgram& - the compiled program. 
+	*/
+	const FDialogueProgram& GetProgram() const;
+
+	/**
+	* Retrieves the dialogue's stable key, which save data is stored 
+	* against. Unlike the asset's name it is unique across folders and 
+	* survives the asset being renamed or moved. 
+	* 
+	* @return uint64 - the key. 
+	*/
+	uint64 GetDialogueKey() const;
+
+	/**
+	* Rebuilds the compiled program from the dialogue's current nodes. 
+	* Called at the end of compiling, and on load for dialogues compiled 
+	* before the program existed. Nodes keep the visit slot they were given
+	* by earlier builds, found by stable ID so renamed nodes keep theirs 
+	* too. Speaker roles are given slots, which are stamped on their 
+	* sockets. 
+	*/
+	void BuildProgram();
 
 	/**
 	* Retrieves the dialogue's current compile status.
@@ -215,22 +289,30 @@ public:
 
 	/**
 	* Retrieves the entire map of expected speaker names to their 
-	* speaker components. 
+	* speaker components in the active instance. Deprecated for Blueprints
+	* in favor of ADialogueController::GetSpeakersInDialogue().
 	* 
 	* @return TMap<FName, UDialogueSpeakerComponent*>, the map of 
-	* speaker names to components. 
+	* speaker names to components. Empty outside of the dialogue's 
+	* execution, which warns. 
 	*/
-	UFUNCTION(BlueprintCallable, Category="Dialogue")
+	UFUNCTION(BlueprintCallable, Category="Dialogue", meta = (
+		DeprecatedFunction,
+		DeprecationMessage = "Use the dialogue controller's GetSpeakersInDialogue or GetSpeakers instead."))
 	TMap<FName, UDialogueSpeakerComponent*> GetAllSpeakers() const;
 
 	/**
 	* Checks if a speaker with the given name is currently present/valid for 
-	* the dialogue. 
+	* the dialogue. Deprecated for Blueprints in favor of 
+	* ADialogueController::GetSpeakerInDialogue().
 	* 
 	* @param SpeakerName - FName, name of the target speaker. 
-	* @return bool - True if the speaker is valid/present; false otherwise. 
+	* @return bool - True if the speaker is valid/present; false otherwise,
+	* or outside of the dialogue's execution, which warns. 
 	*/
-	UFUNCTION(BlueprintCallable, Category="Dialogue")
+	UFUNCTION(BlueprintCallable, Category="Dialogue", meta = (
+		DeprecatedFunction,
+		DeprecationMessage = "Use the dialogue controller's GetSpeakerInDialogue or GetSpeaker instead."))
 	bool SpeakerIsPresent(const FName SpeakerName) const;
 	
 	/**
@@ -248,12 +330,22 @@ public:
 	* @param TargetNode - UDialogueNode* to change visited status for. 
 	* @param bVisited - bool, True for visited, False for unvisited. 
 	*/
-	void MarkNodeVisited(UDialogueNode* TargetNode, bool bVisited);
+	void MarkNodeVisited(UDialogueNode* TargetNode, bool bVisited) const;
 
 	/**
 	* Marks all nodes in the dialogue unvisited. 
 	*/
-	void ClearAllNodeVisits();
+	void ClearAllNodeVisits() const;
+
+	/**
+	* Reads a key from the controller's blackboard. If dialogue is inactive,
+	* returns a default value.
+	*
+	* @param InKey - FName, the key.
+	* @return FDialogueBlackboardValue - the value. Defaulted if the key was
+	* never set.
+	*/
+	FDialogueBlackboardValue GetBlackboardValue(FName InKey) const;
 
 	/**
 	* Checks if the given node ID corresponds to a node in the dialogue. 
@@ -268,7 +360,7 @@ public:
 	* 
 	* @param InNode - UDialogueNode* - the node to resume from. 
 	*/
-	void SetResumeNode(UDialogueNode* InNode);
+	void SetResumeNode(UDialogueNode* InNode) const;
 
 	/**
 	* Retrieves the dialogue's root node.
@@ -300,6 +392,13 @@ public:
 	*/
 	const TArray<UDialogueNode*> GetAllNodes() const;
 
+	/**
+	* Retrieves a map of speaker names to their role structs in the dialogue. 
+	* 
+	* @return const TMap<FName, FSpeakerField>& - the speaker role map.
+	*/
+	const TMap<FName, FSpeakerField>& GetSpeakerRoles() const;
+
 #if WITH_EDITOR
 public:
 	/**
@@ -316,13 +415,6 @@ public:
 	*/
 	void SetEdGraph(UEdGraph* InEdGraph);
 
-	/**
-	* Retrieves a map of speaker names to their role structs in the dialogue. 
-	* 
-	* @return const TMap<FName, FSpeakerField>& - the speaker role map.
-	*/
-	const TMap<FName, FSpeakerField>& GetSpeakerRoles() const;
-
 	/**
 	* Add the given node to the dialogue. 
 	* 
@@ -365,6 +457,28 @@ public:
 #endif
 
 private: 
+	/**
+	* Retrieves the active instance, warning if there is none. For calls 
+	* that mean nothing outside of an execution of the dialogue.
+	* 
+	* @param InFunction - const TCHAR*, the name of the calling function.
+	* @return FDialogueInstance* - the active instance. Nullptr if none.
+	*/
+	FDialogueInstance* GetActiveInstanceOrWarn(const TCHAR* InFunction)
+		const;
+
+	/**
+	* Retrieves the visit slot of a node being compiled, handing out a new
+	* one if the node never had one. 
+	* 
+	* @param InNodeID - FName, the node's ID. 
+	* @param InStableID - uint32, the node's stable ID. 0 if none. 
+	* @param InOutStableSlots - TSet<int32>&, slots owned by a stable ID. 
+	* @return int32 - the visit slot. 
+	*/
+	int32 AssignVisitSlot(FName InNodeID, uint32 InStableID,
+		TSet<int32>& InOutStableSlots);
+
 	/**
 	* Adds the default set of speakers into the graph.
 	*/
@@ -392,28 +506,6 @@ private:
 	*/
 	void OnChangeSingleSpeaker();
 
-	/**
-	* Checks if the dialogue is ready to play. Fills the provided 
-	* error message if not. 
-	* 
-	* @param InController - ADialogueController*, controller that
-	* would interface with the dialogue
-	* @param OutErrorMessage - FString&, error message to fill if
-	* the dialogue cannot play. 
-	* @return bool, whether the dialogue can play or not. 
-	*/
-	bool CanPlay(ADialogueController* InController, FString& OutErrorMessage) 
-		const;
-
-	/**
-	* Refreshes the speakers, plugging in the provided components. 
-	* 
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
-	* the speaker components to enter, matched to their expected
-	* names
-	*/
-	void FillSpeakers(TMap<FName, UDialogueSpeakerComponent*> InSpeakers);
-
 private:
 	/** Editable speaking roles for the graph */
 	UPROPERTY(EditAnywhere, NoClear, Category = "Dialogue", 
@@ -429,17 +521,27 @@ private:
 	UPROPERTY()
 	TObjectPtr<UDialogueEntryNode> RootNode; 
 
-	/** The currently active node in the dialogue */
+	/** Flat, index-addressed form of the nodes used for traversal */
+	UPROPERTY()
+	FDialogueProgram Program;
+
+	/** Visit slot handed out to each node ID, including IDs nodes had 
+	* before being renamed. Kept across recompiles and never reused, so 
+	* saved visit bits keep meaning the same node */
+	UPROPERTY()
+	TMap<FName, int32> VisitSlots;
+
+	/** Visit slot handed out to each node stable ID */
 	UPROPERTY()
-	TObjectPtr<UDialogueNode> ActiveNode;
+	TMap<uint32, int32> StableVisitSlots;
 
-	/** A mapping of speaker names to their found components */
+	/** Number of visit slots handed out */
 	UPROPERTY()
-	TMap<FName, TObjectPtr<UDialogueSpeakerComponent>> Speakers;
+	int32 NumVisitSlots = 0;
 
-	/** The controlling actor for the dialogue */
+	/** Stable key save data for the dialogue is stored against */
 	UPROPERTY()
-	TObjectPtr<ADialogueController> DialogueController;
+	uint64 DialogueKey = 0;
 
 	/** Thhe current compile status of the dialogue */
 	UPROPERTY()
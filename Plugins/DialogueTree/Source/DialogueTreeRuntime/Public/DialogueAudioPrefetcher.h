@@ -0,0 +1,137 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Sound/SoundBase.h"
+
+struct FDialogueProgram;
+
+/**
+* Streams in the speech audio of a playing dialogue ahead of the cursor.
+* Each time the dialogue rests on a node, the audio of every speech within
+* a few speeches of it is requested asynchronously, nearest first, and any
+* line that can no longer be reached is let go. The total prefetched by all
+* dialogues is capped by the budget in the project settings.
+* Owned by the dialogue instance it prefetches for.
+*/
+class DIALOGUETREERUNTIME_API FDialogueAudioPrefetcher
+{
+public:
+	FDialogueAudioPrefetcher() = default;
+	~FDialogueAudioPrefetcher();
+
+	FDialogueAudioPrefetcher(const FDialogueAudioPrefetcher&) = delete;
+	FDialogueAudioPrefetcher& operator=(const FDialogueAudioPrefetcher&)
+		= delete;
+
+	/**
+	* Requests the audio of speeches reachable from the given node and
+	* releases any line that is no longer reachable.
+	*
+	* @param InProgram - const FDialogueProgram&, the playing program.
+	* @param FromIndex - int32, the node the dialogue is resting on.
+	*/
+	void Update(const FDialogueProgram& InProgram, int32 FromIndex);
+
+	/**
+	* Requests the given audio straight away at high priority, for a speech
+	* that has to play before its line was prefetched. Replaces any earlier
+	* request made through here.
+	*
+	* @param InAudio - const TSoftObjectPtr<USoundBase>&, the audio.
+	* @param InOnLoaded - FStreamableDelegate, called once the load ends,
+	* whether or not it succeeded.
+	* @return bool - True if the load was requested. False otherwise.
+	*/
+	bool RequestNow(const TSoftObjectPtr<USoundBase>& InAudio,
+		FStreamableDelegate InOnLoaded);
+
+	/**
+	* Cancels all requests and lets go of every prefetched line.
+	*/
+	void Release();
+
+	/**
+	* Gets the bytes of audio currently held by all prefetchers.
+	*
+	* @return int64 - the prefetched bytes.
+	*/
+	static int64 GetPrefetchedBytes();
+
+private:
+	/** A line requested by the prefetcher */
+	struct FPrefetchEntry
+	{
+		/** Keeps the line loaded for as long as it is held */
+		TSharedPtr<FStreamableHandle> Handle;
+
+		/** Size counted against the budget. Estimated until loaded. */
+		int64 Bytes = 0;
+
+		/** Whether Bytes is the line's real size */
+		bool bSizeKnown = false;
+
+		/** Whether the line was reachable as of the latest update */
+		bool bReachable = false;
+	};
+
+	/**
+	* Marks the given line reachable, requesting it if it has not been yet
+	* and the budget allows.
+	*
+	* @param InAudio - const TSoftObjectPtr<USoundBase>&, the line.
+	* @param InBudget - int64, the budget in bytes.
+	* @param InEstimate - int64, bytes charged for a line still loading.
+	*/
+	void Want(const TSoftObjectPtr<USoundBase>& InAudio, int64 InBudget,
+		int64 InEstimate);
+
+	/**
+	* Called when a prefetched line finishes loading.
+	*
+	* @param InPath - FSoftObjectPath, the line.
+	*/
+	void OnPrefetched(FSoftObjectPath InPath);
+
+	/**
+	* Cancels or releases the given entry's request.
+	*
+	* @param InEntry - FPrefetchEntry&, the entry.
+	*/
+	static void ReleaseEntry(FPrefetchEntry& InEntry);
+
+	/**
+	* Changes the bytes the given entry counts against the budget.
+	*
+	* @param InEntry - FPrefetchEntry&, the entry.
+	* @param InBytes - int64, the entry's new size.
+	*/
+	static void SetEntryBytes(FPrefetchEntry& InEntry, int64 InBytes);
+
+	/**
+	* Cancels or releases the given handle.
+	*
+	* @param InHandle - TSharedPtr<FStreamableHandle>&, the handle. Reset.
+	*/
+	static void ReleaseHandle(TSharedPtr<FStreamableHandle>& InHandle);
+
+private:
+	/** Lines requested by the prefetcher */
+	TMap<FSoftObjectPath, FPrefetchEntry> Entries;
+
+	/** The line requested through RequestNow() */
+	TSharedPtr<FStreamableHandle> ImmediateHandle;
+
+	/** Nodes waiting to be searched, with the speeches passed to get there.
+	* Kept to reuse the allocation. */
+	TArray<TPair<int32, int32>> SearchQueue;
+
+	/** Nodes already searched this update */
+	TBitArray<> Searched;
+
+	/** Bytes held by all prefetchers */
+	static int64 PrefetchedBytes;
+};
@@ -0,0 +1,199 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+//Generated
+#include "DialogueBarkService.generated.h"
+
+class UDialogue;
+class UDialogueManagerSubsystem;
+class UDialogueSpeakerComponent;
+
+/**
+* How a bark competes with the other barks in the world.
+*/
+USTRUCT(BlueprintType)
+struct FDialogueBarkParams
+{
+	GENERATED_BODY()
+
+	/** Higher priority barks start first and may interrupt lower ones */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+	int32 Priority = 0;
+
+	/** Seconds before the speaker may bark the same dialogue again */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue",
+		meta = (ClampMin = 0, Units = "Seconds"))
+	float Cooldown = 0.f;
+
+	/** Whether a higher priority bark may cut this one off */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
+	bool bInterruptible = true;
+
+	/** Seconds the bark may wait for a free voice before it is dropped */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue",
+		meta = (ClampMin = 0, Units = "Seconds"))
+	float MaxDelay = 1.f;
+
+	/** How far to look for speakers to fill the bark's other roles. 0
+	* searches the whole world. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue",
+		meta = (ClampMin = 0, Units = "Centimeters"))
+	float SearchRadius = 1500.f;
+};
+
+/**
+* Arbitrates the barks requested by speakers across a world. Requests are
+* queued by priority and started as ambient dialogues once per frame,
+* within a budget of concurrent barks and of time spent starting them. A
+* bark that cannot get a voice either interrupts a lower priority one,
+* waits, or is dropped once it has waited too long, so crowds reacting at
+* once do not start barks only to end them straight away.
+* Owned and ticked by the dialogue manager subsystem.
+*/
+class DIALOGUETREERUNTIME_API FDialogueBarkService
+{
+public:
+	/**
+	* Sets the subsystem the service starts barks through.
+	*
+	* @param InOwner - UDialogueManagerSubsystem*, the owning subsystem.
+	*/
+	void Initialize(UDialogueManagerSubsystem* InOwner);
+
+	/**
+	* Queues a bark from the given speaker. Replaces a lower priority bark
+	* the speaker already has queued.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the barking speaker.
+	* @param InDialogue - UDialogue*, the bark to play.
+	* @param InParams - const FDialogueBarkParams&, how the bark competes.
+	* @return bool - True if queued. False if the bark is cooling down or
+	* was outranked.
+	*/
+	bool RequestBark(UDialogueSpeakerComponent* InSpeaker,
+		UDialogue* InDialogue, const FDialogueBarkParams& InParams);
+
+	/**
+	* Drops any bark the given speaker has queued.
+	*
+	* @param InSpeaker - const UDialogueSpeakerComponent*, the speaker.
+	*/
+	void CancelBark(const UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Starts as many queued barks as the budgets allow.
+	*/
+	void Tick();
+
+	/**
+	* Forgets a bark that ended, freeing its voice.
+	*
+	* @param Handle - int32, the handle of the ended ambient dialogue.
+	*/
+	void OnBarkEnded(int32 Handle);
+
+	/**
+	* Gets the number of barks waiting for a voice.
+	*
+	* @return int32 - the queued barks.
+	*/
+	int32 GetNumPending() const;
+
+	/**
+	* Gets the number of barks playing.
+	*
+	* @return int32 - the playing barks.
+	*/
+	int32 GetNumRunning() const;
+
+	/**
+	* Drops every queued bark and forgets the playing ones.
+	*/
+	void Reset();
+
+private:
+	/** A bark waiting for a voice */
+	struct FPendingBark
+	{
+		/** The barking speaker */
+		TWeakObjectPtr<UDialogueSpeakerComponent> Speaker;
+
+		/** The bark to play */
+		TWeakObjectPtr<UDialogue> Dialogue;
+
+		/** How the bark competes */
+		FDialogueBarkParams Params;
+
+		/** World time the bark was requested at */
+		double RequestTime = 0.0;
+	};
+
+	/** A bark playing as an ambient dialogue */
+	struct FRunningBark
+	{
+		/** Handle of the ambient dialogue */
+		int32 Handle = INDEX_NONE;
+
+		/** The barking speaker */
+		TWeakObjectPtr<UDialogueSpeakerComponent> Speaker;
+
+		/** Priority the bark was requested with */
+		int32 Priority = 0;
+
+		/** Whether a higher priority bark may cut this one off */
+		bool bInterruptible = true;
+	};
+
+	/**
+	* Finds a playing bark that the given priority may cut off, preferring
+	* the lowest priority.
+	*
+	* @param InPriority - int32, the priority of the incoming bark.
+	* @param InSpeaker - const UDialogueSpeakerComponent*, only consider
+	* this speaker's barks. Null to consider every bark.
+	* @return int32 - index of the bark in the running list. INDEX_NONE if
+	* none may be cut off.
+	*/
+	int32 FindInterruptible(int32 InPriority,
+		const UDialogueSpeakerComponent* InSpeaker) const;
+
+	/**
+	* Ends the playing bark at the given index.
+	*
+	* @param InIndex - int32, index in the running list.
+	*/
+	void Interrupt(int32 InIndex);
+
+	/**
+	* Starts the given bark as an ambient dialogue.
+	*
+	* @param InBark - const FPendingBark&, the bark.
+	* @param InNow - double, the world time.
+	*/
+	void StartBark(const FPendingBark& InBark, double InNow);
+
+	/**
+	* Gets the current world time.
+	*
+	* @return double - the world time in seconds. 0 without a world.
+	*/
+	double GetNow() const;
+
+private:
+	/** The subsystem the service starts barks through */
+	TWeakObjectPtr<UDialogueManagerSubsystem> Owner;
+
+	/** Queued barks, highest priority first, then oldest first */
+	TArray<FPendingBark> Pending;
+
+	/** Barks playing as ambient dialogues */
+	TArray<FRunningBark> Running;
+
+	/** World time each speaker may bark each dialogue again at */
+	TMap<TPair<TObjectKey<UDialogueSpeakerComponent>, TObjectKey<UDialogue>>,
+		double> Cooldowns;
+};
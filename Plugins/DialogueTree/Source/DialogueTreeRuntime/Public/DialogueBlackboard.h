@@ -0,0 +1,199 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+//Generated
+#include "DialogueBlackboard.generated.h"
+
+/**
+* Enum defining the type of value a dialogue blackboard key holds.
+*/
+UENUM(BlueprintType)
+enum class EDialogueBlackboardType : uint8
+{
+	Bool,
+	Int,
+	Float,
+	Name,
+	Tag
+};
+
+/**
+* A value stored on the dialogue blackboard. Bools, ints and floats share
+* the number, so any numeric key can be read as any numeric type.
+*/
+USTRUCT(BlueprintType)
+struct FDialogueBlackboardValue
+{
+	GENERATED_BODY()
+
+	/** The value of bool, int and float keys. Bools are 0 or 1. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, SaveGame,
+		Category = "Dialogue")
+	double Number = 0.0;
+
+	/** The value of name keys */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, SaveGame,
+		Category = "Dialogue")
+	FName Name;
+
+	/** The value of tag keys */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, SaveGame,
+		Category = "Dialogue")
+	FGameplayTag Tag;
+};
+
+/**
+* A key a compiled dialogue reads or writes, resolved to a blackboard slot
+* the first time the dialogue plays.
+*/
+USTRUCT()
+struct FDialogueBlackboardKey
+{
+	GENERATED_BODY()
+
+	/** The key's name */
+	UPROPERTY()
+	FName Name;
+
+	/** The type of value the key holds */
+	UPROPERTY()
+	EDialogueBlackboardType Type = EDialogueBlackboardType::Bool;
+};
+
+/**
+* A single key and its value on the dialogue blackboard.
+*/
+USTRUCT(BlueprintType)
+struct FDialogueBlackboardEntry
+{
+	GENERATED_BODY()
+
+	/** The key's name */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	FName Key;
+
+	/** The type of value the key was added with */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	EDialogueBlackboardType Type = EDialogueBlackboardType::Bool;
+
+	/** The key's value */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	FDialogueBlackboardValue Value;
+};
+
+/**
+* Typed key/value store for game state read by dialogue conditions and
+* written by dialogue events, such as quest flags. Keys are given slots in
+* the order they are added and keep them until the blackboard is reset, so
+* dialogues can resolve each key once and then read and write by index.
+*/
+USTRUCT(BlueprintType)
+struct DIALOGUETREERUNTIME_API FDialogueBlackboard
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Retrieves the slot of the given key.
+	*
+	* @param InKey - FName, the key.
+	* @return int32 - the key's slot. INDEX_NONE if the key was never set.
+	*/
+	int32 FindSlot(FName InKey) const;
+
+	/**
+	* Retrieves the slot of the given key, adding the key with a default
+	* value if needed. A key that already exists keeps its type.
+	*
+	* @param InKey - FName, the key.
+	* @param InType - EDialogueBlackboardType, the type to add the key with.
+	* @return int32 - the key's slot. INDEX_NONE if the key is None.
+	*/
+	int32 FindOrAddSlot(FName InKey, EDialogueBlackboardType InType);
+
+	/**
+	* Checks if the given slot holds a key.
+	*
+	* @param InSlot - int32, the slot.
+	* @return bool - True if valid. False otherwise.
+	*/
+	bool IsValidSlot(int32 InSlot) const;
+
+	/**
+	* Retrieves the value in the given slot.
+	*
+	* @param InSlot - int32, the slot. Must be valid.
+	* @return const FDialogueBlackboardValue& - the value.
+	*/
+	const FDialogueBlackboardValue& GetValue(int32 InSlot) const;
+
+	/**
+	* Overwrites the value in the given slot.
+	*
+	* @param InSlot - int32, the slot. Must be valid.
+	* @param InValue - const FDialogueBlackboardValue&, the new value.
+	*/
+	void SetValue(int32 InSlot, const FDialogueBlackboardValue& InValue);
+
+	/**
+	* Retrieves the value of the given key.
+	*
+	* @param InKey - FName, the key.
+	* @return const FDialogueBlackboardValue* - the value. Nullptr if the
+	* key was never set.
+	*/
+	const FDialogueBlackboardValue* Find(FName InKey) const;
+
+	/**
+	* Retrieves every key and its value, in slot order.
+	*
+	* @return TConstArrayView<FDialogueBlackboardEntry> - the entries.
+	*/
+	TConstArrayView<FDialogueBlackboardEntry> GetEntries() const;
+
+	/**
+	* Gets the number of keys on the blackboard.
+	*
+	* @return int32 - the number of keys.
+	*/
+	int32 Num() const;
+
+	/**
+	* Removes every key.
+	*/
+	void Reset();
+
+	/**
+	* Checks if the blackboard changed since it was last marked clean.
+	*
+	* @return bool - True if changed. False otherwise.
+	*/
+	bool IsDirty() const;
+
+	/**
+	* Marks the blackboard clean, as after it was saved.
+	*/
+	void ClearDirty();
+
+private:
+	/**
+	* Rebuilds the slot lookup if it no longer matches the entries, as after
+	* loading.
+	*/
+	void UpdateSlotLookup() const;
+
+private:
+	/** Keys and their values, by slot */
+	UPROPERTY(SaveGame)
+	TArray<FDialogueBlackboardEntry> Entries;
+
+	/** Lookup from key to slot. Rebuilt from the entries after loading. */
+	mutable TMap<FName, int32> SlotLookup;
+
+	/** Whether the blackboard changed since it was last marked clean */
+	bool bDirty = false;
+};
@@ -4,9 +4,13 @@
 
 //UE
 #include "CoreMinimal.h"
+#include "Engine/TimerHandle.h"
 #include "GameFramework/Actor.h"
 //Plugin
 #include "Dialogue.h"
+#include "DialogueBlackboard.h"
+#include "DialogueInstance.h"
+#include "DialogueRecordsJournal.h"
 //Generated
 #include "DialogueController.generated.h"
 
@@ -16,10 +20,13 @@ class UDialogueSpeakerComponent;
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDialogueControllerDelegate);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
 	FDialogueControllerSpeechDelegate, FSpeechDetails, SpeechDetails);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(
+	FDialogueControllerHandleDelegate, int32, Handle);
 
 /**
 * Struct used to extract node visited data for a single dialogue.
-* Primarily useful for saving/loading.
+* Primarily useful for saving/loading. Visits are stored as one bit per 
+* visit slot of the dialogue. 
 */
 
 USTRUCT(BlueprintType)
@@ -27,14 +34,56 @@ struct FDialogueNodeVisits
 {
 	GENERATED_BODY()
 
+public:
+	/**
+	* Checks if the given visit slot is marked visited. 
+	* 
+	* @param VisitIndex - int32, the node's visit slot. 
+	* @return bool - True if visited. False otherwise. 
+	*/
+	bool IsVisited(int32 VisitIndex) const;
+
+	/**
+	* Marks the given visit slot visited or unvisited. 
+	* 
+	* @param VisitIndex - int32, the node's visit slot. 
+	* @param bVisited - bool, True for visited, False for unvisited. 
+	*/
+	void SetVisited(int32 VisitIndex, bool bVisited);
+
+	/**
+	* Marks every node unvisited, keeping the allocated bits. 
+	*/
+	void ClearVisits();
+
+	/**
+	* Moves visits stored by node ID in older saves into the visit bits. 
+	* 
+	* @param InProgram - const FDialogueProgram&, the dialogue's program, 
+	* used to look up each node's visit slot. 
+	*/
+	void MigrateLegacyVisits(const FDialogueProgram& InProgram);
+
+public:
 	UPROPERTY(BlueprintReadOnly, Category = "Dialogue")
 	FName DialogueFName;
 
+	/** Visited nodes, one bit per visit slot of the dialogue */
+	UPROPERTY(SaveGame)
+	TArray<uint32> VisitedNodeBits;
+
+	/** Visited node IDs as stored by older saves. Migrated into the visit 
+	* bits the first time the dialogue writes to the record. */
 	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
 	TSet<FName> VisitedNodeIDs;
 
 	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
 	FName ResumeNodeID = NAME_None;
+
+	/** Stable ID of the node to resume from, which survives the node being
+	* renamed. Records without one fall back to ResumeNodeID. */
+	UPROPERTY(SaveGame)
+	uint32 ResumeNodeKey = 0;
 };
 
 /**
@@ -46,9 +95,19 @@ struct FDialogueRecords
 {
 	GENERATED_BODY()
 
-	/** Map of dialogue FNames to their records of visited nodes */
+	/** Records of visited nodes by dialogue FName, as stored by older 
+	* saves. Each is moved into KeyedRecords the first time its dialogue 
+	* writes to it. */
 	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
 	TMap<FName, FDialogueNodeVisits> Records;
+
+	/** Records of visited nodes by dialogue key */
+	UPROPERTY(SaveGame)
+	TMap<uint64, FDialogueNodeVisits> KeyedRecords;
+
+	/** Game state read and written by dialogues */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	FDialogueBlackboard Blackboard;
 };
 
 /**
@@ -66,6 +125,12 @@ public:
 	ADialogueController();
 
 public:
+	/** AActor Impl. */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	static void AddReferencedObjects(UObject* InThis, 
+		FReferenceCollector& Collector);
+	/** End AActor */
+
 	/**
 	* Notifies the dialogue that the user is attempting to select
 	* the option at the given index. BlueprintCallable.
@@ -92,14 +157,14 @@ public:
 	* the provided name-speaker pairings.
 	*
 	* @param InDialogue - UDialogue*, the dialogue to start.
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
 	* Speaker Components mapped to their names in dialogue.
 	* @param bResume - bool - If true, the dialogue will resume from the marked
 	* resume node (if any). If false, the dialogue will start over.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartDialogueWithNames(UDialogue* InDialogue,
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers,
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers,
 		bool bResume = false);
 
 	/**
@@ -108,14 +173,15 @@ public:
 	* names. Duplicate or unfilled names not allowed.
 	*
 	* @param InDialogue - UDialogue*, the dialogue to start.
-	* @param InSpeakers - TArray<UDialogueSpeakerComponent*>, Speaker
+	* @param InSpeakers - const TArray<UDialogueSpeakerComponent*>&, Speaker
 	* Components to use.
 	* @param bResume - bool - If true, the dialogue will resume from the marked
 	* resume node (if any). If false, the dialogue will start over.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartDialogue(UDialogue* InDialogue,
-		TArray<UDialogueSpeakerComponent*> InSpeakers, bool bResume = false);
+		const TArray<UDialogueSpeakerComponent*>& InSpeakers, 
+		bool bResume = false);
 
 	/**
 	* Starts the provided dialogue with the provided speaker
@@ -123,12 +189,12 @@ public:
 	* roles using the provided name-speaker pairings.
 	*
 	* @param InDialogue - UDialogue*, the dialogue to start.
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
 	* Speaker Components mapped to their names in dialogue.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartDialogueWithNamesAt(UDialogue* InDialogue, FName NodeID,
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers);
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers);
 
 	/**
 	* Starts the provided dialogue with the provided speaker
@@ -137,12 +203,72 @@ public:
 	* not allowed.
 	*
 	* @param InDialogue - UDialogue*, the dialogue to start.
-	* @param InSpeakers - TArray<UDialogueSpeakerComponent*>, Speaker
+	* @param InSpeakers - const TArray<UDialogueSpeakerComponent*>&, Speaker
 	* Components to use.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartDialogueAt(UDialogue* InDialogue, FName NodeID,
-		TArray<UDialogueSpeakerComponent*> InSpeakers);
+		const TArray<UDialogueSpeakerComponent*>& InSpeakers);
+
+	/**
+	* Starts the provided dialogue at the given dialogue node ID with speaker
+	* components already bound to the dialogue's speaker slots. Skips all
+	* name matching, so callers that start the same dialogue often can bind
+	* once and reuse the slots. See FDialogueProgram::FindSpeakerSlot().
+	*
+	* @param InDialogue - UDialogue*, the dialogue to start.
+	* @param NodeID - FName, the node to start from.
+	* @param InSlots - TConstArrayView<UDialogueSpeakerComponent*>, Speaker
+	* Components in the slot order of the dialogue's compiled roles.
+	*/
+	void StartDialogueInSlots(UDialogue* InDialogue, FName NodeID,
+		TConstArrayView<UDialogueSpeakerComponent*> InSlots);
+
+	/**
+	* Takes a snapshot of the current dialogue's live state: the node it 
+	* rests on, its speakers, its transition timers and pending options, 
+	* and its blocking events. Save it to restore the dialogue mid-line. 
+	*
+	* @param OutSnapshot - FDialogueInstanceSnapshot&, the snapshot.
+	* @return bool - True if a snapshot was taken. False if no dialogue is
+	* playing or it is between nodes.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool SnapshotDialogue(FDialogueInstanceSnapshot& OutSnapshot) const;
+
+	/**
+	* Restores a snapshotted dialogue as the current dialogue, replacing
+	* whatever was playing. The dialogue picks up on the snapshot's node 
+	* without traversing the nodes before it. Speakers are bound to the 
+	* roles they filled by dialogue name, from the given speakers first and
+	* then from any registered with the dialogue subsystem. The dialogue
+	* asset must already be loaded; see RestoreDialogueAsync().
+	*
+	* @param InSnapshot - const FDialogueInstanceSnapshot&, the snapshot.
+	* @param InSpeakers - const TArray<UDialogueSpeakerComponent*>&, 
+	* Speaker Components to bind.
+	* @return bool - True if the dialogue was restored. False otherwise.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool RestoreDialogue(const FDialogueInstanceSnapshot& InSnapshot,
+		const TArray<UDialogueSpeakerComponent*>& InSpeakers);
+
+	/**
+	* Streams in the snapshot's dialogue asset, then restores it as 
+	* RestoreDialogue() does. Restores straight away if the asset is 
+	* already loaded. Starting or restoring another dialogue before the 
+	* asset arrives cancels the restore. OnDialogueStarted is broadcast 
+	* once the dialogue is restored.
+	*
+	* @param InSnapshot - const FDialogueInstanceSnapshot&, the snapshot.
+	* @param InSpeakers - const TArray<UDialogueSpeakerComponent*>&, 
+	* Speaker Components to bind.
+	* @return bool - True if the dialogue was restored or is loading. False
+	* otherwise.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool RestoreDialogueAsync(const FDialogueInstanceSnapshot& InSnapshot,
+		const TArray<UDialogueSpeakerComponent*>& InSpeakers);
 
 	/**
 	* Ends the current dialogue. BlueprintCallable.
@@ -150,6 +276,112 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void EndDialogue();
 
+	/**
+	* Starts the provided dialogue as an ambient conversation. Ambient 
+	* dialogues play alongside the current dialogue and each other without
+	* touching the display, and pick the first unlocked option whenever 
+	* they reach a choice. Matches the speakers to dialogue roles using their
+	* dialogue names. Duplicate or unfilled names not allowed.
+	*
+	* @param InDialogue - UDialogue*, the dialogue to start.
+	* @param InSpeakers - TArray<UDialogueSpeakerComponent*>, Speaker
+	* Components to use.
+	* @param bResume - bool - If true, the dialogue will resume from the marked
+	* resume node (if any). If false, the dialogue will start over.
+	* @return int32 - handle of the ambient dialogue. INDEX_NONE if it could
+	* not be started or ended immediately.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	int32 StartAmbientDialogue(UDialogue* InDialogue,
+		const TArray<UDialogueSpeakerComponent*>& InSpeakers, 
+		bool bResume = false);
+
+	/**
+	* Starts the provided dialogue as an ambient conversation at the given 
+	* dialogue node ID with speaker components already bound to the 
+	* dialogue's speaker slots. See StartDialogueInSlots().
+	*
+	* @param InDialogue - UDialogue*, the dialogue to start.
+	* @param NodeID - FName, the node to start from.
+	* @param InSlots - TConstArrayView<UDialogueSpeakerComponent*>, Speaker
+	* Components in the slot order of the dialogue's compiled roles.
+	* @return int32 - handle of the ambient dialogue. INDEX_NONE if it could
+	* not be started or ended immediately.
+	*/
+	int32 StartAmbientDialogueInSlots(UDialogue* InDialogue, FName NodeID,
+		TConstArrayView<UDialogueSpeakerComponent*> InSlots);
+
+	/**
+	* Ends the ambient dialogue with the given handle. Does nothing if it
+	* already ended.
+	*
+	* @param Handle - int32, the handle returned on starting the dialogue.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void EndAmbientDialogue(int32 Handle);
+
+	/**
+	* Gets the number of ambient dialogues currently playing.
+	*
+	* @return int32 - the number of ambient dialogues.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	int32 GetNumAmbientDialogues() const;
+
+	/**
+	* Gets how much of the given ambient dialogue is presented. 
+	*
+	* @param Handle - int32, the handle returned on starting the dialogue.
+	* @return EDialogueFidelity - the fidelity. State only if the dialogue
+	* is not playing.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	EDialogueFidelity GetAmbientDialogueFidelity(int32 Handle) const;
+
+	/**
+	* Sets how fast the current dialogue's play times run relative to the
+	* world's dialogue clock. 0 holds it on its current speech.
+	*
+	* @param InTimeScale - float, the time scale.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SetDialogueTimeScale(float InTimeScale);
+
+	/**
+	* Sets how fast an ambient dialogue's play times run relative to the 
+	* world's dialogue clock. 0 holds it on its current speech.
+	*
+	* @param Handle - int32, the handle returned on starting the dialogue.
+	* @param InTimeScale - float, the time scale.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SetAmbientDialogueTimeScale(int32 Handle, float InTimeScale);
+
+	/**
+	* Decides how much of an ambient dialogue to present. Called when the 
+	* dialogue starts and then periodically while it plays. By default 
+	* picks by distance using the thresholds in the project settings. 
+	* Override to fold in significance, line of sight and the like.
+	*
+	* @param Handle - int32, the handle of the ambient dialogue.
+	* @param DistanceToViewer - float, distance from the player's view to 
+	* the dialogue's nearest speaker. 0 if there is no local player.
+	* @return EDialogueFidelity - the fidelity to play at.
+	*/
+	UFUNCTION(BlueprintNativeEvent, Category = "Dialogue")
+	EDialogueFidelity EvaluateAmbientFidelity(int32 Handle, 
+		float DistanceToViewer) const;
+	virtual EDialogueFidelity EvaluateAmbientFidelity_Implementation(
+		int32 Handle, float DistanceToViewer) const;
+
+	/**
+	* Ends the given instance, whether it is the current dialogue or an 
+	* ambient one. Called from the instance itself.
+	*
+	* @param InInstance - FDialogueInstance&, the instance to end.
+	*/
+	void EndDialogueInstance(FDialogueInstance& InInstance);
+
 	/**
 	* Tells the dialogue we want to skip the current speech, if
 	* possible. BlueprintCallable.
@@ -175,9 +407,70 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void SetSpeaker(FName InName, UDialogueSpeakerComponent* InSpeaker);
 
+	/**
+	* Retrieves the speaker component playing the given role in the current
+	* dialogue. BlueprintCallable.
+	*
+	* @param InName - FName, the role.
+	* @return UDialogueSpeakerComponent* - the speaker. Nullptr if none, or
+	* if no dialogue is playing.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	UDialogueSpeakerComponent* GetSpeaker(FName InName) const;
+
+	/**
+	* Retrieves the handle of the current dialogue. BlueprintPure.
+	*
+	* @return int32 - the handle. INDEX_NONE if no dialogue is playing.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	int32 GetCurrentDialogueHandle() const;
+
+	/**
+	* Sets the speaker component playing the given role in the dialogue 
+	* with the given handle, whether current or ambient. Does nothing if no
+	* such dialogue is playing. BlueprintCallable.
+	*
+	* @param Handle - int32, the dialogue's handle. See 
+	* GetCurrentDialogueHandle(), StartAmbientDialogue() and 
+	* UDialogue::GetExecutingHandle().
+	* @param InName - FName, the role.
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SetSpeakerInDialogue(int32 Handle, FName InName, 
+		UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Retrieves the speaker component playing the given role in the 
+	* dialogue with the given handle, whether current or ambient. 
+	* BlueprintCallable.
+	*
+	* @param Handle - int32, the dialogue's handle.
+	* @param InName - FName, the role.
+	* @return UDialogueSpeakerComponent* - the speaker. Nullptr if none, or
+	* if no such dialogue is playing.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	UDialogueSpeakerComponent* GetSpeakerInDialogue(int32 Handle, 
+		FName InName) const;
+
+	/**
+	* Retrieves the map of roles to speaker components of the dialogue with
+	* the given handle, whether current or ambient. BlueprintCallable.
+	*
+	* @param Handle - int32, the dialogue's handle.
+	* @return TMap<FName, UDialogueSpeakerComponent*> - the speakers. Empty
+	* if no such dialogue is playing.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	TMap<FName, UDialogueSpeakerComponent*> GetSpeakersInDialogue(
+		int32 Handle) const;
+
 	/**
 	* Exports a dialogue records struct containing the node visits for
-	* all dialogues in the game. Useful for saving.
+	* all dialogues in the game. Copies every record; prefer the record
+	* accessors below for lookups and SaveDialogueRecordsToBytes for saving.
 	*
 	* @return FDialogueMemory - record of all node visits in the game.
 	*/
@@ -185,7 +478,7 @@ public:
 	FDialogueRecords GetDialogueRecords() const;
 
 	/**
-	* Clears node visitation info from all dialogues.
+	* Clears node visitation info from all dialogues, and the blackboard.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void ClearDialogueRecords();
@@ -197,7 +490,235 @@ public:
 	* @param InRecords - const FDialogueRecords&, the records to load.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
-	void ImportDialogueRecords(FDialogueRecords InRecords);
+	void ImportDialogueRecords(const FDialogueRecords& InRecords);
+
+	/**
+	* Writes the dialogue records to a compact binary blob. With 
+	* bOnlyChanged, only dialogues touched since the last save or load are 
+	* written, along with the blackboard if it changed, and the blob must 
+	* be loaded over the blob it follows. Marks the records clean.
+	*
+	* @param bOnlyChanged - bool, whether to only write changed records.
+	* @param OutBytes - TArray<uint8>&, the blob.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SaveDialogueRecordsToBytes(bool bOnlyChanged, 
+		TArray<uint8>& OutBytes);
+
+	/**
+	* Reads dialogue records from a blob written by 
+	* SaveDialogueRecordsToBytes. A full blob replaces the records; a blob 
+	* of only changed records is merged over them. 
+	*
+	* @param InBytes - const TArray<uint8>&, the blob.
+	* @return bool - True if the blob was read. False if it was malformed
+	* or written by a newer version, leaving the records untouched.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool LoadDialogueRecordsFromBytes(const TArray<uint8>& InBytes);
+
+	/**
+	* Saves the dialogue records to a save slot on a worker thread. Changes
+	* made since the last save are handed off as a journal, so the records
+	* are never copied or serialized on the game thread. The first save 
+	* copies the records once to start the journal. 
+	*
+	* @param InSlotName - const FString&, the save slot.
+	* @param InUserIndex - int32, the platform user index.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SaveDialogueRecordsAsync(const FString& InSlotName, 
+		int32 InUserIndex);
+
+	/**
+	* Loads dialogue records saved by SaveDialogueRecordsAsync, waiting for
+	* any save still running first.
+	*
+	* @param InSlotName - const FString&, the save slot.
+	* @param InUserIndex - int32, the platform user index.
+	* @return bool - True if the records were loaded. False otherwise.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool LoadDialogueRecordsFromSlot(const FString& InSlotName, 
+		int32 InUserIndex);
+
+	/**
+	* Blocks until every dialogue records save handed off so far is written.
+	*/
+	void WaitForDialogueSaves() const;
+
+	/**
+	* Checks if there is a record of the given dialogue, without copying 
+	* the records. BlueprintPure.
+	*
+	* @param InDialogue - UDialogue*, the target dialogue.
+	* @return bool - True if the dialogue has a record. False otherwise.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	bool HasDialogueRecord(UDialogue* InDialogue) const;
+
+	/**
+	* Checks if the node with the given ID was visited, without copying
+	* the records. BlueprintPure.
+	*
+	* @param InDialogue - UDialogue*, the target dialogue.
+	* @param InNodeID - FName, the ID of the target node.
+	* @return bool - True if the node was visited. False otherwise.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	bool WasNodeVisitedByID(UDialogue* InDialogue, FName InNodeID) const;
+
+	/**
+	* Gets the ID of the node the given dialogue would resume from, 
+	* without copying the records. BlueprintPure.
+	*
+	* @param InDialogue - UDialogue*, the target dialogue.
+	* @return FName - the resume node's ID. None if there is none.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	FName GetResumeNodeID(UDialogue* InDialogue) const;
+
+	/**
+	* Sets a bool key on the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @param bInValue - bool, the value.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue|Blackboard")
+	void SetBlackboardBool(FName InKey, bool bInValue);
+
+	/**
+	* Sets an int key on the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @param InValue - int32, the value.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue|Blackboard")
+	void SetBlackboardInt(FName InKey, int32 InValue);
+
+	/**
+	* Sets a float key on the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @param InValue - float, the value.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue|Blackboard")
+	void SetBlackboardFloat(FName InKey, float InValue);
+
+	/**
+	* Sets a name key on the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @param InValue - FName, the value.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue|Blackboard")
+	void SetBlackboardName(FName InKey, FName InValue);
+
+	/**
+	* Sets a tag key on the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @param InValue - FGameplayTag, the value.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue|Blackboard")
+	void SetBlackboardTag(FName InKey, FGameplayTag InValue);
+
+	/**
+	* Gets a bool key from the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @return bool - the value. False if the key was never set.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue|Blackboard")
+	bool GetBlackboardBool(FName InKey) const;
+
+	/**
+	* Gets an int key from the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @return int32 - the value. 0 if the key was never set.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue|Blackboard")
+	int32 GetBlackboardInt(FName InKey) const;
+
+	/**
+	* Gets a float key from the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @return float - the value. 0 if the key was never set.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue|Blackboard")
+	float GetBlackboardFloat(FName InKey) const;
+
+	/**
+	* Gets a name key from the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @return FName - the value. None if the key was never set.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue|Blackboard")
+	FName GetBlackboardName(FName InKey) const;
+
+	/**
+	* Gets a tag key from the dialogue blackboard.
+	*
+	* @param InKey - FName, the key.
+	* @return FGameplayTag - the value. Empty if the key was never set.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue|Blackboard")
+	FGameplayTag GetBlackboardTag(FName InKey) const;
+
+	/**
+	* Retrieves the dialogue blackboard.
+	*
+	* @return FDialogueBlackboard& - the blackboard.
+	*/
+	FDialogueBlackboard& GetBlackboard();
+
+	/**
+	* Gets the blackboard's generation, which changes whenever its keys may
+	* have moved to other slots. Slots resolved under an older generation 
+	* have to be resolved again.
+	*
+	* @return uint32 - the generation.
+	*/
+	uint32 GetBlackboardGeneration() const;
+
+	/**
+	* Finds the blackboard slot of the given key, adding the key if needed.
+	*
+	* @param InKey - FName, the key.
+	* @param InType - EDialogueBlackboardType, the type of the key if added.
+	* @return int32 - the slot. INDEX_NONE if the key is None.
+	*/
+	int32 FindOrAddBlackboardSlot(FName InKey, 
+		EDialogueBlackboardType InType);
+
+	/**
+	* Writes a value to the given blackboard slot.
+	*
+	* @param InSlot - int32, the slot.
+	* @param InValue - const FDialogueBlackboardValue&, the value.
+	*/
+	void WriteBlackboardSlot(int32 InSlot, 
+		const FDialogueBlackboardValue& InValue);
+
+	/**
+	* Notes that state dialogue queries may read has changed, so query 
+	* results cached before now are evaluated again. Visits, blackboard 
+	* writes and speaker tag changes already call this; call it whenever 
+	* game state read by cached blueprint queries changes.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void NotifyDialogueStateChanged();
+
+	/**
+	* Gets the state epoch, which changes whenever state dialogue queries
+	* may read has changed.
+	*
+	* @return uint32 - the epoch.
+	*/
+	uint32 GetDialogueStateEpoch() const;
 
 	/**
 	* Checks if the specified speaker is a participant in the current dialogue.
@@ -213,17 +734,17 @@ public:
 	* Marks the given node visited in the controller's memory.
 	*
 	* @param TargetDialogue, UDialogue*
-	* @param TargetNodeID, FName
+	* @param NodeIndex, int32 - the node's index in the dialogue's program.
 	*/
-	void MarkNodeVisited(UDialogue* TargetDialogue, FName TargetNodeID);
+	void MarkNodeVisited(UDialogue* TargetDialogue, int32 NodeIndex);
 
 	/**
 	* Marks the given node unvisited in the controller's memory.
 	*
 	* @param TargetDialogue, UDialogue*
-	* @param TargetNodeID, FName
+	* @param NodeIndex, int32 - the node's index in the dialogue's program.
 	*/
-	void MarkNodeUnvisited(UDialogue* TargetDialogue, FName TargetNodeID);
+	void MarkNodeUnvisited(UDialogue* TargetDialogue, int32 NodeIndex);
 
 	/**
 	* Clears all node visits for the given dialogue.
@@ -236,11 +757,11 @@ public:
 	* Checks if the given node has already been visited.
 	*
 	* @param TargetDialogue, UDialogue*
-	* @param TargetNodeID, FName
+	* @param NodeIndex, int32 - the node's index in the dialogue's program.
 	* @return bool - True if the node was visited, False otherwise.
 	*/
 	bool WasNodeVisited(const UDialogue* TargetDialogue,
-		FName TargetNodeID) const;
+		int32 NodeIndex) const;
 
 	/**
 	* Sets the resume node for the target dialogue to the target node. Called
@@ -251,6 +772,134 @@ public:
 	*/
 	void SetResumeNode(UDialogue* InDialogue, FName InNodeID);
 
+	/**
+	* Retrieves the node the given dialogue should start from. 
+	*
+	* @param InDialogue - UDialogue*, the dialogue to start.
+	* @param bResume - bool, whether to start from the marked resume node. 
+	* @return FName - the ID of the node to start from. 
+	*/
+	FName GetStartNodeID(UDialogue* InDialogue, bool bResume) const;
+
+	/**
+	* Binds the given speakers to the dialogue's speaker slots using their 
+	* dialogue names. Logs an error if any speaker is invalid, unnamed or 
+	* shares its name with another. Speakers without a role in the dialogue
+	* are left out. 
+	*
+	* @param InDialogue - const UDialogue*, the dialogue to bind for.
+	* @param InSpeakers - TConstArrayView<UDialogueSpeakerComponent*>, the 
+	* speakers. 
+	* @param OutSlots - FDialogueSpeakerSlots&, the speakers by slot. 
+	* @return bool - True if all speakers could be bound. False otherwise.
+	*/
+	bool BindSpeakerSlots(const UDialogue* InDialogue,
+		TConstArrayView<UDialogueSpeakerComponent*> InSpeakers,
+		FDialogueSpeakerSlots& OutSlots) const;
+
+private:
+	/**
+	* Binds the given speakers to the dialogue's speaker slots using the 
+	* names they are mapped to. Names without a role in the dialogue and 
+	* null speakers are left out. 
+	*
+	* @param InDialogue - const UDialogue*, the dialogue to bind for.
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
+	* the speakers mapped to their names.
+	* @param OutSlots - FDialogueSpeakerSlots&, the speakers by slot. 
+	*/
+	void BindNamedSpeakerSlots(const UDialogue* InDialogue,
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers,
+		FDialogueSpeakerSlots& OutSlots) const;
+
+	/**
+	* Retrieves the record for the given dialogue, creating it if needed. 
+	* Any visits stored by older saves are migrated first. 
+	*
+	* @param InDialogue - const UDialogue*, the target dialogue.
+	* @return FDialogueNodeVisits& - the dialogue's record.
+	*/
+	FDialogueNodeVisits& FindOrAddRecord(const UDialogue* InDialogue);
+
+	/**
+	* Retrieves the record for the given dialogue, if any. Records of older
+	* saves are found by the dialogue's name. 
+	*
+	* @param InDialogue - const UDialogue*, the target dialogue.
+	* @return const FDialogueNodeVisits* - the dialogue's record. Nullptr 
+	* if there is none.
+	*/
+	const FDialogueNodeVisits* FindRecord(const UDialogue* InDialogue) const;
+
+	/**
+	* Marks the given dialogue's record changed since the last save.
+	*
+	* @param InDialogue - const UDialogue*, the target dialogue.
+	*/
+	void MarkRecordDirty(const UDialogue* InDialogue);
+
+	/**
+	* Marks every record and the blackboard as saved.
+	*/
+	void ClearDirtyRecords();
+
+	/**
+	* Records the given blackboard slot's current value in the journal.
+	*
+	* @param InSlot - int32, the slot.
+	*/
+	void JournalBlackboardSlot(int32 InSlot);
+
+	/**
+	* Finds the ambient dialogue with the given handle.
+	*
+	* @param Handle - int32, the handle of the ambient dialogue.
+	* @return FDialogueInstance* - the instance. Null if not playing.
+	*/
+	FDialogueInstance* FindAmbientInstance(int32 Handle) const;
+
+	/**
+	* Finds the current or ambient dialogue with the given handle.
+	*
+	* @param Handle - int32, the handle of the dialogue.
+	* @return FDialogueInstance* - the instance. Null if not playing.
+	*/
+	FDialogueInstance* FindInstance(int32 Handle) const;
+
+	/**
+	* Cancels the dialogue load of a pending async restore, if any.
+	*/
+	void CancelPendingRestore();
+
+	/**
+	* Re-evaluates the fidelity of every ambient dialogue. Stops the 
+	* periodic update once none are left.
+	*/
+	void UpdateAmbientFidelity();
+
+	/**
+	* Evaluates the fidelity an ambient dialogue should play at given its
+	* speakers.
+	*
+	* @param Handle - int32, the handle of the ambient dialogue.
+	* @param InSpeakers - const SpeakerRangeType&, the dialogue's speakers.
+	* @return EDialogueFidelity - the fidelity to play at.
+	*/
+	template<typename SpeakerRangeType>
+	EDialogueFidelity EvaluateAmbientFidelityFor(int32 Handle,
+		const SpeakerRangeType& InSpeakers) const;
+
+	/**
+	* Creates an instance of the given dialogue, ready to be opened. 
+	*
+	* @param InDialogue - UDialogue*, the dialogue to play.
+	* @param bUsesDisplay - bool, whether the instance drives the display.
+	* @return TSharedPtr<FDialogueInstance> - the new instance. Null if the
+	* dialogue cannot play.
+	*/
+	TSharedPtr<FDialogueInstance> CreateInstance(UDialogue* InDialogue,
+		bool bUsesDisplay);
+
 public:
 	/**
 	* Opens the user-defined dialogue display.
@@ -291,6 +940,23 @@ public:
 	UFUNCTION(BlueprintImplementableEvent)
 	void DisplayOptions(const TArray<FSpeechDetails>& InOptions);
 
+	/**
+	* Displays a speech from an ambient dialogue, such as a subtitle or a
+	* bubble over the speaker. Not called for ambient dialogues playing 
+	* state only. BlueprintImplementable.
+	*
+	* @param Handle - int32, the handle of the ambient dialogue.
+	* @param InSpeechDetails - FSpeechDetails, struct defining
+	* speech details
+	* @param InSpeaker - UDialogueSpeakerComponent*, speaker
+	* component associated with the target speech.
+	* @param InFidelity - EDialogueFidelity, the fidelity the dialogue is
+	* playing at. Text only speeches play no audio.
+	*/
+	UFUNCTION(BlueprintImplementableEvent)
+	void DisplayAmbientSpeech(int32 Handle, FSpeechDetails InSpeechDetails,
+		UDialogueSpeakerComponent* InSpeaker, EDialogueFidelity InFidelity);
+
 	/**
 	* Checks if we can open the user-defined dialogue display.
 	* BlueprintImplementable.
@@ -314,9 +980,51 @@ protected:
 	TObjectPtr<UDialogue> CurrentDialogue = nullptr;
 
 private:
-	/** Controller's memory of visited nodes */
+	/**
+	* Writes a key to the dialogue blackboard, adding it if needed.
+	*
+	* @param InKey - FName, the key.
+	* @param InType - EDialogueBlackboardType, the type of the key.
+	* @param InValue - const FDialogueBlackboardValue&, the value.
+	*/
+	void WriteBlackboard(FName InKey, EDialogueBlackboardType InType,
+		const FDialogueBlackboardValue& InValue);
+
+private:
+	/** Controller's memory of visited nodes and blackboard */
 	FDialogueRecords DialogueRecords;
 
+	/** Changes whenever the blackboard is cleared or replaced */
+	uint32 BlackboardGeneration = 1;
+
+	/** Keys of the records changed since the last save */
+	TSet<uint64> DirtyRecordKeys;
+
+	/** Whether the records were replaced wholesale since the last save */
+	bool bAllRecordsDirty = false;
+
+	/** Changes not yet handed to a background save. Started by the first
+	* save. */
+	TSharedPtr<FDialogueRecordsJournal> Journal;
+
+	/** Changes whenever state dialogue queries may read has changed */
+	uint32 DialogueStateEpoch = 1;
+
+	/** Runtime state of the current dialogue */
+	TSharedPtr<FDialogueInstance> CurrentInstance;
+
+	/** Load of the dialogue asset a pending async restore waits on */
+	TSharedPtr<FStreamableHandle> RestoreLoadHandle;
+
+	/** Runtime state of each playing ambient dialogue */
+	TArray<TSharedPtr<FDialogueInstance>> AmbientInstances;
+
+	/** The handle to give the next started instance */
+	int32 NextInstanceHandle = 0;
+
+	/** Timer re-evaluating the fidelity of ambient dialogues */
+	FTimerHandle AmbientFidelityHandle;
+
 public:
 	/** Delegate event call for when a new dialogue is started.*/
 	UPROPERTY(BlueprintAssignable, Category = "Dialogue")
@@ -329,4 +1037,8 @@ public:
 	/** Delegate event call for when a speech plays.*/
 	UPROPERTY(BlueprintAssignable, Category = "Dialogue")
 	FDialogueControllerSpeechDelegate OnDialogueSpeechDisplayed;
+
+	/** Delegate event call for when an ambient dialogue ends.*/
+	UPROPERTY(BlueprintAssignable, Category = "Dialogue")
+	FDialogueControllerHandleDelegate OnAmbientDialogueEnded;
 };
@@ -0,0 +1,26 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Generated
+#include "DialogueFidelity.generated.h"
+
+/**
+* Enum defining how much of a playing dialogue is presented. Every level
+* advances the dialogue the same way, so visits are recorded and events
+* fire regardless. Used to thin out ambient dialogues far from the player.
+*/
+UENUM(BlueprintType)
+enum class EDialogueFidelity : uint8
+{
+	/** Speeches play their audio and are displayed */
+	Full,
+
+	/** Speeches are displayed as text but play no audio */
+	TextOnly,
+
+	/** Nothing is presented. Speeches last their minimum play time. */
+	StateOnly
+};
@@ -0,0 +1,608 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "DialogueAudioPrefetcher.h"
+#include "DialogueFidelity.h"
+#include "DialogueInstanceSnapshot.h"
+#include "DialogueOption.h"
+#include "DialogueScheduler.h"
+#include "SpeechDetails.h"
+
+class ADialogueController;
+class UDialogue;
+class UDialogueNode;
+class UDialogueSpeakerComponent;
+class UDialogueTransition;
+struct FDialogueBlackboardValue;
+struct FDialogueProgram;
+
+/**
+* Speaker components in the slot order of a dialogue's compiled speaker 
+* roles. Sized for the usual handful of roles so binding needs no heap.
+*/
+using FDialogueSpeakerSlots = 
+	TArray<UDialogueSpeakerComponent*, TInlineAllocator<8>>;
+
+/**
+* Per-conversation state used by speech transitions. Transitions are shared
+* by every conversation playing their dialogue, so anything they need to
+* remember lives here instead.
+*/
+struct FDialogueTransitionState
+{
+	/** Whether the min play time has elapsed yet */
+	bool bMinPlayTimeElapsed = false;
+
+	/** Whether the audio content has finished playing yet */
+	bool bAudioFinished = false;
+
+	/** Wake-up that tracks minimum play time */
+	FDialogueWakeHandle MinPlayTimeWake;
+
+	/** Minimum play time left, held while the instance's time scale is 0 */
+	double HeldMinPlayTime = 0.0;
+
+	/** The available options for the player to choose */
+	TArray<FResolvedDialogueOption> Options;
+};
+
+/**
+* A single playing conversation of a dialogue asset. Holds everything that
+* changes while the dialogue plays: the active node, the speaker bindings,
+* the traversal loop and the transition state. The dialogue asset itself is
+* left untouched, so any number of instances can play it at once.
+* Owned by the dialogue controller that started it.
+*/
+class DIALOGUETREERUNTIME_API FDialogueInstance
+	: public TSharedFromThis<FDialogueInstance>
+{
+public:
+	/**
+	* Marks an instance as the one currently executing. Dialogue objects are
+	* shared between instances, so calls made on them while the scope is
+	* open are routed to this instance's state.
+	*/
+	class DIALOGUETREERUNTIME_API FScope
+	{
+	public:
+		explicit FScope(FDialogueInstance& InInstance);
+		~FScope();
+
+	private:
+		/** The instance that was executing before the scope opened */
+		FDialogueInstance* Previous;
+	};
+
+public:
+	FDialogueInstance(int32 InHandle, UDialogue* InDialogue,
+		ADialogueController* InController, bool bInUsesDisplay);
+	~FDialogueInstance();
+
+	/**
+	* Retrieves the instance currently executing on the game thread, if any.
+	*
+	* @return FDialogueInstance* - the executing instance. Nullptr if none.
+	*/
+	static FDialogueInstance* GetExecuting();
+
+	/**
+	* Retrieves the handle the controller knows the instance by.
+	*
+	* @return int32 - the handle.
+	*/
+	int32 GetHandle() const;
+
+	/**
+	* Retrieves the dialogue being played.
+	*
+	* @return UDialogue* - the dialogue.
+	*/
+	UDialogue* GetDialogue() const;
+
+	/**
+	* Retrieves the controller that owns the instance.
+	*
+	* @return ADialogueController* - the controller.
+	*/
+	ADialogueController* GetController() const;
+
+	/**
+	* Checks if the instance drives the controller's display. Instances that
+	* do not are played out by the speakers alone.
+	*
+	* @return bool - True if speeches and options are displayed.
+	*/
+	bool UsesDisplay() const;
+
+	/**
+	* Sets how much of the dialogue is presented. Takes effect on the spot
+	* without restarting the active speech: dropping below full fidelity 
+	* cuts off its audio, and rising from state only displays it.
+	*
+	* @param InFidelity - EDialogueFidelity, the new fidelity.
+	*/
+	void SetFidelity(EDialogueFidelity InFidelity);
+
+	/**
+	* Retrieves how much of the dialogue is presented.
+	*
+	* @return EDialogueFidelity - the fidelity.
+	*/
+	EDialogueFidelity GetFidelity() const;
+
+	/**
+	* Checks if speeches play their audio.
+	*
+	* @return bool - True at full fidelity.
+	*/
+	bool PlaysAudio() const;
+
+	/**
+	* Checks if speeches are displayed, either through the controller's
+	* display or as ambient speech.
+	*
+	* @return bool - True unless the fidelity is state only.
+	*/
+	bool ShowsText() const;
+
+	/**
+	* Checks if the instance is still playing.
+	*
+	* @return bool - True until the instance is closed.
+	*/
+	bool IsActive() const;
+
+	/**
+	* Starts playing at the given node.
+	*
+	* @param StartIndex - int32, index of the node to start at.
+	* @param InSpeakers - TConstArrayView<UDialogueSpeakerComponent*>,
+	* components to bind, in the slot order of the compiled speaker roles.
+	*/
+	void Open(int32 StartIndex,
+		TConstArrayView<UDialogueSpeakerComponent*> InSpeakers);
+
+	/**
+	* Starts playing from a snapshot of another instance, resting on the 
+	* snapshot's node with its transition state, options and blocking 
+	* events as they were. Nothing before the node is traversed again.
+	*
+	* @param InSnapshot - const FDialogueInstanceSnapshot&, the snapshot.
+	* @param InSpeakers - TConstArrayView<UDialogueSpeakerComponent*>,
+	* components to bind, in the slot order of the compiled speaker roles.
+	* @return bool - True if the instance is playing. False if the node no
+	* longer exists or the instance ended while restoring.
+	*/
+	bool Restore(const FDialogueInstanceSnapshot& InSnapshot,
+		TConstArrayView<UDialogueSpeakerComponent*> InSpeakers);
+
+	/**
+	* Takes a snapshot of the instance's live state. Only possible while the
+	* instance rests on a node, not while it is traversing.
+	*
+	* @param OutSnapshot - FDialogueInstanceSnapshot&, the snapshot.
+	* @return bool - True if a snapshot was taken. False otherwise.
+	*/
+	bool TakeSnapshot(FDialogueInstanceSnapshot& OutSnapshot) const;
+
+	/**
+	* Finds the node a snapshot rests on in the given program, by stable ID
+	* and then by node ID. Static.
+	*
+	* @param InProgram - const FDialogueProgram&, the program.
+	* @param InSnapshot - const FDialogueInstanceSnapshot&, the snapshot.
+	* @return int32 - the node's index. INDEX_NONE if it is not a speech or
+	* event of the program.
+	*/
+	static int32 FindSnapshotNode(const FDialogueProgram& InProgram,
+		const FDialogueInstanceSnapshot& InSnapshot);
+
+	/**
+	* Asks the owning controller to end the instance.
+	*/
+	void End();
+
+	/**
+	* Stops the instance's speakers and timers and marks it inactive. Called
+	* by the controller when ending the instance.
+	*/
+	void Close();
+
+	/**
+	* Attempts to traverse the node at the given index of the compiled
+	* program. Logic nodes are passed through in a loop until a content node
+	* is reached. Nodes traversed while the loop is already running are
+	* picked up by the loop instead of recursing. Ends the instance if
+	* anything goes wrong.
+	*
+	* @param NodeIndex - int32, index of the node to traverse.
+	*/
+	void TraverseNodeAt(int32 NodeIndex);
+
+	/**
+	* Attempts to select a dialogue option at the given index.
+	*
+	* @param InOptionIndex - int32, index of the selection.
+	*/
+	void SelectOption(int32 InOptionIndex);
+
+	/**
+	* Attempts to skip through the active node, if and to the extent
+	* allowable by the node itself.
+	*/
+	void Skip();
+
+	/**
+	* Retrieves the node the instance is currently resting on.
+	*
+	* @return UDialogueNode* - the active node. Nullptr if none.
+	*/
+	UDialogueNode* GetActiveNode() const;
+
+	/**
+	* Retrieves the speaker voicing the speech the instance is resting on.
+	*
+	* @return UDialogueSpeakerComponent* - the speaker. Nullptr if the 
+	* instance is not resting on a speech.
+	*/
+	UDialogueSpeakerComponent* GetActiveSpeaker() const;
+
+	/**
+	* Displays the given speech, if the instance uses the display. Ambient
+	* instances hand it to the controller as ambient speech instead, unless
+	* the fidelity is state only.
+	*
+	* @param InDetails - const FSpeechDetails&, details for the speech.
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker voicing
+	* the speech. Ends the instance if null.
+	*/
+	void DisplaySpeech(const FSpeechDetails& InDetails,
+		UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Displays the given options, if the instance uses the display.
+	*
+	* @param InOptions - const TArray<FResolvedDialogueOption>&, options to
+	* display.
+	*/
+	void DisplayOptions(const TArray<FResolvedDialogueOption>& InOptions);
+
+	/**
+	* Sets the component for the given speaker role.
+	*
+	* @param InName - FName, the speaker role.
+	* @param InSpeaker - UDialogueSpeakerComponent*, the component.
+	*/
+	void SetSpeaker(FName InName, UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Retrieves the component for the given speaker role.
+	*
+	* @param InName - FName, the speaker role.
+	* @return UDialogueSpeakerComponent* - the component. Nullptr if none.
+	*/
+	UDialogueSpeakerComponent* GetSpeaker(FName InName) const;
+
+	/**
+	* Sets the component for the given speaker slot.
+	*
+	* @param InSlot - int32, the slot of the speaker role.
+	* @param InSpeaker - UDialogueSpeakerComponent*, the component.
+	*/
+	void SetSpeakerAt(int32 InSlot, UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Retrieves the component for the given speaker slot.
+	*
+	* @param InSlot - int32, the slot of the speaker role.
+	* @return UDialogueSpeakerComponent* - the component. Nullptr if none.
+	*/
+	UDialogueSpeakerComponent* GetSpeakerAt(int32 InSlot) const;
+
+	/**
+	* Retrieves the speaker components, indexed by speaker slot.
+	*
+	* @return const TArray<TObjectPtr<UDialogueSpeakerComponent>>& - the 
+	* speakers. Empty slots are null.
+	*/
+	const TArray<TObjectPtr<UDialogueSpeakerComponent>>& GetSpeakers() 
+		const;
+
+	/**
+	* Checks if the given component takes part in the instance.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the component.
+	* @return bool - True if the component fills one of the roles.
+	*/
+	bool HasSpeaker(const UDialogueSpeakerComponent* InSpeaker) const;
+
+	/**
+	* Reads a blackboard key of the dialogue's program from the controller's
+	* blackboard. The key's slot is looked up on first use and cached.
+	*
+	* @param InKeyIndex - int32, the key's index in the program.
+	* @return const FDialogueBlackboardValue& - the value. A default value
+	* if the key is invalid.
+	*/
+	const FDialogueBlackboardValue& ReadBlackboard(int32 InKeyIndex);
+
+	/**
+	* Writes a blackboard key of the dialogue's program to the controller's
+	* blackboard.
+	*
+	* @param InKeyIndex - int32, the key's index in the program.
+	* @param InValue - const FDialogueBlackboardValue&, the value.
+	*/
+	void WriteBlackboard(int32 InKeyIndex, 
+		const FDialogueBlackboardValue& InValue);
+
+	/**
+	* Retrieves the cached result of a cacheable query of the dialogue's
+	* program. Results only hold for the frame they were stored in, and 
+	* only until the controller's state changes or a speaker is rebound.
+	*
+	* @param InQueryIndex - int32, the query's index in the program.
+	* @param OutValue - double&, the cached result, if any.
+	* @return bool - True if a result was cached. False otherwise.
+	*/
+	bool FindQueryResult(int32 InQueryIndex, double& OutValue);
+
+	/**
+	* Caches the result of a cacheable query of the dialogue's program.
+	*
+	* @param InQueryIndex - int32, the query's index in the program.
+	* @param InValue - double, the result.
+	*/
+	void StoreQueryResult(int32 InQueryIndex, double InValue);
+
+	/**
+	* Drops every cached query result.
+	*/
+	void InvalidateQueryResults();
+
+	/**
+	* Retrieves the state of the active speech's transition.
+	*
+	* @return FDialogueTransitionState& - the transition state.
+	*/
+	FDialogueTransitionState& GetTransitionState();
+
+	/**
+	* Schedules the active speech's minimum play time with the world's
+	* dialogue scheduler, scaled by the instance's time scale.
+	*
+	* @param InSeconds - float, the minimum play time.
+	*/
+	void StartMinPlayTimer(float InSeconds);
+
+	/**
+	* Stops the minimum play time timer, if running.
+	*/
+	void StopMinPlayTimer();
+
+	/**
+	* Sets how fast the instance's minimum play times run relative to the 
+	* dialogue clock. A running timer keeps the progress it made. 0 holds
+	* the instance on its current speech.
+	*
+	* @param InTimeScale - float, the time scale. Clamped to 0 or more.
+	*/
+	void SetTimeScale(float InTimeScale);
+
+	/**
+	* Gets how fast the instance's minimum play times run.
+	*
+	* @return float - the time scale.
+	*/
+	float GetTimeScale() const;
+
+	/**
+	* Has the world's dialogue scheduler watch for the given speaker to 
+	* finish playing the active speech.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the playing speaker.
+	*/
+	void WaitForSpeechAudio(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Stops listening for the active speech's audio to finish.
+	*/
+	void StopWaitingForSpeechAudio();
+
+	/**
+	* Streams in the given audio for the active speech and has the speaker
+	* play it once loaded, if the speech is still playing by then. Used when
+	* the line was not prefetched in time.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	* @param InAudio - const TSoftObjectPtr<USoundBase>&, the audio.
+	*/
+	void PlaySpeechAudioWhenLoaded(UDialogueSpeakerComponent* InSpeaker,
+		const TSoftObjectPtr<USoundBase>& InAudio);
+
+	/**
+	* Checks if the active speech's audio is still being streamed in.
+	*
+	* @return bool - True if the speaker has yet to start the audio.
+	*/
+	bool IsLoadingSpeechAudio() const;
+
+	/**
+	* Called when the audio the instance is waiting on finishes.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void OnSpeechAudioFinished(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Reports the instance's object references to the garbage collector.
+	*
+	* @param Collector - FReferenceCollector&, the collector.
+	*/
+	void AddReferencedObjects(FReferenceCollector& Collector);
+
+private:
+	/**
+	* Resolves a blackboard key of the dialogue's program to its slot on the
+	* controller's blackboard, adding the key if needed.
+	*
+	* @param InKeyIndex - int32, the key's index in the program.
+	* @return int32 - the slot. INDEX_NONE if the key is invalid.
+	*/
+	int32 ResolveBlackboardSlot(int32 InKeyIndex);
+
+	/**
+	* Drops cached query results if the frame or the controller's state 
+	* changed since they were stored.
+	*/
+	void RefreshQueryResults();
+
+	/**
+	* Refreshes the speakers, plugging in the provided components.
+	*
+	* @param InSpeakers - TConstArrayView<UDialogueSpeakerComponent*>,
+	* the speaker components to enter, in speaker slot order.
+	*/
+	void FillSpeakers(TConstArrayView<UDialogueSpeakerComponent*> InSpeakers);
+
+	/**
+	* Clears any timers and listeners left by the previous speech.
+	*/
+	void ResetTransitionState();
+
+	/**
+	* Called when the minimum play time timer fires.
+	*/
+	void OnMinPlayTimeElapsed();
+
+	/**
+	* Checks if the audio the instance is waiting on has stopped playing.
+	*
+	* @return bool - True once the speaker is silent and no audio is still
+	* streaming in for it.
+	*/
+	bool IsSpeechAudioDone() const;
+
+	/**
+	* Called when audio requested by PlaySpeechAudioWhenLoaded() finishes
+	* loading.
+	*
+	* @param InRequest - int32, the request the load was made for.
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	* @param InAudio - USoundBase*, the loaded audio. Nullptr if the load
+	* failed.
+	*/
+	void OnSpeechAudioLoaded(int32 InRequest,
+		UDialogueSpeakerComponent* InSpeaker, USoundBase* InAudio);
+
+	/**
+	* Retrieves the transition of the active node, if it is a speech.
+	*
+	* @return UDialogueTransition* - the transition. Nullptr if none.
+	*/
+	UDialogueTransition* GetActiveTransition() const;
+
+	/**
+	* Marks the given pass-through node traversed for the current step.
+	*
+	* @param NodeIndex - int32, the node being passed through.
+	* @return bool - True if the node was already traversed this step,
+	* meaning the dialogue is cycling. False otherwise.
+	*/
+	bool MarkTraversedThisStep(int32 NodeIndex);
+
+private:
+	/** The handle the controller knows the instance by */
+	int32 Handle = INDEX_NONE;
+
+	/** The dialogue being played */
+	TObjectPtr<UDialogue> Dialogue;
+
+	/** The controller that owns the instance */
+	TObjectPtr<ADialogueController> Controller;
+
+	/** Whether speeches and options go to the controller's display */
+	bool bUsesDisplay = true;
+
+	/** How much of the dialogue is presented */
+	EDialogueFidelity Fidelity = EDialogueFidelity::Full;
+
+	/** Whether the instance is still playing */
+	bool bActive = false;
+
+	/** The index of the node the instance is resting on */
+	int32 ActiveNodeIndex = INDEX_NONE;
+
+	/** The bound speaker components, indexed by speaker slot */
+	TArray<TObjectPtr<UDialogueSpeakerComponent>> Speakers;
+
+	/** Whether the traversal loop is currently running */
+	bool bTraversing = false;
+
+	/** Whether a node was traversed while the loop was running */
+	bool bHasPendingNode = false;
+
+	/** The node traversed while the loop was running */
+	int32 PendingNodeIndex = INDEX_NONE;
+
+	/** Pass-through nodes traversed since the last content node */
+	TBitArray<> TraversedThisStep;
+
+	/** State of the active speech's transition */
+	FDialogueTransitionState TransitionState;
+
+	/** Option details handed to the display, kept to reuse the allocation */
+	TArray<FSpeechDetails> OptionDetails;
+
+	/** The speaker whose audio the active speech is waiting on */
+	TWeakObjectPtr<UDialogueSpeakerComponent> AudioSpeaker;
+
+	/** Whether the active speech is waiting on its audio */
+	bool bWaitingOnAudio = false;
+
+	/** Whether the scheduler is polling the instance's audio */
+	bool bAudioWatched = false;
+
+	/** The world's dialogue scheduler */
+	FDialogueScheduler* Scheduler = nullptr;
+
+	/** How fast minimum play times run relative to the dialogue clock */
+	float TimeScale = 1.f;
+
+	/** Streams in the audio of speeches ahead of the active node */
+	FDialogueAudioPrefetcher AudioPrefetcher;
+
+	/** Incremented with every speech audio load, so stale loads are ignored */
+	int32 SpeechAudioRequest = 0;
+
+	/** Whether the active speech's audio is still being streamed in */
+	bool bLoadingSpeechAudio = false;
+
+	/** Blackboard slot of each of the program's keys, resolved on use */
+	TArray<int32> BlackboardSlots;
+
+	/** The controller's blackboard generation the slots were resolved for */
+	uint32 BlackboardGeneration = 0;
+
+	/** Cached result of each of the program's queries, and the cache epoch
+	* it was stored under */
+	TArray<TPair<double, uint32>> QueryResults;
+
+	/** Results stored under any other epoch are stale */
+	uint32 QueryResultEpoch = 1;
+
+	/** The frame cached results were stored in */
+	uint64 QueryResultFrame = 0;
+
+	/** The controller's state epoch cached results were stored under */
+	uint32 QueryResultStateEpoch = 0;
+
+	/** The instance currently executing on the game thread */
+	static FDialogueInstance* Executing;
+
+	friend class FDialogueScheduler;
+};
@@ -0,0 +1,93 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "DialogueFidelity.h"
+//Generated
+#include "DialogueInstanceSnapshot.generated.h"
+
+class UDialogue;
+
+/**
+* A pending option of a snapshotted speech.
+*/
+USTRUCT(BlueprintType)
+struct FDialogueOptionSnapshot
+{
+	GENERATED_BODY()
+
+	/** Stable ID of the node the option transitions to */
+	UPROPERTY(SaveGame)
+	uint32 TargetKey = 0;
+
+	/** ID of the node the option transitions to, if it has no stable ID */
+	UPROPERTY(SaveGame)
+	FName TargetID;
+
+	/** Whether the option was locked */
+	UPROPERTY(SaveGame)
+	bool bIsLocked = false;
+};
+
+/**
+* The live state of a playing dialogue, taken while it rests on a speech or
+* event. Restoring it puts the dialogue back on that node without passing
+* through the nodes before it or recording visits. Of the node's events,
+* only those that were still blocking are played again.
+*/
+USTRUCT(BlueprintType)
+struct FDialogueInstanceSnapshot
+{
+	GENERATED_BODY()
+
+	/** The dialogue being played */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	TSoftObjectPtr<UDialogue> Dialogue;
+
+	/** Stable ID of the node the dialogue rests on */
+	UPROPERTY(SaveGame)
+	uint32 ActiveNodeKey = 0;
+
+	/** ID of the node the dialogue rests on */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	FName ActiveNodeID;
+
+	/** The dialogue's speaker roles */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	TArray<FName> SpeakerRoles;
+
+	/** Dialogue names of the speakers bound to each role. None if unbound. */
+	UPROPERTY(BlueprintReadOnly, SaveGame, Category = "Dialogue")
+	TArray<FName> SpeakerNames;
+
+	/** Whether the speech's minimum play time had elapsed */
+	UPROPERTY(SaveGame)
+	bool bMinPlayTimeElapsed = false;
+
+	/** Minimum play time the speech had left */
+	UPROPERTY(SaveGame)
+	double MinPlayTimeLeft = 0.0;
+
+	/** Whether the speech's audio had finished */
+	UPROPERTY(SaveGame)
+	bool bAudioFinished = false;
+
+	/** Options waiting on the player */
+	UPROPERTY(SaveGame)
+	TArray<FDialogueOptionSnapshot> Options;
+
+	/** Indices of the node's events that were still blocking */
+	UPROPERTY(SaveGame)
+	TArray<int32> BlockingEvents;
+
+	/** How much of the dialogue was presented */
+	UPROPERTY(SaveGame)
+	EDialogueFidelity Fidelity = EDialogueFidelity::Full;
+
+	/** How fast minimum play times ran */
+	UPROPERTY(SaveGame)
+	float TimeScale = 1.f;
+};
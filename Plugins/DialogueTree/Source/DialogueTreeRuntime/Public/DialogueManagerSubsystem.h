@@ -6,46 +6,268 @@
 #include "CoreMinimal.h"
 #include "Subsystems/WorldSubsystem.h"
 //Plugin
+#include "DialogueBarkService.h"
+#include "DialogueInstance.h"
+#include "DialogueScheduler.h"
 #include "DialogueSettings.h"
+#include "DialogueSpeakerRegistry.h"
 //Generated
 #include "DialogueManagerSubsystem.generated.h"
 
 class ADialogueController;
+class UDialogue;
+class UDialogueSpeakerComponent;
+struct FStreamableHandle;
+
+/** Delegate used to hand out the dialogue controller once it is spawned */
+DECLARE_MULTICAST_DELEGATE_OneParam(
+	FDialogueControllerReadySignature,
+	ADialogueController*
+);
 
 /**
  * Subsystem used to manage dialogue following a Singleton-like pattern.
  * Lifespan follows the world. Essentially serves as a casing for the
  * polymorphic Dialogue Controller. Abstract to allow Blueprint subclass to
  * handle default values.
+ *
+ * The controller class and its widget classes are streamed in while the
+ * map loads, and the controller is spawned once both the world has begun
+ * play and the classes have arrived.
+ *
+ * Also keeps a registry of the world's playing speakers, so speakers for a
+ * role or near a point can be found without sweeping the world's actors,
+ * ticks the scheduler that times every playing dialogue, and arbitrates
+ * the barks speakers request.
  */
 UCLASS()
-class DIALOGUETREERUNTIME_API UDialogueManagerSubsystem : public UWorldSubsystem
+class DIALOGUETREERUNTIME_API UDialogueManagerSubsystem 
+	: public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
 
 public:
-	/** UWorldSubsystem Impl. */
+	/** UTickableWorldSubsystem Impl. */
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
-	/** End UWorldSubsystem */
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	/** End UTickableWorldSubsystem */
 
 	/**
-	* Retrieves the associated dialogue controller actor. 
-	* 
-	* @return ADialogueController*, the dialogue controller. 
+	* Retrieves the associated dialogue controller actor.
+	*
+	* @return ADialogueController*, the dialogue controller. Nullptr while
+	* the controller class is still loading.
 	*/
 	UFUNCTION(BlueprintPure, Category = "Dialogue")
 	ADialogueController* GetCurrentController();
 
 	/**
-	* Retrieves the settings for the plugin. 
-	* 
+	* Checks if the dialogue controller has yet to be spawned.
+	*
+	* @return bool - True while the controller class is loading or the world
+	* has not begun play. False once the controller spawned or failed to.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	bool IsControllerPending() const;
+
+	/**
+	* Retrieves the delegate broadcast once the pending controller has been
+	* spawned. Listeners are cleared after the broadcast. The controller is
+	* null if it failed to spawn.
+	*
+	* @return FDialogueControllerReadySignature& - the delegate.
+	*/
+	FDialogueControllerReadySignature& OnControllerReady();
+
+	/**
+	* Retrieves the settings for the plugin.
+	*
 	* @return UDialogueSettings*, the settings for the plugin.
 	*/
 	UFUNCTION(BlueprintPure, Category="Dialogue")
 	const UDialogueSettings* GetSettings();
 
+	/**
+	* Adds the given speaker to the speaker registry, or refreshes where it
+	* is filed if it was already registered.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void RegisterSpeaker(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Removes the given speaker from the speaker registry.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void UnregisterSpeaker(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Re-files a registered speaker after it moved.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void UpdateSpeakerLocation(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Finds the playing speaker with the given dialogue name nearest to a
+	* location.
+	*
+	* @param InDialogueName - FName, the dialogue name to look for.
+	* @param InLocation - FVector, the location to search from.
+	* @param InMaxDistance - float, the search radius. 0 searches the whole
+	* world.
+	* @return UDialogueSpeakerComponent* - the nearest speaker. Null if none
+	* were found.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	UDialogueSpeakerComponent* FindNearestSpeaker(FName InDialogueName,
+		FVector InLocation, float InMaxDistance = 0.f) const;
+
+	/**
+	* Gets every playing speaker with the given dialogue name.
+	*
+	* @param InDialogueName - FName, the dialogue name to look for.
+	* @return TArray<UDialogueSpeakerComponent*> - the speakers.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	TArray<UDialogueSpeakerComponent*> GetSpeakersWithName(
+		FName InDialogueName) const;
+
+	/**
+	* Gets every playing speaker within range of a location.
+	*
+	* @param InLocation - FVector, the location to search from.
+	* @param InMaxDistance - float, the search radius.
+	* @return TArray<UDialogueSpeakerComponent*> - the speakers.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	TArray<UDialogueSpeakerComponent*> GetSpeakersInRange(FVector InLocation,
+		float InMaxDistance) const;
+
+	/**
+	* Fills the speaker slots of a dialogue for the given instigator. The
+	* instigator takes its own role and every other role is given to the
+	* nearest playing speaker with that name.
+	*
+	* @param InDialogue - const UDialogue*, the dialogue to fill slots for.
+	* @param InInstigator - UDialogueSpeakerComponent*, the speaker
+	* starting the dialogue. Searched around.
+	* @param InMaxDistance - float, the search radius. 0 searches the whole
+	* world.
+	* @param OutSlots - FDialogueSpeakerSlots&, the filled slots. Roles with
+	* no speaker in range are left null.
+	*/
+	void BindNearestSpeakerSlots(const UDialogue* InDialogue,
+		UDialogueSpeakerComponent* InInstigator, float InMaxDistance,
+		FDialogueSpeakerSlots& OutSlots) const;
+
+	/**
+	* Pauses or resumes every dialogue in the world, without pausing the
+	* game. Audio already playing is left alone.
+	*
+	* @param bInPaused - bool, whether to pause.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SetDialoguePaused(bool bInPaused);
+
+	/**
+	* Checks if dialogue in the world is paused.
+	*
+	* @return bool - True if paused.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	bool IsDialoguePaused() const;
+
+	/**
+	* Sets how fast dialogue play times run relative to world time, on top
+	* of any time dilation.
+	*
+	* @param InTimeScale - float, the time scale.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void SetDialogueTimeScale(float InTimeScale);
+
+	/**
+	* Gets how fast dialogue play times run relative to world time.
+	*
+	* @return float - the time scale.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Dialogue")
+	float GetDialogueTimeScale() const;
+
+	/**
+	* Queues a bark from the given speaker. See FDialogueBarkService.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the barking speaker.
+	* @param InDialogue - UDialogue*, the bark to play.
+	* @param InParams - const FDialogueBarkParams&, how the bark competes.
+	* @return bool - True if queued. False if the bark is cooling down or
+	* was outranked.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool RequestBark(UDialogueSpeakerComponent* InSpeaker, 
+		UDialogue* InDialogue, const FDialogueBarkParams& InParams);
+
+	/**
+	* Drops any bark the given speaker has queued. Barks already playing 
+	* are left alone.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void CancelBark(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Retrieves the service arbitrating the world's barks.
+	*
+	* @return FDialogueBarkService& - the bark service.
+	*/
+	FDialogueBarkService& GetBarkService();
+
+	/**
+	* Retrieves the scheduler timing the world's dialogues.
+	*
+	* @return FDialogueScheduler& - the scheduler.
+	*/
+	FDialogueScheduler& GetScheduler();
+
+	/**
+	* Retrieves the registry of the world's playing speakers.
+	*
+	* @return const FDialogueSpeakerRegistry& - the registry.
+	*/
+	const FDialogueSpeakerRegistry& GetSpeakerRegistry() const;
+
+private:
+	/**
+	* Starts streaming in the controller class and the widget classes it
+	* displays dialogue with.
+	*/
+	void RequestControllerClasses();
+
+	/**
+	* Called when the controller and widget classes finish loading.
+	*/
+	void OnControllerClassesLoaded();
+
+	/**
+	* Spawns the controller once the world has begun play and the classes
+	* have loaded, then hands it to anyone waiting on it.
+	*/
+	void TrySpawnController();
+
+	/**
+	* Called when an ambient dialogue ends, so the voice of a bark is freed.
+	*
+	* @param Handle - int32, the handle of the ended dialogue.
+	*/
+	UFUNCTION()
+	void OnAmbientDialogueEnded(int32 Handle);
+
 private:
 	/** The String type of dialogue controller that will be used if none is
 	 * supplied in the project settings for the plugin.
@@ -55,4 +277,25 @@ private:
 
 	/** The active dialogue controller */
 	TObjectPtr<ADialogueController> DialogueController;
+
+	/** Keeps the controller and widget classes loaded for the world */
+	TSharedPtr<FStreamableHandle> ControllerClassesHandle;
+
+	/** Whether the controller has yet to be spawned */
+	bool bControllerPending = false;
+
+	/** Whether the world has begun play */
+	bool bWorldBegunPlay = false;
+
+	/** Broadcast once the pending controller has been spawned */
+	FDialogueControllerReadySignature ControllerReadyDelegate;
+
+	/** The world's playing speakers */
+	FDialogueSpeakerRegistry SpeakerRegistry;
+
+	/** Times the world's dialogues */
+	FDialogueScheduler Scheduler;
+
+	/** Arbitrates the world's barks */
+	FDialogueBarkService BarkService;
 };
@@ -26,4 +26,24 @@ struct FDialogueOption
 	/** The node the option transitions to */
 	UPROPERTY()
 	TObjectPtr<UDialogueNode> TargetNode = nullptr;
+};
+
+/**
+* A selectable option resolved from a compiled dialogue program. The
+* option's speech details are not copied; they stay in the program and are
+* read by index.
+*/
+struct FResolvedDialogueOption
+{
+	/** The index of the node the option transitions to */
+	int32 TargetIndex = INDEX_NONE;
+
+	/** The index of the option's speech details in the program */
+	int32 SpeechIndex = INDEX_NONE;
+
+	/** The index of the option lock deciding the lock state, if any */
+	int32 LockIndex = INDEX_NONE;
+
+	/** Whether the option is locked */
+	bool bIsLocked = false;
 };
\ No newline at end of file
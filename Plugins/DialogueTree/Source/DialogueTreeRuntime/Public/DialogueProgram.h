@@ -0,0 +1,862 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+//Plugin
+#include "DialogueBlackboard.h"
+#include "DialogueOption.h"
+#include "SpeechDetails.h"
+//Generated
+#include "DialogueProgram.generated.h"
+
+class FDialogueInstance;
+class UDialogue;
+class UDialogueCondition;
+class UDialogueNode;
+class UDialogueQuery;
+
+/**
+* Enum identifying the behavior of a node in a compiled dialogue program.
+*/
+UENUM()
+enum class EDialogueNodeKind : uint8
+{
+	None,
+	Entry,
+	Speech,
+	Event,
+	Branch,
+	Jump,
+	Reroute,
+	OptionLock
+};
+
+/**
+* Versions of the compiled program layout. Dialogues compiled with an older
+* layout are rebuilt on load.
+*/
+enum class EDialogueProgramVersion : int32
+{
+	Initial = 0,
+	OptionRoutes,
+	SpeakerSlots,
+	ConditionCode,
+	Blackboard,
+	StableIDs,
+
+	//Keep last
+	VersionPlusOne,
+	Latest = VersionPlusOne - 1
+};
+
+/**
+* Enum identifying what a compiled condition instruction evaluates.
+*/
+UENUM()
+enum class EDialogueConditionOp : uint8
+{
+	/** Calls IsMet on a condition the compiler could not lower */
+	CallCondition,
+
+	/** Executes a bool query object */
+	CallQueryBool,
+
+	/** Executes an int query object and compares the result */
+	CallQueryInt,
+
+	/** Executes a float query object and compares the result */
+	CallQueryFloat,
+
+	/** Checks if a node in the program was visited */
+	NodeVisited,
+
+	/** Checks if a speaker slot is bound, optionally within range of 
+	* another */
+	SpeakerFound,
+
+	/** Compares the number of a blackboard key */
+	BlackboardNumber,
+
+	/** Checks if a blackboard key holds a name */
+	BlackboardName,
+
+	/** Checks if the tag of a blackboard key matches a tag, counting 
+	* parent tags */
+	BlackboardTag
+};
+
+/**
+* Enum identifying how a compiled condition instruction compares the value
+* it reads against its constant.
+*/
+UENUM()
+enum class EDialogueConditionCompare : uint8
+{
+	IsTrue,
+	GreaterThan,
+	LessThan,
+	EqualTo
+};
+
+/**
+* A single condition lowered by the compiler. Conditions over native 
+* queries are evaluated inline; only queries implemented elsewhere, such as
+* in blueprint, are called through their objects.
+*/
+USTRUCT()
+struct FDialogueConditionInstruction
+{
+	GENERATED_BODY()
+
+	/** What the instruction evaluates */
+	UPROPERTY()
+	EDialogueConditionOp Op = EDialogueConditionOp::CallCondition;
+
+	/** How the value read is compared against Value */
+	UPROPERTY()
+	EDialogueConditionCompare Compare = EDialogueConditionCompare::IsTrue;
+
+	/** Whether the outcome is inverted */
+	UPROPERTY()
+	bool bNegate = false;
+
+	/** Whether speakers in the world that were not brought into the 
+	* dialogue also count. SpeakerFound only. */
+	UPROPERTY()
+	bool bIncludeUnbound = false;
+
+	/** The query to call, node to check, speaker slot or blackboard key 
+	* to look up, depending on the op */
+	UPROPERTY()
+	int32 Operand = INDEX_NONE;
+
+	/** The speaker slot distance is measured from for SpeakerFound. The 
+	* blackboard constant compared against for BlackboardName and 
+	* BlackboardTag. */
+	UPROPERTY()
+	int32 SecondOperand = INDEX_NONE;
+
+	/** The constant to compare against. The range for SpeakerFound. */
+	UPROPERTY()
+	double Value = 0.0;
+};
+
+/**
+* Condition a compiled option route depends on: the branch node that has
+* to evaluate to the given outcome for the route to be taken.
+*/
+USTRUCT()
+struct FDialogueOptionGuard
+{
+	GENERATED_BODY()
+
+	/** The branch node deciding the route */
+	UPROPERTY()
+	int32 NodeIndex = INDEX_NONE;
+
+	/** The outcome the branch needs for the route to be taken */
+	UPROPERTY()
+	bool bPasses = true;
+};
+
+/**
+* One way an outgoing link of an option node can resolve to a speech,
+* precomputed when compiling. A link has one route per combination of
+* branch outcomes that leads to a speech.
+*/
+USTRUCT()
+struct FDialogueOptionRoute
+{
+	GENERATED_BODY()
+
+	/** Which of the option node's links the route starts from */
+	UPROPERTY()
+	int32 LinkSlot = INDEX_NONE;
+
+	/** The node the option transitions to when selected */
+	UPROPERTY()
+	int32 TargetIndex = INDEX_NONE;
+
+	/** The speech the route arrives at. INDEX_NONE if the link was too
+	* tangled to precompute and has to be resolved at runtime */
+	UPROPERTY()
+	int32 SpeechIndex = INDEX_NONE;
+
+	/** The outermost option lock along the route, if any */
+	UPROPERTY()
+	int32 LockIndex = INDEX_NONE;
+
+	/** First guard that must hold for the route to be taken */
+	UPROPERTY()
+	int32 GuardStart = 0;
+
+	/** Number of guards */
+	UPROPERTY()
+	int32 GuardCount = 0;
+};
+
+/**
+* Struct representing a single node in a compiled dialogue program. All
+* references to other data are stored as index ranges into the program's
+* flat arrays.
+*/
+USTRUCT()
+struct FDialogueProgramNode
+{
+	GENERATED_BODY()
+
+	/** How the runtime should treat the node */
+	UPROPERTY()
+	EDialogueNodeKind Kind = EDialogueNodeKind::None;
+
+	/** Whether the node's conditions pass if any single condition does */
+	UPROPERTY()
+	bool bIfAny = false;
+
+	/** Whether the node presents its links as options, and so needs its
+	* option routes compiled */
+	UPROPERTY()
+	bool bResolvesOptions = false;
+
+	/** First outgoing link. Branches store their true and false nodes here,
+	* and jumps store their target */
+	UPROPERTY()
+	int32 LinkStart = 0;
+
+	/** Number of outgoing links */
+	UPROPERTY()
+	int32 LinkCount = 0;
+
+	/** First condition owned by the node. Indexes both the condition 
+	* objects and their compiled instructions. */
+	UPROPERTY()
+	int32 ConditionStart = 0;
+
+	/** Number of conditions owned by the node */
+	UPROPERTY()
+	int32 ConditionCount = 0;
+
+	/** Index of the node's speech details, if any */
+	UPROPERTY()
+	int32 SpeechIndex = INDEX_NONE;
+
+	/** Index of the node's locked message. The unlocked message directly
+	* follows it. */
+	UPROPERTY()
+	int32 MessageIndex = INDEX_NONE;
+
+	/** The node's bit in visit records. Unlike the node's index, this stays
+	* the same across recompiles so saved visits keep pointing at it. */
+	UPROPERTY()
+	int32 VisitIndex = INDEX_NONE;
+
+	/** First precompiled option route of the node */
+	UPROPERTY()
+	int32 RouteStart = 0;
+
+	/** Number of precompiled option routes */
+	UPROPERTY()
+	int32 RouteCount = 0;
+
+	/** The speaker slot of the node's speaker, if any */
+	UPROPERTY()
+	int32 SpeakerSlot = INDEX_NONE;
+
+	/** The node's stable ID, which survives renames. 0 if the node has 
+	* none. */
+	UPROPERTY()
+	uint32 StableID = 0;
+};
+
+/**
+* Runtime cost and outcome of a single compiled condition, gathered when
+* conditions are ordered adaptively.
+*/
+struct FDialogueConditionProfile
+{
+	/** Cycles spent evaluating the condition */
+	uint64 Cycles = 0;
+
+	/** Number of times the condition was evaluated */
+	uint32 Samples = 0;
+
+	/** Number of evaluations the condition passed */
+	uint32 Passes = 0;
+};
+
+/**
+* Flat, index-addressed representation of a compiled dialogue. Built from
+* the dialogue's node objects when compiling so the runtime can walk the
+* dialogue with int32 handles instead of chasing node pointers.
+*/
+USTRUCT()
+struct DIALOGUETREERUNTIME_API FDialogueProgram
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* Empties the program.
+	*/
+	void Reset();
+
+	/**
+	* Checks if the program holds any nodes.
+	*
+	* @return bool - True if the program is empty. False otherwise.
+	*/
+	bool IsEmpty() const;
+
+	/**
+	* Checks if the program was built with the latest layout.
+	*
+	* @return bool - True if the program is up to date. False otherwise.
+	*/
+	bool IsUpToDate() const;
+
+	/**
+	* Checks if the given index refers to a node in the program.
+	*
+	* @param NodeIndex - int32, the index to check.
+	* @return bool - True if the index is valid. False otherwise.
+	*/
+	bool IsValidNode(int32 NodeIndex) const;
+
+	/**
+	* Gets the number of nodes in the program.
+	*
+	* @return int32 - the number of nodes.
+	*/
+	int32 GetNumNodes() const;
+
+	/**
+	* Retrieves the index of the entry node.
+	*
+	* @return int32 - the entry index. INDEX_NONE if there is none.
+	*/
+	int32 GetEntryIndex() const;
+
+	/**
+	* Retrieves the index of the node with the given ID.
+	*
+	* @param NodeID - FName, the target node's ID.
+	* @return int32 - the node's index. INDEX_NONE if not found.
+	*/
+	int32 FindNode(FName NodeID) const;
+
+	/**
+	* Retrieves the index of the node with the given stable ID.
+	*
+	* @param InStableID - uint32, the node's stable ID.
+	* @return int32 - the node's index. INDEX_NONE if not found.
+	*/
+	int32 FindNodeByStableID(uint32 InStableID) const;
+
+	/**
+	* Retrieves the index of the node that was known by the given ID before
+	* being renamed.
+	*
+	* @param OldNodeID - FName, the node's former ID.
+	* @return int32 - the node's index. INDEX_NONE if no node was renamed
+	* from the ID.
+	*/
+	int32 FindRenamedNode(FName OldNodeID) const;
+
+	/**
+	* Retrieves the stable ID of the node at the given index.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return uint32 - the stable ID. 0 if the node has none or the index 
+	* is invalid.
+	*/
+	uint32 GetStableID(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the index of the given node object.
+	*
+	* @param InNode - const UDialogueNode*, the node.
+	* @return int32 - the node's index. INDEX_NONE if the node is not part 
+	* of the program.
+	*/
+	int32 IndexOf(const UDialogueNode* InNode) const;
+
+	/**
+	* Gets the number of visit slots the dialogue has handed out, including
+	* those of nodes that have since been removed.
+	*
+	* @return int32 - the number of visit slots.
+	*/
+	int32 GetNumVisitSlots() const;
+
+	/**
+	* Retrieves the visit slot of the node at the given index.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return int32 - the visit slot. INDEX_NONE if the index is invalid.
+	*/
+	int32 GetVisitIndex(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the visit slot of the node with the given ID. IDs nodes had
+	* before being renamed resolve to the renamed node's slot.
+	*
+	* @param NodeID - FName, the target node's ID.
+	* @return int32 - the visit slot. INDEX_NONE if not found.
+	*/
+	int32 FindVisitIndex(FName NodeID) const;
+
+	/**
+	* Gets the number of speaker roles the program binds speakers to.
+	*
+	* @return int32 - the number of speaker slots.
+	*/
+	int32 GetNumSpeakerSlots() const;
+
+	/**
+	* Retrieves the slot of the speaker role with the given name.
+	*
+	* @param InRole - FName, the speaker role.
+	* @return int32 - the role's slot. INDEX_NONE if the role is not part of
+	* the program.
+	*/
+	int32 FindSpeakerSlot(FName InRole) const;
+
+	/**
+	* Retrieves the name of the speaker role in the given slot.
+	*
+	* @param InSlot - int32, the slot.
+	* @return FName - the role's name. NAME_None if the slot is invalid.
+	*/
+	FName GetSpeakerRole(int32 InSlot) const;
+
+	/**
+	* Retrieves the speaker roles in slot order.
+	*
+	* @return TConstArrayView<FName> - the roles.
+	*/
+	TConstArrayView<FName> GetSpeakerRoles() const;
+
+	/**
+	* Retrieves the blackboard keys the program reads or writes, in the 
+	* order they were added.
+	*
+	* @return TConstArrayView<FDialogueBlackboardKey> - the keys.
+	*/
+	TConstArrayView<FDialogueBlackboardKey> GetBlackboardKeys() const;
+
+	/**
+	* Gets the number of queries compiled conditions call through their 
+	* objects.
+	*
+	* @return int32 - the number of queries.
+	*/
+	int32 GetNumConditionQueries() const;
+
+	/**
+	* Retrieves the compiled data for the node at the given index.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return const FDialogueProgramNode& - the node data.
+	*/
+	const FDialogueProgramNode& GetNode(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the node object the program entry was compiled from.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return UDialogueNode* - the node object.
+	*/
+	UDialogueNode* GetNodeObject(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the outgoing links of the given node.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return TConstArrayView<int32> - indices of the linked nodes.
+	*/
+	TConstArrayView<int32> GetLinks(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the first outgoing link of the given node.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return int32 - the linked node. INDEX_NONE if there are no links.
+	*/
+	int32 GetFirstLink(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the speech details compiled for the given node.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return const FSpeechDetails* - the details. Nullptr if the node has
+	* no speech.
+	*/
+	const FSpeechDetails* GetSpeech(int32 NodeIndex) const;
+
+	/**
+	* Evaluates the conditions of the given node.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return bool - True if the node's conditions pass. False otherwise.
+	*/
+	bool PassesConditions(int32 NodeIndex) const;
+
+	/**
+	* Retrieves the order the given node currently evaluates its conditions
+	* in, as chosen by adaptive condition ordering.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @param OutOrder - TArray<int32>&, filled with the authored position of
+	* each condition, in evaluation order. Empty if the node's conditions
+	* were never profiled.
+	*/
+	void GetConditionOrder(int32 NodeIndex, TArray<int32>& OutOrder) const;
+
+	/**
+	* Resolves the node that a pass-through node hands control to.
+	*
+	* @param NodeIndex - int32, the pass-through node's index.
+	* @return int32 - the next node. INDEX_NONE if there is none.
+	*/
+	int32 ResolveNext(int32 NodeIndex) const;
+
+	/**
+	* Resolves the given node as a selectable option by walking the table. 
+	* Mirrors UDialogueNode::GetAsOption(). Only used for links too tangled
+	* to precompute; everything else goes through GatherOptions().
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @param OutOption - FResolvedDialogueOption&, option to fill.
+	* @return bool - True if the node resolved to a speech. False otherwise.
+	*/
+	bool ResolveOption(int32 NodeIndex, FResolvedDialogueOption& OutOption)
+		const;
+
+	/**
+	* Gathers the options presented by the given node from its precompiled
+	* routes. Only the conditions guarding each route are evaluated.
+	*
+	* @param NodeIndex - int32, the option node's index.
+	* @param OutOptions - TArray<FResolvedDialogueOption>&, array to fill.
+	* Reset first, keeping its allocation.
+	*/
+	void GatherOptions(int32 NodeIndex,
+		TArray<FResolvedDialogueOption>& OutOptions) const;
+
+	/**
+	* Retrieves the speech details of the given option.
+	*
+	* @param InOption - const FResolvedDialogueOption&, the option.
+	* @return const FSpeechDetails& - the option's speech details, as 
+	* compiled. Lock state is not applied.
+	*/
+	const FSpeechDetails& GetOptionSpeech(
+		const FResolvedDialogueOption& InOption) const;
+
+	/**
+	* Fills the given details with the option's speech, applying its lock
+	* state and message.
+	*
+	* @param InOption - const FResolvedDialogueOption&, the option.
+	* @param OutDetails - FSpeechDetails&, details to fill.
+	*/
+	void GetOptionDetails(const FResolvedDialogueOption& InOption,
+		FSpeechDetails& OutDetails) const;
+
+public:
+	/**
+	* Adds the given node object to the program, reserving its index. Links
+	* are not resolved until the node is compiled.
+	*
+	* @param InNode - UDialogueNode*, the node to add.
+	* @return int32 - the node's index.
+	*/
+	int32 AddNode(UDialogueNode* InNode);
+
+	/**
+	* Appends a link to the given node. Links of a node must be added
+	* consecutively. Nodes that are not part of the program are stored as
+	* INDEX_NONE.
+	*
+	* @param InLinked - UDialogueNode*, the linked node.
+	* @param OutNode - FDialogueProgramNode&, the node to add the link to.
+	*/
+	void AddLink(UDialogueNode* InLinked, FDialogueProgramNode& OutNode);
+
+	/**
+	* Appends a condition to the given node. Conditions of a node must be
+	* added consecutively.
+	*
+	* @param InCondition - UDialogueCondition*, the condition.
+	* @param OutNode - FDialogueProgramNode&, the node to add the condition to.
+	*/
+	void AddCondition(UDialogueCondition* InCondition,
+		FDialogueProgramNode& OutNode);
+
+	/**
+	* Adds a query that compiled conditions call through its object. 
+	* Cacheable queries identical to one already added share its index, 
+	* and so its cached result.
+	*
+	* @param InQuery - UDialogueQuery*, the query.
+	* @return int32 - the query's index, for use as an instruction operand.
+	*/
+	int32 AddConditionQuery(UDialogueQuery* InQuery);
+
+	/**
+	* Adds a blackboard key to the program. Keys that are already part of
+	* the program keep their index.
+	*
+	* @param InKey - FName, the key.
+	* @param InType - EDialogueBlackboardType, the type of value it holds.
+	* @return int32 - the key's index, for use as an instruction operand. 
+	* INDEX_NONE if the name is None.
+	*/
+	int32 AddBlackboardKey(FName InKey, EDialogueBlackboardType InType);
+
+	/**
+	* Adds a value that blackboard instructions compare against.
+	*
+	* @param InValue - const FDialogueBlackboardValue&, the value.
+	* @return int32 - the constant's index, for use as an instruction 
+	* operand.
+	*/
+	int32 AddBlackboardConstant(const FDialogueBlackboardValue& InValue);
+
+	/**
+	* Adds a speaker role to the program, giving it the next free slot. Roles
+	* that are already part of the program keep their slot.
+	*
+	* @param InRole - FName, the role to add.
+	* @return int32 - the role's slot. INDEX_NONE if the name is None.
+	*/
+	int32 AddSpeakerRole(FName InRole);
+
+	/**
+	* Adds the given speech details to the program. Also resolves the slot of
+	* the speech's speaker, so roles must be added first.
+	*
+	* @param InDetails - const FSpeechDetails&, the details.
+	* @param OutNode - FDialogueProgramNode&, the node to set the index on.
+	*/
+	void AddSpeech(const FSpeechDetails& InDetails,
+		FDialogueProgramNode& OutNode);
+
+	/**
+	* Adds a locked/unlocked message pair to the program.
+	*
+	* @param LockedText - const FText&, message used when locked.
+	* @param UnlockedText - const FText&, message used when unlocked.
+	* @param OutNode - FDialogueProgramNode&, the node to set the index on.
+	*/
+	void AddMessages(const FText& LockedText, const FText& UnlockedText,
+		FDialogueProgramNode& OutNode);
+
+	/**
+	* Sets the entry node of the program.
+	*
+	* @param InIndex - int32, the entry index.
+	*/
+	void SetEntryIndex(int32 InIndex);
+
+	/**
+	* Records the visit slot of an ID a node had before being renamed, so 
+	* visits saved under the old ID still find it.
+	*
+	* @param OldNodeID - FName, the former ID.
+	* @param InVisitIndex - int32, the renamed node's visit slot.
+	*/
+	void AddRenamedNode(FName OldNodeID, int32 InVisitIndex);
+
+	/**
+	* Sets the number of visit slots handed out by the dialogue.
+	*
+	* @param InNum - int32, the number of visit slots.
+	*/
+	void SetNumVisitSlots(int32 InNum);
+
+	/**
+	* Precomputes the option routes of every node that resolves options.
+	* Called once all nodes have been compiled.
+	*/
+	void CompileOptionRoutes();
+
+	/**
+	* Retrieves mutable data for the node at the given index. Used while
+	* compiling.
+	*
+	* @param NodeIndex - int32, the node's index.
+	* @return FDialogueProgramNode& - the node data.
+	*/
+	FDialogueProgramNode& GetMutableNode(int32 NodeIndex);
+
+private:
+	/**
+	* Precomputes the routes of one link of an option node.
+	*
+	* @param LinkSlot - int32, which of the node's links to compile.
+	* @param LinkedIndex - int32, the node the link points at.
+	*/
+	void CompileOptionRoutesForLink(int32 LinkSlot, int32 LinkedIndex);
+
+	/**
+	* Evaluates a single compiled condition.
+	*
+	* @param InIndex - int32, index of the condition.
+	* @param InDialogue - const UDialogue*, the dialogue being evaluated.
+	* @param InInstance - FDialogueInstance*, the instance evaluating the 
+	* condition. May be null.
+	* @return bool - True if the condition is met. False otherwise.
+	*/
+	bool EvaluateCondition(int32 InIndex, const UDialogue* InDialogue,
+		FDialogueInstance* InInstance) const;
+
+	/**
+	* Checks if a compiled condition has no side effects, so it may be 
+	* evaluated in any order with the conditions around it.
+	*
+	* @param InIndex - int32, index of the condition.
+	* @return bool - True if the condition is pure. False otherwise.
+	*/
+	bool IsConditionPure(int32 InIndex) const;
+
+	/**
+	* Sizes the condition profiles and starts every node off evaluating its
+	* conditions in authored order.
+	*/
+	void InitConditionProfiles() const;
+
+	/**
+	* Reorders the conditions of the given node by their profiled cost and
+	* odds of deciding the node's outcome.
+	*
+	* @param NodeIndex - int32, the node's index.
+	*/
+	void UpdateConditionOrder(int32 NodeIndex) const;
+
+	/**
+	* Evaluates a SpeakerFound instruction.
+	*
+	* @param InInstruction - const FDialogueConditionInstruction&, the 
+	* instruction.
+	* @param InInstance - FDialogueInstance*, the instance evaluating the 
+	* condition. May be null.
+	* @return bool - True if the speaker was found. False otherwise.
+	*/
+	bool IsSpeakerFound(const FDialogueConditionInstruction& InInstruction,
+		FDialogueInstance* InInstance) const;
+
+	/**
+	* Executes a query called through its object, reusing the instance's
+	* cached result if the query is cacheable.
+	*
+	* @param InInstruction - const FDialogueConditionInstruction&, the 
+	* instruction calling the query.
+	* @param InDialogue - const UDialogue*, the dialogue being evaluated.
+	* @param InInstance - FDialogueInstance*, the instance evaluating the 
+	* condition. May be null.
+	* @return double - the query's result. 0 if the query is missing.
+	*/
+	double ExecuteConditionQuery(
+		const FDialogueConditionInstruction& InInstruction,
+		const UDialogue* InDialogue, FDialogueInstance* InInstance) const;
+
+	/**
+	* Checks if all guards of the given route hold.
+	*
+	* @param InRoute - const FDialogueOptionRoute&, the route.
+	* @return bool - True if the route is taken. False otherwise.
+	*/
+	bool PassesGuards(const FDialogueOptionRoute& InRoute) const;
+
+private:
+	/** Compiled node table */
+	UPROPERTY()
+	TArray<FDialogueProgramNode> Nodes;
+
+	/** The node objects each entry was compiled from, by index */
+	UPROPERTY()
+	TArray<TObjectPtr<UDialogueNode>> NodeObjects;
+
+	/** Outgoing links for all nodes */
+	UPROPERTY()
+	TArray<int32> Links;
+
+	/** Conditions for all nodes */
+	UPROPERTY()
+	TArray<TObjectPtr<UDialogueCondition>> Conditions;
+
+	/** Compiled instructions for all conditions, one per condition */
+	UPROPERTY()
+	TArray<FDialogueConditionInstruction> ConditionCode;
+
+	/** Queries that compiled conditions call through their objects */
+	UPROPERTY()
+	TArray<TObjectPtr<UDialogueQuery>> ConditionQueries;
+
+	/** Speech details for all nodes */
+	UPROPERTY()
+	TArray<FSpeechDetails> Speeches;
+
+	/** Option lock messages for all nodes */
+	UPROPERTY()
+	TArray<FText> Messages;
+
+	/** Precompiled option routes for all option nodes */
+	UPROPERTY()
+	TArray<FDialogueOptionRoute> OptionRoutes;
+
+	/** Guards for all option routes */
+	UPROPERTY()
+	TArray<FDialogueOptionGuard> OptionGuards;
+
+	/** Blackboard keys read or written by the program */
+	UPROPERTY()
+	TArray<FDialogueBlackboardKey> BlackboardKeys;
+
+	/** Values blackboard instructions compare against */
+	UPROPERTY()
+	TArray<FDialogueBlackboardValue> BlackboardConstants;
+
+	/** Speaker role of each speaker slot */
+	UPROPERTY()
+	TArray<FName> SpeakerRoles;
+
+	/** Lookup from node ID to index, for entry points addressed by name */
+	UPROPERTY()
+	TMap<FName, int32> NodeIndices;
+
+	/** Lookup from stable ID to index, for save data keyed by stable ID */
+	UPROPERTY()
+	TMap<uint32, int32> StableNodeIndices;
+
+	/** Visit slots of IDs nodes had before being renamed */
+	UPROPERTY()
+	TMap<FName, int32> RenamedVisitSlots;
+
+	/** The index of the entry node */
+	UPROPERTY()
+	int32 EntryIndex = INDEX_NONE;
+
+	/** Number of visit slots handed out by the dialogue */
+	UPROPERTY()
+	int32 NumVisitSlots = 0;
+
+	/** The layout version the program was built with */
+	UPROPERTY()
+	int32 Version = (int32)EDialogueProgramVersion::Initial;
+
+	/** Profile of each condition, when ordering conditions adaptively */
+	mutable TArray<FDialogueConditionProfile> ConditionProfiles;
+
+	/** Conditions in the order they are evaluated, when ordering 
+	* adaptively. Each node's conditions are permuted within its own range
+	* of the array. */
+	mutable TArray<int32> ConditionOrder;
+
+	/** Evaluations of each node's conditions since their order was last
+	* updated */
+	mutable TArray<uint32> ConditionRuns;
+};
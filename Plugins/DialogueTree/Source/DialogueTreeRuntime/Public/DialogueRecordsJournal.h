@@ -0,0 +1,171 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+//Plugin
+#include "DialogueBlackboard.h"
+
+struct FDialogueNodeVisits;
+struct FDialogueRecords;
+
+/**
+* Kinds of change recorded by the dialogue records journal.
+*/
+enum class EDialogueJournalOp : uint8
+{
+	Replace,
+	SetRecord,
+	SetVisited,
+	ClearVisits,
+	SetResumeNode,
+	SetBlackboard
+};
+
+/**
+* A single change to the dialogue records. Only the fields used by the
+* entry's op are set.
+*/
+struct FDialogueJournalEntry
+{
+	/** The kind of change */
+	EDialogueJournalOp Op = EDialogueJournalOp::SetVisited;
+
+	/** Key of the changed dialogue's record */
+	uint64 DialogueKey = 0;
+
+	/** Visit slot of the changed node */
+	int32 VisitIndex = INDEX_NONE;
+
+	/** Whether the node was marked visited or unvisited */
+	bool bVisited = false;
+
+	/** The resume node's ID, or the blackboard key */
+	FName Name;
+
+	/** The resume node's stable ID */
+	uint32 NodeKey = 0;
+
+	/** Type of the blackboard key */
+	EDialogueBlackboardType Type = EDialogueBlackboardType::Bool;
+
+	/** Value written to the blackboard key */
+	FDialogueBlackboardValue Value;
+
+	/** Records replacing all others */
+	TSharedPtr<const FDialogueRecords> Records;
+
+	/** Record replacing the dialogue's record */
+	TSharedPtr<const FDialogueNodeVisits> Record;
+};
+
+/**
+* Journal of changes to the dialogue records, replayed onto a copy of the
+* records owned by background save tasks. The game thread only appends
+* small entries and hands the pending ones to the next save, so saving
+* never copies, serializes, compresses or writes the records on it.
+*/
+class DIALOGUETREERUNTIME_API FDialogueRecordsJournal
+{
+public:
+	/**
+	* Creates a journal whose saves start from the given records.
+	*
+	* @param InRecords - const FDialogueRecords&, the current records.
+	*/
+	explicit FDialogueRecordsJournal(const FDialogueRecords& InRecords);
+
+	/** Waits for any save still running */
+	~FDialogueRecordsJournal();
+
+	/**
+	* Records that every record was replaced, as by a load or clear.
+	*
+	* @param InRecords - const FDialogueRecords&, the new records.
+	*/
+	void RecordReplace(const FDialogueRecords& InRecords);
+
+	/**
+	* Records that a dialogue's record was created or migrated.
+	*
+	* @param InKey - uint64, the dialogue's key.
+	* @param InRecord - const FDialogueNodeVisits&, the record.
+	*/
+	void RecordSetRecord(uint64 InKey, const FDialogueNodeVisits& InRecord);
+
+	/**
+	* Records that a node was marked visited or unvisited.
+	*
+	* @param InKey - uint64, the dialogue's key.
+	* @param InVisitIndex - int32, the node's visit slot.
+	* @param bInVisited - bool, whether the node is now visited.
+	*/
+	void RecordSetVisited(uint64 InKey, int32 InVisitIndex, bool bInVisited);
+
+	/**
+	* Records that all of a dialogue's visits were cleared.
+	*
+	* @param InKey - uint64, the dialogue's key.
+	*/
+	void RecordClearVisits(uint64 InKey);
+
+	/**
+	* Records that a dialogue's resume node was set.
+	*
+	* @param InKey - uint64, the dialogue's key.
+	* @param InNodeID - FName, the resume node's ID.
+	* @param InNodeKey - uint32, the resume node's stable ID.
+	*/
+	void RecordSetResumeNode(uint64 InKey, FName InNodeID, uint32 InNodeKey);
+
+	/**
+	* Records that a blackboard key was added or written.
+	*
+	* @param InKey - FName, the blackboard key.
+	* @param InType - EDialogueBlackboardType, the key's type.
+	* @param InValue - const FDialogueBlackboardValue&, the value.
+	*/
+	void RecordSetBlackboard(FName InKey, EDialogueBlackboardType InType,
+		const FDialogueBlackboardValue& InValue);
+
+	/**
+	* Hands the pending entries to a background task, which replays them
+	* onto its copy of the records and writes the compressed records to
+	* the given save slot. Saves run one at a time, in order.
+	*
+	* @param InSlotName - const FString&, the save slot.
+	* @param InUserIndex - int32, the platform user index.
+	* @return UE::Tasks::FTask - the save task.
+	*/
+	UE::Tasks::FTask SaveAsync(const FString& InSlotName, int32 InUserIndex);
+
+	/**
+	* Blocks until every save handed off so far has finished.
+	*/
+	void WaitForSaves() const;
+
+	/**
+	* Reads and decompresses records written to a save slot by SaveAsync.
+	* Static.
+	*
+	* @param InSlotName - const FString&, the save slot.
+	* @param InUserIndex - int32, the platform user index.
+	* @param OutBytes - TArray<uint8>&, the records blob, as read by
+	* FDialogueRecordsSerializer.
+	* @return bool - True if the slot was read. False otherwise.
+	*/
+	static bool LoadFromSlot(const FString& InSlotName, int32 InUserIndex,
+		TArray<uint8>& OutBytes);
+
+private:
+	/** Entries not yet handed to a save */
+	TArray<FDialogueJournalEntry> Pending;
+
+	/** Records as of the last save. Only touched by save tasks. */
+	TSharedRef<FDialogueRecords> SavedRecords;
+
+	/** The save handed off last */
+	UE::Tasks::FTask LastSave;
+};
@@ -0,0 +1,59 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+
+struct FDialogueRecords;
+
+/**
+* Versions of the binary dialogue records format. Blobs written with an
+* older version can still be read; newer ones are rejected.
+*/
+enum class EDialogueRecordsVersion : uint8
+{
+	Initial = 1,
+
+	//Keep last
+	VersionPlusOne,
+	Latest = VersionPlusOne - 1
+};
+
+/**
+* Writes dialogue records to, and reads them from, a compact versioned
+* binary blob. Names are written once to a table and referenced by index,
+* counts and indices are written as varints, and each dialogue's visits
+* are written as a bitset or as a list of visited slots, whichever is
+* smaller. A blob may hold only some of the records, to be merged over an
+* earlier full blob when loaded.
+*/
+class DIALOGUETREERUNTIME_API FDialogueRecordsSerializer
+{
+public:
+	/**
+	* Writes the given records. Static.
+	*
+	* @param InRecords - const FDialogueRecords&, the records to write.
+	* @param InOnlyKeys - const TSet<uint64>*, if set, only the keyed
+	* records in the set are written and the blob is marked partial.
+	* @param bInWriteBlackboard - bool, whether to write the blackboard.
+	* @param OutBytes - TArray<uint8>&, the blob. Reset first.
+	*/
+	static void Save(const FDialogueRecords& InRecords,
+		const TSet<uint64>* InOnlyKeys, bool bInWriteBlackboard,
+		TArray<uint8>& OutBytes);
+
+	/**
+	* Reads records from the given blob. Static.
+	*
+	* @param InBytes - TConstArrayView<uint8>, the blob.
+	* @param OutRecords - FDialogueRecords&, the records read. Records and
+	* a blackboard missing from a partial blob are left untouched.
+	* @param bOutPartial - bool&, whether the blob only held some records.
+	* @return bool - True if the blob was read. False if it was malformed
+	* or written by a newer version, in which case OutRecords is untouched.
+	*/
+	static bool Load(TConstArrayView<uint8> InBytes,
+		FDialogueRecords& OutRecords, bool& bOutPartial);
+};
@@ -0,0 +1,177 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+
+class FDialogueInstance;
+
+/**
+* Handle to a wake-up scheduled with the dialogue scheduler.
+*/
+struct FDialogueWakeHandle
+{
+	/** Identifies the wake-up. 0 if none. */
+	uint64 Id = 0;
+
+	/**
+	* Checks if the handle refers to a wake-up. The wake-up may since have
+	* fired or been cancelled.
+	*
+	* @return bool - True if set.
+	*/
+	bool IsValid() const
+	{
+		return Id != 0;
+	}
+};
+
+/**
+* Clock driving every playing dialogue in a world. Speeches waiting out
+* their minimum play time are kept in a single queue sorted by deadline
+* instead of holding a timer each, and speeches waiting on their audio are
+* polled together instead of binding a delegate each. Everything due in a
+* frame is woken as one batch.
+* The clock only advances while ticked, so it stops with the game when
+* paused, follows world time dilation, and can be paused or scaled on its
+* own. Owned and ticked by the dialogue manager subsystem.
+*/
+class DIALOGUETREERUNTIME_API FDialogueScheduler
+{
+public:
+	/**
+	* Advances the clock and wakes every instance that came due.
+	*
+	* @param DeltaSeconds - float, the world time passed since last tick.
+	*/
+	void Tick(float DeltaSeconds);
+
+	/**
+	* Schedules the given instance's minimum play time to elapse after the
+	* given delay.
+	*
+	* @param InInstance - const TSharedRef<FDialogueInstance>&, the instance.
+	* @param InDelay - double, the delay in clock seconds.
+	* @return FDialogueWakeHandle - handle to the wake-up.
+	*/
+	FDialogueWakeHandle ScheduleWake(
+		const TSharedRef<FDialogueInstance>& InInstance, double InDelay);
+
+	/**
+	* Cancels a wake-up, if it has yet to fire.
+	*
+	* @param InHandle - FDialogueWakeHandle&, the wake-up. Reset.
+	*/
+	void CancelWake(FDialogueWakeHandle& InHandle);
+
+	/**
+	* Gets the clock seconds left before a wake-up fires. Searches the 
+	* queue, so is meant for occasional use such as rescaling.
+	*
+	* @param InHandle - const FDialogueWakeHandle&, the wake-up.
+	* @return double - the seconds left. 0 if it is no longer pending.
+	*/
+	double GetRemaining(const FDialogueWakeHandle& InHandle) const;
+
+	/**
+	* Starts polling the given instance for the end of its speech audio.
+	* Polling stops by itself once the instance stops waiting.
+	*
+	* @param InInstance - const TSharedRef<FDialogueInstance>&, the instance.
+	*/
+	void WatchAudio(const TSharedRef<FDialogueInstance>& InInstance);
+
+	/**
+	* Pauses or resumes every dialogue in the world.
+	*
+	* @param bInPaused - bool, whether to pause.
+	*/
+	void SetPaused(bool bInPaused);
+
+	/**
+	* Checks if every dialogue in the world is paused.
+	*
+	* @return bool - True if paused.
+	*/
+	bool IsPaused() const;
+
+	/**
+	* Sets how fast the clock runs relative to world time.
+	*
+	* @param InTimeScale - float, the time scale. Clamped to 0 or more.
+	*/
+	void SetTimeScale(float InTimeScale);
+
+	/**
+	* Gets how fast the clock runs relative to world time.
+	*
+	* @return float - the time scale.
+	*/
+	float GetTimeScale() const;
+
+	/**
+	* Gets the number of wake-ups waiting to fire.
+	*
+	* @return int32 - the pending wake-ups.
+	*/
+	int32 GetNumPendingWakes() const;
+
+	/**
+	* Drops every wake-up and watched instance.
+	*/
+	void Reset();
+
+private:
+	/** An entry in the deadline queue */
+	struct FWake
+	{
+		/** Clock time the wake-up fires at */
+		double Deadline = 0.0;
+
+		/** Identifies the wake-up in the pending map */
+		uint64 Id = 0;
+
+		/** Orders the queue soonest first */
+		bool operator<(const FWake& Other) const
+		{
+			return Deadline < Other.Deadline;
+		}
+	};
+
+	/**
+	* Drops cancelled entries from the queue once they outnumber the
+	* pending ones.
+	*/
+	void CompactQueue();
+
+private:
+	/** Wake-ups by deadline. Cancelled ones are left in and skipped. */
+	TArray<FWake> Queue;
+
+	/** The instance behind each pending wake-up */
+	TMap<uint64, TWeakPtr<FDialogueInstance>> PendingWakes;
+
+	/** Instances waiting on their speech audio */
+	TArray<TWeakPtr<FDialogueInstance>> AudioWatchers;
+
+	/** Instances whose wake-up fired this tick, with the wake-up's ID. Kept
+	* to reuse the allocation. */
+	TArray<TPair<TSharedPtr<FDialogueInstance>, uint64>> DueMinPlayTime;
+
+	/** Instances whose audio finished this tick, kept to reuse the
+	* allocation */
+	TArray<TSharedPtr<FDialogueInstance>> DueAudio;
+
+	/** The clock, in seconds */
+	double Now = 0.0;
+
+	/** How fast the clock runs relative to world time */
+	float TimeScale = 1.f;
+
+	/** Whether the clock is stopped */
+	bool bPaused = false;
+
+	/** The ID to give the next wake-up */
+	uint64 NextWakeId = 1;
+};
@@ -76,24 +76,110 @@ class DIALOGUETREERUNTIME_API UDialogueSettings : public UDeveloperSettings
 
 private: 
 	/**
-	* String path used to fetch default controller type. Slightly awkward but
-	* allows users to skip the step of specifying if they want to use the 
-	* default controller. If retrieval fails, an error message will ask them 
-	* to manually specify as normal. 
+	* Object path used to point at the default controller type. Slightly 
+	* awkward but allows users to skip the step of specifying if they want to
+	* use the default controller. If retrieval fails, an error message will 
+	* ask them to manually specify as normal. Only the path is stored; the 
+	* class is streamed in by the dialogue manager when a world starts.
 	*/
-	const FString DefaultControllerCoords = "/Script/Engine.Blueprint'/DialogueTree/Blueprints/Controllers/BP_BasicDialogueController.BP_BasicDialogueController_C'";
+	const FString DefaultControllerCoords = "/DialogueTree/Blueprints/Controllers/BP_BasicDialogueController.BP_BasicDialogueController_C";
 	
 public:
 	/** The type of dialogue controller to use for managing dialogue */
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category="General")
 	TSoftClassPtr<ADialogueController> DialogueControllerType = 
-		LoadClass<ADialogueController>(nullptr, *DefaultControllerCoords);
+		TSoftClassPtr<ADialogueController>(
+			FSoftObjectPath(DefaultControllerCoords)
+		);
 
 	/** The default minimum play time for a speech in dialogue. Can be 
 	* overridden on individual speeches. */
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "General")
 	float DefaultMinimumPlayTime = 3.f;
 
+	/** The maximum number of nodes a dialogue may pass through in a single
+	* step before it is ended as a likely infinite loop */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "General",
+		meta = (ClampMin = 1))
+	int32 MaxTraversalHops = 1000;
+
+	/** How many speeches ahead of the current node a playing dialogue loads
+	* the audio of in advance. 0 only loads each line as it is reached. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Audio",
+		meta = (ClampMin = 0))
+	int32 SpeechAudioPrefetchDepth = 3;
+
+	/** The most speech audio, in megabytes, that all playing dialogues may 
+	* hold loaded in advance. Lines past the budget load as they are 
+	* reached. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Audio",
+		meta = (ClampMin = 0, Units = "Megabytes"))
+	int32 SpeechAudioPrefetchBudgetMB = 64;
+
+	/** Size, in kilobytes, charged against the prefetch budget for a line 
+	* that is still loading. Corrected to the line's real size once it 
+	* loads. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Audio",
+		meta = (ClampMin = 1, Units = "Kilobytes"))
+	int32 SpeechAudioPrefetchEstimateKB = 512;
+
+	/** Edge length, in world units, of the cells the dialogue subsystem 
+	* buckets speakers into for nearby speaker lookups. Best set near the 
+	* usual search radius. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Speakers",
+		meta = (ClampMin = 1, Units = "Centimeters"))
+	float SpeakerRegistryCellSize = 2000.f;
+
+	/** Ambient dialogues with a speaker within this distance of the player's
+	* view play at full fidelity, with audio and display. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Ambient",
+		meta = (ClampMin = 0, Units = "Centimeters"))
+	float AmbientFullFidelityDistance = 1500.f;
+
+	/** Ambient dialogues within this distance of the player's view, but
+	* beyond the full fidelity distance, are displayed as text only. Any
+	* further away play out state only. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Ambient",
+		meta = (ClampMin = 0, Units = "Centimeters"))
+	float AmbientTextFidelityDistance = 4000.f;
+
+	/** How often the fidelity of ambient dialogues is re-evaluated */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Ambient",
+		meta = (ClampMin = 0.05, Units = "Seconds"))
+	float AmbientFidelityUpdateInterval = 0.5f;
+
+	/** Whether the cost and pass rate of conditions are profiled as 
+	* dialogue plays, so each node evaluates the cheapest and most decisive
+	* of its conditions first. Only native checks and queries marked 
+	* cacheable are moved, so outcomes are unchanged. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, 
+		Category = "Conditions")
+	bool bAdaptiveConditionOrder = false;
+
+	/** How many times a node's conditions are evaluated between updates of
+	* their order, when ordering adaptively */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, 
+		Category = "Conditions", meta = (ClampMin = 1, 
+			EditCondition = "bAdaptiveConditionOrder"))
+	int32 ConditionOrderInterval = 64;
+
+	/** The most barks that may play at once across the world */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Barks",
+		meta = (ClampMin = 0))
+	int32 MaxConcurrentBarks = 8;
+
+	/** The most barks that may wait for a voice at once. Past this, the 
+	* lowest priority bark is dropped. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Barks",
+		meta = (ClampMin = 0))
+	int32 MaxPendingBarks = 64;
+
+	/** Time per frame that may be spent starting barks. At least one bark
+	* is started each frame if any can be. */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Barks",
+		meta = (ClampMin = 0, Units = "Milliseconds"))
+	float BarkStartBudgetMs = 0.5f;
+
 	/** 
 	* The type of dialogue widget used to represent dialogue when using the 
 	* default controller. Defaults to W_BasicDialogueDisplay if none. 
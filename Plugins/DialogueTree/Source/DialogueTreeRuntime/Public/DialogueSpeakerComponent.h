@@ -7,11 +7,14 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 //Plugin
+#include "DialogueBarkService.h"
 #include "SpeechDetails.h"
 //Generated
 #include "DialogueSpeakerComponent.generated.h"
 
 class ADialogueController;
+class FDialogueInstance;
+class UDialogueManagerSubsystem;
 
 /**
 * Delegate used to pass data about gameplay tag changes. 
@@ -65,6 +68,7 @@ public:
 public:
 	/** UAudioComponent Impl. */
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	/** End UAudioComponent */
 
 	/**
@@ -127,15 +131,17 @@ public:
 	FGameplayTagContainer GetCurrentGameplayTags();
 
 	/**
-	* Ends the dialogue the speaker is currently participating in, if 
+	* Ends every dialogue the speaker is currently participating in, if 
 	* applicable. Does nothing if the speaker is not engaged in dialogue.
+	* Ambient dialogues are ended as well.
 	*/
 	UFUNCTION(BlueprintCallable, Category="Dialogue")
 	void EndCurrentDialogue();
 
 	/**
-	* Attempts to skip the current speech that is playing. Does nothing
-	* if the speaker component is not engaged in dialogue. 
+	* Attempts to skip the speech the speaker is currently voicing, in 
+	* whichever dialogue it is voicing it. Does nothing if the speaker is 
+	* not speaking. 
 	*/
 	UFUNCTION(BlueprintCallable, Category="Dialogue")
 	void TrySkipSpeech();
@@ -155,9 +161,9 @@ public:
 	* Changes out the speaker's current gameplay tags to the 
 	* provided set. Primarily meant to be called from dialogue side.
 	* 
-	* @param InTags - FGameplayTagContainer, the new tags to set. 
+	* @param InTags - const FGameplayTagContainer&, the new tags to set. 
 	*/
-	void SetCurrentGameplayTags(FGameplayTagContainer InTags);
+	void SetCurrentGameplayTags(const FGameplayTagContainer& InTags);
 
 	/**
 	* Clears the gameplay tags. 
@@ -168,14 +174,14 @@ public:
 	* Starts the default dialogue for this speaker component. Uses the provided
 	* name-speaker pairings for matching with target dialogue. 
 	* 
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
 	* the speaker components to pass to the dialogue. 
 	* @param bResume - bool - If true, the dialogue will resume from the marked
 	* resume node (if any). If false, the dialogue will start over.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartOwnedDialogueWithNames(
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers, 
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers, 
 		bool bResume = false);
 
 	/**
@@ -197,14 +203,14 @@ public:
 	* matching with target dialogue.
 	* 
 	* @param InDialogue - UDialogue*, the dialogue to start. 
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
 	* the speaker components to pass to the dialogue. 
 	* @param bResume - bool - If true, the dialogue will resume from the marked
 	* resume node (if any). If false, the dialogue will start over.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartDialogueWithNames(UDialogue* InDialogue, 
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers,
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers,
 		bool bResume = false);
 
 	/**
@@ -228,12 +234,12 @@ public:
 	* with target dialogue.
 	*
 	* @param InNodeID - FName, the target node ID to start at. 
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
 	* the speaker components to pass to the dialogue.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartOwnedDialogueWithNamesAt(FName InNodeID, 
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers);
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers);
 
 	/**
 	* Starts the default dialogue for this speaker component at the given node 
@@ -254,12 +260,12 @@ public:
 	*
 	* @param InDialogue - UDialogue*, the dialogue to start.
 	* @param InNodeID - FName, the target node to start at. 
-	* @param InSpeakers - TMap<FName, UDialogueSpeakerComponent*>,
+	* @param InSpeakers - const TMap<FName, UDialogueSpeakerComponent*>&,
 	* the speaker components to pass to the dialogue.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Dialogue")
 	void StartDialogueWithNamesAt(UDialogue* InDialogue, FName InNodeID,
-		TMap<FName, UDialogueSpeakerComponent*> InSpeakers);
+		const TMap<FName, UDialogueSpeakerComponent*>& InSpeakers);
 
 	/**
 	* Starts the given dialogue at the given node ID. Uses the provided 
@@ -275,9 +281,75 @@ public:
 	void StartDialogueAt(UDialogue* InDialogue, FName InNodeID,
 		TArray<UDialogueSpeakerComponent*> InSpeakers);
 
+	/**
+	* Starts the default dialogue for this speaker component with the nearest
+	* playing speakers. See StartDialogueWithNearbySpeakers().
+	*
+	* @param InSearchRadius - float, how far to look for the other speakers.
+	* 0 searches the whole world.
+	* @param bResume - bool - If true, the dialogue will resume from the marked
+	* resume node (if any). If false, the dialogue will start over.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void StartOwnedDialogueWithNearbySpeakers(float InSearchRadius, 
+		bool bResume = false);
+
+	/**
+	* Starts the given dialogue with the nearest playing speakers. This
+	* speaker takes its own role, and every other role goes to the nearest
+	* speaker in range with a matching dialogue name. Spares gathering the
+	* speakers from the world by hand.
+	*
+	* @param InDialogue - UDialogue*, the dialogue to start.
+	* @param InSearchRadius - float, how far to look for the other speakers.
+	* 0 searches the whole world.
+	* @param bResume - bool - If true, the dialogue will resume from the marked
+	* resume node (if any). If false, the dialogue will start over.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	void StartDialogueWithNearbySpeakers(UDialogue* InDialogue, 
+		float InSearchRadius, bool bResume = false);
+
+	/**
+	* Asks to play the given dialogue as a bark. Barks from every speaker in
+	* the world compete for a limited number of voices by priority, so the
+	* bark may start later, cut off a lesser one, or be dropped.
+	*
+	* @param InDialogue - UDialogue*, the bark to play.
+	* @param InParams - FDialogueBarkParams, how the bark competes.
+	* @return bool - True if the bark was queued. False if it is cooling 
+	* down or was outranked.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Dialogue")
+	bool RequestBark(UDialogue* InDialogue, FDialogueBarkParams InParams);
+
 public:
 	FSpeakerActorEntry ToSpeakerActorEntry();
 
+	/**
+	* Adds a dialogue instance the speaker is taking part in. A speaker can
+	* take part in several at once. 
+	* 
+	* @param InInstance - TWeakPtr<FDialogueInstance>, the instance. 
+	*/
+	void AddActiveInstance(TWeakPtr<FDialogueInstance> InInstance);
+
+	/**
+	* Removes the given instance from those the speaker takes part in. 
+	* 
+	* @param InInstance - const FDialogueInstance*, the closing instance. 
+	*/
+	void RemoveActiveInstance(const FDialogueInstance* InInstance);
+
+	/**
+	* Retrieves the dialogue instances the speaker is taking part in. 
+	* 
+	* @param OutInstances - TArray<TSharedPtr<FDialogueInstance>>&, the 
+	* active instances. Empty if the speaker is not engaged in dialogue. 
+	*/
+	void GetActiveInstances(
+		TArray<TSharedPtr<FDialogueInstance>>& OutInstances) const;
+
 	/**
 	* Notifies subscribers that the given speech was skipped.
 	* 
@@ -288,6 +360,40 @@ public:
 private:
 	void BroadcastCurrentGameplayTags();
 
+	/**
+	* Queues the given start request until the dialogue controller has been
+	* spawned, if its class is still loading. 
+	* 
+	* @param InStart - TFunction<void()>, the request to replay once the
+	* controller is ready. 
+	* @return bool - True if the request was queued. False if it should go
+	* ahead now. 
+	*/
+	bool DeferUntilControllerReady(TFunction<void()> InStart);
+
+	/**
+	* Called when the dialogue controller is spawned after the speaker began
+	* play. 
+	* 
+	* @param InController - ADialogueController*, the controller. Nullptr if
+	* it failed to spawn. 
+	*/
+	void OnControllerReady(ADialogueController* InController);
+
+	/**
+	* Keeps the speaker registry up to date as the speaker moves.
+	*/
+	void OnSpeakerMoved(USceneComponent* InComponent, 
+		EUpdateTransformFlags InFlags, ETeleportType InTeleport);
+
+	/**
+	* Retrieves the dialogue subsystem of the speaker's world.
+	*
+	* @return UDialogueManagerSubsystem* - the subsystem. Null if the speaker
+	* is not in a world.
+	*/
+	UDialogueManagerSubsystem* GetDialogueSubsystem() const;
+
 protected:
 	/** The name to display for this speaker in dialogue */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dialogue")
@@ -307,6 +413,11 @@ protected:
 		meta = (AllowPrivateAccess = true))
 	FGameplayTagContainer GameplayTags;
 
+private:
+	/** The dialogue instances the speaker is currently taking part in, 
+	* one entry each */
+	TArray<TWeakPtr<FDialogueInstance>, TInlineAllocator<1>> ActiveInstances;
+
 public:
 	/** Currently active dialogue controller */
 	UPROPERTY(BlueprintReadOnly, Category="Dialogue")
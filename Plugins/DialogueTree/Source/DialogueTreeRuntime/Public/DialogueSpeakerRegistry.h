@@ -0,0 +1,158 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UDialogueSpeakerComponent;
+
+/**
+* Registry of the speaker components playing in a world. Speakers are
+* indexed by their dialogue name and bucketed into a coarse spatial hash by
+* location, so finding the speakers for a role or the ones near a point
+* does not have to sweep every actor in the world.
+* Owned by the dialogue manager subsystem. Speakers register themselves on
+* begin play and unregister on end play, which always comes before they are
+* destroyed, so the registry holds them without keeping them alive.
+*/
+class DIALOGUETREERUNTIME_API FDialogueSpeakerRegistry
+{
+public:
+	/**
+	* Sets the edge length of the spatial hash cells. Re-buckets any speakers
+	* already registered.
+	*
+	* @param InCellSize - float, the cell size in world units.
+	*/
+	void SetCellSize(float InCellSize);
+
+	/**
+	* Adds the given speaker, or refreshes its name and cell if it was
+	* already registered.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void Register(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Removes the given speaker.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void Unregister(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Moves a registered speaker to the cell of its current location. Does
+	* nothing if the speaker did not leave its cell.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	*/
+	void UpdateLocation(UDialogueSpeakerComponent* InSpeaker);
+
+	/**
+	* Checks if the given speaker is registered.
+	*
+	* @param InSpeaker - const UDialogueSpeakerComponent*, the speaker.
+	* @return bool - True if registered. False otherwise.
+	*/
+	bool IsRegistered(const UDialogueSpeakerComponent* InSpeaker) const;
+
+	/**
+	* Retrieves the speakers registered under the given dialogue name.
+	*
+	* @param InName - FName, the dialogue name.
+	* @return TConstArrayView<UDialogueSpeakerComponent*> - the speakers.
+	* Only valid until the registry next changes.
+	*/
+	TConstArrayView<UDialogueSpeakerComponent*> FindByName(FName InName) const;
+
+	/**
+	* Finds the speaker with the given dialogue name nearest to a location.
+	*
+	* @param InName - FName, the dialogue name.
+	* @param InOrigin - const FVector&, the location to search from.
+	* @param InMaxDistance - float, the search radius. 0 or less searches
+	* without limit.
+	* @param InIgnore - const UDialogueSpeakerComponent*, a speaker to skip.
+	* @return UDialogueSpeakerComponent* - the nearest speaker. Null if none
+	* were in range.
+	*/
+	UDialogueSpeakerComponent* FindNearest(FName InName,
+		const FVector& InOrigin, float InMaxDistance,
+		const UDialogueSpeakerComponent* InIgnore = nullptr) const;
+
+	/**
+	* Gathers every registered speaker within range of a location.
+	*
+	* @param InOrigin - const FVector&, the location to search from.
+	* @param InMaxDistance - float, the search radius.
+	* @param OutSpeakers - TArray<UDialogueSpeakerComponent*>&, the speakers
+	* found. Appended to.
+	*/
+	void FindInRange(const FVector& InOrigin, float InMaxDistance,
+		TArray<UDialogueSpeakerComponent*>& OutSpeakers) const;
+
+	/**
+	* Gets the number of registered speakers.
+	*
+	* @return int32 - the speaker count.
+	*/
+	int32 Num() const;
+
+	/**
+	* Removes every speaker.
+	*/
+	void Reset();
+
+private:
+	/** Where a registered speaker is filed */
+	struct FSpeakerEntry
+	{
+		/** The dialogue name the speaker is filed under */
+		FName Name;
+
+		/** The spatial hash cell the speaker is filed under */
+		FIntVector Cell;
+	};
+
+	/**
+	* Gets the spatial hash cell containing the given location.
+	*
+	* @param InLocation - const FVector&, the location.
+	* @return FIntVector - the cell.
+	*/
+	FIntVector GetCell(const FVector& InLocation) const;
+
+	/**
+	* Files the speaker under the given entry's name and cell.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	* @param InEntry - const FSpeakerEntry&, where to file it.
+	*/
+	void Insert(UDialogueSpeakerComponent* InSpeaker,
+		const FSpeakerEntry& InEntry);
+
+	/**
+	* Takes the speaker out of the given entry's name and cell.
+	*
+	* @param InSpeaker - UDialogueSpeakerComponent*, the speaker.
+	* @param InEntry - const FSpeakerEntry&, where it was filed.
+	*/
+	void Remove(UDialogueSpeakerComponent* InSpeaker,
+		const FSpeakerEntry& InEntry);
+
+private:
+	/** Where each registered speaker is filed */
+	TMap<TObjectKey<UDialogueSpeakerComponent>, FSpeakerEntry> Entries;
+
+	/** Registered speakers by dialogue name */
+	TMap<FName, TArray<UDialogueSpeakerComponent*>> SpeakersByName;
+
+	/** Registered speakers by spatial hash cell */
+	TMap<FIntVector, TArray<UDialogueSpeakerComponent*>> SpeakersByCell;
+
+	/** Edge length of the spatial hash cells */
+	float CellSize = 2000.f;
+};
@@ -33,6 +33,20 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Dialogue")
 	FName GetSpeakerName() const;
 
+	/**
+	* Sets the slot the speaker's role was compiled to. 
+	* 
+	* @param InSlot - int32, the speaker slot.
+	*/
+	void SetSpeakerSlot(int32 InSlot);
+
+	/**
+	* Retrieves the slot the speaker's role was compiled to. 
+	* 
+	* @return int32, the speaker slot. INDEX_NONE if not compiled.
+	*/
+	int32 GetSpeakerSlot() const;
+
 	/**
 	* Retrieve the component associated with this speaker from 
 	* the provided dialogue. 
@@ -55,4 +69,8 @@ private:
 	/** Name of the speaker */
 	UPROPERTY(EditAnywhere, Category = "Dialogue")
 	FName SpeakerName;
+
+	/** Slot of the speaker's role in the compiled dialogue */
+	UPROPERTY()
+	int32 SpeakerSlot = INDEX_NONE;
 };
@@ -0,0 +1,121 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+//UE
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+class UDialogue;
+
+DECLARE_STATS_GROUP(
+	TEXT("DialogueTree"),
+	STATGROUP_DialogueTree,
+	STATCAT_Advanced
+);
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(
+	TEXT("Active Dialogues"),
+	STAT_DialogueTree_ActiveDialogues,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Hops"),
+	STAT_DialogueTree_Hops,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Condition Evaluations"),
+	STAT_DialogueTree_ConditionEvaluations,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Blueprint Query Calls"),
+	STAT_DialogueTree_BlueprintQueryCalls,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Query Cache Hits"),
+	STAT_DialogueTree_QueryCacheHits,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Barks Started"),
+	STAT_DialogueTree_BarksStarted,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(
+	TEXT("Barks Culled"),
+	STAT_DialogueTree_BarksCulled,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+DECLARE_MEMORY_STAT_EXTERN(
+	TEXT("Prefetched Speech Audio"),
+	STAT_DialogueTree_PrefetchedAudio,
+	STATGROUP_DialogueTree,
+	DIALOGUETREERUNTIME_API
+);
+
+UE_TRACE_CHANNEL_EXTERN(DialogueTreeChannel, DIALOGUETREERUNTIME_API);
+
+namespace DialogueTreeTrace
+{
+	/**
+	* Checks if dialogue scopes are being traced, so their metadata is only
+	* formatted when someone is listening.
+	*
+	* @return bool - True if the dialogue and CPU channels are both on.
+	*/
+	DIALOGUETREERUNTIME_API bool IsEnabled();
+
+	/**
+	* Formats the metadata of a dialogue scope as "Dialogue/Name".
+	*
+	* @param InDialogue - const UDialogue*, the dialogue being played.
+	* @param InName - FName, the node ID or object the scope is about.
+	* @return FString - the scope's metadata.
+	*/
+	DIALOGUETREERUNTIME_API FString DescribeScope(const UDialogue* InDialogue,
+		FName InName);
+}
+
+/**
+* Opens a CPU scope on the DialogueTree trace channel, with a nested scope
+* naming the dialogue and node it ran for. Shows up in Unreal Insights when
+* tracing with -trace=cpu,dialoguetree.
+*/
+#if CPUPROFILERTRACE_ENABLED
+#define DIALOGUE_TRACE_SCOPE(ScopeName, InDialogue, InName) \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR( \
+		"DialogueTree::" ScopeName, \
+		DialogueTreeChannel \
+	) \
+	const bool PREPROCESSOR_JOIN(bDialogueTraceEnabled, __LINE__) = \
+		DialogueTreeTrace::IsEnabled(); \
+	FCpuProfilerTrace::FDynamicEventScope \
+		PREPROCESSOR_JOIN(DialogueTraceDetailScope, __LINE__)( \
+			PREPROCESSOR_JOIN(bDialogueTraceEnabled, __LINE__) \
+				? *DialogueTreeTrace::DescribeScope(InDialogue, InName) \
+				: TEXT(""), \
+			DialogueTreeChannel, \
+			PREPROCESSOR_JOIN(bDialogueTraceEnabled, __LINE__) \
+		);
+#else
+#define DIALOGUE_TRACE_SCOPE(ScopeName, InDialogue, InName)
+#endif
@@ -119,4 +119,8 @@ protected:
 	/** Optional additional speakers to attach to the event */
 	UPROPERTY(EditAnywhere, Category = "DialogueEvent")
 	TArray<TObjectPtr<UDialogueSpeakerSocket>> AdditionalSpeakers;
+
+	/** Entries for the additional speakers, kept between plays */
+	UPROPERTY(Transient)
+	TArray<FSpeakerActorEntry> OtherSpeakerEntries;
 };
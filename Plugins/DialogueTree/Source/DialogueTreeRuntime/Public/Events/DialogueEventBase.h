@@ -7,6 +7,7 @@
 #include "DialogueEventBase.generated.h"
 
 class UDialogue;
+struct FDialogueProgram;
 
 DECLARE_DELEGATE(FDialogueEventSignature);
 
@@ -71,6 +72,15 @@ public:
 	*/
 	virtual void PlayEvent();
 
+	/**
+	* Resolves anything the event needs from the dialogue's compiled 
+	* program, such as blackboard keys. Called while the owning node is 
+	* compiled.
+	*
+	* @param InProgram - FDialogueProgram&, the program being built.
+	*/
+	virtual void CompileEvent(FDialogueProgram& InProgram);
+
 	/**
 	* Sets the event's owning dialogue.
 	*
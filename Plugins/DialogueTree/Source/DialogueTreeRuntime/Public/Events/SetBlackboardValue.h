@@ -0,0 +1,78 @@
+// Copyright Zachary Brett, 2024. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DialogueBlackboard.h"
+#include "Events/DialogueEventBase.h"
+#include "SetBlackboardValue.generated.h"
+
+/**
+ * Dialogue event that writes a key on the dialogue blackboard, such as a 
+ * quest flag. The key is resolved to a blackboard slot when compiled.
+ */
+UCLASS()
+class DIALOGUETREERUNTIME_API USetBlackboardValue : public UDialogueEventBase
+{
+	GENERATED_BODY()
+
+public:
+	/** UDialogueEvent Impl. */
+	virtual void PlayEvent() override;
+	virtual void CompileEvent(FDialogueProgram& InProgram) override;
+	virtual bool HasAllRequirements() const override;
+	virtual FText GetGraphDescription_Implementation() const override;
+	/** End UDialogueEvent */
+
+private:
+	/**
+	* Assembles the value to write from the event's settings.
+	*
+	* @return FDialogueBlackboardValue - the value.
+	*/
+	FDialogueBlackboardValue MakeValue() const;
+
+private:
+	/** The blackboard key to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	FName Key;
+
+	/** The type of value to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue")
+	EDialogueBlackboardType Type = EDialogueBlackboardType::Bool;
+
+	/** Whether to add to the key's number instead of replacing it */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", meta = (EditCondition = 
+		"Type == EDialogueBlackboardType::Int || Type == EDialogueBlackboardType::Float",
+		EditConditionHides))
+	bool bAdd = false;
+
+	/** The bool to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", meta = (EditCondition = 
+		"Type == EDialogueBlackboardType::Bool", EditConditionHides))
+	bool bBoolValue = true;
+
+	/** The int to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", meta = (EditCondition = 
+		"Type == EDialogueBlackboardType::Int", EditConditionHides))
+	int32 IntValue = 0;
+
+	/** The float to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", meta = (EditCondition = 
+		"Type == EDialogueBlackboardType::Float", EditConditionHides))
+	float FloatValue = 0.f;
+
+	/** The name to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", meta = (EditCondition = 
+		"Type == EDialogueBlackboardType::Name", EditConditionHides))
+	FName NameValue;
+
+	/** The tag to write */
+	UPROPERTY(EditAnywhere, Category = "Dialogue", meta = (EditCondition = 
+		"Type == EDialogueBlackboardType::Tag", EditConditionHides))
+	FGameplayTag TagValue;
+
+	/** The key's index in the dialogue's program */
+	UPROPERTY()
+	int32 KeyIndex = INDEX_NONE;
+};
@@ -24,6 +24,8 @@ public:
 	/** UDialogueNode Implementation */
 	virtual FDialogueOption GetAsOption() override;
 	virtual void EnterNode() override;
+	virtual void CompileNode(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End UDialogueNode */
 
 	/**
@@ -20,5 +20,7 @@ class DIALOGUETREERUNTIME_API UDialogueEntryNode : public UDialogueNode
 public:
 	/** UDialogueNode Impl. */
 	virtual void EnterNode() override;
+	virtual void CompileNode(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End UDialogueNode */
 };
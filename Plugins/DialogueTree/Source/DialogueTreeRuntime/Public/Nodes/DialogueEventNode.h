@@ -25,6 +25,10 @@ public:
 	virtual void EnterNode() override;
 	virtual FDialogueOption GetAsOption() override;
 	virtual void Skip() override;
+	virtual void RestoreNode(const FDialogueInstanceSnapshot& InSnapshot) 
+		override;
+	virtual void CompileNode(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End UDialogueNode */
 
 	/**
@@ -48,12 +52,36 @@ public:
 	*/
 	bool GetIsBlocking() const;
 
+	/**
+	* Gets the indices of the events still blocking. 
+	* 
+	* @param OutEvents - TArray<int32>&, the indices. 
+	*/
+	void GetBlockingEvents(TArray<int32>& OutEvents) const;
+
 protected: 
 	/**
 	* Plays the node's events. 
 	*/
 	void PlayEvents();
 
+	/**
+	* Plays again the events that were still blocking when the snapshot was
+	* taken, since whatever they were waiting on did not outlive it. Events
+	* that had finished are not played again. 
+	* 
+	* @param InSnapshot - const FDialogueInstanceSnapshot&, the snapshot.
+	*/
+	void RestoreEvents(const FDialogueInstanceSnapshot& InSnapshot);
+
+	/**
+	* Plays the given event, and has it resume the executing instance when 
+	* it stops blocking. 
+	* 
+	* @param InEvent - UDialogueEventBase*, the event. 
+	*/
+	void PlayEvent(UDialogueEventBase* InEvent);
+
 	/**
 	* Transitions out of the node if all of its events have completed.
 	*/
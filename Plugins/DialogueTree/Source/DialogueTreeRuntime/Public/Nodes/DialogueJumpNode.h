@@ -22,6 +22,8 @@ public:
 	/** UDialogueNode Implementation */
 	virtual void EnterNode() override;
 	virtual FDialogueOption GetAsOption() override;
+	virtual void CompileNode(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End UDialogueNode */
 
 	/**
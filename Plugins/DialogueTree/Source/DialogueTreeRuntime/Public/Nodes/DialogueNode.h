@@ -11,6 +11,9 @@
 #include "DialogueNode.generated.h"
 
 class UDialogue;
+struct FDialogueInstanceSnapshot;
+struct FDialogueProgram;
+struct FDialogueProgramNode;
 
 /**
  * Abstract base class for all runtime dialogue nodes. 
@@ -50,19 +53,31 @@ public:
 	*/
 	void AddChild(UDialogueNode* InChild);
 
+	/**
+	* Removes a dialogue node from this node's parents. 
+	* 
+	* @param InParent - UDialogueNode*, parent node to remove. 
+	*/
+	void RemoveParent(UDialogueNode* InParent);
+
+	/**
+	* Removes all children of this node. 
+	*/
+	void ClearChildren();
+
 	/**
 	* Retrieves a TArray of all parents for this node. 
 	* 
-	* @return TArray<UDialogueNode*>, parent nodes. 
+	* @return const TArray<TObjectPtr<UDialogueNode>>&, parent nodes. 
 	*/
-	TArray<UDialogueNode*> GetParents() const;
+	const TArray<TObjectPtr<UDialogueNode>>& GetParents() const;
 
 	/**
 	* Retrieves a TArray of all children of this node. 
 	* 
-	* @return TArray<UDialogueNode*>, child nodes. 
+	* @return const TArray<TObjectPtr<UDialogueNode>>&, child nodes. 
 	*/
-	TArray<UDialogueNode*> GetChildren() const;
+	const TArray<TObjectPtr<UDialogueNode>>& GetChildren() const;
 
 	/**
 	* Gets an FDialogueOption struct representing this node as a
@@ -77,6 +92,15 @@ public:
 	*/
 	virtual void EnterNode() {};
 
+	/**
+	* Picks up where a snapshotted instance left off on this node, without
+	* replaying what the node already did. The instance's transition state 
+	* is restored first. 
+	* 
+	* @param InSnapshot - const FDialogueInstanceSnapshot&, the snapshot.
+	*/
+	virtual void RestoreNode(const FDialogueInstanceSnapshot& InSnapshot) {};
+
 	/**
 	* Attempts to select the option at the given index, if 
 	* applicable. 
@@ -91,6 +115,31 @@ public:
 	*/
 	virtual void Skip() {};
 
+	/**
+	* Writes the node's runtime data into its entry in the dialogue's
+	* compiled program. Called once every node in the dialogue has been 
+	* assigned an index. 
+	* 
+	* @param InProgram - FDialogueProgram&, the program being built. 
+	* @param OutNode - FDialogueProgramNode&, this node's entry. 
+	*/
+	virtual void CompileNode(FDialogueProgram& InProgram, 
+		FDialogueProgramNode& OutNode) const;
+
+	/**
+	* Retrieves the node's index in the dialogue's compiled program. 
+	* 
+	* @return int32 - the index. INDEX_NONE if not compiled. 
+	*/
+	int32 GetNodeIndex() const;
+
+	/**
+	* Sets the node's index in the dialogue's compiled program.
+	* 
+	* @param InIndex - int32, the new index. 
+	*/
+	void SetNodeIndex(int32 InIndex);
+
 	/**
 	* Retrieves the id for the node in dialogue
 	* 
@@ -105,6 +154,37 @@ public:
 	*/
 	void SetNodeID(FName InID);
 
+	/**
+	* Retrieves the GUID of the graph node the node was compiled from. 
+	* 
+	* @return FGuid - the GUID. Invalid if the node predates stable IDs.
+	*/
+	FGuid GetNodeGuid() const;
+
+	/**
+	* Sets the GUID of the graph node the node was compiled from, deriving
+	* the node's stable ID from it. 
+	* 
+	* @param InGuid - const FGuid&, the graph node's GUID. 
+	*/
+	void SetNodeGuid(const FGuid& InGuid);
+
+	/**
+	* Retrieves the node's stable ID. Unlike the node ID, this survives the
+	* node being renamed, so save data can be keyed by it. 
+	* 
+	* @return uint32 - the stable ID. 0 if the node predates stable IDs.
+	*/
+	uint32 GetStableID() const;
+
+	/**
+	* Derives a compact stable ID from a graph node GUID. Static. 
+	* 
+	* @param InGuid - const FGuid&, the GUID. 
+	* @return uint32 - the stable ID. Never 0 for a valid GUID. 
+	*/
+	static uint32 MakeStableID(const FGuid& InGuid);
+
 	/**
 	* Sets the node's graph location.
 	* 
@@ -128,6 +208,18 @@ protected:
 	UPROPERTY()
 	FName NodeID;
 
+	/** The GUID of the graph node this node was compiled from */
+	UPROPERTY()
+	FGuid NodeGuid;
+
+	/** Stable ID derived from the node GUID. 0 if there is none. */
+	UPROPERTY()
+	uint32 StableID = 0;
+
+	/** The index of the node in the dialogue's compiled program */
+	UPROPERTY()
+	int32 NodeIndex = INDEX_NONE;
+
 	/** Any direct parent nodes in the dialogue */
 	UPROPERTY()
 	TArray<TObjectPtr<UDialogueNode>> Parents;
@@ -18,5 +18,7 @@ public:
 	/** UDialogueNode Impl. */
 	virtual void EnterNode() override;
 	virtual FDialogueOption GetAsOption() override;
+	virtual void CompileNode(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End UDialogueNode */
 };
@@ -43,9 +43,9 @@ public:
 	/**
 	* Retrieves the details struct for the speech.
 	* 
-	* @return FSpeechDetails, details for the speech. 
+	* @return const FSpeechDetails&, details for the speech. 
 	*/
-	FSpeechDetails GetDetails() const;
+	const FSpeechDetails& GetDetails() const;
 
 	/**
 	* Retrieves the speaker component associated with the speech 
@@ -61,6 +61,10 @@ public:
 	virtual FDialogueOption GetAsOption() override;
 	virtual void SelectOption(int32 InOptionIndex) override;
 	virtual void Skip() override;
+	virtual void RestoreNode(const FDialogueInstanceSnapshot& InSnapshot) 
+		override;
+	virtual void CompileNode(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End DialogueEventNode */
 
 	/**
@@ -70,6 +74,13 @@ public:
 	*/
 	TSubclassOf<UDialogueTransition> GetTransitionType() const;
 
+	/**
+	* Retrieves the transition used by the speech. 
+	* 
+	* @return UDialogueTransition*, the transition.
+	*/
+	UDialogueTransition* GetTransition() const;
+
 protected:
 	/** DialogueEventNode Impl */
 	virtual void TransitionIfNotBlocking() const override;
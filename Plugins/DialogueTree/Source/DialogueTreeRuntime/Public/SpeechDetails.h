@@ -30,9 +30,10 @@ struct FSpeechDetails
 	UPROPERTY(BlueprintReadOnly, Category = "Dialogue")
 	FName SpeechTitle = NAME_None; 
 
-	/** The audio associated with the speech */
+	/** The audio associated with the speech. Streamed in by the playing 
+	* dialogue shortly before the speech is reached. */
 	UPROPERTY(BlueprintReadOnly, Category = "Dialogue")
-	TObjectPtr<USoundBase> SpeechAudio = nullptr;
+	TSoftObjectPtr<USoundBase> SpeechAudio;
 
 	/** The minimum time for the speech to play before transitioning (unless
 	* skipped) */
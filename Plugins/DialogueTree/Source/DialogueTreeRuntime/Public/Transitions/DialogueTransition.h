@@ -4,28 +4,28 @@
 
 //UE
 #include "CoreMinimal.h"
-#include "TimerManager.h"
 #include "UObject/NoExportTypes.h"
 //Plugin
 #include "DialogueConnectionLimit.h"
 //Generated
 #include "DialogueTransition.generated.h"
 
+class FDialogueInstance;
 class UDialogueSpeechNode;
+struct FDialogueProgram;
+struct FDialogueProgramNode;
 
 /**
  * Abstract base class for speech transitions. Transitions govern
  * how and when a speech node transfers control on to a child node. 
+ * A transition is shared by every instance playing its dialogue, so any
+ * state it tracks while a speech plays lives on the dialogue instance.
  */
 UCLASS(Abstract)
 class DIALOGUETREERUNTIME_API UDialogueTransition : public UObject
 {
 	GENERATED_BODY()
 
-public:
-	//Constructor
-	UDialogueTransition();
-	
 public:
 	/**
 	* Sets the owning node. 
@@ -40,6 +40,13 @@ public:
 	*/
 	virtual void StartTransition();
 
+	/**
+	* Called when a snapshotted instance is restored on the owning node,
+	* after its transition state. Picks up waiting on the audio and minimum
+	* play time left over, and transitions out if both were done.
+	*/
+	virtual void RestoreTransition();
+
 	/**
 	* Concludes the transition. Largely defined by child transitions.
 	*/
@@ -83,44 +90,43 @@ public:
 	*/
 	virtual EDialogueConnectionLimit GetConnectionLimit() const;
 
+	/**
+	* Adds anything the transition needs to the owning node's compiled 
+	* entry. Base implementation adds nothing. 
+	* 
+	* @param InProgram - FDialogueProgram&, the program being built.
+	* @param OutNode - FDialogueProgramNode&, the owning node's entry.
+	*/
+	virtual void CompileTransition(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const {};
+
 	/**
 	* Checks if the transition should exit, and triggers the transition out
 	* if so.
 	*/
 	void CheckTransitionConditions();
 
-private:
-
 	/**
 	* Called when the speech content has finished playing.
 	*/
-	UFUNCTION()
 	void OnDonePlayingContent();
 
 	/**
 	* Called when the minimum play time has elapsed.
 	*/
-	UFUNCTION()
 	void OnMinPlayTimeElapsed();
 
+protected:
+	/**
+	* Retrieves the dialogue instance the transition is currently 
+	* playing in. 
+	* 
+	* @return FDialogueInstance* - the instance. Nullptr if none.
+	*/
+	FDialogueInstance* GetInstance() const;
+
 protected:
 	/** The node upon which the transition operates*/
 	UPROPERTY()
 	TObjectPtr<UDialogueSpeechNode> OwningNode;
-
-	/** Whether the min play time has elapsed yet */
-	bool bMinPlayTimeElapsed = false;
-
-	/** Whether the audio content has finished playing yet */
-	bool bAudioFinished = false;
-
-private:
-	/** Delegate to call when the minimum play time for the node has elapsed */
-	FTimerDelegate OnTimerEnd;
-
-	/** Timer handle for timer that tracks minimum play time */
-	FTimerHandle MinPlayTimeHandle;
-
-	/** Delegate to call when the speech has finished playing */
-	FScriptDelegate OnContentEnd;
 };
@@ -12,7 +12,8 @@
 
 /**
  * Speech transition that presents options and waits for a player
- * choice. 
+ * choice. Ambient dialogues have no player to choose, so they take the 
+ * first unlocked option instead. 
  */
 UCLASS()
 class DIALOGUETREERUNTIME_API UInputDialogueTransition : 
@@ -23,11 +24,14 @@ class DIALOGUETREERUNTIME_API UInputDialogueTransition :
 public:
 	/** DialogueTransition Implementation */
 	virtual void StartTransition() override;
+	virtual void RestoreTransition() override;
 	virtual void TransitionOut() override;
 	virtual void SelectOption(int32 InOptionIndex);
 	virtual FText GetDisplayName() const override;
 	virtual FText GetNodeCreationTooltip() const override;
 	virtual EDialogueConnectionLimit GetConnectionLimit() const override;
+	virtual void CompileTransition(FDialogueProgram& InProgram,
+		FDialogueProgramNode& OutNode) const override;
 	/** End DialogueTranstion */
 
 private:
@@ -38,13 +42,19 @@ private:
 	void ShowOptions();
 
 	/**
-	* Retrieves and caches the options for the transition. 
+	* Retrieves and caches the options for the transition in the given 
+	* options array. 
+	* 
+	* @param OutOptions - TArray<FResolvedDialogueOption>&, array to fill. 
 	*/
-	UFUNCTION()
-	void GetOptions();
+	void GetOptions(TArray<FResolvedDialogueOption>& OutOptions) const;
 
-private: 
-	/** The available options for the player to choose */
-	UPROPERTY()
-	TArray<FDialogueOption> Options;
+	/**
+	* Picks the first unlocked option on behalf of an ambient dialogue. 
+	* 
+	* @param InOptions - const TArray<FResolvedDialogueOption>&, the 
+	* options. 
+	*/
+	void SelectFirstUnlockedOption(
+		const TArray<FResolvedDialogueOption>& InOptions);
 };